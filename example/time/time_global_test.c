@@ -309,6 +309,7 @@ int main(int argc, char *argv[])
 	odp_barrier_init(&gbls->end_barrier, num_workers);
 	memset(gbls->log, 0, log_size);
 
+	odp_pool_param_init(&params);
 	params.buf.size  = sizeof(timestamp_event_t);
 	params.buf.align = ODP_CACHE_LINE_SIZE;
 	params.buf.num   = num_workers;
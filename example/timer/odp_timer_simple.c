@@ -61,6 +61,7 @@ int main(int argc ODP_UNUSED, char *argv[] ODP_UNUSED)
 	/*
 	 * Create pool of timeouts
 	 */
+	odp_timer_pool_param_init(&tparams);
 	tparams.res_ns = 10 * ODP_TIME_MSEC_IN_NS;
 	tparams.min_tmo = 10 * ODP_TIME_MSEC_IN_NS;
 	tparams.max_tmo = 1 * ODP_TIME_SEC_IN_NS;
@@ -430,6 +430,7 @@ int main(int argc, char *argv[])
 		goto err;
 	}
 
+	odp_timer_pool_param_init(&tparams);
 	tparams.res_ns = gbls->args.resolution_us * ODP_TIME_USEC_IN_NS;
 	tparams.min_tmo = gbls->args.min_us * ODP_TIME_USEC_IN_NS;
 	tparams.max_tmo = gbls->args.max_us * ODP_TIME_USEC_IN_NS;
@@ -0,0 +1,202 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP IPv4 fragmentation and reassembly helper
+ *
+ * Fragmentation splits a datagram into fragments by relinking packet segments
+ * (odp_packet_split()), only L2 and IP headers are written. Reassembly keeps
+ * fragments in a per flow table, keyed by source and destination addresses,
+ * identification and protocol, and joins them with odp_packet_concat().
+ * Incomplete datagrams are evicted by ODP timers.
+ *
+ * A reassembly context is not thread safe. Create one context per worker
+ * and direct all fragments of a datagram to the same worker (e.g. hash on IP
+ * addresses only). Then workers do not share any reassembly state.
+ */
+
+#ifndef ODPH_IPFRAG_H_
+#define ODPH_IPFRAG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp_api.h>
+
+/** @addtogroup odph_ipfrag ODPH IP FRAGMENTATION
+ *  @{
+ */
+
+/** Maximum number of fragments per datagram in reassembly */
+#define ODPH_IPV4_REASS_MAX_FRAGS 64
+
+/**
+ * Fragment IPv4 packet
+ *
+ * Splits an IPv4 datagram into fragments which IP datagram length is 'mtu'
+ * bytes or less. Packet L3 offset must point to the IPv4 header. L2 header
+ * and the IP header are copied in front of each fragment, options not marked
+ * to be copied are left out from other than the first fragment. Payload is
+ * not copied, but moved into fragments as segments when possible. Packet
+ * data after the IP datagram (e.g. Ethernet padding) is removed.
+ *
+ * A datagram which fits into 'mtu' is output as is as the only fragment.
+ *
+ * @param[in, out] pkt   Pointer to packet handle. On failure, the handle is
+ *                       ODP_PACKET_INVALID if the packet was freed. The packet
+ *                       is not modified on failure when the datagram has
+ *                       Don't Fragment flag set or it needs more than
+ *                       'max_frags' fragments.
+ * @param mtu            Maximum IP datagram length of a fragment (e.g.
+ *                       odp_pktio_mtu() of the output interface minus L2
+ *                       header length)
+ * @param[out] frag      Fragment table for output
+ * @param max_frags      Maximum number of fragments to output
+ *
+ * @return Number of fragments output into 'frag'
+ * @retval <0 on failure
+ */
+int odph_ipv4_fragment(odp_packet_t *pkt, uint32_t mtu, odp_packet_t frag[],
+		       int max_frags);
+
+/** IPv4 reassembly context */
+typedef struct odph_ipv4_reass_s *odph_ipv4_reass_t;
+
+/** Invalid reassembly context */
+#define ODPH_IPV4_REASS_INVALID NULL
+
+/** IPv4 reassembly parameters */
+typedef struct odph_ipv4_reass_param_t {
+	/** Maximum number of datagrams under reassembly */
+	uint32_t num_flows;
+
+	/** Maximum number of fragments per datagram. The maximum value is
+	 *  ODPH_IPV4_REASS_MAX_FRAGS. */
+	uint32_t max_frags;
+
+	/** Reassembly timeout in nanoseconds. Incomplete datagrams are
+	 *  evicted and their fragments freed after this time. */
+	uint64_t timeout_ns;
+
+	/** Timer pool for reassembly timers. Context allocates a timer per
+	 *  flow table entry, 'num_flows' rounded up to a power of two. */
+	odp_timer_pool_t timer_pool;
+
+	/** Destination queue of reassembly timeouts. Application passes
+	 *  timeout events from the queue to odph_ipv4_reass_timeout(). Use
+	 *  a queue which is served by the thread owning the context. */
+	odp_queue_t tmo_queue;
+} odph_ipv4_reass_param_t;
+
+/** IPv4 reassembly statistics */
+typedef struct odph_ipv4_reass_stats_t {
+	/** Fragments received */
+	uint64_t frags;
+
+	/** Datagrams reassembled */
+	uint64_t complete;
+
+	/** Datagrams evicted by timeout */
+	uint64_t timeouts;
+
+	/** Fragments dropped as invalid, overlapping or without free table
+	 *  space */
+	uint64_t drops;
+} odph_ipv4_reass_stats_t;
+
+/**
+ * Initialize reassembly parameters
+ *
+ * Sets default values: 1024 flows, 16 fragments, 1 second timeout.
+ * Timer pool and timeout queue must be set by the application.
+ *
+ * @param[out] param  Reassembly parameters to initialize
+ */
+void odph_ipv4_reass_param_init(odph_ipv4_reass_param_t *param);
+
+/**
+ * Create reassembly context
+ *
+ * @param name   Name of the context. Used also for the timeout pool.
+ * @param param  Reassembly parameters
+ *
+ * @return Reassembly context handle
+ * @retval ODPH_IPV4_REASS_INVALID on failure
+ */
+odph_ipv4_reass_t odph_ipv4_reass_create(const char *name,
+					 const odph_ipv4_reass_param_t *param);
+
+/**
+ * Destroy reassembly context
+ *
+ * Frees all fragments under reassembly and the timers. All timeouts of the
+ * context must have been returned through odph_ipv4_reass_timeout() or freed.
+ *
+ * @param reass  Reassembly context
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_ipv4_reass_destroy(odph_ipv4_reass_t reass);
+
+/**
+ * Reassemble IPv4 packet
+ *
+ * Passes packets which are not IPv4 fragments through. Stores a fragment into
+ * the context, or outputs the reassembled datagram when the fragment completes
+ * it. Packet L3 offset must be set. The reassembled packet carries metadata
+ * and L2 header of the first fragment, and an IP header updated for the
+ * whole datagram.
+ *
+ * A duplicate of a stored fragment is dropped. A fragment which overlaps
+ * stored fragments is dropped together with the whole datagram.
+ *
+ * @param reass          Reassembly context
+ * @param[in, out] pkt   Pointer to packet handle. Outputs the complete
+ *                       datagram, or ODP_PACKET_INVALID when the packet was
+ *                       stored or dropped.
+ *
+ * @retval 1  '*pkt' is a complete datagram
+ * @retval 0  Fragment was stored
+ * @retval <0 Fragment was dropped
+ */
+int odph_ipv4_reass(odph_ipv4_reass_t reass, odp_packet_t *pkt);
+
+/**
+ * Process reassembly timeout
+ *
+ * Evicts the datagram of the timeout if it has not been completed within the
+ * reassembly timeout.
+ *
+ * @param reass  Reassembly context
+ * @param ev     Timeout event received from the timeout queue
+ *
+ * @retval 0 on success
+ * @retval <0 if the event does not belong to the context
+ */
+int odph_ipv4_reass_timeout(odph_ipv4_reass_t reass, odp_event_t ev);
+
+/**
+ * Read reassembly statistics
+ *
+ * @param reass       Reassembly context
+ * @param[out] stats  Statistics for output
+ */
+void odph_ipv4_reass_stats(odph_ipv4_reass_t reass,
+			   odph_ipv4_reass_stats_t *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
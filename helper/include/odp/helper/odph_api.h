@@ -24,6 +24,7 @@ extern "C" {
 #include <odp/helper/odph_hashtable.h>
 #include <odp/helper/icmp.h>
 #include <odp/helper/ip.h>
+#include <odp/helper/ipfrag.h>
 #include <odp/helper/ipsec.h>
 #include <odp/helper/odph_lineartable.h>
 #include <odp/helper/odph_iplookuptable.h>
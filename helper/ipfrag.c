@@ -0,0 +1,650 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_api.h>
+#include <odp/helper/chksum.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/ipfrag.h>
+#include "odph_debug.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#define IPV4HDR_MAX_LEN   60
+#define IPV4_MAX_LEN      0xffff
+#define IPV4_FRAG_RSVD    0x8000
+#define IPV4_FRAG_DF      0x4000
+#define IPV4_FRAG_MF      0x2000
+#define IPV4_FRAG_OFFSET  0x1fff
+
+#define IPV4_OPT_EOL      0
+#define IPV4_OPT_NOP      1
+#define IPV4_OPT_COPY     0x80
+
+/* Number of table entries searched for a flow */
+#define REASS_PROBE_LEN   4
+
+/* Copy options which are marked to be copied into all fragments. Output is
+ * padded to a multiple of four bytes. */
+static uint32_t ipv4_opts_copy(uint8_t *dst, const uint8_t *src, uint32_t len)
+{
+	uint32_t i = 0;
+	uint32_t n = 0;
+	uint32_t opt_len;
+
+	while (i < len) {
+		uint8_t type = src[i];
+
+		if (type == IPV4_OPT_EOL)
+			break;
+
+		if (type == IPV4_OPT_NOP) {
+			i++;
+			continue;
+		}
+
+		if (i + 1 >= len)
+			break;
+
+		opt_len = src[i + 1];
+
+		if (opt_len < 2 || i + opt_len > len)
+			break;
+
+		if (type & IPV4_OPT_COPY) {
+			memcpy(&dst[n], &src[i], opt_len);
+			n += opt_len;
+		}
+
+		i += opt_len;
+	}
+
+	while (n & 3)
+		dst[n++] = IPV4_OPT_EOL;
+
+	return n;
+}
+
+/* Update IP header length fields and checksum */
+static void ipv4_hdr_update(uint8_t *hdr, uint32_t ihl, uint32_t payload_len,
+			    uint16_t frag)
+{
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)hdr;
+
+	ip->ver_ihl     = (ODPH_IPV4 << 4) | (ihl / 4);
+	ip->tot_len     = odp_cpu_to_be_16(ihl + payload_len);
+	ip->frag_offset = odp_cpu_to_be_16(frag);
+	ip->chksum      = 0;
+	ip->chksum      = odph_chksum(hdr, ihl);
+}
+
+/* Read IPv4 header of a packet. Returns header length, or 0 when the packet
+ * is not IPv4. */
+static uint32_t ipv4_hdr_read(odp_packet_t pkt, uint32_t l3_off,
+			      odph_ipv4hdr_t *ip)
+{
+	uint32_t ihl, tot_len;
+
+	if (l3_off == ODP_PACKET_OFFSET_INVALID ||
+	    odp_packet_copy_to_mem(pkt, l3_off, sizeof(*ip), ip))
+		return 0;
+
+	if (ODPH_IPV4HDR_VER(ip->ver_ihl) != ODPH_IPV4)
+		return 0;
+
+	ihl     = ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4;
+	tot_len = odp_be_to_cpu_16(ip->tot_len);
+
+	if (ihl < ODPH_IPV4HDR_LEN || tot_len < ihl ||
+	    l3_off + tot_len > odp_packet_len(pkt))
+		return 0;
+
+	return ihl;
+}
+
+/* Remove data after the IP datagram */
+static int ipv4_trim(odp_packet_t *pkt, uint32_t l3_off, uint32_t tot_len)
+{
+	uint32_t pad = odp_packet_len(*pkt) - (l3_off + tot_len);
+
+	if (pad == 0)
+		return 0;
+
+	return odp_packet_trunc_tail(pkt, pad, NULL, NULL);
+}
+
+int odph_ipv4_fragment(odp_packet_t *pkt, uint32_t mtu, odp_packet_t frag[],
+		       int max_frags)
+{
+	odph_ipv4hdr_t ip;
+	uint32_t l3_off = odp_packet_l3_offset(*pkt);
+	uint32_t l2_off = odp_packet_l2_offset(*pkt);
+	uint32_t ihl, tot_len, payload_len, chunk, hdr_len, nf_ihl, offset;
+	uint16_t frag_field;
+	odp_packet_t cur;
+	int num, i, ret;
+
+	ihl = ipv4_hdr_read(*pkt, l3_off, &ip);
+
+	if (ihl == 0 || max_frags < 1)
+		return -1;
+
+	tot_len    = odp_be_to_cpu_16(ip.tot_len);
+	frag_field = odp_be_to_cpu_16(ip.frag_offset);
+
+	if (tot_len <= mtu) {
+		if (ipv4_trim(pkt, l3_off, tot_len) < 0)
+			return -1;
+
+		frag[0] = *pkt;
+		return 1;
+	}
+
+	if ((frag_field & IPV4_FRAG_DF) || mtu < ihl + 8)
+		return -1;
+
+	payload_len = tot_len - ihl;
+	chunk       = (mtu - ihl) & ~7;
+	num         = (payload_len + chunk - 1) / chunk;
+
+	if (num > max_frags)
+		return -1;
+
+	hdr_len = l3_off + ihl;
+
+	uint8_t hdr[hdr_len];
+	uint8_t nf_hdr[hdr_len];
+
+	if (odp_packet_copy_to_mem(*pkt, 0, hdr_len, hdr) ||
+	    ipv4_trim(pkt, l3_off, tot_len) < 0)
+		return -1;
+
+	/* Other fragments have only options marked to be copied */
+	memcpy(nf_hdr, hdr, l3_off + ODPH_IPV4HDR_LEN);
+	nf_ihl = ODPH_IPV4HDR_LEN +
+		 ipv4_opts_copy(&nf_hdr[l3_off + ODPH_IPV4HDR_LEN],
+				&hdr[l3_off + ODPH_IPV4HDR_LEN],
+				ihl - ODPH_IPV4HDR_LEN);
+
+	/* Split payload into fragments */
+	cur = *pkt;
+	ret = 0;
+
+	for (i = 1; i < num && ret >= 0; i++) {
+		uint32_t len = i == 1 ? hdr_len + chunk : chunk;
+
+		ret = odp_packet_split(&cur, len, &frag[i]);
+		frag[i - 1] = cur;
+		cur = frag[i];
+	}
+
+	if (ret < 0) {
+		odp_packet_free_multi(frag, i - 1);
+		*pkt = ODP_PACKET_INVALID;
+		return -1;
+	}
+
+	/* Headers of other fragments */
+	for (i = 1; i < num; i++) {
+		if (odp_packet_extend_head(&frag[i], l3_off + nf_ihl,
+					   NULL, NULL) < 0)
+			break;
+
+		odp_packet_copy_from_mem(frag[i], 0, l3_off + nf_ihl, nf_hdr);
+		odp_packet_l2_offset_set(frag[i], l2_off);
+		odp_packet_l3_offset_set(frag[i], l3_off);
+	}
+
+	if (i < num) {
+		odp_packet_free_multi(frag, num);
+		*pkt = ODP_PACKET_INVALID;
+		return -1;
+	}
+
+	/* Lengths, offsets and checksums. A fragment of a fragment keeps the
+	 * original offset and MF flag in the last fragment. */
+	offset = (frag_field & IPV4_FRAG_OFFSET) * 8;
+
+	for (i = 0; i < num; i++) {
+		uint32_t frag_ihl = i ? nf_ihl : ihl;
+		uint8_t *ip_hdr   = i ? &nf_hdr[l3_off] : &hdr[l3_off];
+		uint32_t len      = odp_packet_len(frag[i]) - l3_off - frag_ihl;
+		uint16_t flags;
+
+		flags = frag_field & (IPV4_FRAG_RSVD | IPV4_FRAG_MF);
+		if (i < num - 1)
+			flags |= IPV4_FRAG_MF;
+
+		ipv4_hdr_update(ip_hdr, frag_ihl, len, flags | (offset / 8));
+		odp_packet_copy_from_mem(frag[i], l3_off, frag_ihl, ip_hdr);
+		offset += len;
+	}
+
+	*pkt = frag[0];
+	return num;
+}
+
+typedef struct ODP_PACKED {
+	odp_u32be_t src_addr;
+	odp_u32be_t dst_addr;
+	odp_u16be_t id;
+	uint8_t     proto;
+	uint8_t     pad;
+} reass_key_t;
+
+typedef struct {
+	odp_packet_t pkt;
+	uint32_t     offset;
+	uint32_t     len;
+} reass_frag_t;
+
+typedef struct {
+	reass_key_t   key;
+	int           active;
+	uint32_t      num_frags;
+	/* Payload length, zero until the last fragment has been received */
+	uint32_t      total_len;
+	uint32_t      recv_len;
+	uint64_t      deadline;
+	odp_timer_t   timer;
+	/* Timeout event when it is not in the timer */
+	odp_event_t   tmo;
+	reass_frag_t *frag;
+} reass_flow_t;
+
+struct odph_ipv4_reass_s {
+	odph_ipv4_reass_param_t param;
+	odph_ipv4_reass_stats_t stats;
+	uint32_t      num_slots;
+	uint64_t      timeout_tick;
+	odp_shm_t     shm;
+	odp_pool_t    tmo_pool;
+	reass_flow_t *flow;
+};
+
+void odph_ipv4_reass_param_init(odph_ipv4_reass_param_t *param)
+{
+	memset(param, 0, sizeof(odph_ipv4_reass_param_t));
+	param->num_flows  = 1024;
+	param->max_frags  = 16;
+	param->timeout_ns = ODP_TIME_SEC_IN_NS;
+	param->timer_pool = ODP_TIMER_POOL_INVALID;
+	param->tmo_queue  = ODP_QUEUE_INVALID;
+}
+
+odph_ipv4_reass_t odph_ipv4_reass_create(const char *name,
+					 const odph_ipv4_reass_param_t *param)
+{
+	struct odph_ipv4_reass_s *reass;
+	odp_pool_param_t pool_param;
+	reass_frag_t *frag;
+	odp_shm_t shm;
+	uint32_t num_slots, i;
+	uint64_t size;
+
+	if (param->num_flows == 0 || param->max_frags == 0 ||
+	    param->max_frags > ODPH_IPV4_REASS_MAX_FRAGS ||
+	    param->timer_pool == ODP_TIMER_POOL_INVALID ||
+	    param->tmo_queue == ODP_QUEUE_INVALID) {
+		ODPH_ERR("Bad reassembly parameters\n");
+		return ODPH_IPV4_REASS_INVALID;
+	}
+
+	num_slots = 1;
+	while (num_slots < param->num_flows)
+		num_slots <<= 1;
+
+	size = sizeof(struct odph_ipv4_reass_s) +
+	       num_slots * sizeof(reass_flow_t) +
+	       (uint64_t)num_slots * param->max_frags * sizeof(reass_frag_t);
+
+	shm = odp_shm_reserve(name, size, ODP_CACHE_LINE_SIZE, 0);
+
+	if (shm == ODP_SHM_INVALID) {
+		ODPH_ERR("Reserving %" PRIu64 " bytes failed\n", size);
+		return ODPH_IPV4_REASS_INVALID;
+	}
+
+	reass = odp_shm_addr(shm);
+	memset(reass, 0, size);
+	reass->param        = *param;
+	reass->num_slots    = num_slots;
+	reass->shm          = shm;
+	reass->flow         = (reass_flow_t *)(void *)(reass + 1);
+	reass->timeout_tick = odp_timer_ns_to_tick(param->timer_pool,
+						   param->timeout_ns);
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type    = ODP_POOL_TIMEOUT;
+	pool_param.tmo.num = num_slots;
+
+	reass->tmo_pool = odp_pool_create(name, &pool_param);
+
+	if (reass->tmo_pool == ODP_POOL_INVALID) {
+		ODPH_ERR("Timeout pool create failed\n");
+		odp_shm_free(shm);
+		return ODPH_IPV4_REASS_INVALID;
+	}
+
+	frag = (reass_frag_t *)(void *)&reass->flow[num_slots];
+
+	for (i = 0; i < num_slots; i++) {
+		reass_flow_t *flow = &reass->flow[i];
+		odp_timeout_t tmo;
+
+		/* Destroy on failure checks these from the failed slot */
+		flow->frag  = &frag[i * param->max_frags];
+		flow->tmo   = ODP_EVENT_INVALID;
+		flow->timer = odp_timer_alloc(param->timer_pool,
+					      param->tmo_queue, flow);
+		tmo = odp_timeout_alloc(reass->tmo_pool);
+
+		if (flow->timer == ODP_TIMER_INVALID ||
+		    tmo == ODP_TIMEOUT_INVALID) {
+			ODPH_ERR("Timer alloc failed\n");
+			if (tmo != ODP_TIMEOUT_INVALID)
+				odp_timeout_free(tmo);
+			break;
+		}
+
+		flow->tmo = odp_timeout_to_event(tmo);
+	}
+
+	if (i < num_slots) {
+		reass->num_slots = i + 1;
+		odph_ipv4_reass_destroy(reass);
+		return ODPH_IPV4_REASS_INVALID;
+	}
+
+	return reass;
+}
+
+static void flow_timer_set(reass_flow_t *flow)
+{
+	/* When the previous timeout is still on its way, the timer is set
+	 * when it is received */
+	if (flow->tmo == ODP_EVENT_INVALID)
+		return;
+
+	/* On failure the flow is evicted when its table entry is needed */
+	(void)odp_timer_set_abs(flow->timer, flow->deadline, &flow->tmo);
+}
+
+static void flow_release(reass_flow_t *flow)
+{
+	odp_event_t ev;
+
+	flow->active = 0;
+
+	if (flow->tmo == ODP_EVENT_INVALID &&
+	    odp_timer_cancel(flow->timer, &ev) == 0)
+		flow->tmo = ev;
+}
+
+static void flow_evict(reass_flow_t *flow)
+{
+	uint32_t i;
+
+	for (i = 0; i < flow->num_frags; i++)
+		odp_packet_free(flow->frag[i].pkt);
+
+	flow_release(flow);
+}
+
+int odph_ipv4_reass_destroy(odph_ipv4_reass_t reass)
+{
+	uint32_t i;
+	int ret = 0;
+
+	for (i = 0; i < reass->num_slots; i++) {
+		reass_flow_t *flow = &reass->flow[i];
+		odp_event_t ev;
+
+		if (flow->active)
+			flow_evict(flow);
+
+		if (flow->timer != ODP_TIMER_INVALID) {
+			ev = odp_timer_free(flow->timer);
+
+			if (ev != ODP_EVENT_INVALID)
+				odp_event_free(ev);
+		}
+
+		if (flow->tmo != ODP_EVENT_INVALID)
+			odp_event_free(flow->tmo);
+	}
+
+	if (odp_pool_destroy(reass->tmo_pool))
+		ret = -1;
+
+	if (odp_shm_free(reass->shm))
+		ret = -1;
+
+	return ret;
+}
+
+static reass_flow_t *flow_lookup(odph_ipv4_reass_t reass,
+				 const reass_key_t *key)
+{
+	reass_flow_t *flow, *free_flow = NULL, *old_flow = NULL;
+	uint64_t now = odp_timer_current_tick(reass->param.timer_pool);
+	uint32_t mask = reass->num_slots - 1;
+	uint32_t idx = odp_hash_crc32c(key, sizeof(reass_key_t), 0);
+	int i;
+
+	for (i = 0; i < REASS_PROBE_LEN; i++) {
+		flow = &reass->flow[(idx + i) & mask];
+
+		if (!flow->active) {
+			if (free_flow == NULL)
+				free_flow = flow;
+			continue;
+		}
+
+		if (memcmp(&flow->key, key, sizeof(reass_key_t)) == 0)
+			return flow;
+
+		if (old_flow == NULL && now >= flow->deadline)
+			old_flow = flow;
+	}
+
+	if (free_flow == NULL) {
+		if (old_flow == NULL)
+			return NULL;
+
+		flow_evict(old_flow);
+		reass->stats.timeouts++;
+		free_flow = old_flow;
+	}
+
+	flow = free_flow;
+	flow->key       = *key;
+	flow->active    = 1;
+	flow->num_frags = 0;
+	flow->total_len = 0;
+	flow->recv_len  = 0;
+	flow->deadline  = now + reass->timeout_tick;
+	flow_timer_set(flow);
+
+	return flow;
+}
+
+/* Join fragments and update the IP header. Fragments are in offset order and
+ * the first one holds L2 and IP headers. */
+static odp_packet_t flow_assemble(reass_flow_t *flow)
+{
+	odp_packet_t pkt = flow->frag[0].pkt;
+	uint32_t l3_off = odp_packet_l3_offset(pkt);
+	uint8_t hdr[IPV4HDR_MAX_LEN];
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(void *)hdr;
+	uint32_t i, ihl;
+	uint16_t frag;
+
+	for (i = 1; i < flow->num_frags; i++) {
+		if (odp_packet_concat(&pkt, flow->frag[i].pkt) < 0) {
+			/* Leave remaining packets to be freed */
+			flow->frag[0].pkt = pkt;
+			memmove(&flow->frag[1], &flow->frag[i],
+				(flow->num_frags - i) * sizeof(reass_frag_t));
+			flow->num_frags -= i - 1;
+			return ODP_PACKET_INVALID;
+		}
+	}
+
+	flow->num_frags = 0;
+
+	odp_packet_copy_to_mem(pkt, l3_off, ODPH_IPV4HDR_LEN, hdr);
+	ihl = ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4;
+	odp_packet_copy_to_mem(pkt, l3_off, ihl, hdr);
+
+	frag = odp_be_to_cpu_16(ip->frag_offset) &
+	       (IPV4_FRAG_RSVD | IPV4_FRAG_DF);
+	ipv4_hdr_update(hdr, ihl, flow->total_len, frag);
+	odp_packet_copy_from_mem(pkt, l3_off, ihl, hdr);
+
+	return pkt;
+}
+
+int odph_ipv4_reass(odph_ipv4_reass_t reass, odp_packet_t *pkt)
+{
+	odph_ipv4hdr_t ip;
+	reass_key_t key;
+	reass_flow_t *flow;
+	reass_frag_t *frag;
+	uint32_t l3_off = odp_packet_l3_offset(*pkt);
+	uint32_t ihl, offset, len, i;
+	uint16_t frag_field;
+	int last;
+
+	ihl = ipv4_hdr_read(*pkt, l3_off, &ip);
+
+	if (ihl == 0)
+		return 1;
+
+	frag_field = odp_be_to_cpu_16(ip.frag_offset);
+
+	if (!ODPH_IPV4HDR_IS_FRAGMENT(frag_field))
+		return 1;
+
+	reass->stats.frags++;
+
+	offset = (frag_field & IPV4_FRAG_OFFSET) * 8;
+	len    = odp_be_to_cpu_16(ip.tot_len) - ihl;
+	last   = !(frag_field & IPV4_FRAG_MF);
+
+	/* Payload of other than the last fragment is a multiple of 8 bytes */
+	if (len == 0 || (!last && (len & 7)) ||
+	    ihl + offset + len > IPV4_MAX_LEN ||
+	    ipv4_trim(pkt, l3_off, ihl + len) < 0)
+		goto drop;
+
+	memset(&key, 0, sizeof(key));
+	key.src_addr = ip.src_addr;
+	key.dst_addr = ip.dst_addr;
+	key.id       = ip.id;
+	key.proto    = ip.proto;
+
+	flow = flow_lookup(reass, &key);
+
+	if (flow == NULL)
+		goto drop;
+
+	frag = flow->frag;
+
+	/* Find the position in offset order and check overlaps */
+	for (i = 0; i < flow->num_frags; i++)
+		if (frag[i].offset >= offset)
+			break;
+
+	if (i < flow->num_frags && frag[i].offset == offset &&
+	    frag[i].len == len)
+		goto drop; /* Duplicate */
+
+	if ((i > 0 && frag[i - 1].offset + frag[i - 1].len > offset) ||
+	    (i < flow->num_frags && offset + len > frag[i].offset) ||
+	    (last && flow->total_len) ||
+	    (flow->total_len && offset + len > flow->total_len) ||
+	    (last && flow->num_frags &&
+	     frag[flow->num_frags - 1].offset +
+	     frag[flow->num_frags - 1].len > offset + len) ||
+	    flow->num_frags == reass->param.max_frags)
+		goto evict;
+
+	/* Only the first fragment keeps headers */
+	if (offset && odp_packet_trunc_head(pkt, l3_off + ihl, NULL, NULL) < 0)
+		goto evict;
+
+	memmove(&frag[i + 1], &frag[i],
+		(flow->num_frags - i) * sizeof(reass_frag_t));
+	frag[i].pkt    = *pkt;
+	frag[i].offset = offset;
+	frag[i].len    = len;
+	flow->num_frags++;
+	flow->recv_len += len;
+	*pkt = ODP_PACKET_INVALID;
+
+	if (last)
+		flow->total_len = offset + len;
+
+	if (flow->total_len == 0 || flow->recv_len != flow->total_len)
+		return 0;
+
+	*pkt = flow_assemble(flow);
+
+	if (*pkt == ODP_PACKET_INVALID) {
+		reass->stats.drops++;
+		flow_evict(flow);
+		return -1;
+	}
+
+	flow_release(flow);
+	reass->stats.complete++;
+	return 1;
+
+evict:
+	flow_evict(flow);
+drop:
+	reass->stats.drops++;
+	odp_packet_free(*pkt);
+	*pkt = ODP_PACKET_INVALID;
+	return -1;
+}
+
+int odph_ipv4_reass_timeout(odph_ipv4_reass_t reass, odp_event_t ev)
+{
+	reass_flow_t *flow;
+	odp_timeout_t tmo;
+
+	if (odp_event_type(ev) != ODP_EVENT_TIMEOUT)
+		return -1;
+
+	tmo  = odp_timeout_from_event(ev);
+	flow = odp_timeout_user_ptr(tmo);
+
+	if (flow < reass->flow || flow >= &reass->flow[reass->num_slots])
+		return -1;
+
+	flow->tmo = ev;
+
+	if (!flow->active)
+		return 0;
+
+	if (odp_timer_current_tick(reass->param.timer_pool) >= flow->deadline) {
+		flow_evict(flow);
+		reass->stats.timeouts++;
+	} else {
+		/* Timeout of an earlier datagram of the entry */
+		flow_timer_set(flow);
+	}
+
+	return 0;
+}
+
+void odph_ipv4_reass_stats(odph_ipv4_reass_t reass,
+			   odph_ipv4_reass_stats_t *stats)
+{
+	*stats = reass->stats;
+}
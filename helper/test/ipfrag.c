@@ -0,0 +1,367 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include "odph_debug.h"
+#include <odp_api.h>
+#include <odp/helper/odph_api.h>
+
+#define PAYLOAD_LEN  4000
+#define IP_LEN       (ODPH_IPV4HDR_LEN + ODPH_UDPHDR_LEN + PAYLOAD_LEN)
+#define PKT_LEN      (ODPH_ETHHDR_LEN + IP_LEN)
+#define MTU          1500
+#define MAX_FRAGS    8
+
+static uint8_t ref_data[PKT_LEN];
+
+static odp_packet_t create_packet(odp_pool_t pool, uint16_t id, uint16_t frag)
+{
+	odp_packet_t pkt;
+	odph_ethhdr_t *eth;
+	odph_ipv4hdr_t *ip;
+	odph_udphdr_t *udp;
+	uint8_t *buf = ref_data;
+	int i;
+
+	memset(buf, 0, PKT_LEN);
+	eth = (odph_ethhdr_t *)(void *)buf;
+	eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4);
+
+	ip = (odph_ipv4hdr_t *)(void *)&buf[ODPH_ETHHDR_LEN];
+	ip->ver_ihl     = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip->tot_len     = odp_cpu_to_be_16(IP_LEN);
+	ip->id          = odp_cpu_to_be_16(id);
+	ip->frag_offset = odp_cpu_to_be_16(frag);
+	ip->ttl         = 64;
+	ip->proto       = ODPH_IPPROTO_UDP;
+	ip->src_addr    = odp_cpu_to_be_32(0x0a000001);
+	ip->dst_addr    = odp_cpu_to_be_32(0x0a000002);
+	ip->chksum      = odph_chksum(ip, ODPH_IPV4HDR_LEN);
+
+	udp = (odph_udphdr_t *)(void *)&buf[ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN];
+	udp->length = odp_cpu_to_be_16(ODPH_UDPHDR_LEN + PAYLOAD_LEN);
+
+	for (i = ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN + ODPH_UDPHDR_LEN;
+	     i < PKT_LEN; i++)
+		buf[i] = i;
+
+	pkt = odp_packet_alloc(pool, PKT_LEN);
+	if (pkt == ODP_PACKET_INVALID)
+		return pkt;
+
+	odp_packet_copy_from_mem(pkt, 0, PKT_LEN, buf);
+	odp_packet_l2_offset_set(pkt, 0);
+	odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+
+	return pkt;
+}
+
+static int check_frags(odp_packet_t frag[], int num)
+{
+	odph_ipv4hdr_t ip;
+	uint32_t offset = 0;
+	uint16_t frag_field;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		uint32_t l3_off = odp_packet_l3_offset(frag[i]);
+		uint32_t tot_len;
+		int more;
+
+		odp_packet_copy_to_mem(frag[i], l3_off, sizeof(ip), &ip);
+		tot_len    = odp_be_to_cpu_16(ip.tot_len);
+		frag_field = odp_be_to_cpu_16(ip.frag_offset);
+		more       = ODPH_IPV4HDR_FLAGS_MORE_FRAGS(frag_field) != 0;
+
+		if (l3_off != ODPH_ETHHDR_LEN || tot_len > MTU ||
+		    odp_packet_len(frag[i]) != l3_off + tot_len ||
+		    !odph_ipv4_csum_valid(frag[i]) ||
+		    ODPH_IPV4HDR_FRAG_OFFSET(frag_field) * 8 != offset ||
+		    more != (i < num - 1))
+			return -1;
+
+		offset += tot_len - ODPH_IPV4HDR_LEN;
+	}
+
+	return offset == IP_LEN - ODPH_IPV4HDR_LEN ? 0 : -1;
+}
+
+/* Copy a fragment and move its fragment offset by 'diff' 8 byte units */
+static odp_packet_t copy_frag(odp_packet_t frag, int diff)
+{
+	odph_ipv4hdr_t *ip;
+	odp_packet_t pkt;
+	uint16_t frag_field;
+
+	pkt = odp_packet_copy(frag, odp_packet_pool(frag));
+	if (pkt == ODP_PACKET_INVALID)
+		return pkt;
+
+	ip = odp_packet_l3_ptr(pkt, NULL);
+	frag_field = odp_be_to_cpu_16(ip->frag_offset);
+	ip->frag_offset = odp_cpu_to_be_16(frag_field + diff);
+	odph_ipv4_csum_update(pkt);
+
+	return pkt;
+}
+
+static int check_packet(odp_packet_t pkt)
+{
+	uint8_t buf[PKT_LEN];
+
+	if (odp_packet_len(pkt) != PKT_LEN ||
+	    odp_packet_l3_offset(pkt) != ODPH_ETHHDR_LEN ||
+	    odp_packet_copy_to_mem(pkt, 0, PKT_LEN, buf))
+		return -1;
+
+	return memcmp(buf, ref_data, PKT_LEN) ? -1 : 0;
+}
+
+int main(int argc ODPH_UNUSED, char *argv[] ODPH_UNUSED)
+{
+	odp_instance_t instance;
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	odp_pool_capability_t capa;
+	odp_timer_pool_param_t tparams;
+	odp_timer_pool_t tp;
+	odp_queue_t queue;
+	odph_ipv4_reass_param_t rparams;
+	odph_ipv4_reass_t reass;
+	odph_ipv4_reass_stats_t stats;
+	odp_packet_t pkt, dup, frag[MAX_FRAGS];
+	odp_event_t ev;
+	odp_time_t end;
+	int num, ret;
+
+	if (odp_init_global(&instance, NULL, NULL)) {
+		ODPH_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(instance, ODP_THREAD_WORKER)) {
+		ODPH_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_pool_capability(&capa) < 0) {
+		ODPH_ERR("Error: pool capability failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Small segments to fragment and reassemble segmented packets */
+	odp_pool_param_init(&params);
+	params.type        = ODP_POOL_PACKET;
+	params.pkt.seg_len = capa.pkt.min_seg_len;
+	params.pkt.len     = PKT_LEN;
+	params.pkt.num     = 64;
+
+	pool = odp_pool_create("packet_pool", &params);
+	if (pool == ODP_POOL_INVALID) {
+		ODPH_ERR("Error: packet pool create failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_timer_pool_param_init(&tparams);
+	tparams.res_ns     = 10 * ODP_TIME_MSEC_IN_NS;
+	tparams.min_tmo    = 10 * ODP_TIME_MSEC_IN_NS;
+	tparams.max_tmo    = 10 * ODP_TIME_SEC_IN_NS;
+	tparams.num_timers = 64;
+	tparams.priv       = 0;
+	tparams.clk_src    = ODP_CLOCK_CPU;
+
+	tp = odp_timer_pool_create("ipfrag_timers", &tparams);
+	if (tp == ODP_TIMER_POOL_INVALID) {
+		ODPH_ERR("Error: timer pool create failed.\n");
+		exit(EXIT_FAILURE);
+	}
+	odp_timer_pool_start();
+
+	queue = odp_queue_create("ipfrag_tmo", NULL);
+	if (queue == ODP_QUEUE_INVALID) {
+		ODPH_ERR("Error: queue create failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odph_ipv4_reass_param_init(&rparams);
+	rparams.num_flows  = 16;
+	rparams.timeout_ns = 50 * ODP_TIME_MSEC_IN_NS;
+	rparams.timer_pool = tp;
+	rparams.tmo_queue  = queue;
+
+	reass = odph_ipv4_reass_create("ipfrag_reass", &rparams);
+	if (reass == ODPH_IPV4_REASS_INVALID) {
+		ODPH_ERR("Error: reassembly create failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Fragment and reassemble out of order */
+	pkt = create_packet(pool, 1, 0);
+	num = odph_ipv4_fragment(&pkt, MTU, frag, MAX_FRAGS);
+	if (num != 3 || check_frags(frag, num)) {
+		ODPH_ERR("Error: fragmentation failed (%i).\n", num);
+		exit(EXIT_FAILURE);
+	}
+
+	pkt = frag[2];
+	ret = odph_ipv4_reass(reass, &pkt);
+	pkt = frag[0];
+	ret |= odph_ipv4_reass(reass, &pkt);
+	if (ret != 0 || pkt != ODP_PACKET_INVALID) {
+		ODPH_ERR("Error: fragment not stored.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pkt = frag[1];
+	if (odph_ipv4_reass(reass, &pkt) != 1 || check_packet(pkt) ||
+	    !odph_ipv4_csum_valid(pkt)) {
+		ODPH_ERR("Error: reassembly failed.\n");
+		exit(EXIT_FAILURE);
+	}
+	odp_packet_free(pkt);
+
+	/* Don't fragment */
+	pkt = create_packet(pool, 2, 0x4000);
+	if (odph_ipv4_fragment(&pkt, MTU, frag, MAX_FRAGS) >= 0 ||
+	    check_packet(pkt)) {
+		ODPH_ERR("Error: DF packet fragmented.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Not a fragment */
+	if (odph_ipv4_reass(reass, &pkt) != 1 || check_packet(pkt)) {
+		ODPH_ERR("Error: packet not passed through.\n");
+		exit(EXIT_FAILURE);
+	}
+	odp_packet_free(pkt);
+
+	/* Duplicate fragment is dropped, the datagram is still reassembled */
+	pkt = create_packet(pool, 4, 0);
+	num = odph_ipv4_fragment(&pkt, MTU, frag, MAX_FRAGS);
+	if (num != 3) {
+		ODPH_ERR("Error: fragmentation failed (%i).\n", num);
+		exit(EXIT_FAILURE);
+	}
+
+	dup = copy_frag(frag[1], 0);
+	if (dup == ODP_PACKET_INVALID) {
+		ODPH_ERR("Error: fragment copy failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pkt = frag[1];
+	ret = odph_ipv4_reass(reass, &pkt);
+	pkt = dup;
+	if (ret != 0 || odph_ipv4_reass(reass, &pkt) >= 0 ||
+	    pkt != ODP_PACKET_INVALID) {
+		ODPH_ERR("Error: duplicate fragment not dropped.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pkt = frag[0];
+	ret = odph_ipv4_reass(reass, &pkt);
+	pkt = frag[2];
+	if (ret != 0 || odph_ipv4_reass(reass, &pkt) != 1 ||
+	    check_packet(pkt) || !odph_ipv4_csum_valid(pkt)) {
+		ODPH_ERR("Error: reassembly with duplicate failed.\n");
+		exit(EXIT_FAILURE);
+	}
+	odp_packet_free(pkt);
+
+	/* Overlapping fragment drops the datagram. Remaining fragments start
+	 * a new one, which is incomplete and evicted by timeout below. */
+	pkt = create_packet(pool, 5, 0);
+	num = odph_ipv4_fragment(&pkt, MTU, frag, MAX_FRAGS);
+	if (num != 3) {
+		ODPH_ERR("Error: fragmentation failed (%i).\n", num);
+		exit(EXIT_FAILURE);
+	}
+
+	dup = copy_frag(frag[1], -1);
+	if (dup == ODP_PACKET_INVALID) {
+		ODPH_ERR("Error: fragment copy failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pkt = frag[0];
+	ret = odph_ipv4_reass(reass, &pkt);
+	pkt = dup;
+	if (ret != 0 || odph_ipv4_reass(reass, &pkt) >= 0 ||
+	    pkt != ODP_PACKET_INVALID) {
+		ODPH_ERR("Error: overlapping fragment not dropped.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	pkt = frag[1];
+	ret = odph_ipv4_reass(reass, &pkt);
+	pkt = frag[2];
+	ret |= odph_ipv4_reass(reass, &pkt);
+	if (ret != 0) {
+		ODPH_ERR("Error: datagram with overlap not dropped.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Incomplete datagram is evicted by timeout */
+	pkt = create_packet(pool, 3, 0);
+	num = odph_ipv4_fragment(&pkt, MTU, frag, MAX_FRAGS);
+	if (num != 3) {
+		ODPH_ERR("Error: fragmentation failed (%i).\n", num);
+		exit(EXIT_FAILURE);
+	}
+
+	odp_packet_free(frag[1]);
+	pkt = frag[0];
+	ret = odph_ipv4_reass(reass, &pkt);
+	pkt = frag[2];
+	ret |= odph_ipv4_reass(reass, &pkt);
+	if (ret != 0) {
+		ODPH_ERR("Error: fragment not stored.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(ODP_TIME_SEC_IN_NS));
+	do {
+		ev = odp_queue_deq(queue);
+		if (ev != ODP_EVENT_INVALID &&
+		    odph_ipv4_reass_timeout(reass, ev)) {
+			ODPH_ERR("Error: bad timeout.\n");
+			exit(EXIT_FAILURE);
+		}
+		odph_ipv4_reass_stats(reass, &stats);
+	} while (stats.timeouts < 2 &&
+		 odp_time_cmp(end, odp_time_local()) > 0);
+
+	if (stats.frags != 13 || stats.complete != 2 || stats.timeouts != 2 ||
+	    stats.drops != 2) {
+		ODPH_ERR("Error: bad statistics.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odph_ipv4_reass_destroy(reass)) {
+		ODPH_ERR("Error: reassembly destroy failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_queue_destroy(queue);
+	odp_timer_pool_destroy(tp);
+
+	if (odp_pool_destroy(pool)) {
+		ODPH_ERR("Error: packet pool destroy failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_local()) {
+		ODPH_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		ODPH_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
@@ -130,6 +130,17 @@ typedef struct odp_cls_capability_t {
 	odp_bool_t pmr_range_supported;
 } odp_cls_capability_t;
 
+/**
+ * Classification statistics counters
+ */
+typedef struct odp_cls_stats_t {
+	/** Number of packets */
+	uint64_t packets;
+
+	/** Number of octets in packets */
+	uint64_t octets;
+} odp_cls_stats_t;
+
 /**
  * class of service packet drop policies
  */
@@ -467,6 +478,37 @@ int odp_cls_cos_pool_set(odp_cos_t cos_id, odp_pool_t pool_id);
 */
 odp_pool_t odp_cls_cos_pool(odp_cos_t cos_id);
 
+/**
+ * Read PMR statistics
+ *
+ * Outputs the number of packets and octets that matched the PMR since it was
+ * created. A packet is counted on a PMR when the PMR selected the next CoS for
+ * the packet. Counters of different threads are summed on read, so the
+ * values may not include packets that are being classified concurrently.
+ *
+ * @param	pmr_id	PMR handle
+ * @param[out]	stats	Pointer to statistics structure
+ *
+ * @retval	0 on success
+ * @retval	<0 on failure
+ */
+int odp_cls_pmr_stats(odp_pmr_t pmr_id, odp_cls_stats_t *stats);
+
+/**
+ * Read class of service statistics
+ *
+ * Outputs the number of packets and octets that were classified to the class
+ * of service since it was created. This includes packets that selected the
+ * CoS as a default, error or QoS CoS of a pktio interface.
+ *
+ * @param	cos_id	class of service handle
+ * @param[out]	stats	Pointer to statistics structure
+ *
+ * @retval	0 on success
+ * @retval	<0 on failure
+ */
+int odp_cls_cos_stats(odp_cos_t cos_id, odp_cls_stats_t *stats);
+
 /**
  * Get printable value for an odp_cos_t
  *
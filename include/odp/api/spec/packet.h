@@ -51,6 +51,16 @@ extern "C" {
  * Invalid packet segment
  */
 
+/**
+ * @typedef odp_packet_vector_t
+ * ODP packet vector
+ */
+
+/**
+ * @def ODP_PACKET_VECTOR_INVALID
+ * Invalid packet vector
+ */
+
  /**
   * @typedef odp_packet_color_t
   * Color of packet for shaper/drop processing
@@ -1358,6 +1368,75 @@ uint32_t odp_packet_l4_offset(odp_packet_t pkt);
  */
 int odp_packet_l4_offset_set(odp_packet_t pkt, uint32_t offset);
 
+/**
+ * Protocol layer
+ */
+typedef enum odp_proto_layer_t {
+	/** No layers */
+	ODP_PROTO_LAYER_NONE = 0,
+
+	/** Layer L2 protocols (Ethernet, VLAN, etc) */
+	ODP_PROTO_LAYER_L2,
+
+	/** Layer L3 protocols (IPv4, IPv6, ICMP, IPsec, etc) */
+	ODP_PROTO_LAYER_L3,
+
+	/** Layer L4 protocols (UDP, TCP, SCTP) */
+	ODP_PROTO_LAYER_L4,
+
+	/** All layers */
+	ODP_PROTO_LAYER_ALL
+
+} odp_proto_layer_t;
+
+/**
+ * Packet parse parameters
+ */
+typedef struct odp_packet_parse_param_t {
+	/** Continue parsing until this layer. Must be the same or higher
+	 *  layer than the layer of the packet start. */
+	odp_proto_layer_t last_layer;
+
+} odp_packet_parse_param_t;
+
+/**
+ * Parse packet
+ *
+ * Parse protocol headers in packet data and update layer/protocol specific
+ * metadata (e.g. offsets, errors, protocols, etc). Parsing starts with an
+ * Ethernet header at the current odp_packet_data() position and continues
+ * until the layer specified in 'param.last_layer' is reached. Metadata of
+ * the other layers is reset, while other packet metadata (e.g. flow hash,
+ * timestamp and user pointer) is not modified.
+ *
+ * Errors found in the protocol headers are reported through packet error
+ * flags (e.g. odp_packet_has_error()), not through the return value.
+ *
+ * @param pkt     Packet handle
+ * @param param   Parse parameters
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_packet_parse(odp_packet_t pkt, const odp_packet_parse_param_t *param);
+
+/**
+ * Parse multiple packets
+ *
+ * Otherwise like odp_packet_parse(), but parses multiple packets. Packets
+ * are parsed in the order of the table. Implementation may overlap header
+ * parsing of a packet with memory accesses of the following packets.
+ *
+ * @param pkt     Packet handle table
+ * @param num     Number of packets and parse parameters
+ * @param param   Parse parameters. Same parameters are used for all packets.
+ *
+ * @return Number of packets parsed successfully (0 ... num)
+ * @retval <0 on failure
+ */
+int odp_packet_parse_multi(const odp_packet_t pkt[], int num,
+			   const odp_packet_parse_param_t *param);
+
 /**
  * Packet flow hash value
  *
@@ -1530,6 +1609,128 @@ uint64_t odp_packet_to_u64(odp_packet_t hdl);
  */
 uint64_t odp_packet_seg_to_u64(odp_packet_seg_t hdl);
 
+/*
+ *
+ * Packet vector
+ * ********************************************************
+ *
+ */
+
+/**
+ * Allocate a packet vector
+ *
+ * Allocates an empty packet vector from a pool of type ODP_POOL_VECTOR.
+ * A packet vector carries a burst of packet handles as a single event
+ * (ODP_EVENT_PACKET_VECTOR). The vector can hold at most 'max_size'
+ * packets, as specified in pool parameters.
+ *
+ * @param pool      Packet vector pool handle
+ *
+ * @return Handle of allocated packet vector
+ * @retval ODP_PACKET_VECTOR_INVALID  Packet vector could not be allocated
+ */
+odp_packet_vector_t odp_packet_vector_alloc(odp_pool_t pool);
+
+/**
+ * Free a packet vector
+ *
+ * Frees the vector into the pool it was allocated from. Packets stored in
+ * the vector are not freed. Use odp_event_free() on the vector event to free
+ * both the vector and the packets in it.
+ *
+ * @param pktv      Packet vector handle
+ */
+void odp_packet_vector_free(odp_packet_vector_t pktv);
+
+/**
+ * Get packet vector handle from event
+ *
+ * Converts an ODP_EVENT_PACKET_VECTOR type event to a packet vector.
+ *
+ * @param ev   Event handle
+ *
+ * @return Packet vector handle
+ *
+ * @see odp_event_type()
+ */
+odp_packet_vector_t odp_packet_vector_from_event(odp_event_t ev);
+
+/**
+ * Convert packet vector handle to event
+ *
+ * @param pktv  Packet vector handle
+ *
+ * @return Event handle
+ */
+odp_event_t odp_packet_vector_to_event(odp_packet_vector_t pktv);
+
+/**
+ * Packet vector table
+ *
+ * Outputs a pointer to the packet handle table of the vector. The table has
+ * room for the maximum number of packets of the vector pool. Application may
+ * read and write handles in the table, and must update the number of valid
+ * handles with odp_packet_vector_size_set() after writing.
+ *
+ * @param      pktv     Packet vector handle
+ * @param[out] pkt_tbl  Pointer to packet handle table for output
+ *
+ * @return Number of packets in the vector
+ */
+uint32_t odp_packet_vector_tbl(odp_packet_vector_t pktv,
+			       odp_packet_t **pkt_tbl);
+
+/**
+ * Number of packets in a vector
+ *
+ * @param pktv  Packet vector handle
+ *
+ * @return Number of packets in the vector
+ */
+uint32_t odp_packet_vector_size(odp_packet_vector_t pktv);
+
+/**
+ * Set the number of packets in a vector
+ *
+ * The size must not exceed the maximum vector size of the pool.
+ *
+ * @param pktv  Packet vector handle
+ * @param size  Number of packets in the vector
+ */
+void odp_packet_vector_size_set(odp_packet_vector_t pktv, uint32_t size);
+
+/**
+ * Packet vector pool
+ *
+ * @param pktv  Packet vector handle
+ *
+ * @return Handle of the pool the vector was allocated from
+ */
+odp_pool_t odp_packet_vector_pool(odp_packet_vector_t pktv);
+
+/**
+ * Check packet vector validity
+ *
+ * @param pktv  Packet vector handle
+ *
+ * @retval 0 Packet vector is not valid
+ * @retval 1 Packet vector is valid
+ */
+int odp_packet_vector_valid(odp_packet_vector_t pktv);
+
+/**
+ * Get printable value for an odp_packet_vector_t
+ *
+ * @param hdl  odp_packet_vector_t handle to be printed
+ * @return     uint64_t value that can be used to print/display this
+ *             handle
+ *
+ * @note This routine is intended to be used for diagnostic purposes
+ * to enable applications to generate a printable value that represents
+ * an odp_packet_vector_t handle.
+ */
+uint64_t odp_packet_vector_to_u64(odp_packet_vector_t hdl);
+
 /**
  * @}
  */
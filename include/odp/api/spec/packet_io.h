@@ -21,6 +21,7 @@ extern "C" {
 
 #include <odp/api/packet_io_stats.h>
 #include <odp/api/queue.h>
+#include <odp/api/thrmask.h>
 #include <odp/api/time.h>
 
 /** @defgroup odp_packet_io ODP PACKET IO
@@ -151,6 +152,69 @@ typedef enum odp_pktio_op_mode_t {
 
 } odp_pktio_op_mode_t;
 
+/**
+ * Packet input poll affinity
+ *
+ * In ODP_PKTIN_MODE_SCHED mode, the scheduler polls packet input queues on
+ * behalf of application threads. Poll affinity limits which threads are used
+ * for polling. It is a performance hint: an implementation may ignore it,
+ * and all input queues are polled regardless.
+ */
+typedef struct odp_pktin_poll_affinity_t {
+	/** Threads used for polling
+	  *
+	  * When no threads are set (default), any thread may be used. */
+	odp_thrmask_t thrmask;
+
+	/** Poll each input queue from a single thread
+	  *
+	  * * 0: Any thread (of 'thrmask') may poll any input queue (default)
+	  * * 1: Each input queue is preferably polled by a single thread (of
+	  *      'thrmask'). Implementation selects the thread and spreads
+	  *      input queues over threads. This avoids moving input queue
+	  *      state between CPUs. Affinity is best effort: an input queue
+	  *      may be polled also by other threads, e.g. when there are more
+	  *      input queues than the threads can own. Input queues of a
+	  *      thread are handed over to other threads when it pauses
+	  *      scheduling (odp_schedule_pause()) or terminates, so a thread
+	  *      should pause before it stops calling schedule functions. */
+	odp_bool_t per_thread;
+
+} odp_pktin_poll_affinity_t;
+
+/**
+ * Packet input vector configuration
+ *
+ * In ODP_PKTIN_MODE_SCHED and ODP_PKTIN_MODE_QUEUE modes, packets received
+ * in the same burst and destined to the same event queue may be delivered as
+ * a single packet vector event (ODP_EVENT_PACKET_VECTOR) instead of one
+ * packet event per packet. Packets may still be delivered as individual
+ * packet events, e.g. when a vector cannot be allocated. Packet vector events
+ * may also be enqueued into packet output event queues, which transmit the
+ * packets of the vector and free the vector.
+ */
+typedef struct odp_pktin_vector_config_t {
+	/** Enable packet vectors
+	  *
+	  * * 0: Packets are delivered as packet events (default)
+	  * * 1: Packets may be delivered as packet vector events. Supported
+	  *      only when pktio capability 'vector.supported' is set. */
+	odp_bool_t enable;
+
+	/** Packet vector pool
+	  *
+	  * Pool of type ODP_POOL_VECTOR used for vector allocation. */
+	odp_pool_t pool;
+
+	/** Maximum number of packets in a vector
+	  *
+	  * Must be between pktio capability 'vector.min_size' and
+	  * 'vector.max_size', and not larger than the 'max_size' of the vector
+	  * pool. Use 0 for the pool maximum. */
+	uint32_t max_size;
+
+} odp_pktin_vector_config_t;
+
 /**
  * Packet input queue parameters
  */
@@ -178,7 +242,9 @@ typedef struct odp_pktin_queue_param_t {
 	  * * 1: Enable flow hashing. Use flow hashing to spread incoming
 	  *      packets into input queues. Hashing can be enabled in all
 	  *      modes. Both classifier and hashing cannot be enabled
-	  *      simultaneously ('classifier_enable' must be 0). */
+	  *      simultaneously ('classifier_enable' must be 0). The hash
+	  *      value of a received packet is available through
+	  *      odp_packet_flow_hash(). */
 	odp_bool_t hash_enable;
 
 	/** Protocol field selection for hashing
@@ -206,6 +272,18 @@ typedef struct odp_pktin_queue_param_t {
 	  * value is ignored. */
 	odp_queue_param_t queue_param;
 
+	/** Poll affinity
+	  *
+	  * Used only in ODP_PKTIN_MODE_SCHED mode. Default values are defined
+	  * in odp_pktin_poll_affinity_t documentation. */
+	odp_pktin_poll_affinity_t poll_affinity;
+
+	/** Packet vector configuration
+	  *
+	  * Used only in ODP_PKTIN_MODE_SCHED and ODP_PKTIN_MODE_QUEUE modes.
+	  * Vectors are disabled by default. */
+	odp_pktin_vector_config_t vector;
+
 } odp_pktin_queue_param_t;
 
 /**
@@ -298,6 +376,15 @@ typedef union odp_pktin_config_opt_t {
 		/** Drop packets with a SCTP error on packet input */
 		uint64_t drop_sctp_err : 1;
 
+		/** Zero copy packet input
+		  *
+		  * Received packets may refer to packet input memory instead
+		  * of a copy in the pool. Input memory is returned to the
+		  * interface when the packet is freed, so holding packets
+		  * may reduce input buffer space. Packets stay valid after
+		  * the pktio has been closed. */
+		uint64_t zero_copy     : 1;
+
 	} bit;
 
 	/** All bits of the bit field structure
@@ -414,6 +501,20 @@ typedef struct odp_pktio_capability_t {
 	 * A boolean to denote whether loop back mode is supported on this
 	 * specific interface. */
 	odp_bool_t loop_supported;
+
+	/** Packet vector capabilities */
+	struct {
+		/** Packet input vectors are supported
+		 *
+		 * See odp_pktin_vector_config_t. */
+		odp_bool_t supported;
+
+		/** Minimum value of vector max_size */
+		uint32_t min_size;
+
+		/** Maximum value of vector max_size */
+		uint32_t max_size;
+	} vector;
 } odp_pktio_capability_t;
 
 /**
@@ -41,6 +41,11 @@ extern "C" {
  * Maximum pool name length in chars including null char
  */
 
+/**
+ * @def ODP_POOL_MAX_NODES
+ * Maximum number of NUMA nodes in pool information
+ */
+
 /**
  * Pool capabilities
  */
@@ -48,6 +53,16 @@ typedef struct odp_pool_capability_t {
 	/** Maximum number of pools of any type */
 	unsigned max_pools;
 
+	/** Number of NUMA nodes a NUMA aware pool is divided into
+	 *
+	 * The value of one means that NUMA aware pools are created as
+	 * normal pools. The maximum value is ODP_POOL_MAX_NODES. */
+	unsigned numa_nodes;
+
+	/** Maximum size of a thread local buffer cache (in number of
+	 *  buffers). See cache parameters of odp_pool_param_t. */
+	uint32_t max_cache_size;
+
 	/** Buffer pool capabilities  */
 	struct {
 		/** Maximum number of buffer pools */
@@ -97,6 +112,12 @@ typedef struct odp_pool_capability_t {
 		 * packet input and user allocated packets.*/
 		uint32_t min_headroom;
 
+		/** Maximum packet level headroom length in bytes
+		 *
+		 * The headroom (in odp_pool_param_t) must not be larger than
+		 * this. */
+		uint32_t max_headroom;
+
 		/** Minimum packet level tailroom length in bytes
 		 *
 		 * The minimum number of tailroom bytes that newly created
@@ -104,6 +125,12 @@ typedef struct odp_pool_capability_t {
 		 * packet input and user allocated packets.*/
 		uint32_t min_tailroom;
 
+		/** Maximum packet level tailroom length in bytes
+		 *
+		 * The tailroom (in odp_pool_param_t) must not be larger than
+		 * this. */
+		uint32_t max_tailroom;
+
 		/** Maximum number of segments per packet */
 		uint32_t max_segs_per_pkt;
 
@@ -141,6 +168,21 @@ typedef struct odp_pool_capability_t {
 		uint32_t max_num;
 	} tmo;
 
+	/** Packet vector pool capabilities */
+	struct {
+		/** Maximum number of packet vector pools */
+		unsigned max_pools;
+
+		/** Maximum number of packet vectors in a pool
+		 *
+		 * The value of zero means that limited only by the available
+		 * memory size for the pool. */
+		uint32_t max_num;
+
+		/** Maximum number of packet handles a vector can hold */
+		uint32_t max_size;
+	} vector;
+
 } odp_pool_capability_t;
 
 /**
@@ -206,6 +248,21 @@ typedef struct odp_pool_param_t {
 			    Use 0 for default. */
 			uint32_t seg_len;
 
+			/** Packet headroom in bytes. Newly allocated packets
+			    and packets received from packet input have this
+			    many headroom bytes. The maximum value is defined
+			    by pool capability pkt.max_headroom. Use 0 for
+			    default (pool capability pkt.min_headroom). */
+			uint32_t headroom;
+
+			/** Packet tailroom in bytes. Newly allocated packets
+			    and packets received from packet input have at
+			    least this many tailroom bytes. The maximum value
+			    is defined by pool capability pkt.max_tailroom.
+			    Use 0 for default (pool capability
+			    pkt.min_tailroom). */
+			uint32_t tailroom;
+
 			/** User area size in bytes. The maximum value is
 			    defined by pool capability pkt.max_uarea_size.
 			    Specify as 0 if no user area is needed. */
@@ -215,7 +272,54 @@ typedef struct odp_pool_param_t {
 			/** Number of timeouts in the pool */
 			uint32_t num;
 		} tmo;
+		struct {
+			/** Number of packet vectors in the pool */
+			uint32_t num;
+
+			/** Maximum number of packet handles stored in a
+			    vector. The maximum value is defined by pool
+			    capability vector.max_size. */
+			uint32_t max_size;
+		} vector;
 	};
+
+	/** NUMA aware pool
+	 *
+	 * When true, pool memory and buffers are divided evenly between NUMA
+	 * nodes (see pool capability numa_nodes). Threads allocate primarily
+	 * from the node of the CPU they run on, and from other nodes only
+	 * when buffers of the local node have run out. Freed buffers return
+	 * to their home node. The default value is false. */
+	odp_bool_t numa;
+
+	/** Thread local cache parameters
+	 *
+	 * Implementation may cache buffers per thread. Cache size is a
+	 * maximum, the number of buffers actually cached per thread may
+	 * adapt to the allocation pattern of the thread. Use 0 for
+	 * defaults. Values outside the allowed range are replaced by
+	 * defaults. odp_pool_info() reports the values in use. */
+	struct {
+		/** Maximum number of buffers cached per thread. The maximum
+		 *  value is defined by pool capability max_cache_size. */
+		uint32_t size;
+
+		/** Number of buffers moved from the pool into an empty cache
+		 *  on allocation. Must not be larger than cache size. */
+		uint32_t refill;
+
+		/** Number of buffers moved from a full cache back to the pool
+		 *  on free. Must not be larger than cache size. */
+		uint32_t flush;
+	} cache;
+
+	/** Pool memory flags
+	 *
+	 * Shared memory flags (ODP_SHM_HP_2M, ODP_SHM_HP_1G,
+	 * ODP_SHM_PREFAULT) applied to the memory reserved for the pool. Pool
+	 * creation fails if the memory cannot be reserved accordingly. Other
+	 * flags are not allowed. The default value is 0. */
+	uint32_t shm_flags;
 } odp_pool_param_t;
 
 /** Packet pool*/
@@ -224,6 +328,8 @@ typedef struct odp_pool_param_t {
 #define ODP_POOL_BUFFER       ODP_EVENT_BUFFER
 /** Timeout pool */
 #define ODP_POOL_TIMEOUT      ODP_EVENT_TIMEOUT
+/** Packet vector pool */
+#define ODP_POOL_VECTOR       ODP_EVENT_PACKET_VECTOR
 
 /**
  * Create a pool
@@ -274,6 +380,35 @@ odp_pool_t odp_pool_lookup(const char *name);
 typedef struct odp_pool_info_t {
 	const char *name;          /**< pool name */
 	odp_pool_param_t params;   /**< pool parameters */
+
+	/** Number of NUMA nodes the pool is divided into. The value is one
+	 *  for pools that are not NUMA aware. */
+	uint32_t num_nodes;
+
+	/** Per node occupancy */
+	struct {
+		/** Number of buffers of the node */
+		uint32_t num;
+
+		/** Number of free buffers of the node. Buffers cached by
+		 *  threads are counted as allocated. */
+		uint32_t num_free;
+	} node[ODP_POOL_MAX_NODES];
+
+	/** Thread local cache statistics, summed over all threads */
+	struct {
+		/** Allocation calls served from the cache */
+		uint64_t alloc_hit;
+
+		/** Allocation calls, which refilled the cache */
+		uint64_t alloc_miss;
+
+		/** Free calls served into the cache */
+		uint64_t free_hit;
+
+		/** Free calls, which flushed the cache */
+		uint64_t free_miss;
+	} cache;
 } odp_pool_info_t;
 
 /**
@@ -112,6 +112,11 @@ typedef struct odp_queue_capability_t {
 	/** Number of scheduling priorities */
 	unsigned sched_prios;
 
+	/** Maximum number of events a queue can store when created with
+	  * a non-zero size parameter. The value of zero means that sized
+	  * queues are not supported. */
+	uint32_t max_size;
+
 } odp_queue_capability_t;
 
 /**
@@ -165,6 +170,15 @@ typedef struct odp_queue_param_t {
 	  * The implementation may use this value as a hint for the number of
 	  * context data bytes to prefetch. Default value is zero (no hint). */
 	uint32_t context_len;
+
+	/** Queue size
+	  *
+	  * The queue must be able to store at minimum this many events. The
+	  * value must not exceed 'max_size' queue capability. When a queue is
+	  * full, enqueue operations fail (or enqueue only part of the events).
+	  * The default value of zero means that the implementation selects
+	  * the queue size. */
+	uint32_t size;
 } odp_queue_param_t;
 
 /**
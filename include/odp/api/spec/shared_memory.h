@@ -66,6 +66,33 @@ extern "C" {
  */
 #define ODP_SHM_EXPORT		0x08
 
+/**
+ * Require 2 MB huge pages
+ *
+ * When set, the memory block is backed by 2 MB huge pages. The reserve call
+ * fails if enough pages of this size are not available, instead of falling
+ * back to another page size. See shm capability hp_flags.
+ */
+#define ODP_SHM_HP_2M		0x10
+
+/**
+ * Require 1 GB huge pages
+ *
+ * When set, the memory block is backed by 1 GB huge pages. The reserve call
+ * fails if enough pages of this size are not available, instead of falling
+ * back to another page size. Cannot be combined with ODP_SHM_HP_2M.
+ */
+#define ODP_SHM_HP_1G		0x20
+
+/**
+ * Pre-fault and lock memory
+ *
+ * When set, all pages of the memory block are faulted in and locked into
+ * memory at reserve time, so that the first accesses to the block do not
+ * suffer page faults. The reserve call fails if the pages cannot be locked.
+ */
+#define ODP_SHM_PREFAULT	0x40
+
 /**
  * Shared memory block info
  */
@@ -99,6 +126,13 @@ typedef struct odp_shm_capability_t {
 	 * available memory size. */
 	uint64_t max_align;
 
+	/** Supported huge page flags
+	 *
+	 * Bit mask of ODP_SHM_HP_2M and ODP_SHM_HP_1G flags. A flag is set
+	 * when the system is configured for huge pages of that size. The
+	 * number of free huge pages is not checked. */
+	uint32_t hp_flags;
+
 } odp_shm_capability_t;
 
 /**
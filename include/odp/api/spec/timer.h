@@ -44,6 +44,29 @@ typedef enum {
 	/* Platform dependent which other clock sources exist */
 } odp_timer_clk_src_t;
 
+/**
+ * Timer pool drive modes
+ *
+ * Drive mode selects how the current tick of a timer pool is advanced and
+ * expired timers are processed. Modes other than ODP_TIMER_DRIVE_SIGNAL
+ * follow the CPU clock without OS timer signals, which allows shorter
+ * resolutions with less wakeup jitter.
+ */
+typedef enum {
+	/** An OS interval timer signals the implementation on every tick */
+	ODP_TIMER_DRIVE_SIGNAL = 0,
+
+	/** Threads calling the scheduler expire timers when they find no
+	 *  events to process. Timers expire only while some thread calls
+	 *  the scheduler. */
+	ODP_TIMER_DRIVE_INLINE,
+
+	/** A dedicated implementation thread busy polls the clock and expires
+	 *  timers. The thread runs on 'drive_cpu' and consumes that CPU
+	 *  fully. */
+	ODP_TIMER_DRIVE_POLL
+} odp_timer_drive_t;
+
 /**
  * @typedef odp_timer_t
  * ODP timer handle
@@ -105,8 +128,42 @@ typedef struct {
 	uint32_t num_timers; /**< (Minimum) number of supported timers */
 	int priv; /**< Shared (false) or private (true) timer pool */
 	odp_timer_clk_src_t clk_src; /**< Clock source for timers */
+
+	/** Drive mode. The default value is ODP_TIMER_DRIVE_SIGNAL. */
+	odp_timer_drive_t drive;
+
+	/** CPU of the timer thread in ODP_TIMER_DRIVE_POLL mode. The default
+	 *  value -1 leaves the thread to any CPU. */
+	int drive_cpu;
+
+	/** Maximum number of timeouts delivered per tick. Timers expiring
+	 *  beyond the limit are delivered on following ticks, which bounds
+	 *  the burst of timeouts when many timers expire on the same tick.
+	 *  When expiry of several ticks is processed at once (e.g. when the
+	 *  processing is late), the limit applies to all of those ticks
+	 *  together. The default value 0 means no limit. */
+	uint32_t max_tmo_per_tick;
+
+	/** Per thread timers. Each thread allocates timers from its own free
+	 *  list and expires the timers it has allocated in idle odp_schedule()
+	 *  calls, so that setting, cancelling and freeing own timers does not
+	 *  access state shared with other threads. Timers set or freed by other
+	 *  threads are passed to the owner thread. Threads must call
+	 *  odp_schedule() regularly while they own timers. Free timers held by
+	 *  one thread are not available to others. Requires
+	 *  ODP_TIMER_DRIVE_INLINE. The default value is false. */
+	odp_bool_t per_thread;
 } odp_timer_pool_param_t;
 
+/**
+ * Initialize timer pool parameters
+ *
+ * Initialize an odp_timer_pool_param_t to its default values for all fields.
+ *
+ * @param param   Address of the odp_timer_pool_param_t to be initialized
+ */
+void odp_timer_pool_param_init(odp_timer_pool_param_t *param);
+
 /**
  * Create a timer pool
  *
@@ -269,6 +269,11 @@ typedef struct {
 	 * have their fan_in only from tm_queues. */
 	uint8_t max_levels;
 
+	/** max_burst specifies the maximum number of packets this TM system
+	 * can process and transmit as one burst.  See max_burst in
+	 * odp_tm_requirements_t. */
+	uint32_t max_burst;
+
 	/** egress_fcn_supported indicates whether the tm system supports
 	* egress function. It is an optional feature used to receive the
 	* packet from the tm system and its performance might be limited.
@@ -404,6 +409,14 @@ typedef struct {
 	 * stages and does not include tm_queues or tm_egress objects. */
 	uint8_t num_levels;
 
+	/** max_burst specifies the maximum number of packets the TM system
+	 * may take in and transmit as one burst.  Larger bursts raise the
+	 * packet rate a TM system can shape, at the cost of adding up to a
+	 * burst worth of packets of delay jitter.  The value is limited to
+	 * the max_burst capability.  The default value of zero selects an
+	 * implementation specific burst size. */
+	uint32_t max_burst;
+
 	/** tm_queue_shaper_needed indicates that the tm_queues are expected
 	 * to do TM shaping. */
 	odp_bool_t tm_queue_shaper_needed;
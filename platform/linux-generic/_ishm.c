@@ -73,6 +73,7 @@
 #include <inttypes.h>
 #include <sys/wait.h>
 #include <libgen.h>
+#include <linux/mempolicy.h>
 
 /*
  * Maximum number of internal shared memory blocks.
@@ -169,6 +170,7 @@ typedef struct ishm_block {
 	uint64_t len;		 /* length. multiple of page size. 0 if free*/
 	ishm_fragment_t *fragment; /* used when _ODP_ISHM_SINGLE_VA is used */
 	huge_flag_t huge;	 /* page type: external means unknown here. */
+	uint64_t page_sz;	 /* size of the pages backing the block     */
 	uint64_t seq;	/* sequence number, incremented on alloc and free   */
 	uint64_t refcnt;/* number of linux processes mapping this block     */
 } ishm_block_t;
@@ -400,6 +402,24 @@ static void free_fragment(ishm_fragment_t *fragmnt)
 	}
 }
 
+/*
+ * Return the hugetlbfs mount point for the given huge page size, or NULL if
+ * there is no such mount.
+ */
+static const char *huge_page_dir(uint64_t page_sz)
+{
+	hugepage_info_t *hp = &odp_global_data.hugepage_info;
+
+	if (page_sz == hp->default_huge_page_size)
+		return hp->default_huge_page_dir;
+	if (page_sz == 2 * 1024 * 1024ULL)
+		return hp->huge_page_dir_2m;
+	if (page_sz == 1024 * 1024 * 1024ULL)
+		return hp->huge_page_dir_1g;
+
+	return NULL;
+}
+
 /*
  * Create file with size len. returns -1 on error
  * Creates a file to /tmp/odp-<pid>-<sequence_or_name> (for normal pages)
@@ -416,6 +436,7 @@ static int create_file(int block_index, huge_flag_t huge, uint64_t len,
 	char filename[ISHM_FILENAME_MAXLEN];/* filename in /tmp/ or /mnt/huge */
 	int  oflag = O_RDWR | O_CREAT | O_TRUNC; /* flags for open	      */
 	FILE *export_file;
+	const char *huge_dir = NULL;
 
 	new_block = &ishm_tbl->block[block_index];
 	name = new_block->name;
@@ -425,14 +446,16 @@ static int create_file(int block_index, huge_flag_t huge, uint64_t len,
 		 ishm_tbl->dev_seq++);
 
 	/* huge dir must be known to create files there!: */
-	if ((huge == HUGE) &&
-	    (!odp_global_data.hugepage_info.default_huge_page_dir))
-		return -1;
+	if (huge == HUGE) {
+		huge_dir = huge_page_dir(new_block->page_sz);
+		if (!huge_dir)
+			return -1;
+	}
 
 	if (huge == HUGE)
 		snprintf(filename, ISHM_FILENAME_MAXLEN,
 			 ISHM_FILENAME_FORMAT,
-			 odp_global_data.hugepage_info.default_huge_page_dir,
+			 huge_dir,
 			 odp_global_data.main_pid,
 			 (name && name[0]) ? name : seq_string);
 	else
@@ -775,11 +798,12 @@ int _odp_ishm_reserve(const char *name, uint64_t size, int fd,
 	uint64_t page_sz;		      /* normal page size. usually 4K*/
 	uint64_t page_hp_size;		      /* huge page size */
 	uint32_t hp_align;
-	uint64_t len;			      /* mapped length */
+	uint64_t len = 0;		      /* mapped length */
 	void *addr = NULL;		      /* mapping address */
 	int new_proc_entry;
 	struct stat statbuf;
 	static int  huge_error_printed;       /* to avoid millions of error...*/
+	int hp_required;		      /* no fall back to other pages */
 
 	odp_spinlock_lock(&ishm_tbl->lock);
 
@@ -790,6 +814,23 @@ int _odp_ishm_reserve(const char *name, uint64_t size, int fd,
 	page_sz      = odp_sys_page_size();
 	page_hp_size = odp_sys_huge_page_size();
 
+	/* an explicit huge page size overrides the default one */
+	hp_required = flags & (_ODP_ISHM_HP_2M | _ODP_ISHM_HP_1G);
+	if (hp_required == (_ODP_ISHM_HP_2M | _ODP_ISHM_HP_1G)) {
+		odp_spinlock_unlock(&ishm_tbl->lock);
+		ODP_ERR("%s: both 2MB and 1GB huge pages requested\n",
+			name ? name : "");
+		return -1;
+	}
+	if (hp_required & _ODP_ISHM_HP_2M)
+		page_hp_size = 2 * 1024 * 1024ULL;
+	if (hp_required & _ODP_ISHM_HP_1G)
+		page_hp_size = 1024 * 1024 * 1024ULL;
+
+	/* locking is what keeps pre-faulted pages resident */
+	if (flags & _ODP_ISHM_PREFAULT)
+		flags |= _ODP_ISHM_LOCK;
+
 	/* grab a new entry: */
 	for (new_index = 0; new_index < ISHM_MAX_NB_BLOCKS; new_index++) {
 		if (ishm_tbl->block[new_index].len == 0) {
@@ -838,30 +879,47 @@ int _odp_ishm_reserve(const char *name, uint64_t size, int fd,
 			return -1;
 		}
 		new_block->huge = EXTERNAL;
+		new_block->page_sz = page_sz;
 		new_block->external_fd = 1;
 	} else {
 		new_block->external_fd = 0;
 	}
 
 	/* Otherwise, Try first huge pages when possible and needed: */
-	if ((fd < 0) && page_hp_size && (size > page_sz)) {
+	if ((fd < 0) && hp_required && !huge_page_dir(page_hp_size)) {
+		odp_spinlock_unlock(&ishm_tbl->lock);
+		ODP_ERR("%s: no hugetlbfs mount for %" PRIu64 " kB pages\n",
+			name ? name : "", page_hp_size / 1024);
+		return -1;
+	}
+
+	if ((fd < 0) && page_hp_size && (hp_required || (size > page_sz))) {
 		/* at least, alignment in VA should match page size, but user
 		 * can request more: If the user requirement exceeds the page
 		 * size then we have to make sure the block will be mapped at
 		 * the same address every where, otherwise alignment may be
 		 * be wrong for some process */
 		hp_align = align;
-		if (hp_align <= odp_sys_huge_page_size())
-			hp_align = odp_sys_huge_page_size();
+		if (hp_align <= page_hp_size)
+			hp_align = page_hp_size;
 		else
 			flags |= _ODP_ISHM_SINGLE_VA;
 
 		/* roundup to page size */
 		len = (size + (page_hp_size - 1)) & (-page_hp_size);
+		new_block->page_sz = page_hp_size;
 		addr = do_map(new_index, len, hp_align, flags, HUGE, &fd);
 
 		if (addr == NULL) {
-			if (!huge_error_printed) {
+			if (hp_required) {
+				ODP_ERR("%s: cannot reserve %" PRIu64 " bytes "
+					"of %" PRIu64 " kB huge pages. check: "
+					"/sys/kernel/mm/hugepages/hugepages-"
+					"%" PRIu64 "kB/nr_hugepages.\n",
+					name ? name : "", len,
+					page_hp_size / 1024,
+					page_hp_size / 1024);
+			} else if (!huge_error_printed) {
 				ODP_ERR("No huge pages, fall back to normal "
 					"pages. "
 					"check: /proc/sys/vm/nr_hugepages.\n");
@@ -872,8 +930,8 @@ int _odp_ishm_reserve(const char *name, uint64_t size, int fd,
 		}
 	}
 
-	/* Try normal pages if huge pages failed */
-	if (fd < 0) {
+	/* Try normal pages if huge pages failed (and were not required) */
+	if ((fd < 0) && !hp_required) {
 		/* at least, alignment in VA should match page size, but user
 		 * can request more: If the user requirement exceeds the page
 		 * size then we have to make sure the block will be mapped at
@@ -886,6 +944,7 @@ int _odp_ishm_reserve(const char *name, uint64_t size, int fd,
 
 		/* roundup to page size */
 		len = (size + (page_sz - 1)) & (-page_sz);
+		new_block->page_sz = page_sz;
 		addr = do_map(new_index, len, align, flags, NORMAL, &fd);
 		new_block->huge = NORMAL;
 	}
@@ -1321,8 +1380,7 @@ int _odp_ishm_info(int block_index, _odp_ishm_info_t *info)
 	info->name	 = ishm_tbl->block[block_index].name;
 	info->addr	 = ishm_proctable->entry[proc_index].start;
 	info->size	 = ishm_tbl->block[block_index].user_len;
-	info->page_size  = (ishm_tbl->block[block_index].huge == HUGE) ?
-			   odp_sys_huge_page_size() : odp_sys_page_size();
+	info->page_size  = ishm_tbl->block[block_index].page_sz;
 	info->flags	 = ishm_tbl->block[block_index].flags;
 	info->user_flags = ishm_tbl->block[block_index].user_flags;
 
@@ -1330,6 +1388,63 @@ int _odp_ishm_info(int block_index, _odp_ishm_info_t *info)
 	return 0;
 }
 
+/*
+ * Set a NUMA node as the preferred memory node of a block range. Pages of
+ * the range are allocated from the node when first touched, and pages
+ * already touched by this process are moved there. Range boundaries are
+ * rounded up to the page size, so that consecutive ranges bound to different
+ * nodes do not overlap.
+ */
+int _odp_ishm_bind_node(int block_index, uint64_t offset, uint64_t len,
+			int node)
+{
+	int proc_index;
+	uint64_t page_sz;
+	uintptr_t start, end;
+	unsigned long nodemask;
+
+	if (node < 0 || node >= (int)(8 * sizeof(nodemask)))
+		return -1;
+
+	odp_spinlock_lock(&ishm_tbl->lock);
+	procsync();
+
+	if ((block_index < 0) ||
+	    (block_index >= ISHM_MAX_NB_BLOCKS) ||
+	    (ishm_tbl->block[block_index].len == 0) ||
+	    (offset + len > ishm_tbl->block[block_index].user_len)) {
+		odp_spinlock_unlock(&ishm_tbl->lock);
+		ODP_ERR("Request for node bind on an invalid block\n");
+		return -1;
+	}
+
+	proc_index = procfind_block(block_index);
+	if (proc_index < 0) {
+		odp_spinlock_unlock(&ishm_tbl->lock);
+		return -1;
+	}
+
+	page_sz = ishm_tbl->block[block_index].page_sz;
+	start = (uintptr_t)ishm_proctable->entry[proc_index].start;
+	odp_spinlock_unlock(&ishm_tbl->lock);
+
+	end   = ROUNDUP_ALIGN(start + offset + len, page_sz);
+	start = ROUNDUP_ALIGN(start + offset, page_sz);
+
+	if (start >= end)
+		return 0;
+
+	nodemask = 1UL << node;
+
+	if (syscall(__NR_mbind, start, end - start, MPOL_PREFERRED, &nodemask,
+		    8 * sizeof(nodemask), MPOL_MF_MOVE)) {
+		ODP_DBG("mbind failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
 static int do_odp_ishm_init_local(void)
 {
 	int i;
@@ -1607,7 +1722,7 @@ int _odp_ishm_term_global(void)
 int _odp_ishm_status(const char *title)
 {
 	int i;
-	char flags[3];
+	char flags[4];
 	char huge;
 	int proc_index;
 	ishm_fragment_t *fragmnt;
@@ -1638,7 +1753,9 @@ int _odp_ishm_status(const char *title)
 								'S' : '.';
 		flags[1] = (ishm_tbl->block[i].flags & _ODP_ISHM_LOCK) ?
 								'L' : '.';
-		flags[2] = 0;
+		flags[2] = (ishm_tbl->block[i].flags & _ODP_ISHM_PREFAULT) ?
+								'P' : '.';
+		flags[3] = 0;
 		switch (ishm_tbl->block[i].huge) {
 		case HUGE:
 			huge = 'H';
@@ -1654,12 +1771,13 @@ int _odp_ishm_status(const char *title)
 		}
 		proc_index = procfind_block(i);
 		ODP_DBG("%-3d:  name:%-.24s file:%-.24s"
-			" flags:%s,%c len:0x%-08lx"
+			" flags:%s,%c page:%" PRIu64 "kB len:0x%-08lx"
 			" user_len:%-8ld seq:%-3ld refcnt:%-4d\n",
 			i,
 			ishm_tbl->block[i].name,
 			ishm_tbl->block[i].filename,
 			flags, huge,
+			ishm_tbl->block[i].page_sz / 1024,
 			ishm_tbl->block[i].len,
 			ishm_tbl->block[i].user_len,
 			ishm_tbl->block[i].seq,
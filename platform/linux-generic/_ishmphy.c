@@ -97,6 +97,10 @@ void *_odp_ishmphy_map(int fd, void *start, uint64_t size,
 	void *mapped_addr_tmp, *mapped_addr;
 	int mmap_flags = 0;
 
+	/* fault in all pages now, rather than on first touch */
+	if (flags & _ODP_ISHM_PREFAULT)
+		mmap_flags |= MAP_POPULATE;
+
 	if (flags & _ODP_ISHM_SINGLE_VA) {
 		if (!start) {
 			ODP_ERR("failure: missing address\n");
@@ -17,6 +17,9 @@ extern "C" {
 #define _ODP_ISHM_SINGLE_VA		1
 #define _ODP_ISHM_LOCK			2
 #define _ODP_ISHM_EXPORT		4 /*create export descr file in /tmp */
+#define _ODP_ISHM_HP_2M			8 /* require 2MB huge pages */
+#define _ODP_ISHM_HP_1G			16 /* require 1GB huge pages */
+#define _ODP_ISHM_PREFAULT		32 /* populate all pages at map time */
 
 /**
  * Shared memory block info
@@ -43,6 +46,8 @@ int   _odp_ishm_find_exported(const char *remote_name,
 			      const char *local_name);
 void *_odp_ishm_address(int block_index);
 int   _odp_ishm_info(int block_index, _odp_ishm_info_t *info);
+int   _odp_ishm_bind_node(int block_index, uint64_t offset, uint64_t len,
+			  int node);
 int   _odp_ishm_status(const char *title);
 
 #ifdef __cplusplus
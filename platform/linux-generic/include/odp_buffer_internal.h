@@ -48,69 +48,47 @@ typedef union odp_buffer_bits_t {
 
 #define BUFFER_BURST_SIZE    CONFIG_BURST_SIZE
 
-/* Common buffer header */
+/* Common buffer header
+ *
+ * Fields that are accessed per event on the fast path (alloc, free, enqueue,
+ * dequeue) fit into the first cache line. Rarely used metadata of each event
+ * type is stored after type specific hot fields. */
 struct odp_buffer_hdr_t {
 	/* Handle union */
 	odp_buffer_bits_t handle;
 
-	/* Initial buffer data pointer and length */
-	uint8_t  *base_data;
-	uint8_t  *buf_end;
-
-	/* Max data size */
-	uint32_t  size;
-
 	/* Pool type */
 	int8_t    type;
 
-	/* Burst counts */
-	uint8_t   burst_num;
-	uint8_t   burst_first;
+	/* Event type. Maybe different than pool type (crypto compl event) */
+	int8_t    event_type;
 
 	/* Segment count */
 	uint8_t   segcount;
 
-	/* Segments */
-	struct {
-		void     *hdr;
-		uint8_t  *data;
-		uint32_t  len;
-	} seg[CONFIG_PACKET_MAX_SEGS];
+	/* Burst counts */
+	uint8_t   burst_num;
+	uint8_t   burst_first;
+
+	/* Max data size */
+	uint32_t  size;
 
 	/* Next buf in a list */
 	struct odp_buffer_hdr_t *next;
 
-	/* User context pointer or u64 */
-	union {
-		uint64_t    buf_u64;
-		void       *buf_ctx;
-		const void *buf_cctx; /* const alias for ctx */
-	};
-
-	/* User area pointer */
-	void    *uarea_addr;
-
-	/* User area size */
-	uint32_t uarea_size;
-
-	/* Event type. Maybe different than pool type (crypto compl event) */
-	int8_t    event_type;
-
-	/* Burst table */
-	struct odp_buffer_hdr_t *burst[BUFFER_BURST_SIZE];
-
-	/* Used only if _ODP_PKTIO_IPC is set.
-	 * ipc mapped process can not walk over pointers,
-	 * offset has to be used */
-	uint64_t ipc_data_offset;
-
 	/* Pool handle */
 	odp_pool_t pool_hdl;
 
-	/* Data or next header */
-	uint8_t data[0];
+	/* Initial buffer data pointer */
+	uint8_t  *base_data;
+
+	/* Burst table, located in the cold end of the event header */
+	struct odp_buffer_hdr_t **burst;
 };
 
+ODP_STATIC_ASSERT(sizeof(struct odp_buffer_hdr_t) <= ODP_CACHE_LINE_SIZE,
+		  "BUFFER_HDR_LARGER_THAN_CACHE_LINE");
+
 ODP_STATIC_ASSERT(CONFIG_PACKET_MAX_SEGS < 256,
 		  "CONFIG_PACKET_MAX_SEGS_TOO_LARGE");
 
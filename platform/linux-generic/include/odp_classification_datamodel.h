@@ -21,6 +21,7 @@ extern "C" {
 
 #include <odp/api/spinlock.h>
 #include <odp/api/classification.h>
+#include <odp/api/thread.h>
 #include <odp_pool_internal.h>
 #include <odp_packet_internal.h>
 #include <odp_packet_io_internal.h>
@@ -30,11 +31,17 @@ extern "C" {
 /* Maximum Class Of Service Entry */
 #define ODP_COS_MAX_ENTRY		64
 /* Maximum PMR Entry */
-#define ODP_PMR_MAX_ENTRY		256
+#define ODP_PMR_MAX_ENTRY		4096
 /* Maximum PMR Terms in a PMR Set */
 #define ODP_PMRTERM_MAX			8
-/* Maximum PMRs attached in PKTIO Level */
-#define ODP_PMR_PER_COS_MAX		8
+/* Maximum compiled field tuples per CoS */
+#define CLS_TUPLE_PER_COS_MAX		16
+/* PMR is not compiled into a tuple */
+#define CLS_TUPLE_NONE			((uint32_t)-1)
+/* Maximum 64 bit words in a tuple key */
+#define CLS_KEY_WORDS			(2 * ODP_PMRTERM_MAX)
+/* Buckets in the PMR hash table, power of two */
+#define CLS_PMR_HASH_SIZE		(2 * ODP_PMR_MAX_ENTRY)
 /* L2 Priority Bits */
 #define ODP_COS_L2_QOS_BITS		3
 /* Max L2 QoS value */
@@ -81,14 +88,41 @@ typedef struct pmr_term_value {
 	uint32_t	val_sz;	/**< Size of the value to be matched */
 } pmr_term_value_t;
 
+/**
+Compiled Tuple Term
+
+One exact match field of a tuple key
+**/
+typedef struct cls_tuple_term {
+	odp_cls_pmr_term_t term;	/* PMR Term */
+	uint32_t offset;		/* Offset for ODP_PMR_CUSTOM_FRAME */
+	uint32_t val_sz;		/* Size for ODP_PMR_CUSTOM_FRAME */
+	uint64_t mask[2];		/* Mask, second word for IPv6 only */
+} cls_tuple_term_t;
+
+/**
+Compiled Field Tuple
+
+Exact match PMRs of a CoS are grouped by the set of terms and masks they
+match on. The PMRs of a tuple are stored in the PMR hash table keyed with
+their term values, so a packet is checked against all of them with one
+hash lookup.
+**/
+typedef struct cls_tuple {
+	uint32_t num_rule;		/* num of PMRs in this tuple */
+	uint32_t num_term;		/* num of terms in the key */
+	cls_tuple_term_t term[ODP_PMRTERM_MAX];
+} cls_tuple_t;
+
 /*
 Class Of Service
 */
 struct cos_s {
 	queue_entry_t *queue;		/* Associated Queue */
 	odp_pool_t pool;		/* Associated Buffer pool */
-	union pmr_u *pmr[ODP_PMR_PER_COS_MAX];	/* Chained PMR */
-	union cos_u *linked_cos[ODP_PMR_PER_COS_MAX]; /* Chained CoS with PMR*/
+	union pmr_u *slow_pmr;		/* PMRs not in a tuple, in order */
+	uint32_t num_tuple;		/* num of tuple slots in use */
+	cls_tuple_t tuple[CLS_TUPLE_PER_COS_MAX]; /* Compiled PMR tuples */
 	uint32_t valid;			/* validity Flag */
 	odp_cls_drop_t drop_policy;	/* Associated Drop Policy */
 	size_t headroom;		/* Headroom for this CoS */
@@ -109,10 +143,17 @@ Packet Matching Rule
 **/
 struct pmr_s {
 	uint32_t valid;			/* Validity Flag */
-	odp_atomic_u32_t count;		/* num of packets matching this rule */
 	uint32_t num_pmr;		/* num of PMR Term Values*/
 	odp_spinlock_t lock;		/* pmr lock*/
 	cos_t *src_cos;			/* source CoS where PMR is attached */
+	cos_t *dst_cos;			/* CoS selected when PMR matches */
+	uint64_t seq;			/* creation order, first match wins */
+	uint32_t linked;		/* PMR is compiled into src_cos */
+	uint32_t tuple;			/* tuple index or CLS_TUPLE_NONE */
+	uint32_t hash;			/* hash of the tuple key */
+	uint32_t key_words;		/* num of words in the tuple key */
+	uint64_t key[CLS_KEY_WORDS];	/* tuple key */
+	union pmr_u *next;		/* next PMR in bucket or slow list */
 	pmr_term_value_t  pmr_term_value[ODP_PMRTERM_MAX];
 			/* List of associated PMR Terms */
 };
@@ -165,15 +206,52 @@ Class of Service Table
 **/
 typedef struct odp_cos_table {
 	cos_t cos_entry[ODP_COS_MAX_ENTRY];
+	/* Statistics table, reserved when the first CoS is created */
+	struct cls_stats_tbl *stats;
 } cos_tbl_t;
 
+/**
+Classifier state of a thread
+
+The sequence number is odd while the thread classifies packets. Rules are
+matched without locks, so PMR and tuple slots removed from the compiled
+tables are reused only after all threads that may have seen them have
+finished classification.
+**/
+typedef struct ODP_ALIGNED_CACHE cls_thr {
+	odp_atomic_u32_t seq;
+} cls_thr_t;
+
 /**
 PMR table
 **/
 typedef struct pmr_tbl {
 	pmr_t pmr[ODP_PMR_MAX_ENTRY];
+	odp_spinlock_t lock;		/* hash table and seq lock */
+	uint64_t seq;			/* next PMR sequence number */
+	pmr_t *bucket[CLS_PMR_HASH_SIZE]; /* compiled PMR hash table */
+	cls_thr_t thr[ODP_THREAD_COUNT_MAX]; /* classifier threads */
 } pmr_tbl_t;
 
+/**
+Per thread classification statistics
+
+Each thread updates only its own counters, so packet classification does
+not need atomic operations or share cache lines between threads. Counters
+are summed over all threads on read.
+**/
+typedef struct cls_thr_stats {
+	odp_cls_stats_t pmr[ODP_PMR_MAX_ENTRY];
+	odp_cls_stats_t cos[ODP_COS_MAX_ENTRY];
+} cls_thr_stats_t;
+
+/**
+Classification statistics table
+**/
+typedef struct cls_stats_tbl {
+	cls_thr_stats_t thr[ODP_THREAD_COUNT_MAX];
+} cls_stats_tbl_t;
+
 #ifdef __cplusplus
 }
 #endif
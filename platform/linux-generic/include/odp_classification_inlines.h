@@ -273,11 +273,38 @@ static inline int verify_pmr_ipsec_spi(const uint8_t *pkt_addr,
 	return 0;
 }
 
+/* Network identifier of a VXLAN or NVGRE tunnel. NVGRE carries the VSID in
+the upper 24 bits of the GRE key. Returns 1 on success and 0 if the packet
+is not tunneled over VXLAN/NVGRE.
+*/
+static inline int cls_ld_vni(odp_packet_hdr_t *pkt_hdr, uint32_t *vni)
+{
+	if (pkt_hdr->p.input_flags.vxlan) {
+		*vni = pkt_hdr->p.tunnel_id;
+		return 1;
+	}
+
+	if (pkt_hdr->p.input_flags.gre && pkt_hdr->p.input_flags.tunnel &&
+	    pkt_hdr->p.inner_l2_offset != ODP_PACKET_OFFSET_INVALID) {
+		*vni = pkt_hdr->p.tunnel_id >> 8;
+		return 1;
+	}
+
+	return 0;
+}
+
 static inline int verify_pmr_ld_vni(const uint8_t *pkt_addr ODP_UNUSED,
-				    odp_packet_hdr_t *pkt_hdr ODP_UNUSED,
-				    pmr_term_value_t *term_value ODP_UNUSED)
+				    odp_packet_hdr_t *pkt_hdr,
+				    pmr_term_value_t *term_value)
 {
-	ODP_UNIMPLEMENTED();
+	uint32_t vni;
+
+	if (!cls_ld_vni(pkt_hdr, &vni))
+		return 0;
+
+	if (term_value->match.value == (vni & term_value->match.mask))
+		return 1;
+
 	return 0;
 }
 
@@ -316,6 +343,117 @@ static inline int verify_pmr_eth_type_x(const uint8_t *pkt_addr ODP_UNUSED,
 	ODP_UNIMPLEMENTED();
 	return 0;
 }
+
+/* Read the packet field of a compiled tuple term into val. IPv6 addresses
+fill both words, other terms only the first one. Field values are in the
+same format as in the verify_pmr_xxx() functions above.
+Returns 1 on success and 0 if the packet does not have the field.
+*/
+static inline int cls_tuple_field(const uint8_t *pkt_addr,
+				  odp_packet_hdr_t *pkt_hdr,
+				  const cls_tuple_term_t *term,
+				  uint64_t val[2])
+{
+	const _odp_ipv4hdr_t *ip;
+	const _odp_ipv6hdr_t *ipv6;
+	const _odp_tcphdr_t *tcp;
+	const _odp_udphdr_t *udp;
+	const _odp_ethhdr_t *eth;
+	uint64_t dmac_be = 0;
+	const uint8_t *l4;
+	uint32_t vni;
+
+	val[0] = 0;
+
+	switch (term->term) {
+	case ODP_PMR_LEN:
+		val[0] = packet_len(pkt_hdr);
+		return 1;
+	case ODP_PMR_IPPROTO:
+	case ODP_PMR_SIP_ADDR:
+	case ODP_PMR_DIP_ADDR:
+		if (!pkt_hdr->p.input_flags.ipv4)
+			return 0;
+		ip = (const _odp_ipv4hdr_t *)(pkt_addr + pkt_hdr->p.l3_offset);
+		if (term->term == ODP_PMR_IPPROTO)
+			val[0] = ip->proto;
+		else if (term->term == ODP_PMR_SIP_ADDR)
+			val[0] = odp_be_to_cpu_32(ip->src_addr);
+		else
+			val[0] = odp_be_to_cpu_32(ip->dst_addr);
+		return 1;
+	case ODP_PMR_TCP_SPORT:
+	case ODP_PMR_TCP_DPORT:
+		if (!pkt_hdr->p.input_flags.tcp)
+			return 0;
+		tcp = (const _odp_tcphdr_t *)(pkt_addr + pkt_hdr->p.l4_offset);
+		if (term->term == ODP_PMR_TCP_SPORT)
+			val[0] = odp_be_to_cpu_16(tcp->src_port);
+		else
+			val[0] = odp_be_to_cpu_16(tcp->dst_port);
+		return 1;
+	case ODP_PMR_UDP_SPORT:
+	case ODP_PMR_UDP_DPORT:
+		if (!pkt_hdr->p.input_flags.udp)
+			return 0;
+		udp = (const _odp_udphdr_t *)(pkt_addr + pkt_hdr->p.l4_offset);
+		if (term->term == ODP_PMR_UDP_SPORT)
+			val[0] = odp_be_to_cpu_16(udp->src_port);
+		else
+			val[0] = odp_be_to_cpu_16(udp->dst_port);
+		return 1;
+	case ODP_PMR_DMAC:
+		if (!packet_hdr_has_eth(pkt_hdr))
+			return 0;
+		eth = (const _odp_ethhdr_t *)(pkt_addr + pkt_hdr->p.l2_offset);
+		memcpy(&dmac_be, eth->dst.addr, _ODP_ETHADDR_LEN);
+		val[0] = odp_be_to_cpu_64(dmac_be);
+		if (dmac_be != val[0])
+			val[0] = val[0] >> (64 - (_ODP_ETHADDR_LEN * 8));
+		return 1;
+	case ODP_PMR_SIP6_ADDR:
+	case ODP_PMR_DIP6_ADDR:
+		if (!packet_hdr_has_ipv6(pkt_hdr))
+			return 0;
+		ipv6 = (const _odp_ipv6hdr_t *)(pkt_addr +
+						pkt_hdr->p.l3_offset);
+		if (term->term == ODP_PMR_SIP6_ADDR) {
+			val[0] = ipv6->src_addr.u64[0];
+			val[1] = ipv6->src_addr.u64[1];
+		} else {
+			val[0] = ipv6->dst_addr.u64[0];
+			val[1] = ipv6->dst_addr.u64[1];
+		}
+		return 1;
+	case ODP_PMR_IPSEC_SPI:
+		l4 = pkt_addr + pkt_hdr->p.l4_offset;
+		if (pkt_hdr->p.input_flags.ipsec_ah) {
+			const _odp_ahhdr_t *ahhdr = (const _odp_ahhdr_t *)l4;
+
+			val[0] = odp_be_to_cpu_32(ahhdr->spi);
+		} else if (pkt_hdr->p.input_flags.ipsec_esp) {
+			const _odp_esphdr_t *esphdr = (const _odp_esphdr_t *)l4;
+
+			val[0] = odp_be_to_cpu_32(esphdr->spi);
+		} else {
+			return 0;
+		}
+		return 1;
+	case ODP_PMR_LD_VNI:
+		if (!cls_ld_vni(pkt_hdr, &vni))
+			return 0;
+		val[0] = vni;
+		return 1;
+	case ODP_PMR_CUSTOM_FRAME:
+		if (packet_len(pkt_hdr) <= term->offset + term->val_sz)
+			return 0;
+		memcpy(&val[0], pkt_addr + term->offset, term->val_sz);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
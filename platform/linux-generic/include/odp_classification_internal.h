@@ -51,6 +51,20 @@ int cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 			uint16_t pkt_len, uint32_t seg_len, odp_pool_t *pool,
 			odp_packet_hdr_t *pkt_hdr);
 
+/**
+@internal
+
+Burst Packet Classifier
+
+Classifies 'num' packets like cls_classify_packet(). Pool of a packet is set to
+ODP_POOL_INVALID when the packet cannot be classified. Returns the number of
+packets classified successfully.
+**/
+int cls_classify_packet_multi(pktio_entry_t *entry, uint8_t *const base[],
+			      const uint16_t pkt_len[],
+			      const uint32_t seg_len[], int num,
+			      odp_pool_t pool[], odp_packet_hdr_t pkt_hdr[]);
+
 /**
 Packet IO classifier init
 
@@ -59,17 +73,6 @@ This function should be called during pktio initialization.
 **/
 int pktio_classifier_init(pktio_entry_t *pktio);
 
-/**
-@internal
-match_pmr_cos
-
-Match a PMR chain with a Packet and return matching CoS
-This function gets called recursively to check the chained PMR Term value
-with the packet.
-
-**/
-cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, pmr_t *pmr,
-		     odp_packet_hdr_t *hdr);
 /**
 @internal
 CoS associated with L3 QoS value
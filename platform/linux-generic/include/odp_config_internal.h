@@ -26,6 +26,22 @@ extern "C" {
  */
 #define CONFIG_QUEUE_MAX_ORD_LOCKS 4
 
+/*
+ * Maximum queue size
+ *
+ * Maximum number of events a ring based queue can store. Must be a power of
+ * two.
+ */
+#define CONFIG_QUEUE_MAX_SIZE 4096
+
+/*
+ * Default queue size
+ *
+ * Size of queues created with zero size parameter. Zero selects the unbounded
+ * linked list queue, any other value a ring based queue of the given size.
+ */
+#define CONFIG_QUEUE_DEFAULT_SIZE 0
+
 /*
  * Maximum number of packet IO resources
  */
@@ -72,6 +88,22 @@ extern "C" {
  */
 #define CONFIG_PACKET_TAILROOM 0
 
+/*
+ * Maximum packet headroom
+ *
+ * This defines the maximum headroom that can be requested per packet pool
+ * (headroom in odp_pool_param_t).
+ */
+#define CONFIG_PACKET_MAX_HEADROOM 1024
+
+/*
+ * Maximum packet tailroom
+ *
+ * This defines the maximum tailroom that can be requested per packet pool
+ * (tailroom in odp_pool_param_t).
+ */
+#define CONFIG_PACKET_MAX_TAILROOM 1024
+
 /*
  * Maximum number of segments per packet
  */
@@ -79,6 +111,9 @@ extern "C" {
 
 /*
  * Maximum packet segment size including head- and tailrooms
+ *
+ * Headroom and tailroom of a pool are taken from this size, a pool with more
+ * than the default rooms has shorter maximum segment data length.
  */
 #define CONFIG_PACKET_SEG_SIZE (8 * 1024)
 
@@ -96,7 +131,8 @@ extern "C" {
  *
  * This defines the minimum packet segment buffer length in bytes. The user
  * defined segment length (seg_len in odp_pool_param_t) will be rounded up into
- * this value.
+ * this value. Pools with more than the default rooms round it up to their
+ * maximum segment data length instead.
  */
 #define CONFIG_PACKET_SEG_LEN_MIN CONFIG_PACKET_MAX_SEG_LEN
 
@@ -129,6 +165,14 @@ extern "C" {
  */
 #define CONFIG_BURST_SIZE 16
 
+/*
+ * Maximum number of packets in a packet vector
+ *
+ * Packet input fills vectors by receiving multiple bursts, so this may be
+ * larger than the event burst size.
+ */
+#define CONFIG_PACKET_VECTOR_MAX_SIZE 64
+
 /*
  * Maximum number of events in a pool
  */
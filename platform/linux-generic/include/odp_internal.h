@@ -27,12 +27,15 @@ extern "C" {
 extern __thread int __odp_errno;
 
 #define MAX_CPU_NUMBER 128
+#define MAX_NUMA_NODES 8
 
 typedef struct {
 	uint64_t cpu_hz_max[MAX_CPU_NUMBER];
 	uint64_t page_size;
 	int      cache_line_size;
 	int      cpu_count;
+	int      numa_nodes;
+	uint8_t  cpu_node[MAX_CPU_NUMBER];
 	char     cpu_arch_str[128];
 	char     model_str[MAX_CPU_NUMBER][128];
 } system_info_t;
@@ -40,6 +43,8 @@ typedef struct {
 typedef struct {
 	uint64_t default_huge_page_size;
 	char     *default_huge_page_dir;
+	char     *huge_page_dir_2m; /* NULL when no 2MB hugetlbfs mount */
+	char     *huge_page_dir_1g; /* NULL when no 1GB hugetlbfs mount */
 } hugepage_info_t;
 
 struct odp_global_data_s {
@@ -76,6 +76,12 @@ typedef union {
 		uint64_t tcpopt:1;    /**< TCP options present */
 		uint64_t sctp:1;      /**< SCTP */
 		uint64_t icmp:1;      /**< ICMP */
+		uint64_t mpls:1;      /**< MPLS label stack found */
+
+		uint64_t tunnel:1;    /**< Tunnel found, inner offsets valid */
+		uint64_t vxlan:1;     /**< VXLAN */
+		uint64_t gtpu:1;      /**< GTP-U */
+		uint64_t gre:1;       /**< GRE */
 
 		uint64_t color:2;     /**< Packet color for traffic mgmt */
 		uint64_t nodrop:1;    /**< Drop eligibility status */
@@ -156,23 +162,77 @@ typedef struct {
 	uint32_t l3_len;    /**< Layer 3 length */
 	uint32_t l4_len;    /**< Layer 4 length */
 
+	/* Following fields are valid only when input_flags.tunnel is set */
+	uint32_t inner_l2_offset; /**< offset to inner Eth hdr, if any */
+	uint32_t inner_l3_offset; /**< offset to inner IPv4/IPv6 hdr */
+	uint32_t inner_l4_offset; /**< offset to inner L4 hdr, if any */
+	uint32_t tunnel_id;	  /**< VXLAN VNI, GRE key or GTP-U TEID */
+	uint16_t inner_ethtype;	  /**< EtherType of inner L3 */
+	uint8_t  inner_ip_proto;  /**< IP protocol of inner L3 */
+
 	uint16_t ethtype;	/**< EtherType */
 	uint8_t  ip_proto;	/**< IP protocol */
 	uint8_t  parsed_layers;	/**< Highest parsed protocol stack layer */
 
 } packet_parser_t;
 
+/**
+ * External packet data
+ *
+ * Packet segment data may be located outside of packet pool memory (e.g. in
+ * a receive ring of a pktio). The owner of the memory is notified through
+ * release() when the last segment referring to the memory has been freed.
+ */
+typedef struct packet_ext_t {
+	odp_atomic_u32_t ref_count;
+	void (*release)(struct packet_ext_t *ext);
+} packet_ext_t;
+
 /**
  * Internal Packet header
  *
  * To optimize fast path performance this struct is not initialized to zero in
  * packet_init(). Because of this any new fields added must be reviewed for
  * initialization requirements.
+ *
+ * Packet only fields of the buffer header are located in the beginning of the
+ * packet header, in the same order as they were in the buffer header.
  */
 typedef struct odp_packet_hdr_t {
 	/* common buffer header */
 	odp_buffer_hdr_t buf_hdr;
 
+	/* End of the segment data area */
+	uint8_t  *buf_end;
+
+	/* Segments */
+	struct {
+		void     *hdr;
+		uint8_t  *data;
+		uint32_t  len;
+	} seg[CONFIG_PACKET_MAX_SEGS];
+
+	/* User context pointer or u64 */
+	union {
+		uint64_t    buf_u64;
+		void       *buf_ctx;
+		const void *buf_cctx; /* const alias for ctx */
+	};
+
+	/* User area pointer */
+	void    *uarea_addr;
+
+	/* User area size */
+	uint32_t uarea_size;
+
+	/* Burst table of the buffer header */
+	odp_buffer_hdr_t *burst[BUFFER_BURST_SIZE];
+
+	/* Used only if _ODP_PKTIO_IPC is set.
+	 * ipc mapped process can not walk over pointers,
+	 * offset has to be used */
+	uint64_t ipc_data_offset;
+
 	/*
 	 * Following members are initialized by packet_init()
 	 */
@@ -192,6 +252,9 @@ typedef struct odp_packet_hdr_t {
 	uint32_t ref_len;
 	odp_atomic_u32_t ref_count;
 
+	/* External data of the segment, initialized in segment init */
+	packet_ext_t *ext;
+
 	/*
 	 * Members below are not initialized by packet_init()
 	 */
@@ -292,7 +355,44 @@ static inline void pull_tail(odp_packet_hdr_t *pkt_hdr, uint32_t len)
 	pkt_hdr->tailroom  += len;
 	pkt_hdr->frame_len -= len;
 	pkt_hdr->unshared_len -= len;
-	pkt_hdr->buf_hdr.seg[last].len -= len;
+	pkt_hdr->seg[last].len -= len;
+}
+
+/* Attach external data to a single segment packet. The packet has no head or
+ * tailroom after this, as the memory around the data is not owned by it. */
+static inline void packet_ext_attach(odp_packet_hdr_t *pkt_hdr,
+				     packet_ext_t *ext, uint8_t *data,
+				     uint32_t len)
+{
+	odp_atomic_inc_u32(&ext->ref_count);
+
+	pkt_hdr->ext = ext;
+	pkt_hdr->seg[0].data = data;
+	pkt_hdr->seg[0].len  = len;
+	pkt_hdr->frame_len    = len;
+	pkt_hdr->unshared_len = len;
+	pkt_hdr->headroom     = 0;
+	pkt_hdr->tailroom     = 0;
+}
+
+/* Drop a reference to external data */
+static inline void packet_ext_unref(packet_ext_t *ext)
+{
+	if (odp_atomic_fetch_dec_u32(&ext->ref_count) == 1)
+		ext->release(ext);
+}
+
+/* Drop segment reference to external data, called when the segment buffer
+ * is freed */
+static inline void packet_ext_free(odp_packet_hdr_t *seg_hdr)
+{
+	packet_ext_t *ext = seg_hdr->ext;
+
+	if (odp_likely(ext == NULL))
+		return;
+
+	seg_hdr->ext = NULL;
+	packet_ext_unref(ext);
 }
 
 static inline uint32_t packet_len(odp_packet_hdr_t *pkt_hdr)
@@ -338,6 +438,18 @@ static inline int packet_parse_not_complete(odp_packet_hdr_t *pkt_hdr)
 	return pkt_hdr->p.parsed_layers != LAYER_ALL;
 }
 
+/* Reset parser metadata before new parse */
+static inline void packet_parser_reset(packet_parser_t *prs)
+{
+	prs->parsed_layers    = LAYER_NONE;
+	prs->error_flags.all  = 0;
+	prs->input_flags.all  = 0;
+	prs->output_flags.all = 0;
+	prs->l2_offset        = 0;
+	prs->l3_offset        = ODP_PACKET_OFFSET_INVALID;
+	prs->l4_offset        = ODP_PACKET_OFFSET_INVALID;
+}
+
 /* Forward declarations */
 int _odp_packet_copy_md_to_packet(odp_packet_t srcpkt, odp_packet_t dstpkt);
 
@@ -354,6 +466,10 @@ int packet_parse_layer(odp_packet_hdr_t *pkt_hdr, layer_t layer);
 /* Reset parser metadata for a new parse */
 void packet_parse_reset(odp_packet_hdr_t *pkt_hdr);
 
+/* Calculate flow hash of a received packet */
+void packet_flow_hash(odp_packet_hdr_t *pkt_hdr,
+		      odp_pktin_hash_proto_t hash_proto);
+
 /* Convert a packet handle to a buffer handle */
 odp_buffer_t _odp_packet_to_buffer(odp_packet_t pkt);
 
@@ -163,11 +163,31 @@ struct pktio_entry {
 	unsigned num_in_queue;
 	unsigned num_out_queue;
 
+	/* Scheduler poll affinity of input queues */
+	odp_pktin_poll_affinity_t poll_affinity;
+
+	/* Packet vectors of input event queues. Disabled when 'enable' is
+	 * zero, otherwise 'max_size' is the resolved vector size. */
+	odp_pktin_vector_config_t in_vector;
+
 	struct {
 		odp_queue_t        queue;
 		odp_pktin_queue_t  pktin;
 	} in_queue[PKTIO_MAX_QUEUES];
 
+	/* Software flow hashing of received packets. When the driver has a
+	 * single input queue, packets are spread to multiple input queues
+	 * by the hash. Packets of other queues are stored into the event
+	 * queue (sched/queue mode) or the staging queue (direct mode) of the
+	 * destination queue. The driver queue is configured multi-thread
+	 * safe, as all input queues receive from it. */
+	struct {
+		odp_pktin_hash_proto_t proto;	/**< Hashed protocol fields */
+		odp_bool_t hash;		/**< Hash received packets */
+		odp_bool_t spread;		/**< Spread packets in software */
+		odp_queue_t queue[PKTIO_MAX_QUEUES]; /**< Staging queues */
+	} rss;
+
 	struct {
 		odp_queue_t        queue;
 		odp_pktout_queue_t pktout;
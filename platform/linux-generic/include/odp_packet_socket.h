@@ -20,6 +20,7 @@
 #include <odp/api/pool.h>
 #include <odp/api/packet.h>
 #include <odp/api/packet_io.h>
+#include <odp/api/ticketlock.h>
 
 #include <linux/version.h>
 
@@ -31,6 +32,8 @@
 #define ODP_PACKET_SOCKET_MAX_BURST_RX 32
 /** Max transmit (Tx) burst size*/
 #define ODP_PACKET_SOCKET_MAX_BURST_TX 32
+/** Max number of pktin/pktout queues of a socket mmap pktio */
+#define ODP_PACKET_SOCKET_MMAP_MAX_QUEUES 64
 
 /*
  * This makes sure that building for kernels older than 3.1 works
@@ -42,6 +45,15 @@
 #define PACKET_FANOUT_HASH	0
 #endif /* PACKET_FANOUT */
 
+#ifndef PACKET_FANOUT_CPU
+#define PACKET_FANOUT_LB	1
+#define PACKET_FANOUT_CPU	2
+#endif /* PACKET_FANOUT_CPU */
+
+#ifndef PACKET_FANOUT_QM
+#define PACKET_FANOUT_QM	5
+#endif /* PACKET_FANOUT_QM */
+
 typedef struct {
 	int sockfd; /**< socket descriptor */
 	odp_pool_t pool; /**< pool to alloc packets from */
@@ -49,6 +61,7 @@ typedef struct {
 	unsigned char if_mac[ETH_ALEN];	/**< IF eth mac addr */
 	uint8_t *cache_ptr[ODP_PACKET_SOCKET_MAX_BURST_RX];
 	odp_shm_t shm;
+	uint64_t in_errors; /**< frames dropped as too long for the pool */
 } pkt_sock_t;
 
 /** packet mmap ring */
@@ -65,13 +78,18 @@ struct ring {
 	size_t rd_len;
 	int flen;
 
-	struct tpacket_req req;
+	/* TPACKET_V3 Rx: next packet and number of packets left in the
+	 * current block (frame_num) */
+	uint8_t *blk_pkt;
+	uint32_t blk_left;
+
+	struct tpacket_req3 req;
 };
 
 ODP_STATIC_ASSERT(offsetof(struct ring, mm_space) <= ODP_CACHE_LINE_SIZE,
 		  "ERR_STRUCT_RING");
 
-/** Packet socket using mmap rings for both Rx and Tx */
+/** Packet mmap socket of a pktin and/or pktout queue */
 typedef struct {
 	/** Packet mmap ring for Rx */
 	struct ring rx_ring ODP_ALIGNED_CACHE;
@@ -79,13 +97,40 @@ typedef struct {
 	struct ring tx_ring ODP_ALIGNED_CACHE;
 
 	int sockfd ODP_ALIGNED_CACHE;
-	odp_pool_t pool;
-	size_t frame_offset; /**< frame start offset from start of pkt buf */
 	uint8_t *mmap_base;
 	unsigned mmap_len;
-	unsigned char if_mac[ETH_ALEN];
 	struct sockaddr_ll ll;
+	/** Rx ring blocks and ring memory (TPACKET_V3) */
+	struct mmap_rx_mem_t *rx_mem;
+	odp_ticketlock_t rx_lock; /**< Rx ring lock */
+	odp_ticketlock_t tx_lock; /**< Tx ring lock */
+} pkt_mmap_queue_t;
+
+/** Packet socket using mmap rings for both Rx and Tx. Each pktin queue has
+ *  its own socket in a fanout group, each pktout queue its own Tx ring. */
+typedef struct {
+	/** Sockets of pktin/pktout queues. Socket 0 is used also for
+	 *  interface control. */
+	pkt_mmap_queue_t queue[ODP_PACKET_SOCKET_MMAP_MAX_QUEUES];
+
+	odp_pool_t pool;
+	size_t frame_offset; /**< frame start offset from start of pkt buf */
+	unsigned char if_mac[ETH_ALEN];
+	int if_idx;
 	int fanout;
+	/** Fanout mode (PACKET_FANOUT_xxx) of the current sockets */
+	int fanout_mode;
+	/** TPACKET version of rings */
+	int version;
+	/** Rx packets refer to ring memory instead of a copy */
+	int zero_copy;
+	/** TPACKET_V3 rings, and thus zero copy Rx, are supported */
+	int v3_supported;
+	unsigned num_queues;    /**< number of sockets */
+	unsigned num_rx_queues; /**< number of sockets with an Rx ring */
+	unsigned num_tx_queues; /**< number of sockets with a Tx ring */
+	odp_bool_t lockless_rx; /**< no locking for rx */
+	odp_bool_t lockless_tx; /**< no locking for tx */
 } pkt_sock_mmap_t;
 
 static inline void
@@ -0,0 +1,72 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP packet vector descriptor - implementation internal
+ */
+
+#ifndef ODP_PACKET_VECTOR_INTERNAL_H_
+#define ODP_PACKET_VECTOR_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/api/packet.h>
+#include <odp_buffer_internal.h>
+#include <odp_buffer_inlines.h>
+#include <odp_pool_internal.h>
+
+/**
+ * Internal packet vector header
+ *
+ * Packet handle table is stored in the data area of the buffer
+ * (buf_hdr.base_data).
+ */
+typedef struct {
+	/* common buffer header */
+	odp_buffer_hdr_t buf_hdr;
+
+	/* Number of packets in the table */
+	uint32_t size;
+} odp_packet_vector_hdr_t;
+
+static inline odp_packet_vector_hdr_t *
+packet_vector_hdr(odp_packet_vector_t pktv)
+{
+	return (odp_packet_vector_hdr_t *)(void *)
+		buf_hdl_to_hdr((odp_buffer_t)pktv);
+}
+
+static inline odp_packet_t *packet_vector_tbl(odp_packet_vector_hdr_t *hdr)
+{
+	return (odp_packet_t *)hdr->buf_hdr.base_data;
+}
+
+/* Free the vector and all packets in it */
+static inline void packet_vector_free_all(odp_packet_vector_t pktv)
+{
+	odp_packet_vector_hdr_t *hdr = packet_vector_hdr(pktv);
+
+	if (hdr->size)
+		odp_packet_free_multi(packet_vector_tbl(hdr), hdr->size);
+
+	odp_packet_vector_free(pktv);
+}
+
+/* Fill vectors from packet table. Outputs vector events, the number of
+ * packets packed into vectors is returned in 'num_packed'. */
+int packet_vector_pack(odp_pool_t pool, uint32_t max_size,
+		       const odp_packet_t pkt[], int num,
+		       odp_packet_vector_t pktv[], int *num_packed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -26,12 +26,30 @@ extern "C" {
 #include <odp_ring_internal.h>
 #include <odp/api/plat/strong_types.h>
 
+/* Thread local buffer cache */
 typedef struct pool_cache_t {
+	/* Number of buffers in the cache */
 	uint32_t num;
 
-	odp_buffer_t buf[CONFIG_POOL_CACHE_SIZE];
+	/* Working size of the cache. Adapts to the alloc/free pattern of
+	 * the thread, between pool cache minimum and maximum size. */
+	uint32_t size;
 
-} pool_cache_t ODP_ALIGNED_CACHE;
+	/* Alloc and free calls, cache misses and maximum number of buffers
+	 * in the cache since the last size adaptation */
+	uint32_t ops;
+	uint32_t miss;
+	uint32_t high;
+
+	/* Statistics */
+	uint64_t alloc_hit;
+	uint64_t alloc_miss;
+	uint64_t free_hit;
+	uint64_t free_miss;
+
+	odp_buffer_t buf[];
+
+} pool_cache_t;
 
 /* Buffer header ring */
 typedef struct {
@@ -59,6 +77,7 @@ typedef struct pool_t {
 	uint32_t         headroom;
 	uint32_t         tailroom;
 	uint32_t         data_size;
+	uint32_t         seg_size;
 	uint32_t         max_len;
 	uint32_t         max_seg_len;
 	uint32_t         uarea_size;
@@ -68,11 +87,27 @@ typedef struct pool_t {
 	uint8_t         *base_addr;
 	uint8_t         *uarea_base_addr;
 
-	pool_cache_t     local_cache[ODP_THREAD_COUNT_MAX];
+	/* Thread local caches. Cache of a thread is located at thread id
+	 * times cache stride from the cache base. */
+	odp_shm_t        cache_shm;
+	uint8_t         *cache_base;
+	uint32_t         cache_stride;
+	uint32_t         cache_size;
+	uint32_t         cache_min;
+	uint32_t         cache_refill;
+	uint32_t         cache_flush;
 
 	odp_shm_t        ring_shm;
 	pool_ring_t     *ring;
 
+	/* NUMA nodes. Buffers are divided evenly between nodes, node_num
+	 * buffers per node. Each node has its own ring. Nodes of a pool that
+	 * is not NUMA aware all point to the pool ring. */
+	uint32_t         num_nodes;
+	uint32_t         node_num;
+	odp_shm_t        node_ring_shm[ODP_POOL_MAX_NODES];
+	pool_ring_t     *node_ring[ODP_POOL_MAX_NODES];
+
 } pool_t;
 
 typedef struct pool_table_t {
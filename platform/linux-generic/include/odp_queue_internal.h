@@ -28,6 +28,7 @@ extern "C" {
 #include <odp/api/hints.h>
 #include <odp/api/ticketlock.h>
 #include <odp_config_internal.h>
+#include <odp_ring_internal.h>
 
 #define QUEUE_MULTI_MAX CONFIG_BURST_SIZE
 
@@ -41,6 +42,16 @@ extern "C" {
 /* forward declaration */
 union queue_entry_u;
 
+/* Event ring of a ring based queue */
+typedef struct {
+	/* Ring header */
+	ring_t   hdr;
+
+	/* Ring data: buffer handles */
+	uint32_t buf[CONFIG_QUEUE_MAX_SIZE];
+
+} queue_ring_t ODP_ALIGNED_CACHE;
+
 typedef int (*enq_func_t)(union queue_entry_u *, odp_buffer_hdr_t *);
 typedef	odp_buffer_hdr_t *(*deq_func_t)(union queue_entry_u *);
 
@@ -56,6 +67,10 @@ struct queue_entry_s {
 	odp_buffer_hdr_t *tail;
 	int               status;
 
+	/* Event ring. NULL when the queue is a linked list. */
+	queue_ring_t     *ring;
+	uint32_t          ring_mask;
+
 	struct {
 		odp_atomic_u64_t  ctx; /**< Current ordered context id */
 		odp_atomic_u64_t  next_ctx; /**< Next unallocated context id */
@@ -169,6 +169,58 @@ static inline void ring_enq_multi(ring_t *ring, uint32_t mask, uint32_t data[],
 	odp_atomic_store_rel_u32(&ring->w_tail, old_head + num);
 }
 
+/* Enqueue multiple data into the ring tail, but not more than there is free
+ * space in the ring. Ring size is mask + 1. Returns the number of data
+ * enqueued. */
+static inline uint32_t ring_try_enq_multi(ring_t *ring, uint32_t mask,
+					  uint32_t data[], uint32_t num)
+{
+	uint32_t old_head, new_head, r_tail, num_free, i;
+	uint32_t size = mask + 1;
+
+	old_head = odp_atomic_load_u32(&ring->w_head);
+
+	/* Reserve slots in the ring for writing */
+	do {
+		r_tail   = odp_atomic_load_acq_u32(&ring->r_tail);
+		num_free = size - (old_head - r_tail);
+
+		/* Ring is full */
+		if (num_free == 0)
+			return 0;
+
+		if (num > num_free)
+			num = num_free;
+
+		new_head = old_head + num;
+
+	} while (odp_unlikely(odp_atomic_cas_acq_u32(&ring->w_head, &old_head,
+			      new_head) == 0));
+
+	/* Write data */
+	for (i = 0; i < num; i++)
+		ring->data[(old_head + 1 + i) & mask] = data[i];
+
+	/* Wait until other writers have updated the tail */
+	while (odp_unlikely(odp_atomic_load_acq_u32(&ring->w_tail) != old_head))
+		odp_cpu_pause();
+
+	/* Now update the writer tail */
+	odp_atomic_store_rel_u32(&ring->w_tail, new_head);
+
+	return num;
+}
+
+/* Number of data in the ring. The value is a snapshot, which may be
+ * outdated when concurrent enqueues or dequeues are in progress. */
+static inline uint32_t ring_len(ring_t *ring)
+{
+	uint32_t r_tail = odp_atomic_load_acq_u32(&ring->r_tail);
+	uint32_t w_tail = odp_atomic_load_acq_u32(&ring->w_tail);
+
+	return w_tail - r_tail;
+}
+
 #ifdef __cplusplus
 }
 #endif
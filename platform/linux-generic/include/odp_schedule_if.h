@@ -14,9 +14,11 @@ extern "C" {
 #include <odp/api/queue.h>
 #include <odp_queue_internal.h>
 #include <odp/api/schedule.h>
+#include <odp/api/packet_io.h>
 
 typedef void (*schedule_pktio_start_fn_t)(int pktio_index, int num_in_queue,
-					  int in_queue_idx[]);
+					  int in_queue_idx[],
+					  const odp_pktin_poll_affinity_t *aff);
 typedef int (*schedule_thr_add_fn_t)(odp_schedule_group_t group, int thr);
 typedef int (*schedule_thr_rem_fn_t)(odp_schedule_group_t group, int thr);
 typedef int (*schedule_num_grps_fn_t)(void);
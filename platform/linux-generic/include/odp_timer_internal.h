@@ -35,4 +35,8 @@ typedef struct {
 	odp_timer_t timer;
 } odp_timeout_hdr_t;
 
+/* Expire timers of inline driven timer pools. Called by threads in the
+ * scheduler when there are no events. */
+void _odp_timer_run_inline(void);
+
 #endif
@@ -39,6 +39,11 @@ typedef struct stat  file_stat_t;
 
 #define INPUT_WORK_RING_SIZE  (16 * 1024)
 
+/* Maximum and default number of input work items processed, timers expired
+ * and pkts transmitted per tm_system per service thread loop iteration. */
+#define TM_MAX_BURST      64
+#define TM_DEFAULT_BURST  16
+
 #define TM_QUEUE_MAGIC_NUM   0xBABEBABE
 #define TM_NODE_MAGIC_NUM    0xBEEFBEEF
 
@@ -367,7 +372,6 @@ struct tm_system_s {
 	_odp_tm_group_t odp_tm_group;
 
 	odp_ticketlock_t tm_system_lock;
-	odp_barrier_t    tm_system_destroy_barrier;
 	odp_atomic_u64_t destroying;
 	_odp_int_name_t  name_tbl_id;
 
@@ -396,6 +400,9 @@ struct tm_system_s {
 
 	tm_random_data_t tm_random_data;
 	odp_pktout_queue_t pktout;
+	uint32_t     burst;
+	uint32_t     num_egress_pkts;
+	odp_packet_t egress_pkts[TM_MAX_BURST];
 	uint64_t   current_time;
 	uint8_t    tm_idx;
 	uint8_t    first_enq;
@@ -408,8 +415,15 @@ struct tm_system_s {
 
 /* A tm_system_group is a set of 1 to N tm_systems that share some processing
  * resources - like a bunch of service threads, input queue, timers, etc.
- * Currently a tm_system_group only supports a single service thread - and
- * while the input work queue is shared - timers are not. */
+ * Currently a tm_system_group only supports a single service thread, pinned
+ * to its own cpu - and neither the input work queues nor the timers are
+ * shared.  Independent tm_systems are spread over different tm_system_groups
+ * (and so different cpus) as long as there are cpus left.
+ *
+ * Threads that need to change the state seen by the service thread (e.g.
+ * profile updates, adding or removing tm_systems) first park the service
+ * thread using the request/serving/done counters below.  A tm_group is
+ * unlinked from tm_group_list before its service thread is told to exit. */
 
 struct tm_system_group_s {
 	tm_system_group_t *prev;
@@ -418,9 +432,16 @@ struct tm_system_group_s {
 	odp_barrier_t  tm_group_barrier;
 	tm_system_t   *first_tm_system;
 	uint32_t       num_tm_systems;
-	uint32_t       first_enq;
+	odp_atomic_u32_t first_enq;
 	pthread_t      thread;
 	pthread_attr_t attr;
+	int            cpu;
+	odp_atomic_u32_t thread_exit;
+
+	odp_bool_t       requested;
+	odp_atomic_u64_t request_cnt;
+	odp_atomic_u64_t serving_cnt;
+	odp_atomic_u64_t done_cnt;
 };
 
 #ifdef __cplusplus
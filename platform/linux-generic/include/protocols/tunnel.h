@@ -0,0 +1,130 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP tunnel headers (VXLAN, GTP-U, GRE, MPLS)
+ */
+
+#ifndef ODP_TUNNEL_H_
+#define ODP_TUNNEL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp_api.h>
+
+/** @addtogroup odp_header ODP HEADER
+ *  @{
+ */
+
+/** VXLAN UDP destination port */
+#define _ODP_UDP_PORT_VXLAN 4789
+
+/** VXLAN header length */
+#define _ODP_VXLANHDR_LEN 8
+
+/** VXLAN flags: VNI present */
+#define _ODP_VXLAN_FLAG_I 0x08
+
+/** VXLAN header */
+typedef struct ODP_PACKED {
+	uint8_t     flags;     /**< Flags */
+	uint8_t     rsvd0[3];  /**< Reserved */
+	odp_u32be_t vni_rsvd;  /**< VNI (24 bits) and reserved byte */
+} _odp_vxlanhdr_t;
+
+/** @internal Compile time assert */
+ODP_STATIC_ASSERT(sizeof(_odp_vxlanhdr_t) == _ODP_VXLANHDR_LEN,
+		  "_ODP_VXLANHDR_T__SIZE_ERROR");
+
+/** GTP-U UDP destination port */
+#define _ODP_UDP_PORT_GTPU 2152
+
+/** GTP-U header length without optional fields */
+#define _ODP_GTPUHDR_LEN 8
+
+/** GTP-U header length with optional fields */
+#define _ODP_GTPUHDR_OPT_LEN 12
+
+/** GTP version 1, protocol type GTP */
+#define _ODP_GTPU_VER_PT 0x30
+
+/** GTP-U flags: extension header, sequence number or N-PDU number present */
+#define _ODP_GTPU_FLAG_OPT 0x07
+
+/** GTP-U flags: extension header present */
+#define _ODP_GTPU_FLAG_E 0x04
+
+/** GTP-U message type of user data (G-PDU) */
+#define _ODP_GTPU_MSG_GPDU 0xFF
+
+/** GTP-U header */
+typedef struct ODP_PACKED {
+	uint8_t     flags;     /**< Version, PT and E/S/PN flags */
+	uint8_t     msg_type;  /**< Message type */
+	odp_u16be_t length;    /**< Length after the mandatory header */
+	odp_u32be_t teid;      /**< Tunnel endpoint identifier */
+} _odp_gtpuhdr_t;
+
+/** @internal Compile time assert */
+ODP_STATIC_ASSERT(sizeof(_odp_gtpuhdr_t) == _ODP_GTPUHDR_LEN,
+		  "_ODP_GTPUHDR_T__SIZE_ERROR");
+
+/** GRE header length without optional fields */
+#define _ODP_GREHDR_LEN 4
+
+/** GRE flags: checksum present */
+#define _ODP_GRE_FLAG_C 0x8000
+
+/** GRE flags: key present */
+#define _ODP_GRE_FLAG_K 0x2000
+
+/** GRE flags: sequence number present */
+#define _ODP_GRE_FLAG_S 0x1000
+
+/** GRE flags: version mask */
+#define _ODP_GRE_VER_MASK 0x0007
+
+/** GRE protocol type of transparent Ethernet bridging (NVGRE) */
+#define _ODP_GRE_PROTO_TEB 0x6558
+
+/** GRE header */
+typedef struct ODP_PACKED {
+	odp_u16be_t flags_ver; /**< Flags and version */
+	odp_u16be_t proto;     /**< Protocol type of the payload */
+} _odp_grehdr_t;
+
+/** @internal Compile time assert */
+ODP_STATIC_ASSERT(sizeof(_odp_grehdr_t) == _ODP_GREHDR_LEN,
+		  "_ODP_GREHDR_T__SIZE_ERROR");
+
+/** MPLS label stack entry length */
+#define _ODP_MPLSHDR_LEN 4
+
+/** MPLS label stack entry: bottom of stack */
+#define _ODP_MPLS_BOS 0x00000100
+
+/** MPLS label stack entry */
+typedef struct ODP_PACKED {
+	odp_u32be_t label_exp_s_ttl; /**< Label, TC, S bit and TTL */
+} _odp_mplshdr_t;
+
+/** @internal Compile time assert */
+ODP_STATIC_ASSERT(sizeof(_odp_mplshdr_t) == _ODP_MPLSHDR_LEN,
+		  "_ODP_MPLSHDR_T__SIZE_ERROR");
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -17,6 +17,10 @@
 #include <odp_classification_inlines.h>
 #include <odp_classification_internal.h>
 #include <odp/api/shared_memory.h>
+#include <odp/api/hash.h>
+#include <odp/api/hints.h>
+#include <odp/api/sync.h>
+#include <odp/api/cpu.h>
 #include <protocols/eth.h>
 #include <protocols/ip.h>
 #include <string.h>
@@ -31,6 +35,62 @@
 static cos_tbl_t *cos_tbl;
 static pmr_tbl_t	*pmr_tbl;
 
+static inline void cls_stats_inc(odp_cls_stats_t *stats, uint32_t len)
+{
+	stats->packets++;
+	stats->octets += len;
+}
+
+static void cls_stats_clear(odp_cls_stats_t *stats)
+{
+	stats->packets = 0;
+	stats->octets = 0;
+}
+
+static void cls_stats_sum(odp_cls_stats_t *sum, const odp_cls_stats_t *stats)
+{
+	sum->packets += stats->packets;
+	sum->octets += stats->octets;
+}
+
+/* Start lock-free rule matching. Only this thread writes the sequence
+ * number, so stores and a local barrier are enough. */
+static inline uint32_t cls_thr_enter(cls_thr_t *thr)
+{
+	uint32_t seq = odp_atomic_load_u32(&thr->seq);
+
+	odp_atomic_store_u32(&thr->seq, seq + 1);
+	odp_mb_full();
+
+	return seq;
+}
+
+static inline void cls_thr_exit(cls_thr_t *thr, uint32_t seq)
+{
+	odp_atomic_store_rel_u32(&thr->seq, seq + 2);
+}
+
+/* Wait until threads that may have seen removed PMRs or tuples have
+ * finished rule matching. Called after unlink, before slots are reused. */
+static void cls_thr_wait(void)
+{
+	uint32_t seq;
+	int i;
+
+	/* Pairs with the barrier in cls_thr_enter() */
+	odp_mb_full();
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		seq = odp_atomic_load_acq_u32(&pmr_tbl->thr[i].seq);
+
+		if ((seq & 1) == 0)
+			continue;
+
+		while (odp_atomic_load_acq_u32(&pmr_tbl->thr[i].seq) == seq)
+			odp_cpu_pause();
+	}
+}
+
 cos_t *get_cos_entry_internal(odp_cos_t cos_id)
 {
 	return &cos_tbl->cos_entry[_odp_typeval(cos_id)];
@@ -88,6 +148,9 @@ int odp_classification_init_global(void)
 			get_pmr_entry_internal(_odp_cast_scalar(odp_pmr_t, i));
 		LOCK_INIT(&pmr->s.lock);
 	}
+	LOCK_INIT(&pmr_tbl->lock);
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		odp_atomic_init_u32(&pmr_tbl->thr[i].seq, 0);
 
 	return 0;
 
@@ -101,6 +164,7 @@ error:
 
 int odp_classification_term_global(void)
 {
+	odp_shm_t shm;
 	int ret = 0;
 	int rc = 0;
 
@@ -116,6 +180,12 @@ int odp_classification_term_global(void)
 		rc = -1;
 	}
 
+	shm = odp_shm_lookup("shm_odp_cls_stats");
+	if (shm != ODP_SHM_INVALID && odp_shm_free(shm) < 0) {
+		ODP_ERR("shm free failed for shm_odp_cls_stats");
+		rc = -1;
+	}
+
 	return rc;
 }
 
@@ -151,15 +221,68 @@ int odp_cls_capability(odp_cls_capability_t *capability)
 	capability->supported_terms.bit.tcp_sport = 1;
 	capability->supported_terms.bit.sip_addr = 1;
 	capability->supported_terms.bit.dip_addr = 1;
+	capability->supported_terms.bit.ld_vni = 1;
+	return 0;
+}
+
+/* Statistics table is large, reserve it only when classification is used.
+ * Lookups store the table pointer in shared memory, so the table is mapped
+ * to the same address in all processes. */
+static int cls_stats_tbl_reserve(void)
+{
+	cls_stats_tbl_t *stats;
+
+	LOCK(&pmr_tbl->lock);
+
+	if (cos_tbl->stats == NULL) {
+		stats = odp_shm_addr(odp_shm_reserve("shm_odp_cls_stats",
+						     sizeof(cls_stats_tbl_t),
+						     ODP_CACHE_LINE_SIZE,
+						     ODP_SHM_SINGLE_VA));
+		if (stats) {
+			memset(stats, 0, sizeof(cls_stats_tbl_t));
+			odp_mb_release();
+			cos_tbl->stats = stats;
+		}
+	}
+
+	UNLOCK(&pmr_tbl->lock);
+
+	if (cos_tbl->stats == NULL) {
+		ODP_ERR("shm allocation failed for shm_odp_cls_stats");
+		return -1;
+	}
+
 	return 0;
 }
 
+/* Clear statistics of a destroyed PMR or CoS. Called after cls_thr_wait(),
+ * when no thread updates the counters anymore. */
+static void cls_pmr_stats_clear(uint32_t idx)
+{
+	int i;
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		cls_stats_clear(&cos_tbl->stats->thr[i].pmr[idx]);
+}
+
+static void cls_cos_stats_clear(uint32_t idx)
+{
+	int i;
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		cls_stats_clear(&cos_tbl->stats->thr[i].cos[idx]);
+}
+
 odp_cos_t odp_cls_cos_create(const char *name, odp_cls_cos_param_t *param)
 {
-	int i, j;
+	int i;
 	queue_entry_t *queue;
 	odp_cls_drop_t drop_policy;
 
+	if (odp_unlikely(cos_tbl->stats == NULL) && cls_stats_tbl_reserve())
+		return ODP_COS_INVALID;
+
 	/* Packets are dropped if Queue or Pool is invalid*/
 	if (param->queue == ODP_QUEUE_INVALID)
 		queue = NULL;
@@ -179,10 +302,8 @@ odp_cos_t odp_cls_cos_create(const char *name, odp_cls_cos_param_t *param)
 				strncpy(cos_name, name, ODP_COS_NAME_LEN - 1);
 				cos_name[ODP_COS_NAME_LEN - 1] = 0;
 			}
-			for (j = 0; j < ODP_PMR_PER_COS_MAX; j++) {
-				cos_tbl->cos_entry[i].s.pmr[j] = NULL;
-				cos_tbl->cos_entry[i].s.linked_cos[j] = NULL;
-			}
+			cos_tbl->cos_entry[i].s.slow_pmr = NULL;
+			cos_tbl->cos_entry[i].s.num_tuple = 0;
 			cos_tbl->cos_entry[i].s.queue = queue;
 			cos_tbl->cos_entry[i].s.pool = param->pool;
 			cos_tbl->cos_entry[i].s.headroom = 0;
@@ -208,8 +329,8 @@ odp_pmr_t alloc_pmr(pmr_t **pmr)
 		LOCK(&pmr_tbl->pmr[i].s.lock);
 		if (0 == pmr_tbl->pmr[i].s.valid) {
 			pmr_tbl->pmr[i].s.valid = 1;
-			odp_atomic_init_u32(&pmr_tbl->pmr[i].s.count, 0);
 			pmr_tbl->pmr[i].s.num_pmr = 0;
+			pmr_tbl->pmr[i].s.linked = 0;
 			*pmr = &pmr_tbl->pmr[i];
 			/* return as locked */
 			return _odp_cast_scalar(odp_pmr_t, i);
@@ -240,16 +361,269 @@ pmr_t *get_pmr_entry(odp_pmr_t pmr_id)
 	return &pmr_tbl->pmr[_odp_typeval(pmr_id)];
 }
 
+static inline uint32_t cls_term_words(odp_cls_pmr_term_t term)
+{
+	if (term == ODP_PMR_SIP6_ADDR || term == ODP_PMR_DIP6_ADDR)
+		return 2;
+
+	return 1;
+}
+
+static inline uint32_t cls_key_hash(cos_t *cos, uint32_t tuple,
+				    const uint64_t key[], uint32_t words)
+{
+	uint32_t seed = ((uint32_t)(cos - cos_tbl->cos_entry) << 8) | tuple;
+
+	return odp_hash_crc32c(key, words * sizeof(uint64_t), seed);
+}
+
+/* PMR term can be matched as a part of a tuple key */
+static int cls_term_exact(const pmr_term_value_t *value)
+{
+	if (value->range_term)
+		return 0;
+
+	switch (value->term) {
+	case ODP_PMR_LEN:
+	case ODP_PMR_IPPROTO:
+	case ODP_PMR_SIP_ADDR:
+	case ODP_PMR_DIP_ADDR:
+	case ODP_PMR_TCP_SPORT:
+	case ODP_PMR_TCP_DPORT:
+	case ODP_PMR_UDP_SPORT:
+	case ODP_PMR_UDP_DPORT:
+	case ODP_PMR_DMAC:
+	case ODP_PMR_SIP6_ADDR:
+	case ODP_PMR_DIP6_ADDR:
+	case ODP_PMR_IPSEC_SPI:
+	case ODP_PMR_LD_VNI:
+	case ODP_PMR_INNER_HDR_OFF:
+		return 1;
+	case ODP_PMR_CUSTOM_FRAME:
+		return value->val_sz <= sizeof(uint64_t);
+	default:
+		return 0;
+	}
+}
+
+static int cls_tuple_term_cmp(const cls_tuple_term_t *a,
+			      const cls_tuple_term_t *b)
+{
+	if (a->term != b->term)
+		return a->term < b->term ? -1 : 1;
+	if (a->offset != b->offset)
+		return a->offset < b->offset ? -1 : 1;
+	if (a->val_sz != b->val_sz)
+		return a->val_sz < b->val_sz ? -1 : 1;
+	if (a->mask[0] != b->mask[0])
+		return a->mask[0] < b->mask[0] ? -1 : 1;
+	if (a->mask[1] != b->mask[1])
+		return a->mask[1] < b->mask[1] ? -1 : 1;
+
+	return 0;
+}
+
+/* Build tuple terms and key of a PMR. Terms are sorted, so that PMRs
+ * matching on the same fields share a tuple regardless of the term order.
+ * Returns the number of tuple terms, or -1 when the PMR has to be verified
+ * term by term. */
+static int cls_pmr_tuple_build(pmr_t *pmr, cls_tuple_term_t term[])
+{
+	uint64_t key[ODP_PMRTERM_MAX][2];
+	cls_tuple_term_t tmp;
+	const pmr_term_value_t *value;
+	uint32_t i, j, w;
+	int num = 0;
+
+	for (i = 0; i < pmr->s.num_pmr; i++) {
+		uint64_t val[2];
+
+		value = &pmr->s.pmr_term_value[i];
+		if (!cls_term_exact(value))
+			return -1;
+		if (value->term == ODP_PMR_INNER_HDR_OFF)
+			continue;
+
+		memset(&tmp, 0, sizeof(tmp));
+		tmp.term = value->term;
+		if (cls_term_words(value->term) == 2) {
+			tmp.mask[0] = value->match_ipv6.mask.u64[0];
+			tmp.mask[1] = value->match_ipv6.mask.u64[1];
+			val[0] = value->match_ipv6.addr.u64[0];
+			val[1] = value->match_ipv6.addr.u64[1];
+		} else {
+			tmp.mask[0] = value->match.mask;
+			val[0] = value->match.value;
+			val[1] = 0;
+		}
+		if (value->term == ODP_PMR_CUSTOM_FRAME) {
+			tmp.offset = value->offset;
+			tmp.val_sz = value->val_sz;
+		}
+
+		for (j = num; j > 0; j--) {
+			if (cls_tuple_term_cmp(&term[j - 1], &tmp) <= 0)
+				break;
+			term[j] = term[j - 1];
+			key[j][0] = key[j - 1][0];
+			key[j][1] = key[j - 1][1];
+		}
+		term[j] = tmp;
+		key[j][0] = val[0];
+		key[j][1] = val[1];
+		num++;
+	}
+
+	w = 0;
+	for (i = 0; i < (uint32_t)num; i++) {
+		pmr->s.key[w++] = key[i][0];
+		if (cls_term_words(term[i].term) == 2)
+			pmr->s.key[w++] = key[i][1];
+	}
+	pmr->s.key_words = w;
+
+	return num;
+}
+
+/* Find or allocate the tuple of a CoS. Returns CLS_TUPLE_NONE when
+ * all tuple slots are in use. */
+static uint32_t cls_tuple_find(cos_t *cos, const cls_tuple_term_t term[],
+			       uint32_t num)
+{
+	cls_tuple_t *tuple;
+	uint32_t free = CLS_TUPLE_NONE;
+	uint32_t i, j;
+
+	for (i = 0; i < cos->s.num_tuple; i++) {
+		tuple = &cos->s.tuple[i];
+		if (tuple->num_rule == 0) {
+			if (free == CLS_TUPLE_NONE)
+				free = i;
+			continue;
+		}
+		if (tuple->num_term != num)
+			continue;
+		for (j = 0; j < num; j++)
+			if (cls_tuple_term_cmp(&tuple->term[j], &term[j]))
+				break;
+		if (j == num)
+			return i;
+	}
+
+	if (free == CLS_TUPLE_NONE) {
+		if (cos->s.num_tuple == CLS_TUPLE_PER_COS_MAX)
+			return CLS_TUPLE_NONE;
+		free = cos->s.num_tuple;
+	}
+
+	tuple = &cos->s.tuple[free];
+	for (j = 0; j < num; j++)
+		tuple->term[j] = term[j];
+	tuple->num_term = num;
+	odp_mb_release();
+
+	if (free == cos->s.num_tuple)
+		cos->s.num_tuple++;
+
+	return free;
+}
+
+/* Compile a PMR into its source CoS. Exact match PMRs are inserted into
+ * the PMR hash table, others are appended to the slow list of the CoS.
+ * Called with the CoS lock held. */
+static void cls_pmr_link(cos_t *cos, pmr_t *pmr)
+{
+	cls_tuple_term_t term[ODP_PMRTERM_MAX];
+	pmr_t **bucket;
+	pmr_t **prev;
+	uint32_t t = CLS_TUPLE_NONE;
+	int num;
+
+	num = cls_pmr_tuple_build(pmr, term);
+	if (num >= 0)
+		t = cls_tuple_find(cos, term, num);
+
+	pmr->s.tuple = t;
+	pmr->s.next = NULL;
+	pmr->s.linked = 1;
+
+	if (t == CLS_TUPLE_NONE) {
+		prev = &cos->s.slow_pmr;
+		while (*prev)
+			prev = &(*prev)->s.next;
+		odp_mb_release();
+		*prev = pmr;
+	} else {
+		pmr->s.hash = cls_key_hash(cos, t, pmr->s.key,
+					   pmr->s.key_words);
+		bucket = &pmr_tbl->bucket[pmr->s.hash &
+					  (CLS_PMR_HASH_SIZE - 1)];
+		LOCK(&pmr_tbl->lock);
+		pmr->s.next = *bucket;
+		odp_mb_release();
+		*bucket = pmr;
+		UNLOCK(&pmr_tbl->lock);
+		cos->s.tuple[t].num_rule++;
+	}
+
+	odp_atomic_inc_u32(&cos->s.num_rule);
+}
+
+/* Remove a PMR from its source CoS. Called with the CoS lock held. Readers
+ * may still refer to the PMR until cls_thr_wait() returns. */
+static void cls_pmr_unlink(pmr_t *pmr)
+{
+	cos_t *cos = pmr->s.src_cos;
+	uint32_t t = pmr->s.tuple;
+	pmr_t **prev;
+
+	if (!pmr->s.linked)
+		return;
+
+	if (t == CLS_TUPLE_NONE) {
+		prev = &cos->s.slow_pmr;
+	} else {
+		cos->s.tuple[t].num_rule--;
+		LOCK(&pmr_tbl->lock);
+		prev = &pmr_tbl->bucket[pmr->s.hash & (CLS_PMR_HASH_SIZE - 1)];
+	}
+
+	while (*prev && *prev != pmr)
+		prev = &(*prev)->s.next;
+	if (*prev)
+		*prev = pmr->s.next;
+
+	if (t != CLS_TUPLE_NONE)
+		UNLOCK(&pmr_tbl->lock);
+
+	pmr->s.linked = 0;
+	odp_atomic_dec_u32(&cos->s.num_rule);
+}
+
 int odp_cos_destroy(odp_cos_t cos_id)
 {
 	cos_t *cos = get_cos_entry(cos_id);
+	pmr_t *pmr;
+	int i;
 
 	if (NULL == cos) {
 		ODP_ERR("Invalid odp_cos_t handle");
 		return -1;
 	}
 
+	LOCK(&cos->s.lock);
+	/* PMRs attached to the CoS are not matched anymore */
+	for (i = 0; i < ODP_PMR_MAX_ENTRY; i++) {
+		pmr = &pmr_tbl->pmr[i];
+		if (pmr->s.valid && pmr->s.src_cos == cos)
+			cls_pmr_unlink(pmr);
+	}
+	/* PMRs leading to an invalid CoS are skipped. CoS lock is held until
+	 * readers have quiesced, so that the slot is not reused before. */
 	cos->s.valid = 0;
+	cls_thr_wait();
+	cls_cos_stats_clear(_odp_typeval(cos_id));
+	UNLOCK(&cos->s.lock);
 	return 0;
 }
 
@@ -495,9 +869,7 @@ static int odp_pmr_create_term(pmr_term_value_t *value,
 int odp_cls_pmr_destroy(odp_pmr_t pmr_id)
 {
 	cos_t *src_cos;
-	uint32_t loc;
 	pmr_t *pmr;
-	uint8_t i;
 
 	pmr = get_pmr_entry(pmr_id);
 	if (pmr == NULL || pmr->s.src_cos == NULL)
@@ -505,18 +877,9 @@ int odp_cls_pmr_destroy(odp_pmr_t pmr_id)
 
 	src_cos = pmr->s.src_cos;
 	LOCK(&src_cos->s.lock);
-	loc = odp_atomic_load_u32(&src_cos->s.num_rule);
-	if (loc == 0)
-		goto no_rule;
-	loc -= 1;
-	for (i = 0; i <= loc; i++)
-		if (src_cos->s.pmr[i] == pmr) {
-			src_cos->s.pmr[i] = src_cos->s.pmr[loc];
-			src_cos->s.linked_cos[i] = src_cos->s.linked_cos[loc];
-		}
-	odp_atomic_dec_u32(&src_cos->s.num_rule);
-
-no_rule:
+	cls_pmr_unlink(pmr);
+	cls_thr_wait();
+	cls_pmr_stats_clear(_odp_typeval(pmr_id));
 	pmr->s.valid = 0;
 	UNLOCK(&src_cos->s.lock);
 	return 0;
@@ -529,7 +892,6 @@ odp_pmr_t odp_cls_pmr_create(const odp_pmr_param_t *terms, int num_terms,
 	int i;
 	odp_pmr_t id;
 	int val_sz;
-	uint32_t loc;
 	cos_t *cos_src = get_cos_entry(src_cos);
 	cos_t *cos_dst = get_cos_entry(dst_cos);
 
@@ -543,9 +905,6 @@ odp_pmr_t odp_cls_pmr_create(const odp_pmr_param_t *terms, int num_terms,
 		return ODP_PMR_INVAL;
 	}
 
-	if (ODP_PMR_PER_COS_MAX == odp_atomic_load_u32(&cos_src->s.num_rule))
-		return ODP_PMR_INVAL;
-
 	id = alloc_pmr(&pmr);
 	/*if alloc_pmr is successful it returns with the acquired lock*/
 	if (id == ODP_PMR_INVAL)
@@ -554,21 +913,25 @@ odp_pmr_t odp_cls_pmr_create(const odp_pmr_param_t *terms, int num_terms,
 	pmr->s.num_pmr = num_terms;
 	for (i = 0; i < num_terms; i++) {
 		val_sz = terms[i].val_sz;
-		if (val_sz > ODP_PMR_TERM_BYTES_MAX) {
-			pmr->s.valid = 0;
-			return ODP_PMR_INVAL;
-		}
-		if (0 > odp_pmr_create_term(&pmr->s.pmr_term_value[i],
+		if (val_sz > ODP_PMR_TERM_BYTES_MAX ||
+		    0 > odp_pmr_create_term(&pmr->s.pmr_term_value[i],
 					    &terms[i])) {
+			pmr->s.valid = 0;
 			UNLOCK(&pmr->s.lock);
 			return ODP_PMR_INVAL;
 		}
 	}
 
-	loc = odp_atomic_fetch_inc_u32(&cos_src->s.num_rule);
-	cos_src->s.pmr[loc] = pmr;
-	cos_src->s.linked_cos[loc] = cos_dst;
 	pmr->s.src_cos = cos_src;
+	pmr->s.dst_cos = cos_dst;
+
+	LOCK(&pmr_tbl->lock);
+	pmr->s.seq = pmr_tbl->seq++;
+	UNLOCK(&pmr_tbl->lock);
+
+	LOCK(&cos_src->s.lock);
+	cls_pmr_link(cos_src, pmr);
+	UNLOCK(&cos_src->s.lock);
 
 	UNLOCK(&pmr->s.lock);
 	return id;
@@ -716,38 +1079,68 @@ int verify_pmr(pmr_t *pmr, const uint8_t *pkt_addr, odp_packet_hdr_t *pkt_hdr)
 		if (pmr_failure)
 			return false;
 	}
-	odp_atomic_inc_u32(&pmr->s.count);
 	return true;
 }
 
-cos_t *match_pmr_cos(cos_t *cos, const uint8_t *pkt_addr, pmr_t *pmr,
-		     odp_packet_hdr_t *hdr)
+/* Find the first PMR of a CoS that matches the packet. All tuples are
+ * checked with one hash lookup each, after which only slow list PMRs created
+ * before the best tuple match need to be verified. PMRs leading to an invalid
+ * CoS are skipped. */
+static pmr_t *cls_match_pmr(cos_t *cos, const uint8_t *pkt_addr,
+			    odp_packet_hdr_t *pkt_hdr)
 {
-	cos_t *retcos;
-	uint32_t i;
-
-	retcos  = NULL;
-
-	if (cos == NULL || pmr == NULL)
-		return NULL;
+	uint64_t key[CLS_KEY_WORDS];
+	uint64_t val[2];
+	const cls_tuple_t *tuple;
+	const cls_tuple_term_t *term;
+	pmr_t *match = NULL;
+	pmr_t *pmr;
+	uint32_t num_tuple, t, i, words, hash;
 
-	if (!cos->s.valid)
+	if (odp_atomic_load_u32(&cos->s.num_rule) == 0)
 		return NULL;
 
-	if (verify_pmr(pmr, pkt_addr, hdr)) {
-		/** This gets called recursively to check all the PMRs in
-		 * a PMR chain */
-		if (0 == odp_atomic_load_u32(&cos->s.num_rule))
-			return cos;
-
-		for (i = 0; i < odp_atomic_load_u32(&cos->s.num_rule); i++) {
-			retcos = match_pmr_cos(cos->s.linked_cos[i], pkt_addr,
-					       cos->s.pmr[i], hdr);
-			if (!retcos)
-				return cos;
+	num_tuple = cos->s.num_tuple;
+	for (t = 0; t < num_tuple; t++) {
+		tuple = &cos->s.tuple[t];
+		if (tuple->num_rule == 0)
+			continue;
+
+		words = 0;
+		for (i = 0; i < tuple->num_term; i++) {
+			term = &tuple->term[i];
+			if (!cls_tuple_field(pkt_addr, pkt_hdr, term, val))
+				break;
+			key[words++] = val[0] & term->mask[0];
+			if (cls_term_words(term->term) == 2)
+				key[words++] = val[1] & term->mask[1];
+		}
+		if (i < tuple->num_term)
+			continue;
+
+		hash = cls_key_hash(cos, t, key, words);
+		pmr = pmr_tbl->bucket[hash & (CLS_PMR_HASH_SIZE - 1)];
+		for (; pmr != NULL; pmr = pmr->s.next) {
+			if (pmr->s.hash != hash || pmr->s.src_cos != cos ||
+			    pmr->s.tuple != t ||
+			    memcmp(pmr->s.key, key, words * sizeof(uint64_t)))
+				continue;
+			if (!pmr->s.dst_cos->s.valid)
+				continue;
+			if (match == NULL || pmr->s.seq < match->s.seq)
+				match = pmr;
 		}
 	}
-	return retcos;
+
+	for (pmr = cos->s.slow_pmr; pmr != NULL; pmr = pmr->s.next) {
+		if (match && pmr->s.seq > match->s.seq)
+			break;
+		if (pmr->s.dst_cos->s.valid &&
+		    verify_pmr(pmr, pkt_addr, pkt_hdr))
+			return pmr;
+	}
+
+	return match;
 }
 
 int pktio_classifier_init(pktio_entry_t *entry)
@@ -779,12 +1172,13 @@ Returns the error_cos if the packet has an error
 **/
 static inline cos_t *cls_select_cos(pktio_entry_t *entry,
 				    const uint8_t *pkt_addr,
-				    odp_packet_hdr_t *pkt_hdr)
+				    odp_packet_hdr_t *pkt_hdr,
+				    cls_thr_stats_t *stats)
 {
 	pmr_t *pmr;
 	cos_t *cos;
 	cos_t *default_cos;
-	uint32_t i;
+	int depth;
 	classifier_t *cls;
 
 	cls = &entry->s.cls;
@@ -797,14 +1191,19 @@ static inline cos_t *cls_select_cos(pktio_entry_t *entry,
 	/* Return error cos for error packet */
 	if (pkt_hdr->p.error_flags.all)
 		return cls->error_cos;
-	/* Calls all the PMRs attached at the PKTIO level*/
-	for (i = 0; i < odp_atomic_load_u32(&default_cos->s.num_rule); i++) {
-		pmr = default_cos->s.pmr[i];
-		cos = default_cos->s.linked_cos[i];
-		cos = match_pmr_cos(cos, pkt_addr, pmr, pkt_hdr);
-		if (cos)
-			return cos;
+	/* Follow the first matching PMR of each CoS, starting from the PMRs
+	 * attached at the PKTIO level */
+	cos = default_cos;
+	for (depth = 0; depth < ODP_COS_MAX_ENTRY; depth++) {
+		pmr = cls_match_pmr(cos, pkt_addr, pkt_hdr);
+		if (pmr == NULL)
+			break;
+		cls_stats_inc(&stats->pmr[pmr - pmr_tbl->pmr],
+			      packet_len(pkt_hdr));
+		cos = pmr->s.dst_cos;
 	}
+	if (cos != default_cos)
+		return cos;
 
 	cos = match_qos_cos(entry, pkt_addr, pkt_hdr);
 	if (cos)
@@ -813,6 +1212,37 @@ static inline cos_t *cls_select_cos(pktio_entry_t *entry,
 	return cls->default_cos;
 }
 
+/* Parse a packet for classification */
+static inline void cls_parse(odp_packet_hdr_t *pkt_hdr, const uint8_t *base,
+			     uint16_t pkt_len, uint32_t seg_len)
+{
+	packet_parse_reset(pkt_hdr);
+	packet_set_len(pkt_hdr, pkt_len);
+	packet_parse_common(&pkt_hdr->p, base, pkt_len, seg_len, LAYER_ALL);
+}
+
+/* Set pool and destination queue of a packet from the selected CoS. Pool is
+ * ODP_POOL_INVALID when the packet must be dropped. */
+static inline int cls_cos_apply(cos_t *cos, cls_thr_stats_t *stats,
+				uint16_t pkt_len, odp_pool_t *pool,
+				odp_packet_hdr_t *pkt_hdr)
+{
+	*pool = ODP_POOL_INVALID;
+
+	if (cos == NULL)
+		return -EINVAL;
+
+	if (cos->s.queue == NULL || cos->s.pool == ODP_POOL_INVALID)
+		return -EFAULT;
+
+	cls_stats_inc(&stats->cos[cos - cos_tbl->cos_entry], pkt_len);
+	*pool = cos->s.pool;
+	pkt_hdr->p.input_flags.dst_queue = 1;
+	pkt_hdr->dst_queue = cos->s.queue->s.handle;
+
+	return 0;
+}
+
 /**
  * Classify packet
  *
@@ -833,25 +1263,75 @@ int cls_classify_packet(pktio_entry_t *entry, const uint8_t *base,
 			uint16_t pkt_len, uint32_t seg_len, odp_pool_t *pool,
 			odp_packet_hdr_t *pkt_hdr)
 {
+	cls_thr_stats_t *stats;
+	cls_thr_t *thr;
 	cos_t *cos;
+	uint32_t seq;
+	int ret;
+	int thr_id = odp_thread_id();
 
-	packet_parse_reset(pkt_hdr);
-	packet_set_len(pkt_hdr, pkt_len);
+	cls_parse(pkt_hdr, base, pkt_len, seg_len);
 
-	packet_parse_common(&pkt_hdr->p, base, pkt_len, seg_len, LAYER_ALL);
-	cos = cls_select_cos(entry, base, pkt_hdr);
+	stats = &cos_tbl->stats->thr[thr_id];
+	thr = &pmr_tbl->thr[thr_id];
+	seq = cls_thr_enter(thr);
+	cos = cls_select_cos(entry, base, pkt_hdr, stats);
+	ret = cls_cos_apply(cos, stats, pkt_len, pool, pkt_hdr);
+	cls_thr_exit(thr, seq);
 
-	if (cos == NULL)
-		return -EINVAL;
+	return ret;
+}
 
-	if (cos->s.queue == NULL || cos->s.pool == ODP_POOL_INVALID)
-		return -EFAULT;
+/**
+ * Classify a burst of packets
+ *
+ * All packets are parsed first and rules are evaluated after that, so that
+ * the parser and the rule tables stay in cache over the burst.
+ *
+ * @param pktio_entry	Ingress pktio
+ * @param base		Packet data of each packet
+ * @param pkt_len	Packet length of each packet
+ * @param seg_len	Segment length of each packet
+ * @param num		Number of packets
+ * @param pool[out]	Packet pool of each packet. ODP_POOL_INVALID when the
+ *			packet could not be classified and must be dropped.
+ * @param pkt_hdr[out]	Packet header of each packet
+ *
+ * @return Number of packets classified successfully
+ */
+int cls_classify_packet_multi(pktio_entry_t *entry, uint8_t *const base[],
+			      const uint16_t pkt_len[],
+			      const uint32_t seg_len[], int num,
+			      odp_pool_t pool[], odp_packet_hdr_t pkt_hdr[])
+{
+	int thr_id = odp_thread_id();
+	cls_thr_stats_t *stats = &cos_tbl->stats->thr[thr_id];
+	cls_thr_t *thr = &pmr_tbl->thr[thr_id];
+	cos_t *cos;
+	uint32_t seq;
+	int i;
+	int num_cls = 0;
 
-	*pool = cos->s.pool;
-	pkt_hdr->p.input_flags.dst_queue = 1;
-	pkt_hdr->dst_queue = cos->s.queue->s.handle;
+	for (i = 0; i < num; i++) {
+		if (i + 1 < num)
+			odp_prefetch(base[i + 1]);
 
-	return 0;
+		cls_parse(&pkt_hdr[i], base[i], pkt_len[i], seg_len[i]);
+	}
+
+	seq = cls_thr_enter(thr);
+
+	for (i = 0; i < num; i++) {
+		cos = cls_select_cos(entry, base[i], &pkt_hdr[i], stats);
+
+		if (cls_cos_apply(cos, stats, pkt_len[i], &pool[i],
+				  &pkt_hdr[i]) == 0)
+			num_cls++;
+	}
+
+	cls_thr_exit(thr, seq);
+
+	return num_cls;
 }
 
 cos_t *match_qos_l3_cos(pmr_l3_cos_t *l3_cos, const uint8_t *pkt_addr,
@@ -923,6 +1403,42 @@ cos_t *match_qos_cos(pktio_entry_t *entry, const uint8_t *pkt_addr,
 	return NULL;
 }
 
+int odp_cls_pmr_stats(odp_pmr_t pmr_id, odp_cls_stats_t *stats)
+{
+	uint32_t idx;
+	int i;
+
+	if (get_pmr_entry(pmr_id) == NULL) {
+		ODP_ERR("Invalid odp_pmr_t handle");
+		return -1;
+	}
+
+	idx = _odp_typeval(pmr_id);
+	memset(stats, 0, sizeof(odp_cls_stats_t));
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		cls_stats_sum(stats, &cos_tbl->stats->thr[i].pmr[idx]);
+
+	return 0;
+}
+
+int odp_cls_cos_stats(odp_cos_t cos_id, odp_cls_stats_t *stats)
+{
+	uint32_t idx;
+	int i;
+
+	if (get_cos_entry(cos_id) == NULL) {
+		ODP_ERR("Invalid odp_cos_t handle");
+		return -1;
+	}
+
+	idx = _odp_typeval(cos_id);
+	memset(stats, 0, sizeof(odp_cls_stats_t));
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		cls_stats_sum(stats, &cos_tbl->stats->thr[i].cos[idx]);
+
+	return 0;
+}
+
 uint64_t odp_cos_to_u64(odp_cos_t hdl)
 {
 	return _odp_pri(hdl);
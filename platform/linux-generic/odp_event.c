@@ -12,6 +12,7 @@
 #include <odp/api/pool.h>
 #include <odp_buffer_internal.h>
 #include <odp_buffer_inlines.h>
+#include <odp_packet_vector_internal.h>
 #include <odp_debug_internal.h>
 
 odp_event_type_t odp_event_type(odp_event_t event)
@@ -34,6 +35,9 @@ void odp_event_free(odp_event_t event)
 	case ODP_EVENT_CRYPTO_COMPL:
 		odp_crypto_compl_free(odp_crypto_compl_from_event(event));
 		break;
+	case ODP_EVENT_PACKET_VECTOR:
+		packet_vector_free_all(odp_packet_vector_from_event(event));
+		break;
 	default:
 		ODP_ABORT("Invalid event type: %d\n", odp_event_type(event));
 	}
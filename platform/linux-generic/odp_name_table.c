@@ -374,8 +374,10 @@ static void name_tbl_entry_free(name_tbl_entry_t *name_tbl_entry)
 	if (!entry)
 		return;
 
+	/* Keep the name_tbl_id, since it is fixed for each entry slot. */
 	memset(name_tbl_entry, 0, sizeof(name_tbl_entry_t));
-	name_tbl_entry->next_entry = name_tbl->free_list_head;
+	name_tbl_entry->name_tbl_id = name_tbl_id;
+	name_tbl_entry->next_entry  = name_tbl->free_list_head;
 	name_tbl->free_list_head   = name_tbl_entry;
 }
 
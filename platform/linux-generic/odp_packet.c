@@ -9,10 +9,12 @@
 #include <odp_debug_internal.h>
 #include <odp/api/hints.h>
 #include <odp/api/byteorder.h>
+#include <odp/api/hash.h>
 
 #include <protocols/eth.h>
 #include <protocols/ip.h>
 #include <protocols/tcp.h>
+#include <protocols/tunnel.h>
 #include <protocols/udp.h>
 
 #include <errno.h>
@@ -20,9 +22,6 @@
 #include <stdio.h>
 #include <inttypes.h>
 
-/* Initial packet segment data length */
-#define BASE_LEN  CONFIG_PACKET_MAX_SEG_LEN
-
 static inline odp_packet_t packet_handle(odp_packet_hdr_t *pkt_hdr)
 {
 	return (odp_packet_t)pkt_hdr->buf_hdr.handle.handle;
@@ -46,13 +45,13 @@ static inline uint32_t packet_ref_dec(odp_packet_hdr_t *pkt_hdr)
 static inline uint32_t packet_seg_len(odp_packet_hdr_t *pkt_hdr,
 				      uint32_t seg_idx)
 {
-	return pkt_hdr->buf_hdr.seg[seg_idx].len;
+	return pkt_hdr->seg[seg_idx].len;
 }
 
 static inline uint8_t *packet_seg_data(odp_packet_hdr_t *pkt_hdr,
 				       uint32_t seg_idx)
 {
-	return pkt_hdr->buf_hdr.seg[seg_idx].data;
+	return pkt_hdr->seg[seg_idx].data;
 }
 
 static inline int packet_last_seg(odp_packet_hdr_t *pkt_hdr)
@@ -65,7 +64,7 @@ static inline int packet_last_seg(odp_packet_hdr_t *pkt_hdr)
 
 static inline void *packet_data(odp_packet_hdr_t *pkt_hdr)
 {
-	return pkt_hdr->buf_hdr.seg[0].data;
+	return pkt_hdr->seg[0].data;
 }
 
 static inline uint32_t packet_first_seg_len(odp_packet_hdr_t *pkt_hdr)
@@ -83,25 +82,43 @@ static inline uint32_t packet_last_seg_len(odp_packet_hdr_t *pkt_hdr)
 static inline void *packet_tail(odp_packet_hdr_t *pkt_hdr)
 {
 	int last = packet_last_seg(pkt_hdr);
-	uint32_t seg_len = pkt_hdr->buf_hdr.seg[last].len;
+	uint32_t seg_len = pkt_hdr->seg[last].len;
+
+	return pkt_hdr->seg[last].data + seg_len;
+}
+
+/* Segment data is outside of the segment buffer (external data). Segment
+ * header refers to external data only while its data is attached there. */
+static inline int seg_is_ext(odp_packet_hdr_t *pkt_hdr, int seg)
+{
+	odp_packet_hdr_t *hdr = pkt_hdr->seg[seg].hdr;
 
-	return pkt_hdr->buf_hdr.seg[last].data + seg_len;
+	return hdr->ext != NULL;
 }
 
 static inline uint32_t seg_headroom(odp_packet_hdr_t *pkt_hdr, int seg)
 {
-	odp_buffer_hdr_t *hdr = pkt_hdr->buf_hdr.seg[seg].hdr;
+	odp_buffer_hdr_t *hdr = pkt_hdr->seg[seg].hdr;
 	uint8_t *base = hdr->base_data;
-	uint8_t *head = pkt_hdr->buf_hdr.seg[seg].data;
+	uint8_t *head = pkt_hdr->seg[seg].data;
+	pool_t *pool;
 
-	return CONFIG_PACKET_HEADROOM + (head - base);
+	if (odp_unlikely(seg_is_ext(pkt_hdr, seg)))
+		return 0;
+
+	pool = pool_entry_from_hdl(hdr->pool_hdl);
+
+	return pool->headroom + (head - base);
 }
 
 static inline uint32_t seg_tailroom(odp_packet_hdr_t *pkt_hdr, int seg)
 {
-	uint32_t seg_len      = pkt_hdr->buf_hdr.seg[seg].len;
-	odp_buffer_hdr_t *hdr = pkt_hdr->buf_hdr.seg[seg].hdr;
-	uint8_t *tail         = pkt_hdr->buf_hdr.seg[seg].data + seg_len;
+	uint32_t seg_len      = pkt_hdr->seg[seg].len;
+	odp_packet_hdr_t *hdr = pkt_hdr->seg[seg].hdr;
+	uint8_t *tail         = pkt_hdr->seg[seg].data + seg_len;
+
+	if (odp_unlikely(seg_is_ext(pkt_hdr, seg)))
+		return 0;
 
 	return hdr->buf_end - tail;
 }
@@ -111,8 +128,8 @@ static inline void push_head(odp_packet_hdr_t *pkt_hdr, uint32_t len)
 	pkt_hdr->headroom  -= len;
 	pkt_hdr->frame_len += len;
 	pkt_hdr->unshared_len += len;
-	pkt_hdr->buf_hdr.seg[0].data -= len;
-	pkt_hdr->buf_hdr.seg[0].len  += len;
+	pkt_hdr->seg[0].data -= len;
+	pkt_hdr->seg[0].len  += len;
 }
 
 static inline void pull_head(odp_packet_hdr_t *pkt_hdr, uint32_t len)
@@ -120,8 +137,8 @@ static inline void pull_head(odp_packet_hdr_t *pkt_hdr, uint32_t len)
 	pkt_hdr->headroom  += len;
 	pkt_hdr->frame_len -= len;
 	pkt_hdr->unshared_len -= len;
-	pkt_hdr->buf_hdr.seg[0].data += len;
-	pkt_hdr->buf_hdr.seg[0].len  -= len;
+	pkt_hdr->seg[0].data += len;
+	pkt_hdr->seg[0].len  -= len;
 }
 
 static inline void push_tail(odp_packet_hdr_t *pkt_hdr, uint32_t len)
@@ -131,7 +148,7 @@ static inline void push_tail(odp_packet_hdr_t *pkt_hdr, uint32_t len)
 	pkt_hdr->tailroom  -= len;
 	pkt_hdr->frame_len += len;
 	pkt_hdr->unshared_len += len;
-	pkt_hdr->buf_hdr.seg[last].len += len;
+	pkt_hdr->seg[last].len += len;
 }
 
 /* Copy all metadata for segmentation modification. Segment data and lengths
@@ -153,17 +170,17 @@ static inline void packet_seg_copy_md(odp_packet_hdr_t *dst,
 	dst->timestamp = src->timestamp;
 	dst->op_result = src->op_result;
 
-	/* buffer header side packet metadata */
-	dst->buf_hdr.buf_u64    = src->buf_hdr.buf_u64;
-	dst->buf_hdr.uarea_addr = src->buf_hdr.uarea_addr;
-	dst->buf_hdr.uarea_size = src->buf_hdr.uarea_size;
+	/* user metadata */
+	dst->buf_u64    = src->buf_u64;
+	dst->uarea_addr = src->uarea_addr;
+	dst->uarea_size = src->uarea_size;
 
 	/* reference related metadata */
 	dst->ref_len      = src->ref_len;
 	dst->unshared_len = src->unshared_len;
 
 	/* segmentation data is not copied:
-	 *   buf_hdr.seg[]
+	 *   seg[]
 	 *   buf_hdr.segcount
 	 */
 }
@@ -188,14 +205,14 @@ static inline void *packet_map(odp_packet_hdr_t *pkt_hdr,
 		return NULL;
 
 	if (odp_likely(CONFIG_PACKET_MAX_SEGS == 1 || seg_count == 1)) {
-		addr = pkt_hdr->buf_hdr.seg[0].data + offset;
-		len  = pkt_hdr->buf_hdr.seg[0].len - offset;
+		addr = pkt_hdr->seg[0].data + offset;
+		len  = pkt_hdr->seg[0].len - offset;
 	} else {
 		int i;
 		uint32_t seg_start = 0, seg_end = 0;
 
 		for (i = 0; i < seg_count; i++) {
-			seg_end += pkt_hdr->buf_hdr.seg[i].len;
+			seg_end += pkt_hdr->seg[i].len;
 
 			if (odp_likely(offset < seg_end))
 				break;
@@ -203,8 +220,8 @@ static inline void *packet_map(odp_packet_hdr_t *pkt_hdr,
 			seg_start = seg_end;
 		}
 
-		addr = pkt_hdr->buf_hdr.seg[i].data + (offset - seg_start);
-		len  = pkt_hdr->buf_hdr.seg[i].len - (offset - seg_start);
+		addr = pkt_hdr->seg[i].data + (offset - seg_start);
+		len  = pkt_hdr->seg[i].len - (offset - seg_start);
 		seg  = i;
 	}
 
@@ -225,50 +242,54 @@ static inline void packet_parse_disable(odp_packet_hdr_t *pkt_hdr)
 
 void packet_parse_reset(odp_packet_hdr_t *pkt_hdr)
 {
-	/* Reset parser metadata before new parse */
+	packet_parser_reset(&pkt_hdr->p);
+
+	/* Ensure dummy pkt_hdrs used in I/O recv classification are valid */
+	pkt_hdr->ref_hdr = NULL;
+}
+
+/**
+ * Initialize packet metadata which does not depend on segmentation
+ */
+static inline void packet_init_md(odp_packet_hdr_t *pkt_hdr, int parse)
+{
 	pkt_hdr->p.parsed_layers    = LAYER_NONE;
-	pkt_hdr->p.error_flags.all  = 0;
 	pkt_hdr->p.input_flags.all  = 0;
 	pkt_hdr->p.output_flags.all = 0;
-	pkt_hdr->p.l2_offset        = 0;
-	pkt_hdr->p.l3_offset        = ODP_PACKET_OFFSET_INVALID;
-	pkt_hdr->p.l4_offset        = ODP_PACKET_OFFSET_INVALID;
+	pkt_hdr->p.error_flags.all  = 0;
 
-	/* Ensure dummy pkt_hdrs used in I/O recv classification are valid */
+	pkt_hdr->p.l2_offset = 0;
+	pkt_hdr->p.l3_offset = ODP_PACKET_OFFSET_INVALID;
+	pkt_hdr->p.l4_offset = ODP_PACKET_OFFSET_INVALID;
+
+	/* Disable lazy parsing on user allocated packets */
+	if (!parse)
+		packet_parse_disable(pkt_hdr);
+
+	pkt_hdr->input = ODP_PKTIO_INVALID;
 	pkt_hdr->ref_hdr = NULL;
 }
 
 /**
  * Initialize packet
  */
-static inline void packet_init(odp_packet_hdr_t *pkt_hdr, uint32_t len,
-			       int parse)
+static inline void packet_init(pool_t *pool, odp_packet_hdr_t *pkt_hdr,
+			       uint32_t len, int parse)
 {
 	uint32_t seg_len;
 	int num = pkt_hdr->buf_hdr.segcount;
 
 	if (odp_likely(CONFIG_PACKET_MAX_SEGS == 1 || num == 1)) {
 		seg_len = len;
-		pkt_hdr->buf_hdr.seg[0].len = len;
+		pkt_hdr->seg[0].len = len;
 	} else {
-		seg_len = len - ((num - 1) * CONFIG_PACKET_MAX_SEG_LEN);
+		seg_len = len - ((num - 1) * pool->max_seg_len);
 
 		/* Last segment data length */
-		pkt_hdr->buf_hdr.seg[num - 1].len = seg_len;
+		pkt_hdr->seg[num - 1].len = seg_len;
 	}
 
-	pkt_hdr->p.parsed_layers    = LAYER_NONE;
-	pkt_hdr->p.input_flags.all  = 0;
-	pkt_hdr->p.output_flags.all = 0;
-	pkt_hdr->p.error_flags.all  = 0;
-
-	pkt_hdr->p.l2_offset = 0;
-	pkt_hdr->p.l3_offset = ODP_PACKET_OFFSET_INVALID;
-	pkt_hdr->p.l4_offset = ODP_PACKET_OFFSET_INVALID;
-
-	/* Disable lazy parsing on user allocated packets */
-	if (!parse)
-		packet_parse_disable(pkt_hdr);
+	packet_init_md(pkt_hdr, parse);
 
        /*
 	* Packet headroom is set from the pool's headroom
@@ -276,18 +297,15 @@ static inline void packet_init(odp_packet_hdr_t *pkt_hdr, uint32_t len,
 	* segment occupied by the allocated length.
 	*/
 	pkt_hdr->frame_len = len;
-	pkt_hdr->headroom  = CONFIG_PACKET_HEADROOM;
-	pkt_hdr->tailroom  = CONFIG_PACKET_MAX_SEG_LEN - seg_len +
-			     CONFIG_PACKET_TAILROOM;
-
-	pkt_hdr->input = ODP_PKTIO_INVALID;
+	pkt_hdr->headroom  = pool->headroom;
+	pkt_hdr->tailroom  = pool->max_seg_len - seg_len + pool->tailroom;
 
 	/* By default packet has no references */
 	pkt_hdr->unshared_len = len;
-	pkt_hdr->ref_hdr = NULL;
 }
 
-static inline void init_segments(odp_packet_hdr_t *pkt_hdr[], int num)
+static inline void init_segments(pool_t *pool, odp_packet_hdr_t *pkt_hdr[],
+				 int num)
 {
 	odp_packet_hdr_t *hdr;
 	int i;
@@ -295,8 +313,9 @@ static inline void init_segments(odp_packet_hdr_t *pkt_hdr[], int num)
 	/* First segment is the packet descriptor */
 	hdr = pkt_hdr[0];
 
-	hdr->buf_hdr.seg[0].data = hdr->buf_hdr.base_data;
-	hdr->buf_hdr.seg[0].len  = BASE_LEN;
+	hdr->seg[0].data = hdr->buf_hdr.base_data;
+	hdr->seg[0].len  = pool->max_seg_len;
+	hdr->ext = NULL;
 	packet_ref_count_set(hdr, 1);
 
 	/* Link segments */
@@ -308,17 +327,18 @@ static inline void init_segments(odp_packet_hdr_t *pkt_hdr[], int num)
 				odp_buffer_hdr_t *buf_hdr;
 
 				packet_ref_count_set(pkt_hdr[i], 1);
+				pkt_hdr[i]->ext = NULL;
 				buf_hdr = &pkt_hdr[i]->buf_hdr;
-				hdr->buf_hdr.seg[i].hdr  = buf_hdr;
-				hdr->buf_hdr.seg[i].data = buf_hdr->base_data;
-				hdr->buf_hdr.seg[i].len  = BASE_LEN;
+				hdr->seg[i].hdr  = buf_hdr;
+				hdr->seg[i].data = buf_hdr->base_data;
+				hdr->seg[i].len  = pool->max_seg_len;
 			}
 		}
 	}
 }
 
 /* Calculate the number of segments */
-static inline int num_segments(uint32_t len)
+static inline int num_segments(pool_t *pool, uint32_t len)
 {
 	uint32_t max_seg_len;
 	int num;
@@ -327,7 +347,7 @@ static inline int num_segments(uint32_t len)
 		return 1;
 
 	num = 1;
-	max_seg_len = CONFIG_PACKET_MAX_SEG_LEN;
+	max_seg_len = pool->max_seg_len;
 
 	if (odp_unlikely(len > max_seg_len)) {
 		num = len / max_seg_len;
@@ -346,9 +366,9 @@ static inline void add_all_segs(odp_packet_hdr_t *to, odp_packet_hdr_t *from)
 	int num = from->buf_hdr.segcount;
 
 	for (i = 0; i < num; i++) {
-		to->buf_hdr.seg[n + i].hdr  = from->buf_hdr.seg[i].hdr;
-		to->buf_hdr.seg[n + i].data = from->buf_hdr.seg[i].data;
-		to->buf_hdr.seg[n + i].len  = from->buf_hdr.seg[i].len;
+		to->seg[n + i].hdr  = from->seg[i].hdr;
+		to->seg[n + i].data = from->seg[i].data;
+		to->seg[n + i].len  = from->seg[i].len;
 	}
 
 	to->buf_hdr.segcount = n + num;
@@ -360,9 +380,9 @@ static inline void copy_num_segs(odp_packet_hdr_t *to, odp_packet_hdr_t *from,
 	int i;
 
 	for (i = 0; i < num; i++) {
-		to->buf_hdr.seg[i].hdr  = from->buf_hdr.seg[first + i].hdr;
-		to->buf_hdr.seg[i].data = from->buf_hdr.seg[first + i].data;
-		to->buf_hdr.seg[i].len  = from->buf_hdr.seg[first + i].len;
+		to->seg[i].hdr  = from->seg[first + i].hdr;
+		to->seg[i].data = from->seg[first + i].data;
+		to->seg[i].len  = from->seg[first + i].len;
 	}
 
 	to->buf_hdr.segcount = num;
@@ -382,7 +402,7 @@ static inline odp_packet_hdr_t *alloc_segments(pool_t *pool, int num)
 		return NULL;
 	}
 
-	init_segments(pkt_hdr, num);
+	init_segments(pool, pkt_hdr, num);
 
 	return pkt_hdr[0];
 }
@@ -407,8 +427,8 @@ static inline odp_packet_hdr_t *add_segments(odp_packet_hdr_t *pkt_hdr,
 		add_all_segs(new_hdr, pkt_hdr);
 
 		/* adjust first segment length */
-		new_hdr->buf_hdr.seg[0].data += offset;
-		new_hdr->buf_hdr.seg[0].len   = seg_len;
+		new_hdr->seg[0].data += offset;
+		new_hdr->seg[0].len   = seg_len;
 
 		packet_seg_copy_md(new_hdr, pkt_hdr);
 		new_hdr->frame_len    = pkt_hdr->frame_len + len;
@@ -425,7 +445,7 @@ static inline odp_packet_hdr_t *add_segments(odp_packet_hdr_t *pkt_hdr,
 
 		/* adjust last segment length */
 		last = packet_last_seg(pkt_hdr);
-		pkt_hdr->buf_hdr.seg[last].len = seg_len;
+		pkt_hdr->seg[last].len = seg_len;
 
 		pkt_hdr->frame_len    += len;
 		pkt_hdr->unshared_len += len;
@@ -441,10 +461,12 @@ static inline void free_bufs(odp_packet_hdr_t *pkt_hdr, int first, int num)
 	odp_buffer_t buf[num];
 
 	for (i = 0, nfree = 0; i < num; i++) {
-		odp_packet_hdr_t *hdr = pkt_hdr->buf_hdr.seg[first + i].hdr;
+		odp_packet_hdr_t *hdr = pkt_hdr->seg[first + i].hdr;
 
-		if (packet_ref_dec(hdr) == 1)
+		if (packet_ref_dec(hdr) == 1) {
+			packet_ext_free(hdr);
 			buf[nfree++] = buffer_handle(hdr);
+		}
 	}
 
 	if (nfree > 0)
@@ -463,14 +485,16 @@ static inline odp_packet_hdr_t *free_segments(odp_packet_hdr_t *pkt_hdr,
 		odp_buffer_t buf[num];
 
 		for (i = 0, nfree = 0; i < num; i++) {
-			new_hdr = pkt_hdr->buf_hdr.seg[i].hdr;
+			new_hdr = pkt_hdr->seg[i].hdr;
 
-			if (packet_ref_dec(new_hdr) == 1)
+			if (packet_ref_dec(new_hdr) == 1) {
+				packet_ext_free(new_hdr);
 				buf[nfree++] = buffer_handle(new_hdr);
+			}
 		}
 
 		/* First remaining segment is the new packet descriptor */
-		new_hdr = pkt_hdr->buf_hdr.seg[num].hdr;
+		new_hdr = pkt_hdr->seg[num].hdr;
 
 		copy_num_segs(new_hdr, pkt_hdr, num, num_remain);
 		packet_seg_copy_md(new_hdr, pkt_hdr);
@@ -504,6 +528,26 @@ static inline odp_packet_hdr_t *free_segments(odp_packet_hdr_t *pkt_hdr,
 	return pkt_hdr;
 }
 
+/* Packet owns all of its segments: it does not refer to another packet and
+ * no segment is shared. Segments of such a packet can be relinked between
+ * packets without copying data. */
+static inline int packet_segs_owned(odp_packet_hdr_t *pkt_hdr)
+{
+	int i;
+
+	if (pkt_hdr->ref_hdr)
+		return 0;
+
+	for (i = 0; i < pkt_hdr->buf_hdr.segcount; i++) {
+		odp_packet_hdr_t *hdr = pkt_hdr->seg[i].hdr;
+
+		if (packet_ref_count(hdr) > 1)
+			return 0;
+	}
+
+	return 1;
+}
+
 static inline int packet_alloc(pool_t *pool, uint32_t len, int max_pkt,
 			       int num_seg, odp_packet_t *pkt, int parse)
 {
@@ -536,9 +580,9 @@ static inline int packet_alloc(pool_t *pool, uint32_t len, int max_pkt,
 		/* First buffer is the packet descriptor */
 		pkt[i] = (odp_packet_t)buf[i * num_seg];
 		hdr    = pkt_hdr[i * num_seg];
-		init_segments(&pkt_hdr[i * num_seg], num_seg);
+		init_segments(pool, &pkt_hdr[i * num_seg], num_seg);
 
-		packet_init(hdr, len, parse);
+		packet_init(pool, hdr, len, parse);
 	}
 
 	return num;
@@ -550,7 +594,10 @@ int packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 	pool_t *pool = pool_entry_from_hdl(pool_hdl);
 	int num, num_seg;
 
-	num_seg = num_segments(len);
+	if (odp_unlikely(len > pool->max_len))
+		return 0;
+
+	num_seg = num_segments(pool, len);
 	num     = packet_alloc(pool, len, max_num, num_seg, pkt, 1);
 
 	return num;
@@ -570,7 +617,7 @@ odp_packet_t odp_packet_alloc(odp_pool_t pool_hdl, uint32_t len)
 	if (odp_unlikely(len > pool->max_len))
 		return ODP_PACKET_INVALID;
 
-	num_seg = num_segments(len);
+	num_seg = num_segments(pool, len);
 	num     = packet_alloc(pool, len, 1, num_seg, &pkt, 0);
 
 	if (odp_unlikely(num == 0))
@@ -593,7 +640,7 @@ int odp_packet_alloc_multi(odp_pool_t pool_hdl, uint32_t len,
 	if (odp_unlikely(len > pool->max_len))
 		return -1;
 
-	num_seg = num_segments(len);
+	num_seg = num_segments(pool, len);
 	num     = packet_alloc(pool, len, max_num, num_seg, pkt, 0);
 
 	return num;
@@ -633,14 +680,32 @@ int odp_packet_reset(odp_packet_t pkt, uint32_t len)
 {
 	odp_packet_hdr_t *const pkt_hdr = odp_packet_hdr(pkt);
 	pool_t *pool = pool_entry_from_hdl(pkt_hdr->buf_hdr.pool_hdl);
+	int segs = pkt_hdr->buf_hdr.segcount;
+	int num = num_segments(pool, len);
+	int i;
 
-	if (len > pool->headroom + pool->data_size + pool->tailroom)
+	if (len > pool->max_len || num > segs)
 		return -1;
 
 	if (pkt_hdr->ref_hdr)
 		packet_free(pkt_hdr->ref_hdr);
 
-	packet_init(pkt_hdr, len, 0);
+	/* Free segments not needed for the new length */
+	if (num < segs) {
+		free_bufs(pkt_hdr, num, segs - num);
+		pkt_hdr->buf_hdr.segcount = num;
+	}
+
+	/* Restore segment data to the segment buffers, also when data was
+	 * external */
+	for (i = 0; i < num; i++) {
+		odp_buffer_hdr_t *hdr = pkt_hdr->seg[i].hdr;
+
+		pkt_hdr->seg[i].data = hdr->base_data;
+		pkt_hdr->seg[i].len  = pool->max_seg_len;
+	}
+
+	packet_init(pool, pkt_hdr, len, 0);
 
 	return 0;
 }
@@ -676,7 +741,7 @@ void *odp_packet_head(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
 
-	return pkt_hdr->buf_hdr.seg[0].data - pkt_hdr->headroom;
+	return pkt_hdr->seg[0].data - pkt_hdr->headroom;
 }
 
 uint32_t odp_packet_buf_len(odp_packet_t pkt)
@@ -685,7 +750,9 @@ uint32_t odp_packet_buf_len(odp_packet_t pkt)
 	uint32_t buf_len = 0;
 
 	do {
-		buf_len += pkt_hdr->buf_hdr.size * pkt_hdr->buf_hdr.segcount;
+		pool_t *pool = pool_entry_from_hdl(pkt_hdr->buf_hdr.pool_hdl);
+
+		buf_len += pool->seg_size * pkt_hdr->buf_hdr.segcount;
 		pkt_hdr  = pkt_hdr->ref_hdr;
 	} while (pkt_hdr);
 
@@ -766,29 +833,30 @@ void *odp_packet_push_head(odp_packet_t pkt, uint32_t len)
 
 static inline uint32_t pack_seg_head(odp_packet_hdr_t *pkt_hdr, int seg)
 {
-	odp_buffer_hdr_t *hdr = pkt_hdr->buf_hdr.seg[seg].hdr;
-	uint32_t len = pkt_hdr->buf_hdr.seg[seg].len;
-	uint8_t *src = pkt_hdr->buf_hdr.seg[seg].data;
+	odp_buffer_hdr_t *hdr = pkt_hdr->seg[seg].hdr;
+	uint32_t len = pkt_hdr->seg[seg].len;
+	uint8_t *src = pkt_hdr->seg[seg].data;
 	uint8_t *dst = hdr->base_data;
 
 	if (dst != src) {
 		memmove(dst, src, len);
-		pkt_hdr->buf_hdr.seg[seg].data = dst;
+		pkt_hdr->seg[seg].data = dst;
 	}
 
 	return len;
 }
 
-static inline uint32_t pack_seg_tail(odp_packet_hdr_t *pkt_hdr, int seg)
+static inline uint32_t pack_seg_tail(pool_t *pool, odp_packet_hdr_t *pkt_hdr,
+				     int seg)
 {
-	odp_buffer_hdr_t *hdr = pkt_hdr->buf_hdr.seg[seg].hdr;
-	uint32_t len = pkt_hdr->buf_hdr.seg[seg].len;
-	uint8_t *src = pkt_hdr->buf_hdr.seg[seg].data;
-	uint8_t *dst = hdr->base_data + BASE_LEN - len;
+	odp_buffer_hdr_t *hdr = pkt_hdr->seg[seg].hdr;
+	uint32_t len = pkt_hdr->seg[seg].len;
+	uint8_t *src = pkt_hdr->seg[seg].data;
+	uint8_t *dst = hdr->base_data + pool->max_seg_len - len;
 
 	if (dst != src) {
 		memmove(dst, src, len);
-		pkt_hdr->buf_hdr.seg[seg].data = dst;
+		pkt_hdr->seg[seg].data = dst;
 	}
 
 	return len;
@@ -797,24 +865,24 @@ static inline uint32_t pack_seg_tail(odp_packet_hdr_t *pkt_hdr, int seg)
 static inline uint32_t fill_seg_head(odp_packet_hdr_t *pkt_hdr, int dst_seg,
 				     int src_seg, uint32_t max_len)
 {
-	uint32_t len    = pkt_hdr->buf_hdr.seg[src_seg].len;
-	uint8_t *src    = pkt_hdr->buf_hdr.seg[src_seg].data;
-	uint32_t offset = pkt_hdr->buf_hdr.seg[dst_seg].len;
-	uint8_t *dst    = pkt_hdr->buf_hdr.seg[dst_seg].data + offset;
+	uint32_t len    = pkt_hdr->seg[src_seg].len;
+	uint8_t *src    = pkt_hdr->seg[src_seg].data;
+	uint32_t offset = pkt_hdr->seg[dst_seg].len;
+	uint8_t *dst    = pkt_hdr->seg[dst_seg].data + offset;
 
 	if (len > max_len)
 		len = max_len;
 
 	memmove(dst, src, len);
 
-	pkt_hdr->buf_hdr.seg[dst_seg].len  += len;
-	pkt_hdr->buf_hdr.seg[src_seg].len  -= len;
-	pkt_hdr->buf_hdr.seg[src_seg].data += len;
+	pkt_hdr->seg[dst_seg].len  += len;
+	pkt_hdr->seg[src_seg].len  -= len;
+	pkt_hdr->seg[src_seg].data += len;
 
-	if (pkt_hdr->buf_hdr.seg[src_seg].len == 0) {
-		odp_buffer_hdr_t *hdr = pkt_hdr->buf_hdr.seg[src_seg].hdr;
+	if (pkt_hdr->seg[src_seg].len == 0) {
+		odp_buffer_hdr_t *hdr = pkt_hdr->seg[src_seg].hdr;
 
-		pkt_hdr->buf_hdr.seg[src_seg].data = hdr->base_data;
+		pkt_hdr->seg[src_seg].data = hdr->base_data;
 	}
 
 	return len;
@@ -823,9 +891,9 @@ static inline uint32_t fill_seg_head(odp_packet_hdr_t *pkt_hdr, int dst_seg,
 static inline uint32_t fill_seg_tail(odp_packet_hdr_t *pkt_hdr, int dst_seg,
 				     int src_seg, uint32_t max_len)
 {
-	uint32_t src_len = pkt_hdr->buf_hdr.seg[src_seg].len;
-	uint8_t *src     = pkt_hdr->buf_hdr.seg[src_seg].data;
-	uint8_t *dst     = pkt_hdr->buf_hdr.seg[dst_seg].data;
+	uint32_t src_len = pkt_hdr->seg[src_seg].len;
+	uint8_t *src     = pkt_hdr->seg[src_seg].data;
+	uint8_t *dst     = pkt_hdr->seg[dst_seg].data;
 	uint32_t len     = src_len;
 
 	if (len > max_len)
@@ -836,20 +904,21 @@ static inline uint32_t fill_seg_tail(odp_packet_hdr_t *pkt_hdr, int dst_seg,
 
 	memmove(dst, src, len);
 
-	pkt_hdr->buf_hdr.seg[dst_seg].data -= len;
-	pkt_hdr->buf_hdr.seg[dst_seg].len  += len;
-	pkt_hdr->buf_hdr.seg[src_seg].len  -= len;
+	pkt_hdr->seg[dst_seg].data -= len;
+	pkt_hdr->seg[dst_seg].len  += len;
+	pkt_hdr->seg[src_seg].len  -= len;
 
-	if (pkt_hdr->buf_hdr.seg[src_seg].len == 0) {
-		odp_buffer_hdr_t *hdr = pkt_hdr->buf_hdr.seg[src_seg].hdr;
+	if (pkt_hdr->seg[src_seg].len == 0) {
+		odp_buffer_hdr_t *hdr = pkt_hdr->seg[src_seg].hdr;
 
-		pkt_hdr->buf_hdr.seg[src_seg].data = hdr->base_data;
+		pkt_hdr->seg[src_seg].data = hdr->base_data;
 	}
 
 	return len;
 }
 
-static inline int move_data_to_head(odp_packet_hdr_t *pkt_hdr, int segs)
+static inline int move_data_to_head(pool_t *pool, odp_packet_hdr_t *pkt_hdr,
+				    int segs)
 {
 	int dst_seg, src_seg;
 	uint32_t len, free_len;
@@ -859,10 +928,10 @@ static inline int move_data_to_head(odp_packet_hdr_t *pkt_hdr, int segs)
 		len    = pack_seg_head(pkt_hdr, dst_seg);
 		moved += len;
 
-		if (len == BASE_LEN)
+		if (len == pool->max_seg_len)
 			continue;
 
-		free_len = BASE_LEN - len;
+		free_len = pool->max_seg_len - len;
 
 		for (src_seg = dst_seg + 1; src_seg < segs; src_seg++) {
 			len = fill_seg_head(pkt_hdr, dst_seg, src_seg,
@@ -886,20 +955,21 @@ static inline int move_data_to_head(odp_packet_hdr_t *pkt_hdr, int segs)
 	return dst_seg;
 }
 
-static inline int move_data_to_tail(odp_packet_hdr_t *pkt_hdr, int segs)
+static inline int move_data_to_tail(pool_t *pool, odp_packet_hdr_t *pkt_hdr,
+				    int segs)
 {
 	int dst_seg, src_seg;
 	uint32_t len, free_len;
 	uint32_t moved = 0;
 
 	for (dst_seg = segs - 1; dst_seg >= 0; dst_seg--) {
-		len    = pack_seg_tail(pkt_hdr, dst_seg);
+		len    = pack_seg_tail(pool, pkt_hdr, dst_seg);
 		moved += len;
 
-		if (len == BASE_LEN)
+		if (len == pool->max_seg_len)
 			continue;
 
-		free_len = BASE_LEN - len;
+		free_len = pool->max_seg_len - len;
 
 		for (src_seg = dst_seg - 1; src_seg >= 0; src_seg--) {
 			len = fill_seg_tail(pkt_hdr, dst_seg, src_seg,
@@ -923,17 +993,18 @@ static inline int move_data_to_tail(odp_packet_hdr_t *pkt_hdr, int segs)
 	return dst_seg;
 }
 
-static inline void reset_seg(odp_packet_hdr_t *pkt_hdr, int first, int num)
+static inline void reset_seg(pool_t *pool, odp_packet_hdr_t *pkt_hdr,
+			     int first, int num)
 {
 	odp_buffer_hdr_t *hdr;
 	void *base;
 	int i;
 
 	for (i = first; i < first + num; i++) {
-		hdr  = pkt_hdr->buf_hdr.seg[i].hdr;
+		hdr  = pkt_hdr->seg[i].hdr;
 		base = hdr->base_data;
-		pkt_hdr->buf_hdr.seg[i].len  = BASE_LEN;
-		pkt_hdr->buf_hdr.seg[i].data = base;
+		pkt_hdr->seg[i].len  = pool->max_seg_len;
+		pkt_hdr->seg[i].data = base;
 	}
 }
 
@@ -953,7 +1024,7 @@ int odp_packet_extend_head(odp_packet_t *pkt, uint32_t len,
 		if (odp_unlikely((frame_len + len) > pool->max_len))
 			return -1;
 
-		num  = num_segments(len - headroom);
+		num  = num_segments(pool, len - headroom);
 		segs = pkt_hdr->buf_hdr.segcount;
 
 		if (odp_unlikely((segs + num) > CONFIG_PACKET_MAX_SEGS)) {
@@ -1003,7 +1074,7 @@ int odp_packet_extend_head(odp_packet_t *pkt, uint32_t len,
 			int free_segs = 0;
 			uint32_t offset;
 
-			num = num_segments(frame_len + len);
+			num = num_segments(pool, frame_len + len);
 
 			if (num > segs) {
 				/* Allocate additional segments */
@@ -1018,8 +1089,8 @@ int odp_packet_extend_head(odp_packet_t *pkt, uint32_t len,
 			}
 
 			/* Pack all data to packet tail */
-			move_data_to_tail(pkt_hdr, segs);
-			reset_seg(pkt_hdr, 0, segs);
+			move_data_to_tail(pool, pkt_hdr, segs);
+			reset_seg(pool, pkt_hdr, 0, segs);
 
 			if (new_segs) {
 				add_all_segs(new_hdr, pkt_hdr);
@@ -1029,7 +1100,7 @@ int odp_packet_extend_head(odp_packet_t *pkt, uint32_t len,
 				pkt_hdr = new_hdr;
 				*pkt    = packet_handle(pkt_hdr);
 			} else if (free_segs) {
-				new_hdr = pkt_hdr->buf_hdr.seg[free_segs].hdr;
+				new_hdr = pkt_hdr->seg[free_segs].hdr;
 				packet_seg_copy_md(new_hdr, pkt_hdr);
 
 				/* Free extra segs */
@@ -1041,10 +1112,10 @@ int odp_packet_extend_head(odp_packet_t *pkt, uint32_t len,
 			}
 
 			frame_len += len;
-			offset = (segs * BASE_LEN) - frame_len;
+			offset = (segs * pool->max_seg_len) - frame_len;
 
-			pkt_hdr->buf_hdr.seg[0].data += offset;
-			pkt_hdr->buf_hdr.seg[0].len  -= offset;
+			pkt_hdr->seg[0].data += offset;
+			pkt_hdr->seg[0].len  -= offset;
 
 			pkt_hdr->buf_hdr.segcount = segs;
 			pkt_hdr->frame_len        = frame_len;
@@ -1195,7 +1266,7 @@ int odp_packet_extend_tail(odp_packet_t *pkt, uint32_t len,
 		if (odp_unlikely((frame_len + len) > pool->max_len))
 			return -1;
 
-		num  = num_segments(len - tailroom);
+		num  = num_segments(pool, len - tailroom);
 		segs = pkt_hdr->buf_hdr.segcount;
 
 		if (odp_unlikely((segs + num) > CONFIG_PACKET_MAX_SEGS)) {
@@ -1205,7 +1276,7 @@ int odp_packet_extend_tail(odp_packet_t *pkt, uint32_t len,
 			int free_segs = 0;
 			uint32_t offset;
 
-			num = num_segments(frame_len + len);
+			num = num_segments(pool, frame_len + len);
 
 			if (num > segs) {
 				/* Allocate additional segments */
@@ -1220,8 +1291,8 @@ int odp_packet_extend_tail(odp_packet_t *pkt, uint32_t len,
 			}
 
 			/* Pack all data to packet head */
-			move_data_to_head(pkt_hdr, segs);
-			reset_seg(pkt_hdr, 0, segs);
+			move_data_to_head(pool, pkt_hdr, segs);
+			reset_seg(pool, pkt_hdr, 0, segs);
 
 			if (new_segs) {
 				/* Add new segs */
@@ -1235,9 +1306,9 @@ int odp_packet_extend_tail(odp_packet_t *pkt, uint32_t len,
 			}
 
 			frame_len += len;
-			offset     = (segs * BASE_LEN) - frame_len;
+			offset     = (segs * pool->max_seg_len) - frame_len;
 
-			pkt_hdr->buf_hdr.seg[segs - 1].len -= offset;
+			pkt_hdr->seg[segs - 1].len -= offset;
 
 			pkt_hdr->buf_hdr.segcount = segs;
 			pkt_hdr->frame_len        = frame_len;
@@ -1380,22 +1451,22 @@ int odp_packet_input_index(odp_packet_t pkt)
 
 void *odp_packet_user_ptr(odp_packet_t pkt)
 {
-	return odp_packet_hdr(pkt)->buf_hdr.buf_ctx;
+	return odp_packet_hdr(pkt)->buf_ctx;
 }
 
 void odp_packet_user_ptr_set(odp_packet_t pkt, const void *ctx)
 {
-	odp_packet_hdr(pkt)->buf_hdr.buf_cctx = ctx;
+	odp_packet_hdr(pkt)->buf_cctx = ctx;
 }
 
 void *odp_packet_user_area(odp_packet_t pkt)
 {
-	return odp_packet_hdr(pkt)->buf_hdr.uarea_addr;
+	return odp_packet_hdr(pkt)->uarea_addr;
 }
 
 uint32_t odp_packet_user_area_size(odp_packet_t pkt)
 {
-	return odp_packet_hdr(pkt)->buf_hdr.uarea_size;
+	return odp_packet_hdr(pkt)->uarea_size;
 }
 
 void *odp_packet_l2_ptr(odp_packet_t pkt, uint32_t *len)
@@ -1541,9 +1612,9 @@ int odp_packet_num_segs(odp_packet_t pkt)
 			for (i = 0, seg_offset = 0;
 			     i < pkt_hdr->buf_hdr.segcount;
 			     i++, seg_offset++) {
-				if (offset < pkt_hdr->buf_hdr.seg[i].len)
+				if (offset < pkt_hdr->seg[i].len)
 					break;
-				offset -= pkt_hdr->buf_hdr.seg[i].len;
+				offset -= pkt_hdr->seg[i].len;
 			}
 		}
 	} while (pkt_hdr);
@@ -1591,9 +1662,9 @@ void *odp_packet_seg_data(odp_packet_t pkt, odp_packet_seg_t seg)
 		for (i = 0, seg_offset = 0;
 		     i < pkt_hdr->buf_hdr.segcount;
 		     i++, seg_offset++) {
-			if (offset < pkt_hdr->buf_hdr.seg[i].len)
+			if (offset < pkt_hdr->seg[i].len)
 				break;
-			offset -= pkt_hdr->buf_hdr.seg[i].len;
+			offset -= pkt_hdr->seg[i].len;
 		}
 	}
 
@@ -1616,9 +1687,9 @@ uint32_t odp_packet_seg_data_len(odp_packet_t pkt, odp_packet_seg_t seg)
 		for (i = 0, seg_offset = 0;
 		     i < pkt_hdr->buf_hdr.segcount;
 		     i++, seg_offset++) {
-			if (offset < pkt_hdr->buf_hdr.seg[i].len)
+			if (offset < pkt_hdr->seg[i].len)
 				break;
-			offset -= pkt_hdr->buf_hdr.seg[i].len;
+			offset -= pkt_hdr->seg[i].len;
 		}
 	}
 
@@ -1635,6 +1706,72 @@ uint32_t odp_packet_seg_data_len(odp_packet_t pkt, odp_packet_seg_t seg)
  *
  */
 
+/* Link new segments into an offset. Data following the offset in the same
+ * segment is copied after the new data, other segments are not touched. */
+static inline int add_data_segs(pool_t *pool, odp_packet_hdr_t *pkt_hdr,
+				uint32_t offset, uint32_t len)
+{
+	odp_packet_hdr_t *new_hdr;
+	uint32_t seg_len = 0; /* GCC */
+	uint32_t seg_off, add_len;
+	uint8_t *data;
+	int seg = 0; /* GCC */
+	int i, first, num;
+	int segs = pkt_hdr->buf_hdr.segcount;
+
+	data    = packet_map(pkt_hdr, offset, &seg_len, &seg);
+	seg_off = pkt_hdr->seg[seg].len - seg_len;
+
+	if (seg_off == 0) {
+		/* New segments are added in front of the segment */
+		first   = seg;
+		add_len = len;
+	} else {
+		/* Segment is split, new segments hold also the rest of it */
+		first   = seg + 1;
+		add_len = len + seg_len;
+	}
+
+	num = num_segments(pool, add_len);
+
+	if (segs + num > CONFIG_PACKET_MAX_SEGS)
+		return -1;
+
+	new_hdr = alloc_segments(pool, num);
+
+	if (new_hdr == NULL)
+		return -1;
+
+	new_hdr->seg[num - 1].len = add_len - (num - 1) * pool->max_seg_len;
+
+	for (i = segs - 1; i >= first; i--)
+		pkt_hdr->seg[i + num] = pkt_hdr->seg[i];
+
+	for (i = 0; i < num; i++)
+		pkt_hdr->seg[first + i] = new_hdr->seg[i];
+
+	if (first == segs)
+		pkt_hdr->tailroom = pool->max_seg_len -
+				    new_hdr->seg[num - 1].len + pool->tailroom;
+
+	pkt_hdr->buf_hdr.segcount = segs + num;
+	pkt_hdr->frame_len       += len;
+	pkt_hdr->unshared_len    += len;
+
+	if (seg_off == 0) {
+		/* Data was not moved in memory */
+		return 0;
+	}
+
+	/* The rest of the split segment was not overwritten, since new data
+	 * is in new segments */
+	pkt_hdr->seg[seg].len = seg_off;
+	odp_packet_copy_from_mem(packet_handle(pkt_hdr), offset + len,
+				 seg_len, data);
+
+	return 1;
+}
+
 int odp_packet_add_data(odp_packet_t *pkt_ptr, uint32_t offset, uint32_t len)
 {
 	odp_packet_t pkt = *pkt_ptr;
@@ -1647,6 +1784,22 @@ int odp_packet_add_data(odp_packet_t *pkt_ptr, uint32_t offset, uint32_t len)
 
 	ODP_ASSERT(odp_packet_unshared_len(*pkt_ptr) >= offset);
 
+	if (packet_segs_owned(pkt_hdr)) {
+		pool_t *pool = pool_entry_from_hdl(pkt_hdr->buf_hdr.pool_hdl);
+		int ret;
+
+		if (offset == 0)
+			return odp_packet_extend_head(pkt_ptr, len, NULL, NULL);
+
+		if (offset == pktlen)
+			return odp_packet_extend_tail(pkt_ptr, len, NULL, NULL);
+
+		ret = add_data_segs(pool, pkt_hdr, offset, len);
+
+		if (ret >= 0)
+			return ret;
+	}
+
 	newpkt = odp_packet_alloc(pkt_hdr->buf_hdr.pool_hdl, pktlen + len);
 
 	if (newpkt == ODP_PACKET_INVALID)
@@ -1718,7 +1871,9 @@ int odp_packet_align(odp_packet_t *pkt, uint32_t offset, uint32_t len,
 			return 0;
 		shift = align - misalign;
 	} else {
-		if (len > pkt_hdr->buf_hdr.size)
+		pool_t *pool = pool_entry_from_hdl(pkt_hdr->buf_hdr.pool_hdl);
+
+		if (len > pool->seg_size)
 			return -1;
 		shift  = len - seglen;
 		uaddr -= shift;
@@ -1752,11 +1907,24 @@ int odp_packet_concat(odp_packet_t *dst, odp_packet_t src)
 
 	ODP_ASSERT(packet_ref_count(dst_hdr) == 1);
 
+	/* Link src as a reference when its data is shared or it refers to
+	 * other packets. The link takes over the reference of src handle. */
+	if (odp_unlikely(src_hdr->ref_hdr ||
+			 packet_ref_count(src_hdr) > 1) &&
+	    dst_hdr->ref_hdr == NULL && dst_pool == src_pool) {
+		dst_hdr->ref_hdr    = src_hdr;
+		dst_hdr->ref_offset = 0;
+		dst_hdr->ref_len    = src_len;
+
+		/* Data was not moved in memory */
+		return 0;
+	}
+
 	/* Do a copy if resulting packet would be out of segments or packets
 	 * are from different pools or src is a reference. */
 	if (odp_unlikely((dst_segs + src_segs) > CONFIG_PACKET_MAX_SEGS) ||
 	    odp_unlikely(dst_pool != src_pool) ||
-	    odp_unlikely(packet_ref_count(src_hdr)) > 1) {
+	    odp_unlikely(src_hdr->ref_hdr || packet_ref_count(src_hdr) > 1)) {
 		if (odp_packet_extend_tail(dst, src_len, NULL, NULL) >= 0) {
 			(void)odp_packet_copy_from_pkt(*dst, dst_len,
 						       src, 0, src_len);
@@ -1779,14 +1947,101 @@ int odp_packet_concat(odp_packet_t *dst, odp_packet_t src)
 	return 0;
 }
 
+/* Move segments after an offset into a new tail packet. When the offset is
+ * not at a segment boundary, only the rest of that segment is copied. The
+ * rest may be longer than a pool segment after push_head() or extend_head(),
+ * so it is copied into as many new segments as needed. Returns NULL when
+ * segments cannot be allocated or the tail would have too many segments. */
+static inline odp_packet_hdr_t *split_segs(pool_t *pool,
+					   odp_packet_hdr_t *pkt_hdr,
+					   uint32_t len)
+{
+	odp_packet_hdr_t *tail_hdr;
+	odp_packet_t tail;
+	uint32_t seg_len = 0; /* GCC */
+	uint32_t seg_off;
+	uint32_t copy_len;
+	uint32_t tailroom = pkt_hdr->tailroom;
+	uint32_t tail_len = pkt_hdr->frame_len - len;
+	int segs = pkt_hdr->buf_hdr.segcount;
+	int seg = 0; /* GCC */
+	int num;
+	int i;
+	uint8_t *data;
+
+	data    = packet_map(pkt_hdr, len, &seg_len, &seg);
+	seg_off = pkt_hdr->seg[seg].len - seg_len;
+
+	if (seg_off == 0 && seg > 0) {
+		/* First segment of the tail is the new packet descriptor */
+		tail_hdr = pkt_hdr->seg[seg].hdr;
+		copy_num_segs(tail_hdr, pkt_hdr, seg, segs - seg);
+
+		tail_hdr->headroom        = seg_headroom(tail_hdr, 0);
+		tail_hdr->tailroom        = tailroom;
+		pkt_hdr->buf_hdr.segcount = seg;
+	} else {
+		num = num_segments(pool, seg_len);
+
+		if (odp_unlikely(num + segs - seg - 1 > CONFIG_PACKET_MAX_SEGS))
+			return NULL;
+
+		if (packet_alloc(pool, seg_len, 1, num, &tail, 0) != 1)
+			return NULL;
+
+		tail_hdr = odp_packet_hdr(tail);
+
+		for (i = 0; i < num; i++) {
+			copy_len = packet_seg_len(tail_hdr, i);
+			memcpy(packet_seg_data(tail_hdr, i), data, copy_len);
+			data += copy_len;
+		}
+
+		for (i = seg + 1; i < segs; i++)
+			tail_hdr->seg[num + i - seg - 1] = pkt_hdr->seg[i];
+
+		/* Tail packet ends with the original last segment */
+		if (seg < segs - 1)
+			tail_hdr->tailroom = tailroom;
+
+		tail_hdr->buf_hdr.segcount = num + segs - seg - 1;
+		pkt_hdr->seg[seg].len      = seg_off;
+		pkt_hdr->buf_hdr.segcount  = seg + 1;
+	}
+
+	packet_init_md(tail_hdr, 0);
+	tail_hdr->frame_len    = tail_len;
+	tail_hdr->unshared_len = tail_len;
+
+	pkt_hdr->frame_len    = len;
+	pkt_hdr->unshared_len = len;
+	pkt_hdr->tailroom     = seg_tailroom(pkt_hdr, packet_last_seg(pkt_hdr));
+
+	return tail_hdr;
+}
+
 int odp_packet_split(odp_packet_t *pkt, uint32_t len, odp_packet_t *tail)
 {
-	uint32_t pktlen = odp_packet_len(*pkt);
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(*pkt);
+	uint32_t pktlen = packet_len(pkt_hdr);
 
 	if (len >= pktlen || tail == NULL)
 		return -1;
 
 	ODP_ASSERT(odp_packet_unshared_len(*pkt) >= len);
+
+	if (packet_segs_owned(pkt_hdr)) {
+		pool_t *pool = pool_entry_from_hdl(pkt_hdr->buf_hdr.pool_hdl);
+		odp_packet_hdr_t *tail_hdr = split_segs(pool, pkt_hdr, len);
+
+		if (odp_likely(tail_hdr != NULL)) {
+			*tail = packet_handle(tail_hdr);
+
+			/* Data of the head packet was not moved */
+			return 0;
+		}
+	}
+
 	*tail = odp_packet_copy_part(*pkt, len, pktlen - len,
 				     odp_packet_pool(*pkt));
 
@@ -1807,7 +2062,7 @@ static inline void packet_ref(odp_packet_hdr_t *pkt_hdr)
 
 	do {
 		for (i = 0; i < pkt_hdr->buf_hdr.segcount; i++) {
-			hdr = pkt_hdr->buf_hdr.seg[i].hdr;
+			hdr = pkt_hdr->seg[i].hdr;
 			packet_ref_inc(hdr);
 		}
 
@@ -1962,6 +2217,43 @@ int odp_packet_copy_to_mem(odp_packet_t pkt, uint32_t offset,
 	return 0;
 }
 
+/* Copy data that a packet refers to into its own segments and release the
+ * references, so that the data can be written (copy on write). Packets
+ * which are referenced themselves cannot be unshared this way. */
+static int packet_unshare(odp_packet_hdr_t *pkt_hdr)
+{
+	pool_t *pool = pool_entry_from_hdl(pkt_hdr->buf_hdr.pool_hdl);
+	odp_packet_hdr_t *ref_hdr = pkt_hdr->ref_hdr;
+	odp_packet_hdr_t *new_hdr;
+	odp_packet_t pkt = packet_handle(pkt_hdr);
+	odp_packet_t copy;
+	uint32_t len;
+	int num;
+
+	if (ref_hdr == NULL || packet_ref_count(pkt_hdr) > 1)
+		return 0;
+
+	len = packet_len(pkt_hdr) - pkt_hdr->frame_len;
+	num = num_segments(pool, len);
+
+	if (pkt_hdr->buf_hdr.segcount + num > CONFIG_PACKET_MAX_SEGS ||
+	    packet_alloc(pool, len, 1, num, &copy, 0) != 1)
+		return -1;
+
+	new_hdr = odp_packet_hdr(copy);
+	odp_packet_copy_from_pkt(copy, 0, pkt, pkt_hdr->frame_len, len);
+
+	pkt_hdr->ref_hdr = NULL;
+	packet_free(ref_hdr);
+
+	add_all_segs(pkt_hdr, new_hdr);
+	pkt_hdr->frame_len    += len;
+	pkt_hdr->unshared_len  = pkt_hdr->frame_len;
+	pkt_hdr->tailroom      = new_hdr->tailroom;
+
+	return 0;
+}
+
 int odp_packet_copy_from_mem(odp_packet_t pkt, uint32_t offset,
 			     uint32_t len, const void *src)
 {
@@ -1974,6 +2266,11 @@ int odp_packet_copy_from_mem(odp_packet_t pkt, uint32_t offset,
 	if (offset + len > packet_len(pkt_hdr))
 		return -1;
 
+	if (odp_unlikely(pkt_hdr->ref_hdr != NULL) &&
+	    odp_packet_unshared_len(pkt) < offset + len &&
+	    packet_unshare(pkt_hdr))
+		return -1;
+
 	ODP_ASSERT(odp_packet_unshared_len(pkt) >= offset + len);
 
 	while (len > 0) {
@@ -2005,6 +2302,11 @@ int odp_packet_copy_from_pkt(odp_packet_t dst, uint32_t dst_offset,
 	    src_offset + len > packet_len(src_hdr))
 		return -1;
 
+	if (odp_unlikely(dst_hdr->ref_hdr != NULL) &&
+	    odp_packet_unshared_len(dst) < dst_offset + len &&
+	    packet_unshare(dst_hdr))
+		return -1;
+
 	ODP_ASSERT(odp_packet_unshared_len(dst) >= dst_offset + len);
 
 	overlap = (dst_hdr == src_hdr &&
@@ -2143,15 +2445,11 @@ int _odp_packet_copy_md_to_packet(odp_packet_t srcpkt, odp_packet_t dstpkt)
 
 	dsthdr->input = srchdr->input;
 	dsthdr->dst_queue = srchdr->dst_queue;
-	dsthdr->buf_hdr.buf_u64 = srchdr->buf_hdr.buf_u64;
-	if (dsthdr->buf_hdr.uarea_addr != NULL &&
-	    srchdr->buf_hdr.uarea_addr != NULL)
-		memcpy(dsthdr->buf_hdr.uarea_addr,
-		       srchdr->buf_hdr.uarea_addr,
-		       dsthdr->buf_hdr.uarea_size <=
-		       srchdr->buf_hdr.uarea_size ?
-		       dsthdr->buf_hdr.uarea_size :
-		       srchdr->buf_hdr.uarea_size);
+	dsthdr->buf_u64 = srchdr->buf_u64;
+	if (dsthdr->uarea_addr != NULL && srchdr->uarea_addr != NULL)
+		memcpy(dsthdr->uarea_addr, srchdr->uarea_addr,
+		       dsthdr->uarea_size <= srchdr->uarea_size ?
+		       dsthdr->uarea_size : srchdr->uarea_size);
 
 	copy_packet_parser_metadata(srchdr, dsthdr);
 
@@ -2159,7 +2457,7 @@ int _odp_packet_copy_md_to_packet(odp_packet_t srcpkt, odp_packet_t dstpkt)
 	 * user area was truncated in the process. Note this can only
 	 * happen when copying between different pools.
 	 */
-	return dsthdr->buf_hdr.uarea_size < srchdr->buf_hdr.uarea_size;
+	return dsthdr->uarea_size < srchdr->uarea_size;
 }
 
 /**
@@ -2312,6 +2610,290 @@ static inline void parse_udp(packet_parser_t *prs,
 	*parseptr += sizeof(_odp_udphdr_t);
 }
 
+/**
+ * Parser helper function for MPLS
+ *
+ * Skips the label stack and sets EtherType according to the IP version of
+ * the payload. EtherType is left as MPLS when the payload is not IP.
+ */
+static inline void parse_mpls(packet_parser_t *prs, const uint8_t *ptr,
+			      uint32_t *offset, uint32_t seg_len)
+{
+	const _odp_mplshdr_t *mpls;
+	uint32_t label;
+	uint8_t ver;
+
+	prs->input_flags.mpls = 1;
+
+	do {
+		if (odp_unlikely(*offset + _ODP_MPLSHDR_LEN >= seg_len))
+			return;
+
+		mpls  = (const _odp_mplshdr_t *)(ptr + *offset);
+		label = odp_be_to_cpu_32(mpls->label_exp_s_ttl);
+		*offset += _ODP_MPLSHDR_LEN;
+	} while (!(label & _ODP_MPLS_BOS));
+
+	ver = ptr[*offset] >> 4;
+
+	if (ver == 4)
+		prs->ethtype = _ODP_ETHTYPE_IPV4;
+	else if (ver == 6)
+		prs->ethtype = _ODP_ETHTYPE_IPV6;
+}
+
+/**
+ * Parser helper function for tunneled headers
+ *
+ * Inner headers start at 'offset' with an Ethernet header when 'ethtype' is
+ * zero, otherwise with an L3 header of the given EtherType. Inner offsets are
+ * recorded and input_flags.tunnel set when the inner L3 header is found.
+ */
+static inline void parse_inner(packet_parser_t *prs, const uint8_t *ptr,
+			       uint32_t offset, uint16_t ethtype,
+			       uint32_t frame_len, uint32_t seg_len)
+{
+	packet_parser_t inner;
+	const uint8_t *parseptr;
+	uint8_t ip_proto;
+
+	prs->inner_l2_offset = ODP_PACKET_OFFSET_INVALID;
+
+	if (ethtype == 0) {
+		const _odp_ethhdr_t *eth;
+		const _odp_vlanhdr_t *vlan;
+
+		if (odp_unlikely(offset + _ODP_ETHHDR_LEN > seg_len))
+			return;
+
+		eth = (const _odp_ethhdr_t *)(ptr + offset);
+		prs->inner_l2_offset = offset;
+		ethtype = odp_be_to_cpu_16(eth->type);
+		offset += _ODP_ETHHDR_LEN;
+
+		if (ethtype == _ODP_ETHTYPE_VLAN) {
+			if (odp_unlikely(offset + _ODP_VLANHDR_LEN > seg_len))
+				return;
+
+			vlan = (const _odp_vlanhdr_t *)(ptr + offset);
+			ethtype = odp_be_to_cpu_16(vlan->type);
+			offset += _ODP_VLANHDR_LEN;
+		}
+	}
+
+	parseptr = ptr + offset;
+	inner.l3_offset = offset;
+	inner.error_flags.all = 0;
+	inner.input_flags.all = 0;
+
+	if (ethtype == _ODP_ETHTYPE_IPV4 &&
+	    offset + _ODP_IPV4HDR_LEN <= seg_len)
+		ip_proto = parse_ipv4(&inner, &parseptr, &offset, frame_len);
+	else if (ethtype == _ODP_ETHTYPE_IPV6 &&
+		 offset + _ODP_IPV6HDR_LEN <= seg_len)
+		ip_proto = parse_ipv6(&inner, &parseptr, &offset, frame_len,
+				      seg_len);
+	else
+		return;
+
+	if (odp_unlikely(inner.error_flags.ip_err))
+		return;
+
+	prs->input_flags.tunnel = 1;
+	prs->inner_ethtype   = ethtype;
+	prs->inner_l3_offset = inner.l3_offset;
+	prs->inner_l4_offset = offset;
+	prs->inner_ip_proto  = ip_proto;
+}
+
+/**
+ * Parser helper function for VXLAN
+ */
+static void parse_vxlan(packet_parser_t *prs, const uint8_t *ptr,
+			uint32_t offset, uint32_t frame_len, uint32_t seg_len)
+{
+	const _odp_vxlanhdr_t *vxlan;
+
+	if (odp_unlikely(offset + _ODP_VXLANHDR_LEN > seg_len))
+		return;
+
+	vxlan = (const _odp_vxlanhdr_t *)(ptr + offset);
+
+	if (!(vxlan->flags & _ODP_VXLAN_FLAG_I))
+		return;
+
+	prs->input_flags.vxlan = 1;
+	prs->tunnel_id = odp_be_to_cpu_32(vxlan->vni_rsvd) >> 8;
+
+	parse_inner(prs, ptr, offset + _ODP_VXLANHDR_LEN, 0, frame_len,
+		    seg_len);
+}
+
+/**
+ * Parser helper function for GTP-U
+ */
+static void parse_gtpu(packet_parser_t *prs, const uint8_t *ptr,
+		       uint32_t offset, uint32_t frame_len, uint32_t seg_len)
+{
+	const _odp_gtpuhdr_t *gtpu;
+	uint32_t hdr_len = _ODP_GTPUHDR_LEN;
+	uint32_t ext_len;
+	uint8_t next;
+	uint8_t ver;
+
+	if (odp_unlikely(offset + _ODP_GTPUHDR_LEN > seg_len))
+		return;
+
+	gtpu = (const _odp_gtpuhdr_t *)(ptr + offset);
+
+	if ((gtpu->flags & 0xf0) != _ODP_GTPU_VER_PT ||
+	    gtpu->msg_type != _ODP_GTPU_MSG_GPDU)
+		return;
+
+	prs->input_flags.gtpu = 1;
+	prs->tunnel_id = odp_be_to_cpu_32(gtpu->teid);
+
+	/* Optional fields follow the mandatory header when any of E, S or PN
+	 * flags is set */
+	if (gtpu->flags & _ODP_GTPU_FLAG_OPT) {
+		hdr_len = _ODP_GTPUHDR_OPT_LEN;
+		if (odp_unlikely(offset + hdr_len > seg_len))
+			return;
+
+		next = (gtpu->flags & _ODP_GTPU_FLAG_E) ?
+		       ptr[offset + hdr_len - 1] : 0;
+
+		/* Extension headers: length in 4 byte units, last byte is
+		 * the type of the next extension header */
+		while (next) {
+			if (odp_unlikely(offset + hdr_len >= seg_len))
+				return;
+
+			ext_len = ptr[offset + hdr_len] * 4;
+			if (odp_unlikely(ext_len == 0 ||
+					 offset + hdr_len + ext_len > seg_len))
+				return;
+
+			hdr_len += ext_len;
+			next = ptr[offset + hdr_len - 1];
+		}
+	}
+
+	if (odp_unlikely(offset + hdr_len >= seg_len))
+		return;
+
+	ver = ptr[offset + hdr_len] >> 4;
+
+	if (ver == 4)
+		parse_inner(prs, ptr, offset + hdr_len, _ODP_ETHTYPE_IPV4,
+			    frame_len, seg_len);
+	else if (ver == 6)
+		parse_inner(prs, ptr, offset + hdr_len, _ODP_ETHTYPE_IPV6,
+			    frame_len, seg_len);
+}
+
+/**
+ * Parser helper function for GRE
+ */
+static void parse_gre(packet_parser_t *prs, const uint8_t *ptr,
+		      uint32_t offset, uint32_t frame_len, uint32_t seg_len)
+{
+	const _odp_grehdr_t *gre;
+	uint32_t hdr_len = _ODP_GREHDR_LEN;
+	odp_u32be_t key;
+	uint16_t flags;
+	uint16_t proto;
+
+	if (odp_unlikely(offset + _ODP_GREHDR_LEN > seg_len))
+		return;
+
+	gre   = (const _odp_grehdr_t *)(ptr + offset);
+	flags = odp_be_to_cpu_16(gre->flags_ver);
+	proto = odp_be_to_cpu_16(gre->proto);
+
+	if (flags & _ODP_GRE_VER_MASK)
+		return;
+
+	prs->input_flags.gre = 1;
+	prs->tunnel_id = 0;
+
+	if (flags & _ODP_GRE_FLAG_C)
+		hdr_len += 4;
+
+	if (flags & _ODP_GRE_FLAG_K) {
+		if (odp_unlikely(offset + hdr_len + 4 > seg_len))
+			return;
+
+		memcpy(&key, ptr + offset + hdr_len, sizeof(key));
+		prs->tunnel_id = odp_be_to_cpu_32(key);
+		hdr_len += 4;
+	}
+
+	if (flags & _ODP_GRE_FLAG_S)
+		hdr_len += 4;
+
+	if (proto == _ODP_GRE_PROTO_TEB)
+		parse_inner(prs, ptr, offset + hdr_len, 0, frame_len,
+			    seg_len);
+	else if (proto == _ODP_ETHTYPE_IPV4 || proto == _ODP_ETHTYPE_IPV6)
+		parse_inner(prs, ptr, offset + hdr_len, proto, frame_len,
+			    seg_len);
+}
+
+/** Tunnel parser function, called with the offset of the tunnel header */
+typedef void (*parse_tunnel_fn_t)(packet_parser_t *prs, const uint8_t *ptr,
+				  uint32_t offset, uint32_t frame_len,
+				  uint32_t seg_len);
+
+/**
+ * Tunnel protocols recognized by the parser
+ *
+ * A tunnel is identified by the outer IP protocol and, for UDP based
+ * tunnels, the UDP destination port. New tunnel types are supported by
+ * adding an entry with the parser function of the tunnel header.
+ */
+static const struct {
+	uint8_t ip_proto;
+	uint16_t udp_port;
+	parse_tunnel_fn_t parse;
+} parse_tunnel_tbl[] = {
+	{ _ODP_IPPROTO_UDP, _ODP_UDP_PORT_VXLAN, parse_vxlan },
+	{ _ODP_IPPROTO_UDP, _ODP_UDP_PORT_GTPU,  parse_gtpu  },
+	{ _ODP_IPPROTO_GRE, 0,                   parse_gre   }
+};
+
+#define PARSE_TUNNEL_NUM (sizeof(parse_tunnel_tbl) / \
+			  sizeof(parse_tunnel_tbl[0]))
+
+/**
+ * Parser helper function for tunnels
+ *
+ * Called with the offset of the outer L4 header.
+ */
+static inline void parse_tunnel(packet_parser_t *prs, const uint8_t *ptr,
+				uint32_t offset, uint32_t frame_len,
+				uint32_t seg_len)
+{
+	const _odp_udphdr_t *udp;
+	uint16_t port = 0;
+	unsigned i;
+
+	if (prs->ip_proto == _ODP_IPPROTO_UDP) {
+		udp     = (const _odp_udphdr_t *)(ptr + offset);
+		port    = odp_be_to_cpu_16(udp->dst_port);
+		offset += _ODP_UDPHDR_LEN;
+	}
+
+	for (i = 0; i < PARSE_TUNNEL_NUM; i++) {
+		if (parse_tunnel_tbl[i].ip_proto == prs->ip_proto &&
+		    parse_tunnel_tbl[i].udp_port == port) {
+			parse_tunnel_tbl[i].parse(prs, ptr, offset, frame_len,
+						  seg_len);
+			return;
+		}
+	}
+}
+
 /**
  * Initialize L2 related parser flags and metadata
  */
@@ -2415,6 +2997,10 @@ int packet_parse_common(packet_parser_t *prs, const uint8_t *ptr,
 			parseptr += sizeof(_odp_vlanhdr_t);
 		}
 
+		if (odp_unlikely(prs->ethtype == _ODP_ETHTYPE_MPLS ||
+				 prs->ethtype == _ODP_ETHTYPE_MPLS_MCAST))
+			parse_mpls(prs, ptr, &offset, seg_len);
+
 		prs->l3_offset = offset;
 		prs->parsed_layers = LAYER_L2;
 		if (layer == LAYER_L2)
@@ -2486,6 +3072,17 @@ int packet_parse_common(packet_parser_t *prs, const uint8_t *ptr,
 				return -1;
 			prs->input_flags.udp = 1;
 			parse_udp(prs, &parseptr, NULL);
+			if (!prs->input_flags.ipfrag && !prs->error_flags.all)
+				parse_tunnel(prs, ptr, offset, frame_len,
+					     seg_len);
+			break;
+
+		case _ODP_IPPROTO_GRE:
+			prs->input_flags.l4 = 0;
+			if (!prs->input_flags.ipfrag && !prs->error_flags.all)
+				parse_tunnel(prs, ptr, offset, frame_len,
+					     seg_len);
+			prs->l4_offset = ODP_PACKET_OFFSET_INVALID;
 			break;
 
 		case _ODP_IPPROTO_AH:
@@ -2538,6 +3135,172 @@ int packet_parse_layer(odp_packet_hdr_t *pkt_hdr, layer_t layer)
 				   seg_len, layer);
 }
 
+/**
+ * Calculate packet flow hash
+ *
+ * The hash is CRC32C over IP addresses and, when selected in 'hash_proto',
+ * TCP/UDP port numbers. Ports of IP fragments are not hashed. The packet is
+ * parsed first up to the layer of the selected fields, when not parsed
+ * already. Flow hash metadata is left untouched when no selected protocol
+ * matches the packet.
+ */
+void packet_flow_hash(odp_packet_hdr_t *pkt_hdr,
+		      odp_pktin_hash_proto_t hash_proto)
+{
+	uint32_t key[(2 * _ODP_IPV6ADDR_LEN + 4) / sizeof(uint32_t)];
+	uint32_t seg_len = packet_first_seg_len(pkt_hdr);
+	const uint8_t *base = packet_data(pkt_hdr);
+	uint32_t l3_offset, l4_offset;
+	uint32_t len;
+	int udp, tcp, l4;
+	layer_t layer = LAYER_L3;
+
+	if (hash_proto.proto.ipv4_udp || hash_proto.proto.ipv4_tcp ||
+	    hash_proto.proto.ipv6_udp || hash_proto.proto.ipv6_tcp)
+		layer = LAYER_L4;
+
+	if (pkt_hdr->p.parsed_layers < layer)
+		packet_parse_layer(pkt_hdr, layer);
+
+	l3_offset = pkt_hdr->p.l3_offset;
+	l4_offset = pkt_hdr->p.l4_offset;
+	udp = pkt_hdr->p.input_flags.udp;
+	tcp = pkt_hdr->p.input_flags.tcp;
+
+	if (pkt_hdr->p.input_flags.ipv4) {
+		const _odp_ipv4hdr_t *ipv4;
+
+		l4 = (udp && hash_proto.proto.ipv4_udp) ||
+		     (tcp && hash_proto.proto.ipv4_tcp);
+		len = 2 * sizeof(uint32_t);
+
+		if (!l4 && !hash_proto.proto.ipv4)
+			return;
+
+		if (odp_unlikely(l3_offset + _ODP_IPV4HDR_LEN > seg_len))
+			return;
+
+		ipv4 = (const _odp_ipv4hdr_t *)(base + l3_offset);
+		memcpy(key, &ipv4->src_addr, len);
+	} else if (pkt_hdr->p.input_flags.ipv6) {
+		const _odp_ipv6hdr_t *ipv6;
+
+		l4 = (udp && hash_proto.proto.ipv6_udp) ||
+		     (tcp && hash_proto.proto.ipv6_tcp);
+		len = 2 * _ODP_IPV6ADDR_LEN;
+
+		if (!l4 && !hash_proto.proto.ipv6)
+			return;
+
+		if (odp_unlikely(l3_offset + _ODP_IPV6HDR_LEN > seg_len))
+			return;
+
+		ipv6 = (const _odp_ipv6hdr_t *)(base + l3_offset);
+		memcpy(key, &ipv6->src_addr, len);
+	} else {
+		return;
+	}
+
+	/* Source and destination ports are the first four bytes of both TCP
+	 * and UDP headers */
+	if (l4 && !pkt_hdr->p.input_flags.ipfrag &&
+	    l4_offset + sizeof(uint32_t) <= seg_len) {
+		memcpy((uint8_t *)key + len, base + l4_offset,
+		       sizeof(uint32_t));
+		len += sizeof(uint32_t);
+	}
+
+	pkt_hdr->flow_hash = odp_hash_crc32c(key, len, 0);
+	pkt_hdr->p.input_flags.flow_hash = 1;
+}
+
+static inline int packet_parse_proto(odp_packet_hdr_t *pkt_hdr,
+				     odp_proto_layer_t last_layer)
+{
+	input_flags_t flags;
+	layer_t layer;
+
+	switch (last_layer) {
+	case ODP_PROTO_LAYER_NONE:
+		layer = LAYER_NONE;
+		break;
+	case ODP_PROTO_LAYER_L2:
+		layer = LAYER_L2;
+		break;
+	case ODP_PROTO_LAYER_L3:
+		layer = LAYER_L3;
+		break;
+	case ODP_PROTO_LAYER_L4:
+		layer = LAYER_L4;
+		break;
+	case ODP_PROTO_LAYER_ALL:
+		layer = LAYER_ALL;
+		break;
+	default:
+		ODP_ERR("Invalid parse layer: %d\n", (int)last_layer);
+		return -1;
+	}
+
+	/* Reset parser metadata, keep flags of other packet metadata */
+	flags.all       = 0;
+	flags.dst_queue = pkt_hdr->p.input_flags.dst_queue;
+	flags.flow_hash = pkt_hdr->p.input_flags.flow_hash;
+	flags.timestamp = pkt_hdr->p.input_flags.timestamp;
+	flags.color     = pkt_hdr->p.input_flags.color;
+	flags.nodrop    = pkt_hdr->p.input_flags.nodrop;
+
+	pkt_hdr->p.input_flags     = flags;
+	pkt_hdr->p.error_flags.all = 0;
+	pkt_hdr->p.parsed_layers   = LAYER_NONE;
+	pkt_hdr->p.l2_offset       = 0;
+	pkt_hdr->p.l3_offset       = ODP_PACKET_OFFSET_INVALID;
+	pkt_hdr->p.l4_offset       = ODP_PACKET_OFFSET_INVALID;
+
+	if (layer == LAYER_NONE)
+		return 0;
+
+	if (packet_parse_layer(pkt_hdr, layer) < 0)
+		return -1;
+
+	return 0;
+}
+
+int odp_packet_parse(odp_packet_t pkt, const odp_packet_parse_param_t *param)
+{
+	return packet_parse_proto(odp_packet_hdr(pkt), param->last_layer);
+}
+
+int odp_packet_parse_multi(const odp_packet_t pkt[], int num,
+			   const odp_packet_parse_param_t *param)
+{
+	odp_packet_hdr_t *pkt_hdr;
+	int i;
+
+	if (odp_unlikely(num <= 0))
+		return 0;
+
+	pkt_hdr = odp_packet_hdr(pkt[0]);
+	odp_prefetch(packet_data(pkt_hdr));
+
+	for (i = 0; i < num; i++) {
+		odp_packet_hdr_t *next_hdr = NULL;
+
+		/* Fetch headers of the next packet while parsing this one */
+		if (i + 1 < num) {
+			next_hdr = odp_packet_hdr(pkt[i + 1]);
+			odp_prefetch(packet_data(next_hdr));
+		}
+
+		if (odp_unlikely(packet_parse_proto(pkt_hdr,
+						    param->last_layer)))
+			return i ? i : -1;
+
+		pkt_hdr = next_hdr;
+	}
+
+	return num;
+}
+
 uint64_t odp_packet_to_u64(odp_packet_t hdl)
 {
 	return _odp_pri(hdl);
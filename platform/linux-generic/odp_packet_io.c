@@ -10,6 +10,7 @@
 #include <odp_packet_io_queue.h>
 #include <odp/api/packet.h>
 #include <odp_packet_internal.h>
+#include <odp_packet_vector_internal.h>
 #include <odp_internal.h>
 #include <odp/api/spinlock.h>
 #include <odp/api/ticketlock.h>
@@ -22,6 +23,7 @@
 #include <odp_debug_internal.h>
 #include <odp_packet_io_ipc_internal.h>
 #include <odp/api/time.h>
+#include <odp/api/cpu.h>
 
 #include <string.h>
 #include <inttypes.h>
@@ -37,6 +39,9 @@
  * Must be power of two. */
 #define SLEEP_CHECK 32
 
+/* Maximum number of events returned by one input event queue receive */
+#define PKTIN_RECV_MAX CONFIG_PACKET_VECTOR_MAX_SIZE
+
 pktio_table_t *pktio_tbl;
 
 /* pktio pointer entries ( for inlines) */
@@ -129,7 +134,12 @@ static void init_in_queues(pktio_entry_t *entry)
 	for (i = 0; i < PKTIO_MAX_QUEUES; i++) {
 		entry->s.in_queue[i].queue = ODP_QUEUE_INVALID;
 		entry->s.in_queue[i].pktin = PKTIN_INVALID;
+		entry->s.rss.queue[i] = ODP_QUEUE_INVALID;
 	}
+
+	entry->s.rss.hash   = 0;
+	entry->s.rss.spread = 0;
+	entry->s.in_vector.enable = 0;
 }
 
 static void init_out_queues(pktio_entry_t *entry)
@@ -297,6 +307,7 @@ static int _pktio_close(pktio_entry_t *entry)
 
 static void destroy_in_queues(pktio_entry_t *entry, int num)
 {
+	odp_event_t ev;
 	int i;
 
 	for (i = 0; i < num; i++) {
@@ -304,7 +315,19 @@ static void destroy_in_queues(pktio_entry_t *entry, int num)
 			odp_queue_destroy(entry->s.in_queue[i].queue);
 			entry->s.in_queue[i].queue = ODP_QUEUE_INVALID;
 		}
+
+		if (entry->s.rss.queue[i] != ODP_QUEUE_INVALID) {
+			while ((ev = odp_queue_deq(entry->s.rss.queue[i])) !=
+			       ODP_EVENT_INVALID)
+				odp_event_free(ev);
+
+			odp_queue_destroy(entry->s.rss.queue[i]);
+			entry->s.rss.queue[i] = ODP_QUEUE_INVALID;
+		}
 	}
+
+	entry->s.rss.hash   = 0;
+	entry->s.rss.spread = 0;
 }
 
 static void destroy_out_queues(pktio_entry_t *entry, int num)
@@ -471,7 +494,8 @@ int odp_pktio_start(odp_pktio_t hdl)
 			}
 		}
 
-		sched_fn->pktio_start(pktio_to_id(hdl), num, index);
+		sched_fn->pktio_start(pktio_to_id(hdl), num, index,
+				      &entry->s.poll_affinity);
 	}
 
 	return res;
@@ -545,19 +569,126 @@ odp_pktio_t odp_pktio_lookup(const char *name)
 	return hdl;
 }
 
-static inline int pktin_recv_buf(odp_pktin_queue_t queue,
+/* Free packet and packet vector events */
+static inline void pktin_free_hdr(odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		odp_event_free((odp_event_t)buf_hdr[i]->handle.handle);
+}
+
+/* Pack packets into vectors in place. Vector events are stored first,
+ * followed by packets that did not fit into allocated vectors. Returns the
+ * number of events in the table. */
+static inline int pktin_vector_pack(pktio_entry_t *entry,
+				    odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	odp_packet_t pkt[num];
+	odp_packet_vector_t pktv[num];
+	int i, j, num_vec, num_packed;
+
+	for (i = 0; i < num; i++)
+		pkt[i] = _odp_packet_from_buffer(buf_hdr[i]->handle.handle);
+
+	num_vec = packet_vector_pack(entry->s.in_vector.pool,
+				     entry->s.in_vector.max_size,
+				     pkt, num, pktv, &num_packed);
+
+	for (i = 0; i < num_vec; i++)
+		buf_hdr[i] = buf_hdl_to_hdr((odp_buffer_t)pktv[i]);
+
+	for (j = num_packed; j < num; j++)
+		buf_hdr[i++] = buf_hdl_to_hdr(_odp_packet_to_buffer(pkt[j]));
+
+	return i;
+}
+
+/* Enqueue packets with one queue_enq_multi() call per destination queue.
+ * Packet order is maintained per destination queue. */
+static inline void pktin_enq_dst(pktio_entry_t *entry,
+				 odp_buffer_hdr_t *buf_hdr[],
+				 odp_queue_t dst_queue[], int num)
+{
+	odp_buffer_hdr_t *hdr_tbl[num];
+	odp_queue_t queue;
+	int i, j, num_enq, ret;
+
+	for (i = 0; i < num; i++) {
+		if (buf_hdr[i] == NULL)
+			continue;
+
+		queue = dst_queue[i];
+		num_enq = 0;
+		for (j = i; j < num; j++) {
+			if (buf_hdr[j] == NULL || dst_queue[j] != queue)
+				continue;
+			hdr_tbl[num_enq++] = buf_hdr[j];
+			buf_hdr[j] = NULL;
+		}
+
+		if (entry->s.in_vector.enable)
+			num_enq = pktin_vector_pack(entry, hdr_tbl, num_enq);
+
+		ret = queue_enq_multi(queue_to_qentry(queue), hdr_tbl,
+				      num_enq);
+		if (ret < 0)
+			ret = 0;
+
+		if (ret < num_enq)
+			pktin_free_hdr(&hdr_tbl[ret], num_enq - ret);
+	}
+}
+
+/* Receive up to 'num' packets in event burst sized pieces. Stops on the
+ * first short receive. */
+static inline int pktin_recv_burst(odp_pktin_queue_t queue,
+				   odp_packet_t packets[], int num)
+{
+	int pkts = 0;
+	int ret, len;
+
+	while (pkts < num) {
+		len = num - pkts;
+		if (len > QUEUE_MULTI_MAX)
+			len = QUEUE_MULTI_MAX;
+
+		ret = odp_pktin_recv(queue, &packets[pkts], len);
+		if (ret <= 0)
+			break;
+
+		pkts += ret;
+		if (ret < len)
+			break;
+	}
+
+	return pkts;
+}
+
+/* Receive packets of an input event queue. Returns up to PKTIN_RECV_MAX
+ * events. With packet vectors enabled, received packets are returned
+ * packed into vector events. */
+static inline int pktin_recv_buf(pktio_entry_t *entry, odp_pktin_queue_t queue,
 				 odp_buffer_hdr_t *buffer_hdrs[], int num)
 {
 	odp_packet_t pkt;
-	odp_packet_t packets[num];
+	odp_packet_t packets[PKTIN_RECV_MAX];
 	odp_packet_hdr_t *pkt_hdr;
 	odp_buffer_hdr_t *buf_hdr;
 	odp_buffer_t buf;
+	odp_buffer_hdr_t *cls_hdr[PKTIN_RECV_MAX];
+	odp_queue_t cls_queue[PKTIN_RECV_MAX];
+	int vector = entry->s.in_vector.enable;
 	int i;
 	int pkts;
 	int num_rx = 0;
+	int num_cls = 0;
 
-	pkts = odp_pktin_recv(queue, packets, num);
+	if (vector)
+		pkts = pktin_recv_burst(queue, packets,
+					entry->s.in_vector.max_size);
+	else
+		pkts = odp_pktin_recv(queue, packets, num);
 
 	for (i = 0; i < pkts; i++) {
 		pkt = packets[i];
@@ -566,26 +697,74 @@ static inline int pktin_recv_buf(odp_pktin_queue_t queue,
 		buf_hdr = buf_hdl_to_hdr(buf);
 
 		if (pkt_hdr->p.input_flags.dst_queue) {
-			queue_entry_t *dst_queue;
-			int ret;
-
-			dst_queue = queue_to_qentry(pkt_hdr->dst_queue);
-			ret = queue_enq(dst_queue, buf_hdr);
-			if (ret < 0)
-				odp_packet_free(pkt);
+			cls_hdr[num_cls] = buf_hdr;
+			cls_queue[num_cls++] = pkt_hdr->dst_queue;
 			continue;
 		}
 		buffer_hdrs[num_rx++] = buf_hdr;
 	}
+
+	if (num_cls)
+		pktin_enq_dst(entry, cls_hdr, cls_queue, num_cls);
+
+	if (vector && num_rx)
+		num_rx = pktin_vector_pack(entry, buffer_hdrs, num_rx);
+
 	return num_rx;
 }
 
+/* Send packets of a vector. The vector is consumed only when all packets
+ * were sent. Otherwise, unsent packets are moved to the head of the vector
+ * and the caller keeps the vector as with any failed enqueue. */
+static inline int pktout_send_vector(queue_entry_t *qentry,
+				     odp_buffer_hdr_t *buf_hdr)
+{
+	odp_packet_vector_hdr_t *hdr;
+	odp_packet_t *pkt;
+	uint32_t size;
+	int sent = 0;
+	int ret;
+	uint32_t i;
+
+	hdr  = (odp_packet_vector_hdr_t *)(void *)buf_hdr;
+	pkt  = packet_vector_tbl(hdr);
+	size = hdr->size;
+
+	while ((uint32_t)sent < size) {
+		ret = odp_pktout_send(qentry->s.pktout, &pkt[sent],
+				      size - sent);
+		if (ret <= 0)
+			break;
+
+		sent += ret;
+	}
+
+	if (odp_unlikely((uint32_t)sent < size)) {
+		for (i = 0; i < size - sent; i++)
+			pkt[i] = pkt[sent + i];
+
+		hdr->size = size - sent;
+		return -1;
+	}
+
+	buffer_free_multi(&buf_hdr->handle.handle, 1);
+	return 0;
+}
+
+static inline int is_packet_vector(odp_buffer_hdr_t *buf_hdr)
+{
+	return buf_hdr->event_type == ODP_EVENT_PACKET_VECTOR;
+}
+
 int pktout_enqueue(queue_entry_t *qentry, odp_buffer_hdr_t *buf_hdr)
 {
 	odp_packet_t pkt = _odp_packet_from_buffer(buf_hdr->handle.handle);
 	int len = 1;
 	int nbr;
 
+	if (odp_unlikely(is_packet_vector(buf_hdr)))
+		return pktout_send_vector(qentry, buf_hdr);
+
 	nbr = odp_pktout_send(qentry->s.pktout, &pkt, len);
 	return (nbr == len ? 0 : -1);
 }
@@ -603,11 +782,31 @@ int pktout_enq_multi(queue_entry_t *qentry, odp_buffer_hdr_t *buf_hdr[],
 	int nbr;
 	int i;
 
-	for (i = 0; i < num; ++i)
+	for (i = 0; i < num; ++i) {
+		if (odp_unlikely(is_packet_vector(buf_hdr[i])))
+			break;
+
 		pkt_tbl[i] = _odp_packet_from_buffer(buf_hdr[i]->handle.handle);
+	}
 
-	nbr = odp_pktout_send(qentry->s.pktout, pkt_tbl, num);
-	return nbr;
+	if (odp_likely(i == num))
+		return odp_pktout_send(qentry->s.pktout, pkt_tbl, num);
+
+	/* Send packets preceding the vector, the vector and then the rest */
+	if (i) {
+		nbr = odp_pktout_send(qentry->s.pktout, pkt_tbl, i);
+		if (nbr < i)
+			return nbr;
+	}
+
+	if (pktout_send_vector(qentry, buf_hdr[i]))
+		return i;
+
+	if (++i == num)
+		return num;
+
+	nbr = pktout_enq_multi(qentry, &buf_hdr[i], num - i);
+	return nbr > 0 ? i + nbr : i;
 }
 
 int pktout_deq_multi(queue_entry_t *qentry ODP_UNUSED,
@@ -628,14 +827,16 @@ int pktin_enqueue(queue_entry_t *qentry ODP_UNUSED,
 odp_buffer_hdr_t *pktin_dequeue(queue_entry_t *qentry)
 {
 	odp_buffer_hdr_t *buf_hdr;
-	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
+	odp_buffer_hdr_t *hdr_tbl[PKTIN_RECV_MAX];
+	pktio_entry_t *entry = get_pktio_entry(qentry->s.pktin.pktio);
 	int pkts;
 
 	buf_hdr = queue_deq(qentry);
 	if (buf_hdr != NULL)
 		return buf_hdr;
 
-	pkts = pktin_recv_buf(qentry->s.pktin, hdr_tbl, QUEUE_MULTI_MAX);
+	pkts = pktin_recv_buf(entry, qentry->s.pktin, hdr_tbl,
+			      QUEUE_MULTI_MAX);
 
 	if (pkts <= 0)
 		return NULL;
@@ -656,7 +857,8 @@ int pktin_enq_multi(queue_entry_t *qentry ODP_UNUSED,
 int pktin_deq_multi(queue_entry_t *qentry, odp_buffer_hdr_t *buf_hdr[], int num)
 {
 	int nbr;
-	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
+	odp_buffer_hdr_t *hdr_tbl[PKTIN_RECV_MAX];
+	pktio_entry_t *entry = get_pktio_entry(qentry->s.pktin.pktio);
 	int pkts, i, j;
 
 	nbr = queue_deq_multi(qentry, buf_hdr, num);
@@ -669,7 +871,8 @@ int pktin_deq_multi(queue_entry_t *qentry, odp_buffer_hdr_t *buf_hdr[], int num)
 	if (nbr == num)
 		return nbr;
 
-	pkts = pktin_recv_buf(qentry->s.pktin, hdr_tbl, QUEUE_MULTI_MAX);
+	pkts = pktin_recv_buf(entry, qentry->s.pktin, hdr_tbl,
+			      QUEUE_MULTI_MAX);
 	if (pkts <= 0)
 		return nbr;
 
@@ -687,7 +890,7 @@ int pktin_deq_multi(queue_entry_t *qentry, odp_buffer_hdr_t *buf_hdr[], int num)
 
 int sched_cb_pktin_poll(int pktio_index, int num_queue, int index[])
 {
-	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
+	odp_buffer_hdr_t *hdr_tbl[PKTIN_RECV_MAX];
 	int num, idx;
 	pktio_entry_t *entry;
 	entry = pktio_entry_by_index(pktio_index);
@@ -707,7 +910,7 @@ int sched_cb_pktin_poll(int pktio_index, int num_queue, int index[])
 		odp_queue_t queue;
 		odp_pktin_queue_t pktin = entry->s.in_queue[index[idx]].pktin;
 
-		num = pktin_recv_buf(pktin, hdr_tbl, QUEUE_MULTI_MAX);
+		num = pktin_recv_buf(entry, pktin, hdr_tbl, QUEUE_MULTI_MAX);
 
 		if (num == 0)
 			continue;
@@ -911,6 +1114,8 @@ void odp_pktin_queue_param_init(odp_pktin_queue_param_t *param)
 	param->num_queues = 1;
 	/* no need to choose queue type since pktin mode defines it */
 	odp_queue_param_init(&param->queue_param);
+	odp_thrmask_zero(&param->poll_affinity.thrmask);
+	param->vector.pool = ODP_POOL_INVALID;
 }
 
 void odp_pktout_queue_param_init(odp_pktout_queue_param_t *param)
@@ -1095,9 +1300,19 @@ int odp_pktio_term_global(void)
 	return ret;
 }
 
+static int pktio_drv_capability(pktio_entry_t *entry,
+				odp_pktio_capability_t *capa)
+{
+	if (entry->s.ops->capability)
+		return entry->s.ops->capability(entry, capa);
+
+	return single_capability(capa);
+}
+
 int odp_pktio_capability(odp_pktio_t pktio, odp_pktio_capability_t *capa)
 {
 	pktio_entry_t *entry;
+	int num_cpu;
 
 	entry = get_pktio_entry(pktio);
 	if (entry == NULL) {
@@ -1105,10 +1320,25 @@ int odp_pktio_capability(odp_pktio_t pktio, odp_pktio_capability_t *capa)
 		return -1;
 	}
 
-	if (entry->s.ops->capability)
-		return entry->s.ops->capability(entry, capa);
+	if (pktio_drv_capability(entry, capa))
+		return -1;
 
-	return single_capability(capa);
+	/* Flows are spread to multiple input queues in software. More queues
+	 * than CPUs would not add parallelism. */
+	if (capa->max_input_queues == 1) {
+		num_cpu = odp_cpu_count();
+
+		if (num_cpu > 1)
+			capa->max_input_queues = num_cpu < PKTIO_MAX_QUEUES ?
+						 num_cpu : PKTIO_MAX_QUEUES;
+	}
+
+	/* Packet vectors are formed in software */
+	capa->vector.supported = 1;
+	capa->vector.min_size  = 1;
+	capa->vector.max_size  = CONFIG_PACKET_VECTOR_MAX_SIZE;
+
+	return 0;
 }
 
 unsigned odp_pktio_max_index(void)
@@ -1169,6 +1399,39 @@ int odp_pktio_stats_reset(odp_pktio_t pktio)
 	return ret;
 }
 
+static int pktin_vector_config(pktio_entry_t *entry,
+			       const odp_pktin_queue_param_t *param)
+{
+	odp_pktin_mode_t mode = entry->s.param.in_mode;
+	pool_t *pool;
+
+	if (mode != ODP_PKTIN_MODE_QUEUE && mode != ODP_PKTIN_MODE_SCHED) {
+		ODP_DBG("pktio %s: vectors need an event queue input mode\n",
+			entry->s.name);
+		return -1;
+	}
+
+	if (param->vector.pool == ODP_POOL_INVALID) {
+		ODP_DBG("pktio %s: no vector pool\n", entry->s.name);
+		return -1;
+	}
+
+	pool = pool_entry_from_hdl(param->vector.pool);
+
+	if (pool->params.type != ODP_POOL_VECTOR) {
+		ODP_DBG("pktio %s: bad vector pool type\n", entry->s.name);
+		return -1;
+	}
+
+	if (param->vector.max_size > pool->params.vector.max_size) {
+		ODP_DBG("pktio %s: vector max_size too large\n",
+			entry->s.name);
+		return -1;
+	}
+
+	return 0;
+}
+
 int odp_pktin_queue_config(odp_pktio_t pktio,
 			   const odp_pktin_queue_param_t *param)
 {
@@ -1180,6 +1443,8 @@ int odp_pktin_queue_config(odp_pktio_t pktio,
 	int rc;
 	odp_queue_t queue;
 	odp_pktin_queue_param_t default_param;
+	odp_pktin_queue_param_t drv_param;
+	odp_bool_t spread;
 
 	if (param == NULL) {
 		odp_pktin_queue_param_init(&default_param);
@@ -1222,6 +1487,18 @@ int odp_pktin_queue_config(odp_pktio_t pktio,
 		return -1;
 	}
 
+	rc = pktio_drv_capability(entry, &capa);
+	if (rc) {
+		ODP_DBG("pktio %s: unable to read capabilities\n",
+			entry->s.name);
+		return -1;
+	}
+
+	spread = num_queues > capa.max_input_queues;
+
+	if (param->vector.enable && pktin_vector_config(entry, param))
+		return -1;
+
 	/* If re-configuring, destroy old queues */
 	if (entry->s.num_in_queue)
 		destroy_in_queues(entry, entry->s.num_in_queue);
@@ -1271,11 +1548,49 @@ int odp_pktin_queue_config(odp_pktio_t pktio,
 			entry->s.in_queue[i].queue = ODP_QUEUE_INVALID;
 		}
 
+		if (spread && mode == ODP_PKTIN_MODE_DIRECT) {
+			char name[ODP_QUEUE_NAME_LEN];
+
+			snprintf(name, sizeof(name), "odp-pktin-rss-%i-%i",
+				 pktio_to_id(pktio), i);
+
+			queue = odp_queue_create(name, NULL);
+			if (queue == ODP_QUEUE_INVALID) {
+				ODP_DBG("pktio %s: rss queue create failed\n",
+					entry->s.name);
+				destroy_in_queues(entry, i + 1);
+				return -1;
+			}
+
+			entry->s.rss.queue[i] = queue;
+		}
+
 		entry->s.in_queue[i].pktin.index = i;
 		entry->s.in_queue[i].pktin.pktio = entry->s.handle;
 	}
 
 	entry->s.num_in_queue = num_queues;
+	entry->s.poll_affinity = param->poll_affinity;
+	entry->s.in_vector = param->vector;
+
+	if (param->vector.enable && param->vector.max_size == 0)
+		entry->s.in_vector.max_size = pool_entry_from_hdl(
+			param->vector.pool)->params.vector.max_size;
+
+	/* Without hashing, flows are spread using all protocol fields */
+	entry->s.rss.proto.all_bits = ~0;
+	if (param->hash_enable)
+		entry->s.rss.proto = param->hash_proto;
+	entry->s.rss.hash   = param->hash_enable || spread;
+	entry->s.rss.spread = spread;
+
+	if (spread) {
+		drv_param = *param;
+		drv_param.num_queues  = 1;
+		drv_param.hash_enable = 0;
+		drv_param.op_mode     = ODP_PKTIO_OP_MT;
+		param = &drv_param;
+	}
 
 	if (entry->s.ops->input_queues_config)
 		return entry->s.ops->input_queues_config(entry, param);
@@ -1525,10 +1840,77 @@ int odp_pktout_queue(odp_pktio_t pktio, odp_pktout_queue_t queues[], int num)
 	return num_queues;
 }
 
+/* Receive from the single driver input queue and spread packets to input
+ * queues by flow hash. Packets of the requested queue are returned, others
+ * are enqueued to the event or staging queue of their input queue. */
+static int pktin_recv_spread(pktio_entry_t *entry, int index,
+			     odp_packet_t packets[], int num)
+{
+	odp_packet_t pkt_tbl[QUEUE_MULTI_MAX];
+	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
+	odp_queue_t dst_queue[QUEUE_MULTI_MAX];
+	odp_packet_hdr_t *pkt_hdr;
+	uint64_t num_queue = entry->s.num_in_queue;
+	int direct = entry->s.param.in_mode == ODP_PKTIN_MODE_DIRECT;
+	queue_entry_t *qentry;
+	int num_rx = 0;
+	int num_enq = 0;
+	int pkts, i;
+
+	/* Packets spread to this queue on earlier calls */
+	if (direct) {
+		qentry = queue_to_qentry(entry->s.rss.queue[index]);
+		pkts   = num < QUEUE_MULTI_MAX ? num : QUEUE_MULTI_MAX;
+		num_rx = queue_deq_multi(qentry, hdr_tbl, pkts);
+		if (num_rx < 0)
+			num_rx = 0;
+
+		for (i = 0; i < num_rx; i++)
+			packets[i] = _odp_packet_from_buffer(
+					hdr_tbl[i]->handle.handle);
+
+		if (num_rx == num)
+			return num_rx;
+	}
+
+	pkts = entry->s.ops->recv(entry, 0, pkt_tbl, QUEUE_MULTI_MAX);
+
+	if (pkts <= 0)
+		return num_rx ? num_rx : pkts;
+
+	for (i = 0; i < pkts; i++) {
+		unsigned q = 0;
+
+		pkt_hdr = odp_packet_hdr(pkt_tbl[i]);
+		packet_flow_hash(pkt_hdr, entry->s.rss.proto);
+
+		if (pkt_hdr->p.input_flags.flow_hash)
+			q = (pkt_hdr->flow_hash * num_queue) >> 32;
+
+		if (pkt_hdr->p.input_flags.dst_queue) {
+			dst_queue[num_enq] = pkt_hdr->dst_queue;
+		} else if (q == (unsigned)index && num_rx < num) {
+			packets[num_rx++] = pkt_tbl[i];
+			continue;
+		} else {
+			dst_queue[num_enq] = direct ? entry->s.rss.queue[q] :
+					     entry->s.in_queue[q].queue;
+		}
+
+		hdr_tbl[num_enq++] = &pkt_hdr->buf_hdr;
+	}
+
+	if (num_enq)
+		pktin_enq_dst(entry, hdr_tbl, dst_queue, num_enq);
+
+	return num_rx;
+}
+
 int odp_pktin_recv(odp_pktin_queue_t queue, odp_packet_t packets[], int num)
 {
 	pktio_entry_t *entry;
 	odp_pktio_t pktio = queue.pktio;
+	int ret, i;
 
 	entry = get_pktio_entry(pktio);
 	if (entry == NULL) {
@@ -1536,7 +1918,18 @@ int odp_pktin_recv(odp_pktin_queue_t queue, odp_packet_t packets[], int num)
 		return -1;
 	}
 
-	return entry->s.ops->recv(entry, queue.index, packets, num);
+	if (odp_unlikely(entry->s.rss.spread))
+		return pktin_recv_spread(entry, queue.index, packets, num);
+
+	ret = entry->s.ops->recv(entry, queue.index, packets, num);
+
+	if (entry->s.rss.hash) {
+		for (i = 0; i < ret; i++)
+			packet_flow_hash(odp_packet_hdr(packets[i]),
+					 entry->s.rss.proto);
+	}
+
+	return ret;
 }
 
 int odp_pktin_recv_tmo(odp_pktin_queue_t queue, odp_packet_t packets[], int num,
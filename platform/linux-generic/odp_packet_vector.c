@@ -0,0 +1,134 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/api/packet.h>
+#include <odp/api/event.h>
+#include <odp_packet_vector_internal.h>
+#include <odp_pool_internal.h>
+#include <odp_debug_internal.h>
+
+#include <string.h>
+
+odp_packet_vector_t odp_packet_vector_alloc(odp_pool_t pool_hdl)
+{
+	pool_t *pool = pool_entry_from_hdl(pool_hdl);
+	odp_packet_vector_hdr_t *hdr;
+	odp_buffer_hdr_t *buf_hdr;
+	odp_buffer_t buf;
+
+	ODP_ASSERT(pool->params.type == ODP_POOL_VECTOR);
+
+	if (odp_unlikely(buffer_alloc_multi(pool, &buf, &buf_hdr, 1) != 1))
+		return ODP_PACKET_VECTOR_INVALID;
+
+	hdr = (odp_packet_vector_hdr_t *)(void *)buf_hdr;
+	hdr->size = 0;
+
+	return (odp_packet_vector_t)buf;
+}
+
+void odp_packet_vector_free(odp_packet_vector_t pktv)
+{
+	odp_buffer_t buf = (odp_buffer_t)pktv;
+
+	buffer_free_multi(&buf, 1);
+}
+
+odp_packet_vector_t odp_packet_vector_from_event(odp_event_t ev)
+{
+	return (odp_packet_vector_t)ev;
+}
+
+odp_event_t odp_packet_vector_to_event(odp_packet_vector_t pktv)
+{
+	return (odp_event_t)pktv;
+}
+
+uint32_t odp_packet_vector_tbl(odp_packet_vector_t pktv,
+			       odp_packet_t **pkt_tbl)
+{
+	odp_packet_vector_hdr_t *hdr = packet_vector_hdr(pktv);
+
+	*pkt_tbl = packet_vector_tbl(hdr);
+
+	return hdr->size;
+}
+
+uint32_t odp_packet_vector_size(odp_packet_vector_t pktv)
+{
+	return packet_vector_hdr(pktv)->size;
+}
+
+void odp_packet_vector_size_set(odp_packet_vector_t pktv, uint32_t size)
+{
+	odp_packet_vector_hdr_t *hdr = packet_vector_hdr(pktv);
+
+	ODP_ASSERT(size <= pool_entry_from_hdl(hdr->buf_hdr.pool_hdl)->
+		   params.vector.max_size);
+
+	hdr->size = size;
+}
+
+odp_pool_t odp_packet_vector_pool(odp_packet_vector_t pktv)
+{
+	return packet_vector_hdr(pktv)->buf_hdr.pool_hdl;
+}
+
+int odp_packet_vector_valid(odp_packet_vector_t pktv)
+{
+	odp_packet_vector_hdr_t *hdr;
+	pool_t *pool;
+
+	if (pktv == ODP_PACKET_VECTOR_INVALID ||
+	    !odp_buffer_is_valid((odp_buffer_t)pktv))
+		return 0;
+
+	hdr  = packet_vector_hdr(pktv);
+	pool = pool_entry_from_hdl(hdr->buf_hdr.pool_hdl);
+
+	if (hdr->buf_hdr.event_type != ODP_EVENT_PACKET_VECTOR ||
+	    hdr->size > pool->params.vector.max_size)
+		return 0;
+
+	return 1;
+}
+
+uint64_t odp_packet_vector_to_u64(odp_packet_vector_t hdl)
+{
+	return _odp_pri(hdl);
+}
+
+int packet_vector_pack(odp_pool_t pool_hdl, uint32_t max_size,
+		       const odp_packet_t pkt[], int num,
+		       odp_packet_vector_t pktv[], int *num_packed)
+{
+	pool_t *pool = pool_entry_from_hdl(pool_hdl);
+	int num_vec = (num + max_size - 1) / max_size;
+	odp_buffer_t buf[num_vec];
+	odp_buffer_hdr_t *buf_hdr[num_vec];
+	odp_packet_vector_hdr_t *hdr;
+	int i, packed, n;
+
+	num_vec = buffer_alloc_multi(pool, buf, buf_hdr, num_vec);
+	packed  = 0;
+
+	for (i = 0; i < num_vec; i++) {
+		hdr = (odp_packet_vector_hdr_t *)(void *)buf_hdr[i];
+		n   = num - packed;
+
+		if (n > (int)max_size)
+			n = max_size;
+
+		memcpy(packet_vector_tbl(hdr), &pkt[packed],
+		       n * sizeof(odp_packet_t));
+		hdr->size = n;
+		pktv[i]   = (odp_packet_vector_t)buf[i];
+		packed   += n;
+	}
+
+	*num_packed = packed;
+	return num_vec;
+}
@@ -8,14 +8,18 @@
 #include <odp/api/shared_memory.h>
 #include <odp/api/align.h>
 #include <odp/api/ticketlock.h>
+#include <odp/api/cpu.h>
 
 #include <odp_pool_internal.h>
 #include <odp_internal.h>
 #include <odp_buffer_inlines.h>
 #include <odp_packet_internal.h>
+#include <odp_timer_internal.h>
+#include <odp_packet_vector_internal.h>
 #include <odp_config_internal.h>
 #include <odp_debug_internal.h>
 #include <odp_ring_internal.h>
+#include <_ishm_internal.h>
 
 #include <string.h>
 #include <stdio.h>
@@ -29,6 +33,12 @@
 #define CACHE_BURST    32
 #define RING_SIZE_MIN  (2 * CACHE_BURST)
 
+/* Number of alloc/free calls between cache size adaptations */
+#define CACHE_ADAPT_OPS  256
+
+/* Cache grows when more than 1/CACHE_MISS_RATIO of calls miss the cache */
+#define CACHE_MISS_RATIO 16
+
 /* Define a practical limit for contiguous memory allocations */
 #define MAX_SIZE   (10 * 1024 * 1024)
 
@@ -38,10 +48,29 @@ ODP_STATIC_ASSERT(CONFIG_POOL_CACHE_SIZE > (2 * CACHE_BURST),
 ODP_STATIC_ASSERT(CONFIG_PACKET_SEG_LEN_MIN >= 256,
 		  "ODP Segment size must be a minimum of 256 bytes");
 
+ODP_STATIC_ASSERT(CONFIG_PACKET_SEG_SIZE - CONFIG_PACKET_MAX_HEADROOM -
+		  CONFIG_PACKET_MAX_TAILROOM >= 256,
+		  "Packet headroom and tailroom too large for segment size");
+
+ODP_STATIC_ASSERT(sizeof(odp_timeout_hdr_t) <=
+		  offsetof(odp_packet_hdr_t, burst),
+		  "Timeout header overlaps burst table");
+
+ODP_STATIC_ASSERT(sizeof(odp_packet_vector_hdr_t) <=
+		  offsetof(odp_packet_hdr_t, burst),
+		  "Packet vector header overlaps burst table");
+
+ODP_STATIC_ASSERT(CONFIG_PACKET_VECTOR_MAX_SIZE >= CONFIG_BURST_SIZE,
+		  "Packet vector smaller than event burst");
+
+ODP_STATIC_ASSERT(MAX_NUMA_NODES <= ODP_POOL_MAX_NODES,
+		  "Too_many_numa_nodes");
+
 /* Thread local variables */
 typedef struct pool_local_t {
-	pool_cache_t *cache[ODP_CONFIG_POOLS];
 	int thr_id;
+	/* NUMA node of the CPU */
+	int node;
 } pool_local_t;
 
 pool_table_t *pool_tbl;
@@ -52,6 +81,12 @@ static inline odp_pool_t pool_index_to_handle(uint32_t pool_idx)
 	return _odp_cast_scalar(odp_pool_t, pool_idx);
 }
 
+static inline pool_cache_t *pool_local_cache(pool_t *pool)
+{
+	return (pool_cache_t *)(uintptr_t)&pool->cache_base[local.thr_id *
+							   pool->cache_stride];
+}
+
 static inline uint32_t pool_id_from_buf(odp_buffer_t buf)
 {
 	odp_buffer_bits_t handle;
@@ -121,34 +156,95 @@ int odp_pool_term_global(void)
 
 int odp_pool_init_local(void)
 {
-	pool_t *pool;
-	int i;
+	int cpu;
 	int thr_id = odp_thread_id();
 
 	memset(&local, 0, sizeof(pool_local_t));
 
-	for (i = 0; i < ODP_CONFIG_POOLS; i++) {
-		pool           = pool_entry(i);
-		local.cache[i] = &pool->local_cache[thr_id];
-		local.cache[i]->num = 0;
-	}
-
 	local.thr_id = thr_id;
+	local.node   = 0;
+
+	cpu = odp_cpu_id();
+	if (cpu >= 0 && cpu < MAX_CPU_NUMBER)
+		local.node = odp_global_data.system_info.cpu_node[cpu];
+
 	return 0;
 }
 
+/* Ring of the node, which buffer memory belongs to */
+static inline ring_t *home_ring(pool_t *pool, uint32_t data)
+{
+	odp_buffer_bits_t handle;
+
+	if (odp_likely(pool->num_nodes == 1))
+		return &pool->ring->hdr;
+
+	handle.handle = (odp_buffer_t)(uintptr_t)data;
+
+	return &pool->node_ring[handle.index / pool->node_num]->hdr;
+}
+
+/* Return buffers into the rings of their home nodes */
+static inline void ring_enq_home(pool_t *pool, uint32_t data[], uint32_t num)
+{
+	uint32_t i, first;
+	uint32_t mask = pool->ring_mask;
+	ring_t *ring = NULL;
+
+	if (odp_likely(pool->num_nodes == 1)) {
+		ring_enq_multi(&pool->ring->hdr, mask, data, num);
+		return;
+	}
+
+	/* Enqueue runs of buffers with the same home node at once */
+	first = 0;
+
+	for (i = 0; i < num; i++) {
+		ring_t *next = home_ring(pool, data[i]);
+
+		if (next == ring)
+			continue;
+
+		if (ring)
+			ring_enq_multi(ring, mask, &data[first], i - first);
+
+		first = i;
+		ring  = next;
+	}
+
+	if (ring)
+		ring_enq_multi(ring, mask, &data[first], num - first);
+}
+
+/* Dequeue buffers from other nodes, when the local node is out of buffers */
+static uint32_t ring_deq_remote(pool_t *pool, uint32_t data[], uint32_t num)
+{
+	uint32_t i, node;
+	uint32_t num_deq = 0;
+
+	for (i = 1; i < pool->num_nodes && num_deq < num; i++) {
+		node = (local.node + i) % pool->num_nodes;
+
+		num_deq += ring_deq_multi(&pool->node_ring[node]->hdr,
+					  pool->ring_mask, &data[num_deq],
+					  num - num_deq);
+	}
+
+	return num_deq;
+}
+
 static void flush_cache(pool_cache_t *cache, pool_t *pool)
 {
 	ring_t *ring;
 	uint32_t mask;
 	uint32_t cache_num, i, data;
 
-	ring = &pool->ring->hdr;
 	mask = pool->ring_mask;
 	cache_num = cache->num;
 
 	for (i = 0; i < cache_num; i++) {
 		data = (uint32_t)(uintptr_t)cache->buf[i];
+		ring = home_ring(pool, data);
 		ring_enq(ring, mask, data);
 	}
 
@@ -162,7 +258,45 @@ int odp_pool_term_local(void)
 	for (i = 0; i < ODP_CONFIG_POOLS; i++) {
 		pool_t *pool = pool_entry(i);
 
-		flush_cache(local.cache[i], pool);
+		if (pool->reserved && pool->cache_base)
+			flush_cache(pool_local_cache(pool), pool);
+	}
+
+	return 0;
+}
+
+/* Reserve thread local caches. Each cache starts from the maximum size. */
+static int cache_init(pool_t *pool)
+{
+	int i;
+	odp_shm_t shm;
+	char cache_name[ODP_POOL_NAME_LEN];
+
+	pool->cache_stride = ROUNDUP_CACHE_LINE(sizeof(pool_cache_t) +
+						pool->cache_size *
+						sizeof(odp_buffer_t));
+
+	sprintf(cache_name, "pool_cache_%u", pool->pool_idx);
+	shm = odp_shm_reserve(cache_name,
+			      ODP_THREAD_COUNT_MAX * pool->cache_stride,
+			      ODP_CACHE_LINE_SIZE, 0);
+
+	pool->cache_shm = shm;
+
+	if (shm == ODP_SHM_INVALID) {
+		ODP_ERR("Unable to alloc pool cache\n");
+		return -1;
+	}
+
+	pool->cache_base = odp_shm_addr(shm);
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		pool_cache_t *cache;
+
+		cache = (pool_cache_t *)(uintptr_t)
+			&pool->cache_base[i * pool->cache_stride];
+		memset(cache, 0, sizeof(pool_cache_t));
+		cache->size = pool->cache_size;
 	}
 
 	return 0;
@@ -226,9 +360,7 @@ static void init_buffers(pool_t *pool)
 	ring_t *ring;
 	uint32_t mask;
 	int type;
-	uint32_t seg_size;
 
-	ring = &pool->ring->hdr;
 	mask = pool->ring_mask;
 	type = pool->params.type;
 
@@ -240,10 +372,9 @@ static void init_buffers(pool_t *pool)
 		if (pool->uarea_size)
 			uarea = &pool->uarea_base_addr[i * pool->uarea_size];
 
-		data = buf_hdr->data;
-
-		if (type == ODP_POOL_PACKET)
-			data = pkt_hdr->data;
+		/* All event types reserve packet header sized metadata. Burst
+		 * table is stored in its cold end and data after it. */
+		data = pkt_hdr->data;
 
 		offset = pool->headroom;
 
@@ -253,36 +384,111 @@ static void init_buffers(pool_t *pool)
 
 		memset(buf_hdr, 0, (uintptr_t)data - (uintptr_t)buf_hdr);
 
-		seg_size = pool->headroom + pool->data_size + pool->tailroom;
-
 		/* Initialize buffer metadata */
-		buf_hdr->size = seg_size;
 		buf_hdr->type = type;
 		buf_hdr->event_type = type;
 		buf_hdr->pool_hdl = pool->pool_hdl;
-		buf_hdr->uarea_addr = uarea;
-		/* Show user requested size through API */
-		buf_hdr->uarea_size = pool->params.pkt.uarea_size;
+		buf_hdr->burst = pkt_hdr->burst;
 		buf_hdr->segcount = 1;
+		buf_hdr->size = pool->seg_size;
+
+		/* Pointer to data start. Stored for fast init. */
+		buf_hdr->base_data = &data[offset];
 
-		/* Pointer to data start (of the first segment) */
-		buf_hdr->seg[0].hdr       = buf_hdr;
-		buf_hdr->seg[0].data      = &data[offset];
-		buf_hdr->seg[0].len       = pool->data_size;
+		if (type == ODP_POOL_PACKET) {
+			pkt_hdr->uarea_addr = uarea;
+			/* Show user requested size through API */
+			pkt_hdr->uarea_size = pool->params.pkt.uarea_size;
 
-		/* Store base values for fast init */
-		buf_hdr->base_data = buf_hdr->seg[0].data;
-		buf_hdr->buf_end   = &data[offset + pool->data_size +
-				     pool->tailroom];
+			/* First segment */
+			pkt_hdr->seg[0].hdr  = buf_hdr;
+			pkt_hdr->seg[0].data = buf_hdr->base_data;
+			pkt_hdr->seg[0].len  = pool->data_size;
+
+			pkt_hdr->buf_end = &data[offset + pool->data_size +
+					   pool->tailroom];
+		}
 
 		buf_hdl = form_buffer_handle(pool->pool_idx, i);
 		buf_hdr->handle.handle = buf_hdl;
 
-		/* Store buffer into the global pool */
+		/* Store buffer into the global pool of its node */
+		ring = &pool->node_ring[i / pool->node_num]->hdr;
 		ring_enq(ring, mask, (uint32_t)(uintptr_t)buf_hdl);
 	}
 }
 
+static void free_node_rings(pool_t *pool)
+{
+	int i;
+
+	for (i = 1; i < ODP_POOL_MAX_NODES; i++) {
+		if (pool->node_ring_shm[i] != ODP_SHM_INVALID)
+			odp_shm_free(pool->node_ring_shm[i]);
+
+		pool->node_ring_shm[i] = ODP_SHM_INVALID;
+		pool->node_ring[i]     = pool->ring;
+	}
+}
+
+/* Reserve rings for other than the first node, and set the node of each
+ * ring and buffer memory range. Memory binding may fail e.g. due to missing
+ * privileges, which leaves the memory on the node that touches it first. */
+static int numa_init(pool_t *pool)
+{
+	uint32_t node, first, num;
+	int shm_idx, uarea_idx, ring_idx;
+	odp_shm_t shm;
+	char ring_name[ODP_POOL_NAME_LEN];
+
+	shm_idx   = _odp_ishm_lookup_by_address(pool->base_addr);
+	uarea_idx = -1;
+
+	if (pool->uarea_size)
+		uarea_idx = _odp_ishm_lookup_by_address(pool->uarea_base_addr);
+
+	for (node = 0; node < pool->num_nodes; node++) {
+		if (node > 0) {
+			sprintf(ring_name, "pool_ring_%u_%u", pool->pool_idx,
+				node);
+			shm = odp_shm_reserve(ring_name, sizeof(pool_ring_t),
+					      ODP_CACHE_LINE_SIZE, 0);
+
+			if (shm == ODP_SHM_INVALID) {
+				ODP_ERR("Unable to alloc node %u ring\n", node);
+				return -1;
+			}
+
+			pool->node_ring_shm[node] = shm;
+			pool->node_ring[node]     = odp_shm_addr(shm);
+		}
+
+		ring_idx = _odp_ishm_lookup_by_address(pool->node_ring[node]);
+		_odp_ishm_bind_node(ring_idx, 0, sizeof(pool_ring_t), node);
+
+		first = node * pool->node_num;
+
+		if (first >= pool->num)
+			continue;
+
+		num = pool->num - first;
+
+		if (num > pool->node_num)
+			num = pool->node_num;
+
+		_odp_ishm_bind_node(shm_idx, (uint64_t)first * pool->block_size,
+				    (uint64_t)num * pool->block_size, node);
+
+		if (uarea_idx >= 0)
+			_odp_ishm_bind_node(uarea_idx,
+					    (uint64_t)first * pool->uarea_size,
+					    (uint64_t)num * pool->uarea_size,
+					    node);
+	}
+
+	return 0;
+}
+
 static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 			      uint32_t shmflags)
 {
@@ -290,8 +496,8 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 	uint32_t uarea_size, headroom, tailroom;
 	odp_shm_t shm;
 	uint32_t data_size, align, num, hdr_size, block_size;
-	uint32_t max_len, max_seg_len;
-	uint32_t ring_size;
+	uint32_t max_len, max_seg_len, min_seg_len, seg_len, len;
+	uint32_t ring_size, num_nodes, i;
 	int name_len;
 	const char *postfix = "_uarea";
 	char uarea_name[ODP_POOL_NAME_LEN + sizeof(postfix)];
@@ -334,15 +540,66 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 		tailroom    = CONFIG_PACKET_TAILROOM;
 		num         = params->pkt.num;
 		uarea_size  = params->pkt.uarea_size;
-		data_size   = CONFIG_PACKET_MAX_SEG_LEN;
-		max_seg_len = CONFIG_PACKET_MAX_SEG_LEN;
+
+		if (params->pkt.headroom)
+			headroom = params->pkt.headroom;
+
+		if (params->pkt.tailroom)
+			tailroom = params->pkt.tailroom;
+
+		/* Segment data length is limited by the segment size that
+		 * includes both rooms */
+		max_seg_len = CONFIG_PACKET_SEG_SIZE - headroom - tailroom;
+		min_seg_len = CONFIG_PACKET_SEG_LEN_MIN;
+		seg_len     = max_seg_len;
+
+		if (min_seg_len > max_seg_len)
+			min_seg_len = max_seg_len;
+
+		if (params->pkt.seg_len) {
+			seg_len = params->pkt.seg_len;
+
+			if (seg_len < min_seg_len)
+				seg_len = min_seg_len;
+		}
+
+		/* Segments must fit 'len' and 'max_len' bytes long packets */
+		len = params->pkt.len;
+
+		if (params->pkt.max_len > len)
+			len = params->pkt.max_len;
+
+		if (len > CONFIG_PACKET_MAX_SEGS * seg_len)
+			seg_len = (len + CONFIG_PACKET_MAX_SEGS - 1) /
+				  CONFIG_PACKET_MAX_SEGS;
+
+		if (seg_len > max_seg_len) {
+			ODP_ERR("Bad segment or packet length");
+			return ODP_POOL_INVALID;
+		}
+
+		data_size   = seg_len;
+		max_seg_len = seg_len;
 		max_len     = CONFIG_PACKET_MAX_SEGS * max_seg_len;
+
+		/* Reserve segments for 'num' packets of 'len' bytes */
+		if (params->pkt.len > seg_len) {
+			num *= (params->pkt.len + seg_len - 1) / seg_len;
+
+			if (num > CONFIG_POOL_MAX_NUM)
+				num = CONFIG_POOL_MAX_NUM;
+		}
 		break;
 
 	case ODP_POOL_TIMEOUT:
 		num = params->tmo.num;
 		break;
 
+	case ODP_POOL_VECTOR:
+		num = params->vector.num;
+		data_size = params->vector.max_size * sizeof(odp_packet_t);
+		break;
+
 	default:
 		ODP_ERR("Bad pool type");
 		return ODP_POOL_INVALID;
@@ -388,6 +645,7 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 	pool->align          = align;
 	pool->headroom       = headroom;
 	pool->data_size      = data_size;
+	pool->seg_size       = headroom + data_size + tailroom;
 	pool->max_len        = max_len;
 	pool->max_seg_len    = max_seg_len;
 	pool->tailroom       = tailroom;
@@ -396,6 +654,67 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 	pool->shm_size       = num * block_size;
 	pool->uarea_shm_size = num * uarea_size;
 
+	num_nodes = 1;
+
+	if (params->numa)
+		num_nodes = odp_global_data.system_info.numa_nodes;
+
+	pool->num_nodes = num_nodes;
+	pool->node_num  = (num + num_nodes - 1) / num_nodes;
+
+	if (pool->node_num == 0)
+		pool->node_num = 1;
+
+	for (i = 0; i < ODP_POOL_MAX_NODES; i++) {
+		pool->node_ring_shm[i] = ODP_SHM_INVALID;
+		pool->node_ring[i]     = pool->ring;
+	}
+
+	/* Cache parameters may be garbage when the application did not call
+	 * odp_pool_param_init(). Out of range values fall back to defaults. */
+	pool->cache_size   = CONFIG_POOL_CACHE_SIZE;
+	pool->cache_refill = CACHE_BURST;
+	pool->cache_flush  = CACHE_BURST;
+
+	if (params->cache.size && params->cache.size <= CONFIG_POOL_CACHE_SIZE)
+		pool->cache_size = params->cache.size;
+	else if (params->cache.size)
+		ODP_DBG("Pool %s: bad cache.size %u, using default\n",
+			pool->name, params->cache.size);
+
+	if (pool->cache_refill > pool->cache_size)
+		pool->cache_refill = pool->cache_size;
+
+	if (pool->cache_flush > pool->cache_size)
+		pool->cache_flush = pool->cache_size;
+
+	if (params->cache.refill && params->cache.refill <= pool->cache_size)
+		pool->cache_refill = params->cache.refill;
+	else if (params->cache.refill)
+		ODP_DBG("Pool %s: bad cache.refill %u, using default\n",
+			pool->name, params->cache.refill);
+
+	if (params->cache.flush && params->cache.flush <= pool->cache_size)
+		pool->cache_flush = params->cache.flush;
+	else if (params->cache.flush)
+		ODP_DBG("Pool %s: bad cache.flush %u, using default\n",
+			pool->name, params->cache.flush);
+
+	pool->params.cache.size   = pool->cache_size;
+	pool->params.cache.refill = pool->cache_refill;
+	pool->params.cache.flush  = pool->cache_flush;
+
+	pool->cache_min = pool->cache_refill;
+
+	if (pool->cache_flush > pool->cache_min)
+		pool->cache_min = pool->cache_flush;
+
+	pool->cache_shm  = ODP_SHM_INVALID;
+	pool->cache_base = NULL;
+
+	if (cache_init(pool))
+		goto error;
+
 	shm = odp_shm_reserve(pool->name, pool->shm_size,
 			      ODP_PAGE_SIZE, shmflags);
 
@@ -423,7 +742,12 @@ static odp_pool_t pool_create(const char *name, odp_pool_param_t *params,
 		pool->uarea_base_addr = odp_shm_addr(pool->uarea_shm);
 	}
 
-	ring_init(&pool->ring->hdr);
+	if (num_nodes > 1 && numa_init(pool))
+		goto error;
+
+	for (i = 0; i < num_nodes; i++)
+		ring_init(&pool->node_ring[i]->hdr);
+
 	init_buffers(pool);
 
 	return pool->pool_hdl;
@@ -435,6 +759,12 @@ error:
 	if (pool->uarea_shm != ODP_SHM_INVALID)
 		odp_shm_free(pool->uarea_shm);
 
+	if (pool->cache_shm != ODP_SHM_INVALID)
+		odp_shm_free(pool->cache_shm);
+
+	pool->cache_base = NULL;
+	free_node_rings(pool);
+
 	LOCK(&pool->lock);
 	pool->reserved = 0;
 	UNLOCK(&pool->lock);
@@ -447,6 +777,12 @@ static int check_params(odp_pool_param_t *params)
 
 	odp_pool_capability(&capa);
 
+	if (params->shm_flags & ~(ODP_SHM_HP_2M | ODP_SHM_HP_1G |
+				  ODP_SHM_PREFAULT)) {
+		printf("bad shm_flags 0x%x\n", params->shm_flags);
+		return -1;
+	}
+
 	switch (params->type) {
 	case ODP_POOL_BUFFER:
 		if (params->buf.num > capa.buf.max_num) {
@@ -484,6 +820,18 @@ static int check_params(odp_pool_param_t *params)
 			return -1;
 		}
 
+		if (params->pkt.headroom > capa.pkt.max_headroom) {
+			printf("pkt.headroom too large %u\n",
+			       params->pkt.headroom);
+			return -1;
+		}
+
+		if (params->pkt.tailroom > capa.pkt.max_tailroom) {
+			printf("pkt.tailroom too large %u\n",
+			       params->pkt.tailroom);
+			return -1;
+		}
+
 		if (params->pkt.uarea_size > capa.pkt.max_uarea_size) {
 			printf("pkt.uarea_size too large %u\n",
 			       params->pkt.uarea_size);
@@ -499,6 +847,21 @@ static int check_params(odp_pool_param_t *params)
 		}
 		break;
 
+	case ODP_POOL_VECTOR:
+		if (params->vector.num > capa.vector.max_num) {
+			printf("vector.num too large %u\n",
+			       params->vector.num);
+			return -1;
+		}
+
+		if (params->vector.max_size == 0 ||
+		    params->vector.max_size > capa.vector.max_size) {
+			printf("bad vector.max_size %u\n",
+			       params->vector.max_size);
+			return -1;
+		}
+		break;
+
 	default:
 		printf("bad pool type %i\n", params->type);
 		return -1;
@@ -519,6 +882,8 @@ odp_pool_t odp_pool_create(const char *name, odp_pool_param_t *params)
 		shm_flags = ODP_SHM_PROC;
 #endif
 
+	shm_flags |= params->shm_flags;
+
 	return pool_create(name, params, shm_flags);
 }
 
@@ -540,14 +905,18 @@ int odp_pool_destroy(odp_pool_t pool_hdl)
 
 	/* Make sure local caches are empty */
 	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
-		flush_cache(&pool->local_cache[i], pool);
+		flush_cache((pool_cache_t *)(uintptr_t)
+			    &pool->cache_base[i * pool->cache_stride], pool);
 
 	odp_shm_free(pool->shm);
+	odp_shm_free(pool->cache_shm);
+	pool->cache_base = NULL;
 
 	if (pool->uarea_shm != ODP_SHM_INVALID)
 		odp_shm_free(pool->uarea_shm);
 
 	pool->reserved = 0;
+	free_node_rings(pool);
 	odp_shm_free(pool->ring_shm);
 	pool->ring = NULL;
 	UNLOCK(&pool->lock);
@@ -588,16 +957,76 @@ odp_pool_t odp_pool_lookup(const char *name)
 int odp_pool_info(odp_pool_t pool_hdl, odp_pool_info_t *info)
 {
 	pool_t *pool = pool_entry_from_hdl(pool_hdl);
+	uint32_t i;
 
 	if (pool == NULL || info == NULL)
 		return -1;
 
 	info->name = pool->name;
 	info->params = pool->params;
+	info->num_nodes = pool->num_nodes;
+
+	memset(info->node, 0, sizeof(info->node));
+
+	for (i = 0; i < pool->num_nodes; i++) {
+		uint32_t first = i * pool->node_num;
+
+		if (first < pool->num)
+			info->node[i].num = pool->num - first;
+
+		if (info->node[i].num > pool->node_num)
+			info->node[i].num = pool->node_num;
+
+		info->node[i].num_free = ring_len(&pool->node_ring[i]->hdr);
+	}
+
+	memset(&info->cache, 0, sizeof(info->cache));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		pool_cache_t *cache = (pool_cache_t *)(uintptr_t)
+				      &pool->cache_base[i * pool->cache_stride];
+
+		info->cache.alloc_hit  += cache->alloc_hit;
+		info->cache.alloc_miss += cache->alloc_miss;
+		info->cache.free_hit   += cache->free_hit;
+		info->cache.free_miss  += cache->free_miss;
+	}
 
 	return 0;
 }
 
+/* Adapt cache working size to the recent alloc/free pattern. Grow when
+ * the cache misses often. Shrink when the cache has been hit always but
+ * only half of it has been in use, so that idle buffers are not held in the
+ * cache. */
+static void cache_adapt(pool_t *pool, pool_cache_t *cache)
+{
+	uint32_t size = cache->size;
+
+	if (cache->miss > CACHE_ADAPT_OPS / CACHE_MISS_RATIO) {
+		size = 2 * size;
+
+		if (size > pool->cache_size)
+			size = pool->cache_size;
+	} else if (cache->miss == 0 && cache->high <= size / 2) {
+		size = size / 2;
+
+		if (size < pool->cache_min)
+			size = pool->cache_min;
+	}
+
+	cache->size = size;
+	cache->ops  = 0;
+	cache->miss = 0;
+	cache->high = cache->num;
+}
+
+static inline void cache_ops_inc(pool_t *pool, pool_cache_t *cache)
+{
+	if (odp_unlikely(++cache->ops == CACHE_ADAPT_OPS))
+		cache_adapt(pool, cache);
+}
+
 int buffer_alloc_multi(pool_t *pool, odp_buffer_t buf[],
 		       odp_buffer_hdr_t *buf_hdr[], int max_num)
 {
@@ -607,20 +1036,25 @@ int buffer_alloc_multi(pool_t *pool, odp_buffer_t buf[],
 	uint32_t cache_num, num_ch, num_deq, burst;
 	odp_buffer_hdr_t *hdr;
 
-	cache = local.cache[pool->pool_idx];
+	cache = pool_local_cache(pool);
 
 	cache_num = cache->num;
 	num_ch    = max_num;
 	num_deq   = 0;
-	burst     = CACHE_BURST;
+	burst     = pool->cache_refill;
 
 	if (odp_unlikely(cache_num < (uint32_t)max_num)) {
 		/* Cache does not have enough buffers */
 		num_ch  = cache_num;
 		num_deq = max_num - cache_num;
 
-		if (odp_unlikely(num_deq > CACHE_BURST))
+		if (odp_unlikely(num_deq > burst))
 			burst = num_deq;
+
+		cache->alloc_miss++;
+		cache->miss++;
+	} else {
+		cache->alloc_hit++;
 	}
 
 	/* Get buffers from the cache */
@@ -637,9 +1071,16 @@ int buffer_alloc_multi(pool_t *pool, odp_buffer_t buf[],
 		 * and not uint32_t. */
 		uint32_t data[burst];
 
-		ring      = &pool->ring->hdr;
+		ring      = &pool->node_ring[local.node]->hdr;
 		mask      = pool->ring_mask;
 		burst     = ring_deq_multi(ring, mask, data, burst);
+
+		/* Fall back to other nodes, but take only the buffers
+		 * needed. */
+		if (odp_unlikely(burst < num_deq && pool->num_nodes > 1))
+			burst += ring_deq_remote(pool, &data[burst],
+						 num_deq - burst);
+
 		cache_num = burst - num_deq;
 
 		if (odp_unlikely(burst < num_deq)) {
@@ -658,7 +1099,8 @@ int buffer_alloc_multi(pool_t *pool, odp_buffer_t buf[],
 				buf_hdr[idx] = hdr;
 		}
 
-		/* Cache extra buffers. Cache is currently empty. */
+		/* Cache extra buffers. Cache is currently empty. Refill size
+		 * is not larger than cache minimum size. */
 		for (i = 0; i < cache_num; i++)
 			cache->buf[i] = (odp_buffer_t)
 					(uintptr_t)data[num_deq + i];
@@ -668,6 +1110,8 @@ int buffer_alloc_multi(pool_t *pool, odp_buffer_t buf[],
 		cache->num = cache_num - num_ch;
 	}
 
+	cache_ops_inc(pool, cache);
+
 	return num_ch + num_deq;
 }
 
@@ -679,35 +1123,43 @@ static inline void buffer_free_to_pool(uint32_t pool_id,
 	ring_t *ring;
 	uint32_t mask;
 	pool_cache_t *cache;
-	uint32_t cache_num;
+	uint32_t cache_num, cache_size;
 
-	cache = local.cache[pool_id];
 	pool  = pool_entry(pool_id);
+	cache = pool_local_cache(pool);
+	cache_size = cache->size;
 
 	/* Special case of a very large free. Move directly to
 	 * the global pool. */
-	if (odp_unlikely(num > CONFIG_POOL_CACHE_SIZE)) {
-		ring  = &pool->ring->hdr;
+	if (odp_unlikely(num > (int)cache_size)) {
 		mask  = pool->ring_mask;
-		for (i = 0; i < num; i++)
-			ring_enq(ring, mask, (uint32_t)(uintptr_t)buf[i]);
+		for (i = 0; i < num; i++) {
+			uint32_t data = (uint32_t)(uintptr_t)buf[i];
+
+			ring = home_ring(pool, data);
+			ring_enq(ring, mask, data);
+		}
 
+		cache->free_miss++;
+		cache->miss++;
+		cache_ops_inc(pool, cache);
 		return;
 	}
 
-	/* Make room into local cache if needed. Do at least burst size
+	/* Make room into local cache if needed. Do at least flush size
 	 * transfer. */
 	cache_num = cache->num;
 
-	if (odp_unlikely((int)(CONFIG_POOL_CACHE_SIZE - cache_num) < num)) {
+	if (odp_unlikely((int)(cache_size - cache_num) < num)) {
 		uint32_t index;
-		int burst = CACHE_BURST;
+		uint32_t burst = pool->cache_flush;
+		uint32_t needed = num - (cache_size - cache_num);
 
-		ring  = &pool->ring->hdr;
-		mask  = pool->ring_mask;
+		if (odp_unlikely(needed > burst))
+			burst = needed;
 
-		if (odp_unlikely(num > CACHE_BURST))
-			burst = num;
+		if (burst > cache_num)
+			burst = cache_num;
 
 		{
 			/* Temporary copy needed since odp_buffer_t is
@@ -716,20 +1168,30 @@ static inline void buffer_free_to_pool(uint32_t pool_id,
 
 			index = cache_num - burst;
 
-			for (i = 0; i < burst; i++)
+			for (i = 0; i < (int)burst; i++)
 				data[i] = (uint32_t)
 					  (uintptr_t)cache->buf[index + i];
 
-			ring_enq_multi(ring, mask, data, burst);
+			ring_enq_home(pool, data, burst);
 		}
 
 		cache_num -= burst;
+		cache->free_miss++;
+		cache->miss++;
+	} else {
+		cache->free_hit++;
 	}
 
 	for (i = 0; i < num; i++)
 		cache->buf[cache_num + i] = buf[i];
 
-	cache->num = cache_num + num;
+	cache_num += num;
+	cache->num = cache_num;
+
+	if (cache_num > cache->high)
+		cache->high = cache_num;
+
+	cache_ops_inc(pool, cache);
 }
 
 void buffer_free_multi(const odp_buffer_t buf[], int num_total)
@@ -803,6 +1265,8 @@ int odp_pool_capability(odp_pool_capability_t *capa)
 	memset(capa, 0, sizeof(odp_pool_capability_t));
 
 	capa->max_pools = ODP_CONFIG_POOLS;
+	capa->numa_nodes = odp_global_data.system_info.numa_nodes;
+	capa->max_cache_size = CONFIG_POOL_CACHE_SIZE;
 
 	/* Buffer pools */
 	capa->buf.max_pools = ODP_CONFIG_POOLS;
@@ -815,9 +1279,11 @@ int odp_pool_capability(odp_pool_capability_t *capa)
 	capa->pkt.max_len          = CONFIG_PACKET_MAX_SEGS * max_seg_len;
 	capa->pkt.max_num	   = CONFIG_POOL_MAX_NUM;
 	capa->pkt.min_headroom     = CONFIG_PACKET_HEADROOM;
+	capa->pkt.max_headroom     = CONFIG_PACKET_MAX_HEADROOM;
 	capa->pkt.min_tailroom     = CONFIG_PACKET_TAILROOM;
+	capa->pkt.max_tailroom     = CONFIG_PACKET_MAX_TAILROOM;
 	capa->pkt.max_segs_per_pkt = CONFIG_PACKET_MAX_SEGS;
-	capa->pkt.min_seg_len      = max_seg_len;
+	capa->pkt.min_seg_len      = CONFIG_PACKET_SEG_LEN_MIN;
 	capa->pkt.max_seg_len      = max_seg_len;
 	capa->pkt.max_uarea_size   = MAX_SIZE;
 
@@ -825,12 +1291,18 @@ int odp_pool_capability(odp_pool_capability_t *capa)
 	capa->tmo.max_pools = ODP_CONFIG_POOLS;
 	capa->tmo.max_num   = CONFIG_POOL_MAX_NUM;
 
+	/* Packet vector pools */
+	capa->vector.max_pools = ODP_CONFIG_POOLS;
+	capa->vector.max_num   = CONFIG_POOL_MAX_NUM;
+	capa->vector.max_size  = CONFIG_PACKET_VECTOR_MAX_SIZE;
+
 	return 0;
 }
 
 void odp_pool_print(odp_pool_t pool_hdl)
 {
 	pool_t *pool;
+	uint32_t i;
 
 	pool = pool_entry_from_hdl(pool_hdl);
 
@@ -843,7 +1315,8 @@ void odp_pool_print(odp_pool_t pool_hdl)
 	       pool->params.type == ODP_POOL_BUFFER ? "buffer" :
 	       (pool->params.type == ODP_POOL_PACKET ? "packet" :
 	       (pool->params.type == ODP_POOL_TIMEOUT ? "timeout" :
-		"unknown")));
+	       (pool->params.type == ODP_POOL_VECTOR ? "vector" :
+		"unknown"))));
 	printf("  pool shm        %" PRIu64 "\n",
 	       odp_shm_to_u64(pool->shm));
 	printf("  user area shm   %" PRIu64 "\n",
@@ -861,6 +1334,32 @@ void odp_pool_print(odp_pool_t pool_hdl)
 	printf("  base addr       %p\n", pool->base_addr);
 	printf("  uarea shm size  %u\n", pool->uarea_shm_size);
 	printf("  uarea base addr %p\n", pool->uarea_base_addr);
+	printf("  numa nodes      %u\n", pool->num_nodes);
+
+	for (i = 0; i < pool->num_nodes; i++)
+		printf("    node %u free   %u\n", i,
+		       ring_len(&pool->node_ring[i]->hdr));
+
+	printf("  cache size      %u\n", pool->cache_size);
+	printf("  cache refill    %u\n", pool->cache_refill);
+	printf("  cache flush     %u\n", pool->cache_flush);
+	printf("  cache stats     thread: size num alloc hit/miss "
+	       "free hit/miss\n");
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		pool_cache_t *cache = (pool_cache_t *)(uintptr_t)
+				      &pool->cache_base[i * pool->cache_stride];
+
+		if (cache->alloc_hit + cache->alloc_miss == 0 &&
+		    cache->free_hit + cache->free_miss == 0)
+			continue;
+
+		printf("    %3u: %4u %4u %" PRIu64 "/%" PRIu64 " %" PRIu64
+		       "/%" PRIu64 "\n", i, cache->size, cache->num,
+		       cache->alloc_hit, cache->alloc_miss, cache->free_hit,
+		       cache->free_miss);
+	}
+
 	printf("\n");
 }
 
@@ -14,6 +14,7 @@
 #include <odp_buffer_inlines.h>
 #include <odp_internal.h>
 #include <odp/api/shared_memory.h>
+#include <odp/api/spinlock.h>
 #include <odp/api/schedule.h>
 #include <odp_schedule_if.h>
 #include <odp_config_internal.h>
@@ -36,9 +37,22 @@
 
 typedef struct queue_table_t {
 	queue_entry_t  queue[ODP_CONFIG_QUEUES];
+	/* Serializes reserve of the ring table */
+	odp_spinlock_t ring_lock;
 } queue_table_t;
 
+typedef struct queue_ring_table_t {
+	queue_ring_t   ring[ODP_CONFIG_QUEUES];
+} queue_ring_table_t;
+
 static queue_table_t *queue_tbl;
+static queue_ring_table_t *queue_ring_tbl;
+
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(CONFIG_QUEUE_MAX_SIZE),
+		  "Queue_max_size_is_not_power_of_two");
+
+ODP_STATIC_ASSERT(CONFIG_QUEUE_DEFAULT_SIZE <= CONFIG_QUEUE_MAX_SIZE,
+		  "Queue_default_size_is_too_large");
 
 static inline odp_queue_t queue_from_id(uint32_t queue_id)
 {
@@ -60,9 +74,50 @@ queue_entry_t *get_qentry(uint32_t queue_id)
 	return &queue_tbl->queue[queue_id];
 }
 
+/* Ring table is reserved when the first ring based queue is created. Queues
+ * store ring pointers, so the table is mapped to the same address in all
+ * processes. */
+static int queue_ring_tbl_reserve(void)
+{
+	odp_shm_t shm;
+
+	odp_spinlock_lock(&queue_tbl->ring_lock);
+
+	shm = odp_shm_lookup("odp_queue_rings");
+	if (shm == ODP_SHM_INVALID)
+		shm = odp_shm_reserve("odp_queue_rings",
+				      sizeof(queue_ring_table_t),
+				      ODP_CACHE_LINE_SIZE, ODP_SHM_SINGLE_VA);
+
+	odp_spinlock_unlock(&queue_tbl->ring_lock);
+
+	queue_ring_tbl = odp_shm_addr(shm);
+
+	if (queue_ring_tbl == NULL) {
+		ODP_ERR("Queue ring table reserve failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 static int queue_init(queue_entry_t *queue, const char *name,
 		      const odp_queue_param_t *param)
 {
+	uint32_t size = param->size;
+
+	if (size == 0)
+		size = CONFIG_QUEUE_DEFAULT_SIZE;
+
+	if (size > CONFIG_QUEUE_MAX_SIZE) {
+		ODP_ERR("Too large queue size %" PRIu32 "\n", size);
+		return -1;
+	}
+
+	if (size && odp_unlikely(queue_ring_tbl == NULL) &&
+	    queue_ring_tbl_reserve())
+		return -1;
+
 	if (name == NULL) {
 		queue->s.name[0] = 0;
 	} else {
@@ -99,6 +154,15 @@ static int queue_init(queue_entry_t *queue, const char *name,
 	queue->s.head = NULL;
 	queue->s.tail = NULL;
 
+	if (size) {
+		queue->s.ring      = &queue_ring_tbl->ring[queue->s.index];
+		queue->s.ring_mask = ROUNDUP_POWER2_U32(size) - 1;
+		ring_init(&queue->s.ring->hdr);
+	} else {
+		queue->s.ring      = NULL;
+		queue->s.ring_mask = 0;
+	}
+
 	return 0;
 }
 
@@ -120,6 +184,10 @@ int odp_queue_init_global(void)
 		return -1;
 
 	memset(queue_tbl, 0, sizeof(queue_table_t));
+	odp_spinlock_init(&queue_tbl->ring_lock);
+
+	/* Ring data is not initialized, rings are reset on queue create */
+	queue_ring_tbl = NULL;
 
 	for (i = 0; i < ODP_CONFIG_QUEUES; i++) {
 		/* init locks */
@@ -145,6 +213,7 @@ int odp_queue_term_global(void)
 	int ret = 0;
 	int rc = 0;
 	queue_entry_t *queue;
+	odp_shm_t shm;
 	int i;
 
 	for (i = 0; i < ODP_CONFIG_QUEUES; i++) {
@@ -157,6 +226,13 @@ int odp_queue_term_global(void)
 		UNLOCK(&queue->s.lock);
 	}
 
+	shm = odp_shm_lookup("odp_queue_rings");
+	if (shm != ODP_SHM_INVALID && odp_shm_free(shm) < 0) {
+		ODP_ERR("shm free failed for odp_queue_rings");
+		rc = -1;
+	}
+	queue_ring_tbl = NULL;
+
 	ret = odp_shm_free(odp_shm_lookup("odp_queues"));
 	if (ret < 0) {
 		ODP_ERR("shm free failed for odp_queues");
@@ -175,6 +251,7 @@ int odp_queue_capability(odp_queue_capability_t *capa)
 	capa->max_ordered_locks = sched_fn->max_ordered_locks();
 	capa->max_sched_groups  = sched_fn->num_grps();
 	capa->sched_prios       = odp_schedule_num_prio();
+	capa->max_size          = CONFIG_QUEUE_MAX_SIZE;
 
 	return 0;
 }
@@ -275,6 +352,19 @@ odp_queue_t odp_queue_create(const char *name, const odp_queue_param_t *param)
 	return handle;
 }
 
+static inline int queue_is_empty(queue_entry_t *queue)
+{
+	ring_t *ring;
+
+	if (queue->s.ring == NULL)
+		return queue->s.head == NULL;
+
+	ring = &queue->s.ring->hdr;
+
+	return odp_atomic_load_acq_u32(&ring->w_tail) ==
+	       odp_atomic_load_acq_u32(&ring->r_tail);
+}
+
 void sched_cb_queue_destroy_finalize(uint32_t queue_index)
 {
 	queue_entry_t *queue = get_qentry(queue_index);
@@ -307,7 +397,7 @@ int odp_queue_destroy(odp_queue_t handle)
 		ODP_ERR("queue \"%s\" already destroyed\n", queue->s.name);
 		return -1;
 	}
-	if (queue->s.head != NULL) {
+	if (!queue_is_empty(queue)) {
 		UNLOCK(&queue->s.lock);
 		ODP_ERR("queue \"%s\" not empty\n", queue->s.name);
 		return -1;
@@ -381,6 +471,47 @@ odp_queue_t odp_queue_lookup(const char *name)
 	return ODP_QUEUE_INVALID;
 }
 
+static inline int enq_multi_ring(queue_entry_t *queue,
+				 odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	int sched = 0;
+	int i;
+	uint32_t buf[num];
+
+	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
+		ODP_ERR("Bad queue status\n");
+		return -1;
+	}
+
+	for (i = 0; i < num; i++)
+		buf[i] = (uint32_t)(uintptr_t)buf_hdr[i]->handle.handle;
+
+	num = ring_try_enq_multi(&queue->s.ring->hdr, queue->s.ring_mask,
+				 buf, num);
+
+	if (odp_unlikely(num == 0) || queue->s.type != ODP_QUEUE_TYPE_SCHED)
+		return num;
+
+	/* Events must be visible in the ring before status is checked. Pairs
+	 * with the status update in deq_multi_ring(). */
+	odp_mb_full();
+
+	if (odp_unlikely(queue->s.status == QUEUE_STATUS_NOTSCHED)) {
+		LOCK(&queue->s.lock);
+		if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
+			queue->s.status = QUEUE_STATUS_SCHED;
+			sched = 1; /* retval: schedule queue */
+		}
+		UNLOCK(&queue->s.lock);
+	}
+
+	/* Add queue to scheduling */
+	if (sched && sched_fn->sched_queue(queue->s.index))
+		ODP_ABORT("schedule_queue failed\n");
+
+	return num;
+}
+
 static inline int enq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
 			    int num)
 {
@@ -392,6 +523,9 @@ static inline int enq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
 			&ret))
 		return ret;
 
+	if (queue->s.ring)
+		return enq_multi_ring(queue, buf_hdr, num);
+
 	/* Optimize the common case of single enqueue */
 	if (num == 1) {
 		tail = buf_hdr[0];
@@ -503,6 +637,72 @@ int odp_queue_enq(odp_queue_t handle, odp_event_t ev)
 	return queue->s.enqueue(queue, buf_hdr);
 }
 
+static inline int deq_multi_ring(queue_entry_t *queue,
+				 odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	uint32_t buf[num];
+	int i, ret;
+	int sched = queue->s.type == ODP_QUEUE_TYPE_SCHED;
+	int locked = 0;
+	ring_t *ring = &queue->s.ring->hdr;
+	uint32_t mask = queue->s.ring_mask;
+
+	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY))
+		return -1;
+
+	/* Ordered context must be saved in the same order as events are
+	 * dequeued */
+	if (sched && queue_is_ordered(queue)) {
+		LOCK(&queue->s.lock);
+		locked = 1;
+	}
+
+	ret = ring_deq_multi(ring, mask, buf, num);
+
+	if (odp_unlikely(ret == 0) && sched) {
+		if (!locked) {
+			LOCK(&queue->s.lock);
+			locked = 1;
+		}
+
+		if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
+			/* Queue has been destroyed. Scheduler finalizes queue
+			 * destroy after this. */
+			UNLOCK(&queue->s.lock);
+			return -1;
+		}
+
+		if (queue->s.status == QUEUE_STATUS_SCHED) {
+			/* Status must be updated before the ring is checked
+			 * again. Pairs with the barrier in enq_multi_ring(). An
+			 * enqueuer either sees the new status, or its events
+			 * are found here. */
+			queue->s.status = QUEUE_STATUS_NOTSCHED;
+			odp_mb_full();
+
+			ret = ring_deq_multi(ring, mask, buf, num);
+
+			if (ret)
+				queue->s.status = QUEUE_STATUS_SCHED;
+			else
+				sched_fn->unsched_queue(queue->s.index);
+		}
+	}
+
+	for (i = 0; i < ret; i++) {
+		buf_hdr[i] = buf_hdl_to_hdr((odp_buffer_t)(uintptr_t)buf[i]);
+		odp_prefetch(buf_hdr[i]);
+	}
+
+	if (ret && sched)
+		sched_fn->save_context(queue);
+
+	if (locked)
+		UNLOCK(&queue->s.lock);
+
+	return ret;
+}
+
 static inline int deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
 			    int num)
 {
@@ -510,6 +710,9 @@ static inline int deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
 	int i, j;
 	int updated = 0;
 
+	if (queue->s.ring)
+		return deq_multi_ring(queue, buf_hdr, num);
+
 	LOCK(&queue->s.lock);
 	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
 		/* Bad queue, or queue has been destroyed.
@@ -749,7 +952,7 @@ int sched_cb_queue_empty(uint32_t queue_index)
 		return -1;
 	}
 
-	if (queue->s.head == NULL) {
+	if (queue_is_empty(queue)) {
 		/* Already empty queue. Update status. */
 		if (queue->s.status == QUEUE_STATUS_SCHED)
 			queue->s.status = QUEUE_STATUS_NOTSCHED;
@@ -22,6 +22,8 @@
 #include <odp/api/sync.h>
 #include <odp_ring_internal.h>
 #include <odp_queue_internal.h>
+#include <odp_pool_internal.h>
+#include <odp_timer_internal.h>
 
 /* Number of priority levels  */
 #define NUM_PRIO 8
@@ -69,10 +71,16 @@ ODP_STATIC_ASSERT((ODP_SCHED_PRIO_NORMAL > 0) &&
 /* Mask for wrapping around pktio poll command index */
 #define PKTIO_RING_MASK (PKTIO_RING_SIZE - 1)
 
+/* Number of priority queue sets. Each schedule group is mapped to a set of
+ * priority queues, so that a thread needs to check only those sets that
+ * its groups are mapped to. Predefined groups have sets of their own, named
+ * groups share the rest. */
+#define NUM_GRP_SETS 64
+
 /* Priority queue ring size. In worst case, all event queues are scheduled
- * queues and have the same priority. The ring size must be larger than or
- * equal to ODP_CONFIG_QUEUES / QUEUES_PER_PRIO, so that it can hold all
- * queues in the worst case. */
+ * queues and have the same priority and group set. The ring size must be
+ * larger than or equal to ODP_CONFIG_QUEUES / QUEUES_PER_PRIO, so that it
+ * can hold all queues in the worst case. */
 #define PRIO_QUEUE_RING_SIZE  (ODP_CONFIG_QUEUES / QUEUES_PER_PRIO)
 
 /* Mask for wrapping around priority queue index */
@@ -98,18 +106,35 @@ ODP_STATIC_ASSERT(CHECK_IS_POWER2(PKTIO_RING_SIZE),
 ODP_STATIC_ASSERT(CHECK_IS_POWER2(PKTIO_CMD_QUEUES),
 		  "pktio_cmd_queues_is_not_power_of_two");
 
-/* Mask of queues per priority */
-typedef uint8_t pri_mask_t;
+/* Mask of non-empty priority queues in a group set. Bit (prio *
+ * QUEUES_PER_PRIO + id) is set when priority queue [prio][id] may have
+ * queues in it. */
+typedef uint32_t prio_q_mask_t;
+
+/* Mask of bits of a single priority in prio_q_mask_t */
+#define PRIO_BITS_MASK ((1 << QUEUES_PER_PRIO) - 1)
 
-ODP_STATIC_ASSERT((8 * sizeof(pri_mask_t)) >= QUEUES_PER_PRIO,
-		  "pri_mask_t_is_too_small");
+ODP_STATIC_ASSERT((8 * sizeof(prio_q_mask_t)) >= NUM_PRIO * QUEUES_PER_PRIO,
+		  "prio_q_mask_t_is_too_small");
 
 /* Start of named groups in group mask arrays */
 #define SCHED_GROUP_NAMED (ODP_SCHED_GROUP_CONTROL + 1)
 
+ODP_STATIC_ASSERT(NUM_GRP_SETS > SCHED_GROUP_NAMED &&
+		  NUM_GRP_SETS <= 64, "Bad_number_of_group_sets");
+
 /* Maximum number of dequeues */
 #define MAX_DEQ CONFIG_BURST_SIZE
 
+/* Maximum number of pktio poll commands owned by a thread */
+#define MAX_OWN_PKTIO_CMD 16
+
+/* Maximum number of queues in the per thread prefetch stash */
+#define MAX_PREFETCH_QUEUES 4
+
+/* Maximum number of events in the per thread prefetch stash */
+#define MAX_PREFETCH_EVENTS (MAX_PREFETCH_QUEUES * MAX_DEQ)
+
 /* Maximum number of ordered locks per queue */
 #define MAX_ORDERED_LOCKS_PER_QUEUE 2
 
@@ -126,6 +151,42 @@ typedef struct {
 	int num;
 } ordered_stash_t;
 
+/* Number of reorder windows. Ordered queues created after all windows are
+ * in use fall back to waiting for order on context release. */
+#define NUM_REORDER_WINDOWS 64
+
+/* Reorder window size in ordered contexts. Must be a power of two. */
+#define REORDER_WINDOW_SIZE 32
+#define REORDER_WINDOW_MASK (REORDER_WINDOW_SIZE - 1)
+
+ODP_STATIC_ASSERT(CHECK_IS_POWER2(REORDER_WINDOW_SIZE),
+		  "Reorder_window_size_is_not_power_of_two");
+
+/* Maximum number of stashed enqueue operations per reorder slot */
+#define REORDER_SLOT_ENQS 2
+
+/* Sequence number of a free reorder slot */
+#define REORDER_SLOT_FREE UINT64_MAX
+
+/* No reorder window */
+#define REORDER_WINDOW_NONE (-1)
+
+/* Completion slot of an ordered context, which finished out of order. Holds
+ * the enqueue operations that are performed when the context is in order. */
+typedef struct {
+	/* Context id of stored operations, or REORDER_SLOT_FREE */
+	odp_atomic_u64_t seq ODP_ALIGNED_CACHE;
+	/* Ordered locks not called by the context */
+	uint32_t lock_release;
+	int num_enq;
+	ordered_stash_t enq[REORDER_SLOT_ENQS];
+} reorder_slot_t;
+
+typedef struct {
+	reorder_slot_t slot[REORDER_WINDOW_SIZE];
+	int allocated;
+} reorder_window_t;
+
 /* Ordered lock states */
 typedef union {
 	uint8_t u8[CONFIG_QUEUE_MAX_ORD_LOCKS];
@@ -135,6 +196,13 @@ typedef union {
 ODP_STATIC_ASSERT(sizeof(lock_called_t) == sizeof(uint32_t),
 		  "Lock_called_values_do_not_fit_in_uint32");
 
+/* Events pre-scheduled from a parallel queue by schedule_prefetch() */
+typedef struct {
+	odp_queue_t queue;
+	int num;
+	odp_event_t ev[MAX_DEQ];
+} prefetch_stash_t;
+
 /* Scheduler local data */
 typedef struct {
 	int thr;
@@ -144,11 +212,19 @@ typedef struct {
 	uint16_t round;
 	uint16_t prefer_offset;
 	uint16_t pktin_polls;
+	uint16_t num_own_cmd;
+	uint16_t num_grp_set;
+	uint32_t grp_epoch;
 	uint32_t queue_index;
 	odp_queue_t queue;
 	odp_event_t ev_stash[MAX_DEQ];
+	/* Group sets of the groups this thread belongs to */
+	uint8_t grp_set[NUM_GRP_SETS];
+	/* Pktio poll commands polled only by this thread */
+	uint32_t own_cmd[MAX_OWN_PKTIO_CMD];
 	struct {
 		queue_entry_t *src_queue; /**< Source queue entry */
+		reorder_window_t *window; /**< Reorder window or NULL */
 		uint64_t ctx; /**< Ordered context id */
 		int stash_num; /**< Number of stashed enqueue operations */
 		uint8_t in_order; /**< Order status */
@@ -156,6 +232,13 @@ typedef struct {
 		/** Storage for stashed enqueue operations */
 		ordered_stash_t stash[MAX_ORDERED_STASH];
 	} ordered;
+	struct {
+		int first; /**< Index of the oldest prefetch stash */
+		int num_queues; /**< Number of stashes in use */
+		int num_ev; /**< Total number of events in stashes */
+		/** Storage for prefetched events */
+		prefetch_stash_t stash[MAX_PREFETCH_QUEUES];
+	} prefetch;
 
 } sched_local_t;
 
@@ -169,6 +252,15 @@ typedef struct {
 
 } prio_queue_t ODP_ALIGNED_CACHE;
 
+/* Priority queues of a group set */
+typedef struct {
+	/* Non-empty priority queues */
+	prio_q_mask_t  mask ODP_ALIGNED_CACHE;
+
+	prio_queue_t   prio_q[NUM_PRIO][QUEUES_PER_PRIO];
+
+} grp_set_t;
+
 /* Packet IO queue */
 typedef struct {
 	/* Ring header */
@@ -185,17 +277,32 @@ typedef struct {
 	int num_pktin;
 	int pktin[MAX_PKTIN];
 	uint32_t cmd_index;
+	/* Command queue of the command */
+	int queue_idx;
+	/* Threads that may poll. Any thread, when num_thr is zero. */
+	int num_thr;
+	odp_thrmask_t thrmask;
+	/* Poll from a single thread */
+	int per_thread;
+	/* Thread that owns the command, or -1 when in a command queue */
+	int owner;
 } pktio_cmd_t;
 
 typedef struct {
-	pri_mask_t     pri_mask[NUM_PRIO];
-	odp_spinlock_t mask_lock;
+	grp_set_t      grp_set[NUM_GRP_SETS];
 
-	prio_queue_t   prio_q[NUM_PRIO][QUEUES_PER_PRIO];
+	/* Dequeue burst size per priority */
+	uint16_t       burst_size[NUM_PRIO];
+
+	/* Poll packet input on every Nth schedule call. Zero when packet
+	 * input is polled only when there are no events. */
+	uint32_t       pktin_poll_interval;
 
 	odp_spinlock_t poll_cmd_lock;
 	/* Number of commands in a command queue */
 	uint16_t       num_pktio_cmd[PKTIO_CMD_QUEUES];
+	/* Number of commands to be polled from a single thread */
+	uint32_t       num_per_thr_cmd;
 
 	/* Packet IO command queues */
 	pktio_queue_t  pktio_q[PKTIO_CMD_QUEUES];
@@ -204,9 +311,10 @@ typedef struct {
 	pktio_cmd_t    pktio_cmd[NUM_PKTIO_CMD];
 
 	odp_shm_t      shm;
-	uint32_t       pri_count[NUM_PRIO][QUEUES_PER_PRIO];
 
 	odp_spinlock_t grp_lock;
+	/* Incremented on every change of group membership */
+	odp_atomic_u32_t grp_epoch;
 	odp_thrmask_t mask_all;
 	struct {
 		char           name[ODP_SCHED_GROUP_NAME_LEN];
@@ -217,8 +325,13 @@ typedef struct {
 	struct {
 		int         prio;
 		int         queue_per_prio;
+		int         grp_set;
+		int         reorder;
 	} queue[ODP_CONFIG_QUEUES];
 
+	odp_spinlock_t   reorder_lock;
+	reorder_window_t reorder[NUM_REORDER_WINDOWS];
+
 	struct {
 		/* Number of active commands for a pktio interface */
 		int num_cmd;
@@ -242,12 +355,76 @@ static void sched_local_init(void)
 	sched_local.thr       = odp_thread_id();
 	sched_local.queue     = ODP_QUEUE_INVALID;
 	sched_local.queue_index = PRIO_QUEUE_EMPTY;
+
+	/* Force update of group sets on first schedule call */
+	sched_local.grp_epoch =
+		odp_atomic_load_u32(&sched->grp_epoch) - 1;
+}
+
+/* Read per priority dequeue burst sizes. Low priorities have smaller batch
+ * size by default to limit head of line blocking latency. The defaults can be
+ * overridden with "scheduler.burst_size" array in the configuration file
+ * (one value per priority, highest priority first). */
+static void burst_size_init(void)
+{
+	const config_setting_t *setting;
+	int i, num;
+
+	for (i = 0; i < NUM_PRIO; i++) {
+		if (i > ODP_SCHED_PRIO_DEFAULT)
+			sched->burst_size[i] = MAX_DEQ / 2;
+		else
+			sched->burst_size[i] = MAX_DEQ;
+	}
+
+	setting = config_lookup(&odp_global_data.configuration,
+				"scheduler.burst_size");
+	if (setting == NULL)
+		return;
+
+	num = config_setting_length(setting);
+	if (num > NUM_PRIO)
+		num = NUM_PRIO;
+
+	for (i = 0; i < num; i++) {
+		int burst = config_setting_get_int_elem(setting, i);
+
+		if (burst < 1 || burst > MAX_DEQ) {
+			ODP_ERR("Bad burst size %i for prio %i, using %u\n",
+				burst, i, sched->burst_size[i]);
+			continue;
+		}
+
+		sched->burst_size[i] = burst;
+	}
+}
+
+/* Read packet input poll interval. By default, packet input is polled only
+ * when no events were found. With "scheduler.pktin_poll_interval" set to N,
+ * packet input is polled also before event dispatch on every Nth schedule
+ * call, so that packet input is not starved under sustained event load. */
+static void pktin_poll_init(void)
+{
+	int val;
+
+	sched->pktin_poll_interval = 0;
+
+	if (!config_lookup_int(&odp_global_data.configuration,
+			       "scheduler.pktin_poll_interval", &val))
+		return;
+
+	if (val < 0) {
+		ODP_ERR("Bad pktin poll interval %i\n", val);
+		return;
+	}
+
+	sched->pktin_poll_interval = val;
 }
 
 static int schedule_init_global(void)
 {
 	odp_shm_t shm;
-	int i, j;
+	int i, j, g;
 
 	ODP_DBG("Schedule init ... ");
 
@@ -265,17 +442,20 @@ static int schedule_init_global(void)
 	memset(sched, 0, sizeof(sched_global_t));
 
 	sched->shm  = shm;
-	odp_spinlock_init(&sched->mask_lock);
 
-	for (i = 0; i < NUM_PRIO; i++) {
-		for (j = 0; j < QUEUES_PER_PRIO; j++) {
-			int k;
+	for (g = 0; g < NUM_GRP_SETS; g++) {
+		for (i = 0; i < NUM_PRIO; i++) {
+			for (j = 0; j < QUEUES_PER_PRIO; j++) {
+				prio_queue_t *prio_q;
+				int k;
 
-			ring_init(&sched->prio_q[i][j].ring);
+				prio_q = &sched->grp_set[g].prio_q[i][j];
+				ring_init(&prio_q->ring);
 
-			for (k = 0; k < PRIO_QUEUE_RING_SIZE; k++)
-				sched->prio_q[i][j].queue_index[k] =
-				PRIO_QUEUE_EMPTY;
+				for (k = 0; k < PRIO_QUEUE_RING_SIZE; k++)
+					prio_q->queue_index[k] =
+					PRIO_QUEUE_EMPTY;
+			}
 		}
 	}
 
@@ -291,6 +471,7 @@ static int schedule_init_global(void)
 		sched->pktio_cmd[i].cmd_index = PKTIO_CMD_FREE;
 
 	odp_spinlock_init(&sched->grp_lock);
+	odp_atomic_init_u32(&sched->grp_epoch, 0);
 
 	for (i = 0; i < NUM_SCHED_GRPS; i++) {
 		memset(sched->sched_grp[i].name, 0, ODP_SCHED_GROUP_NAME_LEN);
@@ -299,35 +480,47 @@ static int schedule_init_global(void)
 
 	odp_thrmask_setall(&sched->mask_all);
 
+	odp_spinlock_init(&sched->reorder_lock);
+
+	for (i = 0; i < ODP_CONFIG_QUEUES; i++)
+		sched->queue[i].reorder = REORDER_WINDOW_NONE;
+
+	burst_size_init();
+	pktin_poll_init();
+
 	ODP_DBG("done\n");
 
 	return 0;
 }
 
-static int schedule_term_global(void)
+static void drain_prio_q(prio_queue_t *prio_q)
 {
-	int ret = 0;
-	int rc = 0;
-	int i, j;
+	uint32_t qi;
 
-	for (i = 0; i < NUM_PRIO; i++) {
-		for (j = 0; j < QUEUES_PER_PRIO; j++) {
-			ring_t *ring = &sched->prio_q[i][j].ring;
-			uint32_t qi;
+	while ((qi = ring_deq(&prio_q->ring, PRIO_QUEUE_MASK)) != RING_EMPTY) {
+		odp_event_t events[1];
+		int num;
 
-			while ((qi = ring_deq(ring, PRIO_QUEUE_MASK)) !=
-			       RING_EMPTY) {
-				odp_event_t events[1];
-				int num;
+		num = sched_cb_queue_deq_multi(qi, events, 1);
 
-				num = sched_cb_queue_deq_multi(qi, events, 1);
+		if (num < 0)
+			sched_cb_queue_destroy_finalize(qi);
 
-				if (num < 0)
-					sched_cb_queue_destroy_finalize(qi);
+		if (num > 0)
+			ODP_ERR("Queue not empty\n");
+	}
+}
 
-				if (num > 0)
-					ODP_ERR("Queue not empty\n");
-			}
+static int schedule_term_global(void)
+{
+	int ret = 0;
+	int rc = 0;
+	int i, j, g;
+
+	for (g = 0; g < NUM_GRP_SETS; g++) {
+		for (i = 0; i < NUM_PRIO; i++) {
+			for (j = 0; j < QUEUES_PER_PRIO; j++)
+				drain_prio_q(&sched->grp_set[g].prio_q[i][j]);
 		}
 	}
 
@@ -346,14 +539,17 @@ static int schedule_init_local(void)
 	return 0;
 }
 
+static void release_own_pktio_cmd(void);
+
 static int schedule_term_local(void)
 {
-	if (sched_local.num) {
+	if (sched_local.num || sched_local.prefetch.num_ev) {
 		ODP_ERR("Locally pre-scheduled events exist.\n");
 		return -1;
 	}
 
 	schedule_release_context();
+	release_own_pktio_cmd();
 	return 0;
 }
 
@@ -367,59 +563,181 @@ static inline int queue_per_prio(uint32_t queue_index)
 	return ((QUEUES_PER_PRIO - 1) & queue_index);
 }
 
-static void pri_set(int id, int prio)
+static inline int grp_set_idx(int grp)
+{
+	if (grp < SCHED_GROUP_NAMED)
+		return grp;
+
+	return SCHED_GROUP_NAMED +
+	       (grp - SCHED_GROUP_NAMED) % (NUM_GRP_SETS - SCHED_GROUP_NAMED);
+}
+
+static inline prio_q_mask_t prio_q_bit(int prio, int id)
 {
-	odp_spinlock_lock(&sched->mask_lock);
-	sched->pri_mask[prio] |= 1 << id;
-	sched->pri_count[prio][id]++;
-	odp_spinlock_unlock(&sched->mask_lock);
+	return (prio_q_mask_t)1 << (prio * QUEUES_PER_PRIO + id);
 }
 
-static void pri_clr(int id, int prio)
+/* Enqueue a queue into a priority queue and mark it non-empty. The mask is
+ * checked after the ring enqueue, see prio_q_deq(). */
+static inline void prio_q_enq(int grp_set, int prio, int id, uint32_t qi)
 {
-	odp_spinlock_lock(&sched->mask_lock);
+	grp_set_t *set = &sched->grp_set[grp_set];
+
+	ring_enq(&set->prio_q[prio][id].ring, PRIO_QUEUE_MASK, qi);
 
-	/* Clear mask bit when last queue is removed*/
-	sched->pri_count[prio][id]--;
+	odp_mb_full();
 
-	if (sched->pri_count[prio][id] == 0)
-		sched->pri_mask[prio] &= (uint8_t)(~(1 << id));
+	if (!(__atomic_load_n(&set->mask, __ATOMIC_RELAXED) &
+	      prio_q_bit(prio, id)))
+		__atomic_fetch_or(&set->mask, prio_q_bit(prio, id),
+				  __ATOMIC_SEQ_CST);
+}
 
-	odp_spinlock_unlock(&sched->mask_lock);
+static inline void prio_q_enq_queue(uint32_t qi)
+{
+	prio_q_enq(sched->queue[qi].grp_set, sched->queue[qi].prio,
+		   sched->queue[qi].queue_per_prio, qi);
 }
 
-static void pri_set_queue(uint32_t queue_index, int prio)
+/* Dequeue a queue from a priority queue. When the priority queue is found
+ * empty, it is marked empty and checked once more, so that a concurrent
+ * prio_q_enq() is not missed. */
+static inline uint32_t prio_q_deq(int grp_set, int prio, int id)
 {
-	int id = queue_per_prio(queue_index);
+	grp_set_t *set = &sched->grp_set[grp_set];
+	ring_t *ring   = &set->prio_q[prio][id].ring;
+	uint32_t qi;
+
+	qi = ring_deq(ring, PRIO_QUEUE_MASK);
+
+	if (odp_likely(qi != RING_EMPTY))
+		return qi;
+
+	__atomic_fetch_and(&set->mask, ~prio_q_bit(prio, id),
+			   __ATOMIC_SEQ_CST);
+
+	odp_mb_full();
+
+	qi = ring_deq(ring, PRIO_QUEUE_MASK);
+
+	if (qi != RING_EMPTY)
+		__atomic_fetch_or(&set->mask, prio_q_bit(prio, id),
+				  __ATOMIC_SEQ_CST);
 
-	return pri_set(id, prio);
+	return qi;
 }
 
-static void pri_clr_queue(uint32_t queue_index, int prio)
+/* Update group sets of this thread after a group membership change */
+static void grp_set_update(void)
 {
-	int id = queue_per_prio(queue_index);
-	pri_clr(id, prio);
+	uint64_t sets = 0;
+	int grp, i;
+	int num = 0;
+
+	odp_spinlock_lock(&sched->grp_lock);
+
+	sched_local.grp_epoch = odp_atomic_load_u32(&sched->grp_epoch);
+
+	for (grp = 0; grp < NUM_SCHED_GRPS; grp++) {
+		if (grp >= SCHED_GROUP_NAMED &&
+		    !sched->sched_grp[grp].allocated)
+			continue;
+
+		if (grp == ODP_SCHED_GROUP_ALL ||
+		    odp_thrmask_isset(&sched->sched_grp[grp].mask,
+				      sched_local.thr))
+			sets |= (uint64_t)1 << grp_set_idx(grp);
+	}
+
+	odp_spinlock_unlock(&sched->grp_lock);
+
+	for (i = 0; i < NUM_GRP_SETS; i++) {
+		if (sets & ((uint64_t)1 << i))
+			sched_local.grp_set[num++] = i;
+	}
+
+	sched_local.num_grp_set = num;
+}
+
+/* Index of the group set to check first. Rotates per call and thread. */
+static inline int grp_set_first(void)
+{
+	if (sched_local.num_grp_set <= 1)
+		return 0;
+
+	return (sched_local.thr + sched_local.round) %
+	       sched_local.num_grp_set;
+}
+
+static inline void grp_set_check(void)
+{
+	if (odp_unlikely(sched_local.grp_epoch !=
+			 odp_atomic_load_u32(&sched->grp_epoch)))
+		grp_set_update();
+}
+
+static inline void grp_epoch_inc(void)
+{
+	odp_atomic_inc_u32(&sched->grp_epoch);
+}
+
+static int alloc_reorder_window(void)
+{
+	int i, j;
+	int idx = REORDER_WINDOW_NONE;
+
+	odp_spinlock_lock(&sched->reorder_lock);
+
+	for (i = 0; i < NUM_REORDER_WINDOWS; i++) {
+		reorder_window_t *window = &sched->reorder[i];
+
+		if (window->allocated)
+			continue;
+
+		for (j = 0; j < REORDER_WINDOW_SIZE; j++)
+			odp_atomic_init_u64(&window->slot[j].seq,
+					    REORDER_SLOT_FREE);
+
+		window->allocated = 1;
+		idx = i;
+		break;
+	}
+
+	odp_spinlock_unlock(&sched->reorder_lock);
+
+	return idx;
+}
+
+static void free_reorder_window(int idx)
+{
+	odp_spinlock_lock(&sched->reorder_lock);
+	sched->reorder[idx].allocated = 0;
+	odp_spinlock_unlock(&sched->reorder_lock);
 }
 
 static int schedule_init_queue(uint32_t queue_index,
 			       const odp_schedule_param_t *sched_param)
 {
-	int prio = sched_param->prio;
-
-	pri_set_queue(queue_index, prio);
-	sched->queue[queue_index].prio = prio;
+	sched->queue[queue_index].prio = sched_param->prio;
 	sched->queue[queue_index].queue_per_prio = queue_per_prio(queue_index);
+	sched->queue[queue_index].grp_set = grp_set_idx(sched_param->group);
+	sched->queue[queue_index].reorder = REORDER_WINDOW_NONE;
+
+	if (sched_param->sync == ODP_SCHED_SYNC_ORDERED)
+		sched->queue[queue_index].reorder = alloc_reorder_window();
 
 	return 0;
 }
 
 static void schedule_destroy_queue(uint32_t queue_index)
 {
-	int prio = sched->queue[queue_index].prio;
+	if (sched->queue[queue_index].reorder != REORDER_WINDOW_NONE)
+		free_reorder_window(sched->queue[queue_index].reorder);
 
-	pri_clr_queue(queue_index, prio);
 	sched->queue[queue_index].prio = 0;
 	sched->queue[queue_index].queue_per_prio = 0;
+	sched->queue[queue_index].grp_set = 0;
+	sched->queue[queue_index].reorder = REORDER_WINDOW_NONE;
 }
 
 static int poll_cmd_queue_idx(int pktio_index, int pktin_idx)
@@ -458,7 +776,8 @@ static inline void free_pktio_cmd(pktio_cmd_t *cmd)
 }
 
 static void schedule_pktio_start(int pktio_index, int num_pktin,
-				 int pktin_idx[])
+				 int pktin_idx[],
+				 const odp_pktin_poll_affinity_t *aff)
 {
 	int i, idx;
 	pktio_cmd_t *cmd;
@@ -478,25 +797,36 @@ static void schedule_pktio_start(int pktio_index, int num_pktin,
 
 		idx = poll_cmd_queue_idx(pktio_index, pktin_idx[i]);
 
+		cmd->pktio_index = pktio_index;
+		cmd->num_pktin   = 1;
+		cmd->pktin[0]    = pktin_idx[i];
+		cmd->queue_idx   = idx;
+		cmd->owner       = -1;
+		cmd->thrmask     = aff->thrmask;
+		cmd->num_thr     = odp_thrmask_count(&aff->thrmask);
+		cmd->per_thread  = aff->per_thread;
+
 		odp_spinlock_lock(&sched->poll_cmd_lock);
 		sched->num_pktio_cmd[idx]++;
+		if (cmd->per_thread)
+			sched->num_per_thr_cmd++;
 		odp_spinlock_unlock(&sched->poll_cmd_lock);
 
-		cmd->pktio_index = pktio_index;
-		cmd->num_pktin   = 1;
-		cmd->pktin[0]    = pktin_idx[i];
 		ring_enq(&sched->pktio_q[idx].ring, PKTIO_RING_MASK,
 			 cmd->cmd_index);
 	}
 }
 
-static int schedule_pktio_stop(int pktio_index, int first_pktin)
+static int schedule_pktio_stop(pktio_cmd_t *cmd)
 {
 	int num;
-	int idx = poll_cmd_queue_idx(pktio_index, first_pktin);
+	int pktio_index = cmd->pktio_index;
 
 	odp_spinlock_lock(&sched->poll_cmd_lock);
-	sched->num_pktio_cmd[idx]--;
+	if (cmd->owner < 0)
+		sched->num_pktio_cmd[cmd->queue_idx]--;
+	if (cmd->per_thread)
+		sched->num_per_thr_cmd--;
 	sched->pktio[pktio_index].num_cmd--;
 	num = sched->pktio[pktio_index].num_cmd;
 	odp_spinlock_unlock(&sched->poll_cmd_lock);
@@ -504,87 +834,405 @@ static int schedule_pktio_stop(int pktio_index, int first_pktin)
 	return num;
 }
 
+/* Number of per thread poll commands a thread may own. The share follows
+ * the current number of eligible threads. */
+static inline uint32_t pktio_cmd_share(const pktio_cmd_t *cmd)
+{
+	int num_thr = cmd->num_thr;
+
+	/* Spread commands over worker threads when thread mask is empty */
+	if (num_thr == 0) {
+		odp_thrmask_t *worker;
+
+		worker  = &sched->sched_grp[ODP_SCHED_GROUP_WORKER].mask;
+		num_thr = odp_thrmask_count(worker);
+	}
+
+	if (num_thr < 1)
+		num_thr = 1;
+
+	return (sched->num_per_thr_cmd + num_thr - 1) / num_thr;
+}
+
+/* Take ownership of a per thread poll command, if this thread does not
+ * already own its share of those. Returns 1 on success. */
+static inline int claim_pktio_cmd(pktio_cmd_t *cmd)
+{
+	if (sched_local.num_own_cmd >= MAX_OWN_PKTIO_CMD)
+		return 0;
+
+	if (sched_local.num_own_cmd >= pktio_cmd_share(cmd))
+		return 0;
+
+	odp_spinlock_lock(&sched->poll_cmd_lock);
+	sched->num_pktio_cmd[cmd->queue_idx]--;
+	cmd->owner = sched_local.thr;
+	odp_spinlock_unlock(&sched->poll_cmd_lock);
+
+	sched_local.own_cmd[sched_local.num_own_cmd++] = cmd->cmd_index;
+	return 1;
+}
+
+/* Return an own poll command to its command queue */
+static inline void release_pktio_cmd(pktio_cmd_t *cmd)
+{
+	odp_spinlock_lock(&sched->poll_cmd_lock);
+	sched->num_pktio_cmd[cmd->queue_idx]++;
+	cmd->owner = -1;
+	odp_spinlock_unlock(&sched->poll_cmd_lock);
+
+	ring_enq(&sched->pktio_q[cmd->queue_idx].ring, PKTIO_RING_MASK,
+		 cmd->cmd_index);
+}
+
+/* Return own poll commands to command queues */
+static void release_own_pktio_cmd(void)
+{
+	int i;
+
+	for (i = 0; i < sched_local.num_own_cmd; i++)
+		release_pktio_cmd(&sched->pktio_cmd[sched_local.own_cmd[i]]);
+
+	sched_local.num_own_cmd = 0;
+}
+
+/* Return own poll commands exceeding the current share of this thread, so
+ * that threads joining later get their share of the commands */
+static void rebalance_own_pktio_cmd(void)
+{
+	int i = 0;
+
+	while (i < sched_local.num_own_cmd) {
+		pktio_cmd_t *cmd = &sched->pktio_cmd[sched_local.own_cmd[i]];
+
+		if (sched_local.num_own_cmd <= pktio_cmd_share(cmd)) {
+			i++;
+			continue;
+		}
+
+		sched_local.num_own_cmd--;
+		sched_local.own_cmd[i] =
+			sched_local.own_cmd[sched_local.num_own_cmd];
+		release_pktio_cmd(cmd);
+	}
+}
+
+/* Poll packet input of a command. Returns 1 when the pktio has been stopped
+ * and the command was removed. */
+static inline int poll_pktio_cmd(pktio_cmd_t *cmd)
+{
+	if (odp_likely(sched_cb_pktin_poll(cmd->pktio_index, cmd->num_pktin,
+					   cmd->pktin) == 0))
+		return 0;
+
+	/* Pktio stopped or closed. Remove poll command and call stop_finalize
+	 * when all commands of the pktio has been removed. */
+	if (schedule_pktio_stop(cmd) == 0)
+		sched_cb_pktio_stop_finalize(cmd->pktio_index);
+
+	free_pktio_cmd(cmd);
+	return 1;
+}
+
+static inline void poll_own_pktio_cmd(void)
+{
+	int i = 0;
+
+	while (i < sched_local.num_own_cmd) {
+		pktio_cmd_t *cmd = &sched->pktio_cmd[sched_local.own_cmd[i]];
+
+		if (poll_pktio_cmd(cmd)) {
+			/* Removed. Replace with the last command. */
+			sched_local.num_own_cmd--;
+			sched_local.own_cmd[i] =
+				sched_local.own_cmd[sched_local.num_own_cmd];
+			continue;
+		}
+
+		i++;
+	}
+}
+
+/*
+ * Poll packet input
+ *   * Commands owned by this thread are polled first, and only by this
+ *     thread. Commands exceeding the share of the thread are returned to
+ *     command queues when threads join, and all own commands when the
+ *     thread pauses or terminates. Per thread commands that no thread can
+ *     claim are polled like other commands, so affinity is best effort.
+ *   * Each thread starts the search for a poll command from its
+ *     preferred command queue. If the queue is empty, it moves to other
+ *     queues.
+ *   * Most of the times, the search stops on the first command found to
+ *     optimize multi-threaded performance. A small portion of polls
+ *     have to do full iteration to avoid packet input starvation when
+ *     there are less threads than command queues.
+ */
+static void poll_pktin(void)
+{
+	int i, id;
+
+	if (sched_local.num_own_cmd) {
+		poll_own_pktio_cmd();
+
+		/* Check command queues only occasionally */
+		if (odp_likely(sched_local.pktin_polls++ & 0xf))
+			return;
+
+		/* Number of threads may have changed since commands were
+		 * claimed */
+		rebalance_own_pktio_cmd();
+	}
+
+	id = sched_local.thr & PKTIO_CMD_QUEUE_MASK;
+
+	for (i = 0; i < PKTIO_CMD_QUEUES; i++, id = ((id + 1) &
+	     PKTIO_CMD_QUEUE_MASK)) {
+		ring_t *ring;
+		uint32_t cmd_index;
+		pktio_cmd_t *cmd;
+
+		if (odp_unlikely(sched->num_pktio_cmd[id] == 0))
+			continue;
+
+		ring      = &sched->pktio_q[id].ring;
+		cmd_index = ring_deq(ring, PKTIO_RING_MASK);
+
+		if (odp_unlikely(cmd_index == RING_EMPTY))
+			continue;
+
+		cmd = &sched->pktio_cmd[cmd_index];
+
+		if (cmd->num_thr &&
+		    !odp_thrmask_isset(&cmd->thrmask, sched_local.thr)) {
+			/* This thread is not eligible for polling the
+			 * command, so continue scheduling it. */
+			ring_enq(ring, PKTIO_RING_MASK, cmd_index);
+			continue;
+		}
+
+		if (cmd->per_thread && claim_pktio_cmd(cmd)) {
+			/* From now on, polled only by this thread */
+			poll_own_pktio_cmd();
+			break;
+		}
+
+		/* Poll packet input */
+		if (odp_likely(poll_pktio_cmd(cmd) == 0)) {
+			/* Continue scheduling the pktio */
+			ring_enq(ring, PKTIO_RING_MASK, cmd_index);
+
+			/* Do not iterate through all pktin poll command queues
+			 * every time. */
+			if (odp_likely(sched_local.pktin_polls & 0xf))
+				break;
+		}
+	}
+
+	sched_local.pktin_polls++;
+}
+
 static void schedule_release_atomic(void)
 {
 	uint32_t qi = sched_local.queue_index;
 
 	if (qi != PRIO_QUEUE_EMPTY && sched_local.num  == 0) {
-		int prio           = sched->queue[qi].prio;
-		int queue_per_prio = sched->queue[qi].queue_per_prio;
-		ring_t *ring       = &sched->prio_q[prio][queue_per_prio].ring;
-
 		/* Release current atomic queue */
-		ring_enq(ring, PRIO_QUEUE_MASK, qi);
+		prio_q_enq_queue(qi);
 		sched_local.queue_index = PRIO_QUEUE_EMPTY;
 	}
 }
 
-static inline int ordered_own_turn(queue_entry_t *queue)
+static inline int ordered_own_turn(queue_entry_t *queue)
+{
+	uint64_t ctx;
+
+	ctx = odp_atomic_load_acq_u64(&queue->s.ordered.ctx);
+
+	return ctx == sched_local.ordered.ctx;
+}
+
+static inline void wait_for_order(queue_entry_t *queue)
+{
+	/* Busy loop to synchronize ordered processing */
+	while (1) {
+		if (ordered_own_turn(queue))
+			break;
+		odp_cpu_pause();
+	}
+}
+
+/**
+ * Perform stashed enqueue operations
+ *
+ * Should be called only when already in order.
+ */
+static inline void ordered_stash_release(void)
+{
+	int i;
+
+	for (i = 0; i < sched_local.ordered.stash_num; i++) {
+		queue_entry_t *queue;
+		odp_buffer_hdr_t **buf_hdr;
+		int num;
+
+		queue = sched_local.ordered.stash[i].queue;
+		buf_hdr = sched_local.ordered.stash[i].buf_hdr;
+		num = sched_local.ordered.stash[i].num;
+
+		queue_enq_multi(queue, buf_hdr, num);
+	}
+	sched_local.ordered.stash_num = 0;
+}
+
+/* Release ordered locks which were not called in the context. Should be
+ * called only when in order. */
+static inline void release_ordered_locks(queue_entry_t *queue, uint64_t ctx,
+					 lock_called_t lock_called)
+{
+	unsigned i;
+
+	for (i = 0; i < queue->s.param.sched.lock_count; i++) {
+		if (!lock_called.u8[i])
+			odp_atomic_store_rel_u64(&queue->s.ordered.lock[i],
+						 ctx + 1);
+	}
+}
+
+/* Perform operations of a context, which finished out of order */
+static inline void reorder_slot_release(queue_entry_t *queue,
+					reorder_slot_t *slot, uint64_t ctx)
+{
+	lock_called_t lock_called;
+	int i;
+
+	lock_called.all = slot->lock_release;
+	release_ordered_locks(queue, ctx, lock_called);
+
+	for (i = 0; i < slot->num_enq; i++)
+		queue_enq_multi(slot->enq[i].queue, slot->enq[i].buf_hdr,
+				slot->enq[i].num);
+}
+
+/* Try to claim a completed slot for release. Succeeds only for one thread. */
+static inline int reorder_slot_claim(reorder_slot_t *slot, uint64_t ctx)
+{
+	uint64_t seq = ctx;
+
+	if (odp_atomic_load_acq_u64(&slot->seq) != ctx)
+		return 0;
+
+	return odp_atomic_cas_acq_u64(&slot->seq, &seq, REORDER_SLOT_FREE);
+}
+
+/* Pass the order to the next context. Contexts that already finished are
+ * released here on their behalf. */
+static inline void ordered_advance(queue_entry_t *queue,
+				   reorder_window_t *window, uint64_t ctx)
+{
+	reorder_slot_t *slot;
+
+	while (1) {
+		/* Next thread can continue processing */
+		odp_atomic_store_rel_u64(&queue->s.ordered.ctx, ctx);
+
+		if (window == NULL)
+			return;
+
+		/* Synchronize with a thread storing its completion into the
+		 * slot while checking the current context. */
+		odp_mb_full();
+
+		slot = &window->slot[ctx & REORDER_WINDOW_MASK];
+
+		if (!reorder_slot_claim(slot, ctx))
+			return;
+
+		reorder_slot_release(queue, slot, ctx);
+		ctx++;
+	}
+}
+
+/* Store context completion into the reorder window instead of waiting for
+ * the order. Returns 1 on success, 0 when the window or slot is full. */
+static inline int reorder_store(queue_entry_t *queue, reorder_window_t *window)
 {
-	uint64_t ctx;
+	reorder_slot_t *slot;
+	uint64_t head;
+	int i, j;
+	uint64_t ctx = sched_local.ordered.ctx;
+	int stash_num = sched_local.ordered.stash_num;
 
-	ctx = odp_atomic_load_acq_u64(&queue->s.ordered.ctx);
+	if (stash_num > REORDER_SLOT_ENQS)
+		return 0;
 
-	return ctx == sched_local.ordered.ctx;
-}
+	/* Slot may be still in use by a context a window size behind */
+	head = odp_atomic_load_acq_u64(&queue->s.ordered.ctx);
+	if (ctx - head >= REORDER_WINDOW_SIZE)
+		return 0;
 
-static inline void wait_for_order(queue_entry_t *queue)
-{
-	/* Busy loop to synchronize ordered processing */
-	while (1) {
-		if (ordered_own_turn(queue))
-			break;
-		odp_cpu_pause();
+	slot = &window->slot[ctx & REORDER_WINDOW_MASK];
+
+	for (i = 0; i < stash_num; i++) {
+		ordered_stash_t *stash = &sched_local.ordered.stash[i];
+
+		slot->enq[i].queue = stash->queue;
+		slot->enq[i].num   = stash->num;
+		for (j = 0; j < stash->num; j++)
+			slot->enq[i].buf_hdr[j] = stash->buf_hdr[j];
 	}
-}
 
-/**
- * Perform stashed enqueue operations
- *
- * Should be called only when already in order.
- */
-static inline void ordered_stash_release(void)
-{
-	int i;
+	slot->num_enq      = stash_num;
+	slot->lock_release = sched_local.ordered.lock_called.all;
+	sched_local.ordered.stash_num = 0;
 
-	for (i = 0; i < sched_local.ordered.stash_num; i++) {
-		queue_entry_t *queue;
-		odp_buffer_hdr_t **buf_hdr;
-		int num;
+	odp_atomic_store_rel_u64(&slot->seq, ctx);
 
-		queue = sched_local.ordered.stash[i].queue;
-		buf_hdr = sched_local.ordered.stash[i].buf_hdr;
-		num = sched_local.ordered.stash[i].num;
+	/* Previous context may have finished meanwhile without seeing the
+	 * slot. Release it here in that case. */
+	odp_mb_full();
 
-		queue_enq_multi(queue, buf_hdr, num);
+	if (odp_atomic_load_acq_u64(&queue->s.ordered.ctx) == ctx &&
+	    reorder_slot_claim(slot, ctx)) {
+		reorder_slot_release(queue, slot, ctx);
+		ordered_advance(queue, window, ctx + 1);
 	}
-	sched_local.ordered.stash_num = 0;
+
+	return 1;
 }
 
 static inline void release_ordered(void)
 {
-	unsigned i;
 	queue_entry_t *queue;
+	reorder_window_t *window;
+	uint64_t ctx;
+	int in_order;
 
-	queue = sched_local.ordered.src_queue;
-
-	wait_for_order(queue);
+	queue    = sched_local.ordered.src_queue;
+	window   = sched_local.ordered.window;
+	ctx      = sched_local.ordered.ctx;
+	in_order = sched_local.ordered.in_order;
 
-	/* Release all ordered locks */
-	for (i = 0; i < queue->s.param.sched.lock_count; i++) {
-		if (!sched_local.ordered.lock_called.u8[i])
-			odp_atomic_store_rel_u64(&queue->s.ordered.lock[i],
-						 sched_local.ordered.ctx + 1);
+	/* Leave the ordered context before any enqueue below. Otherwise
+	 * schedule_ord_enq_multi() would release the stash again, or stash
+	 * events released on behalf of other contexts. */
+	sched_local.ordered.src_queue = NULL;
+	sched_local.ordered.in_order = 1;
+
+	/* Out of order contexts store their completion into the reorder
+	 * window and continue. Others wait for their turn. */
+	if (in_order || ordered_own_turn(queue) ||
+	    window == NULL || !reorder_store(queue, window)) {
+		wait_for_order(queue);
+		release_ordered_locks(queue, ctx,
+				      sched_local.ordered.lock_called);
+		ordered_stash_release();
+		ordered_advance(queue, window, ctx + 1);
 	}
 
 	sched_local.ordered.lock_called.all = 0;
-	sched_local.ordered.src_queue = NULL;
+	sched_local.ordered.window = NULL;
 	sched_local.ordered.in_order = 0;
-
-	ordered_stash_release();
-
-	/* Next thread can continue processing */
-	odp_atomic_add_rel_u64(&queue->s.ordered.ctx, 1);
 }
 
 static void schedule_release_ordered(void)
@@ -662,219 +1310,246 @@ static int schedule_ord_enq_multi(uint32_t queue_index, void *buf_hdr[],
 	return 1;
 }
 
+/* Move the oldest prefetch stash into the event stash */
+static inline int prefetch_stash_pop(void)
+{
+	int first = sched_local.prefetch.first;
+	prefetch_stash_t *stash = &sched_local.prefetch.stash[first];
+	int num = stash->num;
+
+	memcpy(sched_local.ev_stash, stash->ev, num * sizeof(odp_event_t));
+	sched_local.num   = num;
+	sched_local.index = 0;
+	sched_local.queue = stash->queue;
+
+	sched_local.prefetch.first = (first + 1) & (MAX_PREFETCH_QUEUES - 1);
+	sched_local.prefetch.num_queues--;
+	sched_local.prefetch.num_ev -= num;
+
+	return num;
+}
+
 /*
- * Schedule queues
+ * Schedule events from priority queues of a group set. Bits of the non-empty
+ * priority queues of the priority are passed in 'bits'.
  */
-static int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
-		       unsigned int max_num)
+static inline int schedule_prio_q(int grp_set, int prio, int first_id,
+				  prio_q_mask_t bits, odp_queue_t *out_queue,
+				  odp_event_t out_ev[], unsigned int max_num)
 {
-	int prio, i;
-	int ret;
-	int id;
-	int offset = 0;
-	unsigned int max_deq = MAX_DEQ;
+	int i, ret;
+	int id = first_id;
+	unsigned int max_deq;
 	uint32_t qi;
 
-	if (sched_local.num) {
-		ret = copy_events(out_ev, max_num);
+	for (i = 0; i < QUEUES_PER_PRIO;) {
+		int num;
+		int grp;
+		int ordered;
+		odp_queue_t handle;
 
-		if (out_queue)
-			*out_queue = sched_local.queue;
+		if (id >= QUEUES_PER_PRIO)
+			id = 0;
 
-		return ret;
-	}
+		/* Priority queue empty */
+		if ((bits & (1 << id)) == 0) {
+			i++;
+			id++;
+			continue;
+		}
 
-	schedule_release_context();
+		/* Get queue index from the priority queue */
+		qi = prio_q_deq(grp_set, prio, id);
 
-	if (odp_unlikely(sched_local.pause))
-		return 0;
+		/* Priority queue empty */
+		if (qi == RING_EMPTY) {
+			i++;
+			id++;
+			continue;
+		}
 
-	/* Each thread prefers a priority queue. This offset avoids starvation
-	 * of other priority queues on low thread counts. */
-	if (odp_unlikely((sched_local.round & 0x3f) == 0)) {
-		offset = sched_local.prefer_offset;
-		sched_local.prefer_offset = (offset + 1) &
-					    (QUEUES_PER_PRIO - 1);
-	}
+		grp = sched_cb_queue_grp(qi);
 
-	sched_local.round++;
+		if (grp > ODP_SCHED_GROUP_ALL &&
+		    !odp_thrmask_isset(&sched->sched_grp[grp].mask,
+				       sched_local.thr)) {
+			/* This thread is not eligible for work from
+			 * this queue (group shares the set with another group),
+			 * so continue scheduling it. */
+			prio_q_enq(grp_set, prio, id, qi);
 
-	/* Schedule events */
-	for (prio = 0; prio < NUM_PRIO; prio++) {
+			i++;
+			id++;
+			continue;
+		}
+
+		max_deq = sched->burst_size[prio];
+
+		ordered = sched_cb_queue_is_ordered(qi);
+
+		/* Do not cache ordered events locally to improve
+		 * parallelism. Ordered context can only be released
+		 * when the local cache is empty. */
+		if (ordered && max_num < max_deq)
+			max_deq = max_num;
+
+		num = sched_cb_queue_deq_multi(qi, sched_local.ev_stash,
+					       max_deq);
+
+		if (num < 0) {
+			/* Destroyed queue. Continue scheduling the same
+			 * priority queue. */
+			sched_cb_queue_destroy_finalize(qi);
+			continue;
+		}
 
-		if (sched->pri_mask[prio] == 0)
+		if (num == 0) {
+			/* Remove empty queue from scheduling. Continue
+			 * scheduling the same priority queue. */
 			continue;
+		}
 
-		id = (sched_local.thr + offset) & (QUEUES_PER_PRIO - 1);
+		handle            = sched_cb_queue_handle(qi);
+		sched_local.num   = num;
+		sched_local.index = 0;
+		sched_local.queue = handle;
+		ret = copy_events(out_ev, max_num);
 
-		for (i = 0; i < QUEUES_PER_PRIO;) {
-			int num;
-			int grp;
-			int ordered;
-			odp_queue_t handle;
-			ring_t *ring;
+		if (ordered) {
+			uint64_t ctx;
+			queue_entry_t *queue;
+			odp_atomic_u64_t *next_ctx;
 
-			if (id >= QUEUES_PER_PRIO)
-				id = 0;
+			queue = get_qentry(qi);
+			next_ctx = &queue->s.ordered.next_ctx;
 
-			/* No queues created for this priority queue */
-			if (odp_unlikely((sched->pri_mask[prio] & (1 << id))
-			    == 0)) {
-				i++;
-				id++;
-				continue;
-			}
+			ctx = odp_atomic_fetch_inc_u64(next_ctx);
 
-			/* Get queue index from the priority queue */
-			ring = &sched->prio_q[prio][id].ring;
-			qi   = ring_deq(ring, PRIO_QUEUE_MASK);
+			sched_local.ordered.ctx = ctx;
+			sched_local.ordered.src_queue = queue;
+			sched_local.ordered.window = NULL;
 
-			/* Priority queue empty */
-			if (qi == RING_EMPTY) {
-				i++;
-				id++;
-				continue;
-			}
+			if (sched->queue[qi].reorder != REORDER_WINDOW_NONE)
+				sched_local.ordered.window =
+				&sched->reorder[sched->queue[qi].reorder];
 
-			grp = sched_cb_queue_grp(qi);
+			/* Continue scheduling ordered queues */
+			prio_q_enq(grp_set, prio, id, qi);
 
-			if (grp > ODP_SCHED_GROUP_ALL &&
-			    !odp_thrmask_isset(&sched->sched_grp[grp].mask,
-					       sched_local.thr)) {
-				/* This thread is not eligible for work from
-				 * this queue, so continue scheduling it.
-				 */
-				ring_enq(ring, PRIO_QUEUE_MASK, qi);
+		} else if (sched_cb_queue_is_atomic(qi)) {
+			/* Hold queue during atomic access */
+			sched_local.queue_index = qi;
+		} else {
+			/* Continue scheduling the queue */
+			prio_q_enq(grp_set, prio, id, qi);
+		}
 
-				i++;
-				id++;
-				continue;
-			}
+		/* Output the source queue handle */
+		if (out_queue)
+			*out_queue = handle;
 
-			/* Low priorities have smaller batch size to limit
-			 * head of line blocking latency. */
-			if (odp_unlikely(prio > ODP_SCHED_PRIO_DEFAULT))
-				max_deq = MAX_DEQ / 2;
+		return ret;
+	}
 
-			ordered = sched_cb_queue_is_ordered(qi);
+	return 0;
+}
 
-			/* Do not cache ordered events locally to improve
-			 * parallelism. Ordered context can only be released
-			 * when the local cache is empty. */
-			if (ordered && max_num < MAX_DEQ)
-				max_deq = max_num;
+/*
+ * Schedule queues
+ */
+static int do_schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
+		       unsigned int max_num)
+{
+	int prio, i, j, first;
+	int ret;
+	int id;
+	int offset = 0;
+	prio_q_mask_t mask[NUM_GRP_SETS];
 
-			num = sched_cb_queue_deq_multi(qi, sched_local.ev_stash,
-						       max_deq);
+	if (sched_local.num) {
+		ret = copy_events(out_ev, max_num);
 
-			if (num < 0) {
-				/* Destroyed queue. Continue scheduling the same
-				 * priority queue. */
-				sched_cb_queue_destroy_finalize(qi);
-				continue;
-			}
+		if (out_queue)
+			*out_queue = sched_local.queue;
 
-			if (num == 0) {
-				/* Remove empty queue from scheduling. Continue
-				 * scheduling the same priority queue. */
-				continue;
-			}
+		return ret;
+	}
+
+	schedule_release_context();
 
-			handle            = sched_cb_queue_handle(qi);
-			sched_local.num   = num;
-			sched_local.index = 0;
-			sched_local.queue = handle;
-			ret = copy_events(out_ev, max_num);
+	/* Events from parallel queues have been pre-scheduled by
+	 * schedule_prefetch(). Those are output also when paused. */
+	if (sched_local.prefetch.num_queues) {
+		prefetch_stash_pop();
+		ret = copy_events(out_ev, max_num);
+
+		if (out_queue)
+			*out_queue = sched_local.queue;
 
-			if (ordered) {
-				uint64_t ctx;
-				queue_entry_t *queue;
-				odp_atomic_u64_t *next_ctx;
+		return ret;
+	}
 
-				queue = get_qentry(qi);
-				next_ctx = &queue->s.ordered.next_ctx;
+	if (odp_unlikely(sched_local.pause))
+		return 0;
 
-				ctx = odp_atomic_fetch_inc_u64(next_ctx);
+	/* Each thread prefers a priority queue. This offset avoids starvation
+	 * of other priority queues on low thread counts. */
+	if (odp_unlikely((sched_local.round & 0x3f) == 0)) {
+		offset = sched_local.prefer_offset;
+		sched_local.prefer_offset = (offset + 1) &
+					    (QUEUES_PER_PRIO - 1);
+	}
 
-				sched_local.ordered.ctx = ctx;
-				sched_local.ordered.src_queue = queue;
+	sched_local.round++;
 
-				/* Continue scheduling ordered queues */
-				ring_enq(ring, PRIO_QUEUE_MASK, qi);
+	/* Poll packet input before event dispatch */
+	if (odp_unlikely(sched->pktin_poll_interval) &&
+	    (sched_local.round % sched->pktin_poll_interval) == 0)
+		poll_pktin();
 
-			} else if (sched_cb_queue_is_atomic(qi)) {
-				/* Hold queue during atomic access */
-				sched_local.queue_index = qi;
-			} else {
-				/* Continue scheduling the queue */
-				ring_enq(ring, PRIO_QUEUE_MASK, qi);
-			}
+	grp_set_check();
 
-			/* Output the source queue handle */
-			if (out_queue)
-				*out_queue = handle;
+	for (i = 0; i < sched_local.num_grp_set; i++) {
+		grp_set_t *set = &sched->grp_set[sched_local.grp_set[i]];
 
-			return ret;
-		}
+		mask[i] = __atomic_load_n(&set->mask, __ATOMIC_RELAXED);
 	}
 
-	/*
-	 * Poll packet input when there are no events
-	 *   * Each thread starts the search for a poll command from its
-	 *     preferred command queue. If the queue is empty, it moves to other
-	 *     queues.
-	 *   * Most of the times, the search stops on the first command found to
-	 *     optimize multi-threaded performance. A small portion of polls
-	 *     have to do full iteration to avoid packet input starvation when
-	 *     there are less threads than command queues.
-	 */
-	id = sched_local.thr & PKTIO_CMD_QUEUE_MASK;
+	id = (sched_local.thr + offset) & (QUEUES_PER_PRIO - 1);
 
-	for (i = 0; i < PKTIO_CMD_QUEUES; i++, id = ((id + 1) &
-	     PKTIO_CMD_QUEUE_MASK)) {
-		ring_t *ring;
-		uint32_t cmd_index;
-		pktio_cmd_t *cmd;
+	/* Rotate the first group set, so that a busy set does not starve
+	 * the other sets of the same priority. */
+	first = grp_set_first();
 
-		if (odp_unlikely(sched->num_pktio_cmd[id] == 0))
-			continue;
+	/* Schedule events */
+	for (prio = 0; prio < NUM_PRIO; prio++) {
+		for (j = 0; j < sched_local.num_grp_set; j++) {
+			prio_q_mask_t bits;
 
-		ring      = &sched->pktio_q[id].ring;
-		cmd_index = ring_deq(ring, PKTIO_RING_MASK);
+			i = first + j;
+			if (i >= sched_local.num_grp_set)
+				i -= sched_local.num_grp_set;
 
-		if (odp_unlikely(cmd_index == RING_EMPTY))
-			continue;
+			bits = (mask[i] >> (prio * QUEUES_PER_PRIO)) &
+			       PRIO_BITS_MASK;
 
-		cmd = &sched->pktio_cmd[cmd_index];
+			if (bits == 0)
+				continue;
 
-		/* Poll packet input */
-		if (odp_unlikely(sched_cb_pktin_poll(cmd->pktio_index,
-						     cmd->num_pktin,
-						     cmd->pktin))){
-			/* Pktio stopped or closed. Remove poll command and call
-			 * stop_finalize when all commands of the pktio has
-			 * been removed. */
-			if (schedule_pktio_stop(cmd->pktio_index,
-						cmd->pktin[0]) == 0)
-				sched_cb_pktio_stop_finalize(cmd->pktio_index);
-
-			free_pktio_cmd(cmd);
-		} else {
-			/* Continue scheduling the pktio */
-			ring_enq(ring, PKTIO_RING_MASK, cmd_index);
+			ret = schedule_prio_q(sched_local.grp_set[i], prio, id,
+					      bits, out_queue, out_ev, max_num);
 
-			/* Do not iterate through all pktin poll command queues
-			 * every time. */
-			if (odp_likely(sched_local.pktin_polls & 0xf))
-				break;
+			if (ret)
+				return ret;
 		}
 	}
 
-	sched_local.pktin_polls++;
+	/* Poll packet input when there are no events */
+	poll_pktin();
+
 	return 0;
 }
 
-
 static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 			 odp_event_t out_ev[],
 			 unsigned int max_num)
@@ -889,6 +1564,8 @@ static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 		if (ret)
 			break;
 
+		_odp_timer_run_inline();
+
 		if (wait == ODP_SCHED_WAIT)
 			continue;
 
@@ -987,6 +1664,10 @@ static void schedule_order_unlock(unsigned lock_index)
 static void schedule_pause(void)
 {
 	sched_local.pause = 1;
+
+	/* Paused threads do not poll packet input. Let other threads poll
+	 * the commands owned by this thread. */
+	release_own_pktio_cmd();
 }
 
 static void schedule_resume(void)
@@ -1026,6 +1707,7 @@ static odp_schedule_group_t schedule_group_create(const char *name,
 			odp_thrmask_copy(&sched->sched_grp[i].mask, mask);
 			group = (odp_schedule_group_t)i;
 			sched->sched_grp[i].allocated = 1;
+			grp_epoch_inc();
 			break;
 		}
 	}
@@ -1046,6 +1728,7 @@ static int schedule_group_destroy(odp_schedule_group_t group)
 		memset(sched->sched_grp[group].name, 0,
 		       ODP_SCHED_GROUP_NAME_LEN);
 		sched->sched_grp[group].allocated = 0;
+		grp_epoch_inc();
 		ret = 0;
 	} else {
 		ret = -1;
@@ -1085,6 +1768,7 @@ static int schedule_group_join(odp_schedule_group_t group,
 		odp_thrmask_or(&sched->sched_grp[group].mask,
 			       &sched->sched_grp[group].mask,
 			       mask);
+		grp_epoch_inc();
 		ret = 0;
 	} else {
 		ret = -1;
@@ -1109,6 +1793,7 @@ static int schedule_group_leave(odp_schedule_group_t group,
 		odp_thrmask_and(&sched->sched_grp[group].mask,
 				&sched->sched_grp[group].mask,
 				&leavemask);
+		grp_epoch_inc();
 		ret = 0;
 	} else {
 		ret = -1;
@@ -1165,6 +1850,7 @@ static int schedule_thr_add(odp_schedule_group_t group, int thr)
 	odp_spinlock_lock(&sched->grp_lock);
 
 	odp_thrmask_set(&sched->sched_grp[group].mask, thr);
+	grp_epoch_inc();
 
 	odp_spinlock_unlock(&sched->grp_lock);
 
@@ -1179,24 +1865,198 @@ static int schedule_thr_rem(odp_schedule_group_t group, int thr)
 	odp_spinlock_lock(&sched->grp_lock);
 
 	odp_thrmask_clr(&sched->sched_grp[group].mask, thr);
+	grp_epoch_inc();
 
 	odp_spinlock_unlock(&sched->grp_lock);
 
 	return 0;
 }
 
-/* This function is a no-op */
-static void schedule_prefetch(int num ODP_UNUSED)
+/* Prefetch event metadata and the first cache line of event data */
+static inline void prefetch_events(odp_event_t ev[], int num)
 {
+	odp_buffer_hdr_t *buf_hdr[MAX_DEQ];
+	int i;
+
+	for (i = 0; i < num; i++) {
+		buf_hdr[i] = buf_hdl_to_hdr(odp_buffer_from_event(ev[i]));
+		odp_prefetch(buf_hdr[i]);
+	}
+
+	for (i = 0; i < num; i++)
+		odp_prefetch(buf_hdr[i]->base_data);
 }
 
-static int schedule_sched_queue(uint32_t queue_index)
+/* Top up the event stash from the atomic queue currently held */
+static inline int prefetch_atomic(uint32_t qi, int num)
+{
+	int ret;
+
+	if (sched_local.num >= num || sched_local.num == MAX_DEQ)
+		return 0;
+
+	/* Compact the stash to make room for new events */
+	if (sched_local.index) {
+		memmove(sched_local.ev_stash,
+			&sched_local.ev_stash[sched_local.index],
+			sched_local.num * sizeof(odp_event_t));
+		sched_local.index = 0;
+	}
+
+	ret = sched_cb_queue_deq_multi(qi,
+				       &sched_local.ev_stash[sched_local.num],
+				       MAX_DEQ - sched_local.num);
+	if (ret <= 0)
+		return 0;
+
+	prefetch_events(&sched_local.ev_stash[sched_local.num], ret);
+	sched_local.num += ret;
+
+	return ret;
+}
+
+/* Pre-schedule events from parallel queues of a group set priority.
+ * Returns the number of events pre-scheduled. */
+static inline int prefetch_prio_q(int grp_set, int prio, prio_q_mask_t bits,
+				  int num)
+{
+	int i;
+	int events = 0;
+	int id = sched_local.thr & (QUEUES_PER_PRIO - 1);
+
+	for (i = 0; i < QUEUES_PER_PRIO;) {
+		int ret, grp, slot;
+		prefetch_stash_t *stash;
+		uint32_t qi;
+
+		if (id >= QUEUES_PER_PRIO)
+			id = 0;
+
+		if ((bits & (1 << id)) == 0) {
+			i++;
+			id++;
+			continue;
+		}
+
+		qi = prio_q_deq(grp_set, prio, id);
+
+		if (qi == RING_EMPTY) {
+			i++;
+			id++;
+			continue;
+		}
+
+		grp = sched_cb_queue_grp(qi);
+
+		if ((grp > ODP_SCHED_GROUP_ALL &&
+		     !odp_thrmask_isset(&sched->sched_grp[grp].mask,
+					sched_local.thr)) ||
+		    sched_cb_queue_is_ordered(qi) ||
+		    sched_cb_queue_is_atomic(qi)) {
+			/* Leave for do_schedule() */
+			prio_q_enq(grp_set, prio, id, qi);
+			i++;
+			id++;
+			continue;
+		}
+
+		slot  = (sched_local.prefetch.first +
+			 sched_local.prefetch.num_queues) &
+			(MAX_PREFETCH_QUEUES - 1);
+		stash = &sched_local.prefetch.stash[slot];
+
+		ret = sched_cb_queue_deq_multi(qi, stash->ev,
+					       sched->burst_size[prio]);
+
+		if (ret < 0) {
+			sched_cb_queue_destroy_finalize(qi);
+			continue;
+		}
+
+		if (ret == 0)
+			continue;
+
+		/* Continue scheduling the queue */
+		prio_q_enq(grp_set, prio, id, qi);
+
+		prefetch_events(stash->ev, ret);
+
+		stash->queue = sched_cb_queue_handle(qi);
+		stash->num   = ret;
+		sched_local.prefetch.num_queues++;
+		sched_local.prefetch.num_ev += ret;
+		events += ret;
+
+		if (events >= num ||
+		    sched_local.prefetch.num_queues == MAX_PREFETCH_QUEUES)
+			break;
+
+		i++;
+		id++;
+	}
+
+	return events;
+}
+
+/*
+ * Pre-schedule events into the prefetch stash. Only parallel queues are
+ * pre-scheduled, since atomic and ordered queues would need a scheduling
+ * context, and the current context must not be affected.
+ */
+static void schedule_prefetch(int num)
 {
-	int prio           = sched->queue[queue_index].prio;
-	int queue_per_prio = sched->queue[queue_index].queue_per_prio;
-	ring_t *ring       = &sched->prio_q[prio][queue_per_prio].ring;
+	int prio, i, j, first;
+	int events;
+	uint32_t qi;
+
+	if (odp_unlikely(sched_local.pause))
+		return;
+
+	if (num > MAX_PREFETCH_EVENTS)
+		num = MAX_PREFETCH_EVENTS;
+
+	qi = sched_local.queue_index;
+
+	if (qi != PRIO_QUEUE_EMPTY)
+		prefetch_atomic(qi, num);
 
-	ring_enq(ring, PRIO_QUEUE_MASK, queue_index);
+	events = sched_local.num + sched_local.prefetch.num_ev;
+
+	grp_set_check();
+	first = grp_set_first();
+
+	for (prio = 0; prio < NUM_PRIO; prio++) {
+		for (j = 0; j < sched_local.num_grp_set; j++) {
+			int set;
+			prio_q_mask_t bits;
+
+			i = first + j;
+			if (i >= sched_local.num_grp_set)
+				i -= sched_local.num_grp_set;
+
+			set = sched_local.grp_set[i];
+
+			if (events >= num ||
+			    sched_local.prefetch.num_queues ==
+			    MAX_PREFETCH_QUEUES)
+				return;
+
+			bits = (__atomic_load_n(&sched->grp_set[set].mask,
+						__ATOMIC_RELAXED) >>
+				(prio * QUEUES_PER_PRIO)) & PRIO_BITS_MASK;
+
+			if (bits == 0)
+				continue;
+
+			events += prefetch_prio_q(set, prio, bits,
+						  num - events);
+		}
+	}
+}
+
+static int schedule_sched_queue(uint32_t queue_index)
+{
+	prio_q_enq_queue(queue_index);
 	return 0;
 }
 
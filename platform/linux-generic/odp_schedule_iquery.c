@@ -15,6 +15,7 @@
 #include <odp_queue_internal.h>
 #include <odp_buffer_internal.h>
 #include <odp_bitmap_internal.h>
+#include <odp_timer_internal.h>
 #include <odp/api/thread.h>
 #include <odp/api/time.h>
 #include <odp/api/rwlock.h>
@@ -541,7 +542,9 @@ static inline void free_pktio_cmd(pktio_cmd_t *cmd)
 	odp_rwlock_write_unlock(&sched->pktio_poll.lock);
 }
 
-static void schedule_pktio_start(int pktio, int count, int pktin[])
+/* Poll affinity is not supported, any thread may poll any pktin */
+static void schedule_pktio_start(int pktio, int count, int pktin[],
+				 const odp_pktin_poll_affinity_t *aff ODP_UNUSED)
 {
 	int i, index;
 	pktio_cmd_t *cmd;
@@ -723,6 +726,8 @@ static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 		if (count)
 			break;
 
+		_odp_timer_run_inline();
+
 		if (wait == ODP_SCHED_WAIT)
 			continue;
 
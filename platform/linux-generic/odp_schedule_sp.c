@@ -15,6 +15,7 @@
 #include <odp_align_internal.h>
 #include <odp_config_internal.h>
 #include <odp_ring_internal.h>
+#include <odp_timer_internal.h>
 
 #define NUM_THREAD        ODP_THREAD_COUNT_MAX
 #define NUM_QUEUE         ODP_CONFIG_QUEUES
@@ -426,7 +427,9 @@ static int ord_enq_multi(uint32_t queue_index, void *buf_hdr[], int num,
 	return 0;
 }
 
-static void pktio_start(int pktio_index, int num, int pktin_idx[])
+/* Poll affinity is not supported, any thread may poll any pktin */
+static void pktio_start(int pktio_index, int num, int pktin_idx[],
+			const odp_pktin_poll_affinity_t *aff ODP_UNUSED)
 {
 	int i;
 	sched_cmd_t *cmd;
@@ -535,6 +538,8 @@ static int schedule_multi(odp_queue_t *from, uint64_t wait,
 
 		if (cmd == NULL) {
 			/* All priority queues are empty */
+			_odp_timer_run_inline();
+
 			if (wait == ODP_SCHED_NO_WAIT)
 				return 0;
 
@@ -5,6 +5,7 @@
  */
 
 #include <odp_config_internal.h>
+#include <odp_internal.h>
 #include <odp/api/debug.h>
 #include <odp/api/std_types.h>
 #include <odp/api/shared_memory.h>
@@ -36,6 +37,9 @@ static uint32_t get_ishm_flags(uint32_t flags)
 	 * another linux process */
 	f |= (flags & (ODP_SHM_PROC | ODP_SHM_EXPORT)) ? _ODP_ISHM_EXPORT : 0;
 	f |= (flags & ODP_SHM_SINGLE_VA) ? _ODP_ISHM_SINGLE_VA : 0;
+	f |= (flags & ODP_SHM_HP_2M) ? _ODP_ISHM_HP_2M : 0;
+	f |= (flags & ODP_SHM_HP_1G) ? _ODP_ISHM_HP_1G : 0;
+	f |= (flags & ODP_SHM_PREFAULT) ? _ODP_ISHM_PREFAULT : 0;
 
 	return f;
 }
@@ -48,6 +52,11 @@ int odp_shm_capability(odp_shm_capability_t *capa)
 	capa->max_size = 0;
 	capa->max_align = 0;
 
+	if (odp_global_data.hugepage_info.huge_page_dir_2m)
+		capa->hp_flags |= ODP_SHM_HP_2M;
+	if (odp_global_data.hugepage_info.huge_page_dir_1g)
+		capa->hp_flags |= ODP_SHM_HP_1G;
+
 	return 0;
 }
 
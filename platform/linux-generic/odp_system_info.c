@@ -23,6 +23,7 @@
 #include <sched.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <inttypes.h>
 #include <ctype.h>
 
@@ -289,6 +290,57 @@ static int systemcpu(system_info_t *sysinfo)
 	return 0;
 }
 
+/*
+ * Analysis of /sys/devices/system/node/ files. Systems without NUMA support
+ * have a single node.
+ */
+static void systemnode(system_info_t *sysinfo)
+{
+	char path[64];
+	int node, cpu;
+	DIR *dir;
+	struct dirent *entry;
+
+	sysinfo->numa_nodes = 1;
+
+	/* Node ids may be sparse, so scan all nodeN entries. Number of nodes
+	 * is the largest node id plus one. */
+	dir = opendir("/sys/devices/system/node");
+
+	while (dir && (entry = readdir(dir)) != NULL) {
+		if (strncmp(entry->d_name, "node", 4) ||
+		    !isdigit((unsigned char)entry->d_name[4]))
+			continue;
+
+		node = atoi(&entry->d_name[4]);
+
+		if (node >= MAX_NUMA_NODES) {
+			ODP_DBG("NUMA node %i ignored\n", node);
+			continue;
+		}
+
+		if (node + 1 > sysinfo->numa_nodes)
+			sysinfo->numa_nodes = node + 1;
+	}
+
+	if (dir)
+		closedir(dir);
+
+	for (cpu = 0; cpu < MAX_CPU_NUMBER; cpu++) {
+		sysinfo->cpu_node[cpu] = 0;
+
+		for (node = 1; node < sysinfo->numa_nodes; node++) {
+			sprintf(path, "/sys/devices/system/cpu/cpu%i/node%i",
+				cpu, node);
+
+			if (access(path, F_OK) == 0) {
+				sysinfo->cpu_node[cpu] = node;
+				break;
+			}
+		}
+	}
+}
+
 /*
  * Huge page information
  */
@@ -299,6 +351,10 @@ static int system_hp(hugepage_info_t *hugeinfo)
 	/* default_huge_page_dir may be NULL if no huge page support */
 	hugeinfo->default_huge_page_dir = get_hugepage_dir(0);
 
+	/* directories for explicitly requested page sizes */
+	hugeinfo->huge_page_dir_2m = get_hugepage_dir(2 * 1024 * 1024ULL);
+	hugeinfo->huge_page_dir_1g = get_hugepage_dir(1024 * 1024 * 1024ULL);
+
 	return 0;
 }
 
@@ -328,6 +384,8 @@ int odp_system_info_init(void)
 		return -1;
 	}
 
+	systemnode(&odp_global_data.system_info);
+
 	system_hp(&odp_global_data.hugepage_info);
 
 	return 0;
@@ -339,6 +397,8 @@ int odp_system_info_init(void)
 int odp_system_info_term(void)
 {
 	free(odp_global_data.hugepage_info.default_huge_page_dir);
+	free(odp_global_data.hugepage_info.huge_page_dir_2m);
+	free(odp_global_data.hugepage_info.huge_page_dir_1g);
 
 	return 0;
 }
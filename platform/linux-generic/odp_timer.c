@@ -28,6 +28,7 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <sys/syscall.h>
+#include <sched.h>
 #include <inttypes.h>
 #include <string.h>
 
@@ -46,10 +47,12 @@
 #include <odp/api/hints.h>
 #include <odp_internal.h>
 #include <odp/api/queue.h>
+#include <odp/api/rwlock.h>
 #include <odp/api/shared_memory.h>
 #include <odp/api/spinlock.h>
 #include <odp/api/std_types.h>
 #include <odp/api/sync.h>
+#include <odp/api/thread.h>
 #include <odp/api/time.h>
 #include <odp/api/timer.h>
 #include <odp_timer_internal.h>
@@ -117,8 +120,18 @@ ODP_STATIC_ASSERT(sizeof(tick_buf_t) == 16, "sizeof(tick_buf_t) == 16");
 typedef struct odp_timer_s {
 	void *user_ptr;
 	odp_queue_t queue;/* Used for free list when timer is free */
+	odp_atomic_u32_t pending;/* Timer is in a mailbox */
+	uint32_t mbox_next;/* Next timer in the mailbox */
+	uint32_t owner;/* Owner thread in per thread pools or TIMER_NONE */
 } odp_timer;
 
+/* Timing wheel links of a timer */
+typedef struct {
+	uint32_t next;
+	uint32_t prev;
+	uint32_t slot;/* Wheel slot or TIMER_NONE */
+} timer_node_t;
+
 static void timer_init(odp_timer *tim,
 		tick_buf_t *tb,
 		odp_queue_t _q,
@@ -164,6 +177,56 @@ static inline void set_next_free(odp_timer *tim, uint32_t nf)
  * Inludes alloc and free timer
  *****************************************************************************/
 
+/* Timing wheel has WHEEL_LEVELS levels of WHEEL_LEVEL_SLOTS slots. A slot on
+ * level N spans WHEEL_LEVEL_SLOTS^N ticks. Timers further in the future than
+ * the highest level wait on an overflow list. */
+#define WHEEL_BITS 8
+#define WHEEL_LEVEL_SLOTS (1U << WHEEL_BITS)
+#define WHEEL_LEVEL_MASK (WHEEL_LEVEL_SLOTS - 1)
+#define WHEEL_LEVELS 4
+#define WHEEL_OVERFLOW (WHEEL_LEVELS * WHEEL_LEVEL_SLOTS)
+#define WHEEL_SLOTS (WHEEL_OVERFLOW + 1)
+#define TIMER_NONE ((uint32_t)-1)
+/* Number of set timers moved onto wheel at a time */
+#define WHEEL_BURST 32
+/* Number of destination queues with timeouts pending delivery */
+#define TMO_BATCH_QUEUES 8
+/* Maximum number of timeouts delivered to a queue at a time */
+#define TMO_BATCH_SIZE 32
+
+/* Free timers in a thread local free list of a per thread pool */
+#define TIMER_CACHE_SIZE 64
+/* Number of timers moved between local and global free lists at a time */
+#define TIMER_CACHE_BURST 32
+
+/* Expired timeouts to a destination queue */
+typedef struct {
+	odp_queue_t queue;
+	uint32_t num;
+	odp_event_t ev[TMO_BATCH_SIZE];
+} tmo_batch_t;
+
+/* Timing wheel. Accessed only by the thread expiring its timers, other
+ * threads pass timers through the mailbox. */
+typedef struct ODP_ALIGNED_CACHE {
+	uint64_t tck;/* Last processed tick */
+	uint64_t next_tick_ns;/* Time of the next tick, clock driven pools */
+	uint32_t num;/* Timers on the wheel */
+	uint32_t num_tmo;/* Timeouts delivered by the current expiry call */
+	uint32_t num_batch;/* Destination queues in batch[] */
+	uint32_t head[WHEEL_SLOTS];
+	tmo_batch_t batch[TMO_BATCH_QUEUES];
+	/* Stack of timers set or freed by other threads */
+	odp_atomic_u32_t mbox ODP_ALIGNED_CACHE;
+} timer_wheel_t;
+
+/* Thread local free list of a per thread pool */
+typedef struct ODP_ALIGNED_CACHE {
+	int32_t num_used;/* Timers allocated minus freed by the thread */
+	uint32_t num;
+	uint32_t idx[TIMER_CACHE_SIZE];
+} timer_cache_t;
+
 typedef struct odp_timer_pool_s {
 /* Put frequently accessed fields in the first cache line */
 	odp_atomic_u64_t cur_tick;/* Current tick value */
@@ -183,13 +246,29 @@ typedef struct odp_timer_pool_s {
 	int notify_overrun;
 	pthread_t timer_thread; /* pthread_t of timer thread */
 	pid_t timer_thread_id; /* gettid() for timer thread */
-	int timer_thread_exit; /* request to exit for timer thread */
+	odp_atomic_u32_t timer_thread_exit; /* request to exit timer thread */
+	/* Clock based ticks of other than signal drive modes */
+	uint64_t start_ns;/* Time of tick 0 */
+	odp_spinlock_t run_lock;/* Expiring thread of an inline pool */
+	timer_node_t *wheel_node;
+	timer_wheel_t *wheel;/* One wheel, or one per thread */
+	timer_cache_t *cache;/* Free lists per thread, or NULL */
 } odp_timer_pool;
 
 #define MAX_TIMER_POOLS 255 /* Leave one for ODP_TIMER_INVALID */
 #define INDEX_BITS 24
 static odp_atomic_u32_t num_timer_pools;
 static odp_timer_pool *timer_pool[MAX_TIMER_POOLS];
+static odp_atomic_u32_t num_inline_pools;
+
+/* Inline timer processing state of a thread. The sequence number is odd
+ * while the thread runs inline pools. Pool destroy waits for running threads
+ * to finish, so that idle threads do not need a shared lock. */
+typedef struct ODP_ALIGNED_CACHE {
+	odp_atomic_u32_t seq;
+} inline_thr_t;
+
+static inline_thr_t inline_thr[ODP_THREAD_COUNT_MAX];
 
 static inline odp_timer_pool *handle_to_tp(odp_timer_t hdl)
 {
@@ -222,6 +301,17 @@ static inline odp_timer_t tp_idx_to_handle(struct odp_timer_pool_s *tp,
 /* Forward declarations */
 static void itimer_init(odp_timer_pool *tp);
 static void itimer_fini(odp_timer_pool *tp);
+static void poll_thread_init(odp_timer_pool *tp);
+
+/* Pool has an implementation thread to stop at destroy */
+static inline int has_timer_thread(odp_timer_pool *tp)
+{
+	if (tp->param.drive == ODP_TIMER_DRIVE_POLL)
+		return 1;
+
+	return tp->param.drive == ODP_TIMER_DRIVE_SIGNAL &&
+	       tp->param.clk_src == ODP_CLOCK_CPU;
+}
 
 static odp_timer_pool_t odp_timer_pool_new(const char *name,
 					   const odp_timer_pool_param_t *param)
@@ -236,11 +326,18 @@ static odp_timer_pool_t odp_timer_pool_new(const char *name,
 	size_t sz0 = ROUNDUP_CACHE_LINE(sizeof(odp_timer_pool));
 	size_t sz1 = ROUNDUP_CACHE_LINE(sizeof(tick_buf_t) * param->num_timers);
 	size_t sz2 = ROUNDUP_CACHE_LINE(sizeof(odp_timer) * param->num_timers);
-	odp_shm_t shm = odp_shm_reserve(name, sz0 + sz1 + sz2,
+	size_t sz3 = ROUNDUP_CACHE_LINE(sizeof(timer_node_t) *
+					param->num_timers);
+	uint32_t num_wheel = param->per_thread ? ODP_THREAD_COUNT_MAX : 1;
+	size_t sz4 = sizeof(timer_wheel_t) * num_wheel;
+	size_t sz5 = param->per_thread ?
+		     sizeof(timer_cache_t) * ODP_THREAD_COUNT_MAX : 0;
+	size_t sz = sz0 + sz1 + sz2 + sz3 + sz4 + sz5;
+	odp_shm_t shm = odp_shm_reserve(name, sz,
 			ODP_CACHE_LINE_SIZE, ODP_SHM_SW_ONLY);
 	if (odp_unlikely(shm == ODP_SHM_INVALID))
 		ODP_ABORT("%s: timer pool shm-alloc(%zuKB) failed\n",
-			  name, (sz0 + sz1 + sz2) / 1024);
+			  name, sz / 1024);
 	odp_timer_pool *tp = (odp_timer_pool *)odp_shm_addr(shm);
 	odp_atomic_init_u64(&tp->cur_tick, 0);
 
@@ -260,12 +357,41 @@ static odp_timer_pool_t odp_timer_pool_new(const char *name,
 	tp->notify_overrun = 1;
 	tp->tick_buf = (void *)((char *)odp_shm_addr(shm) + sz0);
 	tp->timers = (void *)((char *)odp_shm_addr(shm) + sz0 + sz1);
+	tp->wheel_node = (void *)((char *)odp_shm_addr(shm) + sz0 + sz1 + sz2);
+	tp->wheel = (void *)((char *)odp_shm_addr(shm) + sz0 + sz1 + sz2 +
+			     sz3);
+	tp->cache = NULL;
+	if (param->per_thread)
+		tp->cache = (void *)((char *)odp_shm_addr(shm) + sz0 + sz1 +
+				     sz2 + sz3 + sz4);
+	/* Initialize wheels and free lists */
+	uint32_t i, j;
+
+	for (i = 0; i < num_wheel; i++) {
+		timer_wheel_t *wheel = &tp->wheel[i];
+
+		wheel->tck = 0;
+		wheel->next_tick_ns = 0;
+		wheel->num = 0;
+		wheel->num_tmo = 0;
+		wheel->num_batch = 0;
+		for (j = 0; j < WHEEL_SLOTS; j++)
+			wheel->head[j] = TIMER_NONE;
+		odp_atomic_init_u32(&wheel->mbox, TIMER_NONE);
+
+		if (tp->cache) {
+			tp->cache[i].num_used = 0;
+			tp->cache[i].num = 0;
+		}
+	}
 	/* Initialize all odp_timer entries */
-	uint32_t i;
 	for (i = 0; i < tp->param.num_timers; i++) {
 		tp->timers[i].queue = ODP_QUEUE_INVALID;
 		set_next_free(&tp->timers[i], i + 1);
 		tp->timers[i].user_ptr = NULL;
+		odp_atomic_init_u32(&tp->timers[i].pending, 0);
+		tp->timers[i].owner = TIMER_NONE;
+		tp->wheel_node[i].slot = TIMER_NONE;
 #if __GCC_ATOMIC_LLONG_LOCK_FREE < 2
 		tp->tick_buf[i].exp_tck.v = TMO_UNUSED;
 #else
@@ -275,8 +401,20 @@ static odp_timer_pool_t odp_timer_pool_new(const char *name,
 	}
 	tp->tp_idx = tp_idx;
 	odp_spinlock_init(&tp->lock);
+	odp_spinlock_init(&tp->run_lock);
+	odp_atomic_init_u32(&tp->timer_thread_exit, 0);
+	tp->start_ns = odp_time_to_ns(odp_time_global());
+
+	/* Initialize the pool before inline threads may see it */
+	odp_mb_release();
 	timer_pool[tp_idx] = tp;
-	if (tp->param.clk_src == ODP_CLOCK_CPU)
+	if (tp->param.drive == ODP_TIMER_DRIVE_INLINE)
+		odp_atomic_inc_u32(&num_inline_pools);
+
+	if (tp->param.drive == ODP_TIMER_DRIVE_POLL)
+		poll_thread_init(tp);
+	else if (tp->param.drive == ODP_TIMER_DRIVE_SIGNAL &&
+		 tp->param.clk_src == ODP_CLOCK_CPU)
 		itimer_init(tp);
 	return tp;
 }
@@ -295,24 +433,67 @@ static void stop_timer_thread(odp_timer_pool *tp)
 	int ret;
 
 	ODP_DBG("stop\n");
-	tp->timer_thread_exit = 1;
+	odp_atomic_store_u32(&tp->timer_thread_exit, 1);
 	ret = pthread_join(tp->timer_thread, NULL);
 	if (ret != 0)
 		ODP_ABORT("unable to join thread, err %d\n", ret);
 }
 
+/* Number of timers allocated by the application */
+static uint32_t timers_in_use(odp_timer_pool *tp)
+{
+	int32_t num = 0;
+	int i;
+
+	if (!tp->param.per_thread)
+		return tp->num_alloc;
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		num += tp->cache[i].num_used;
+
+	return num;
+}
+
+/* Wait until threads that may have seen a removed pool have finished
+ * running inline pools */
+static void inline_thr_wait(void)
+{
+	uint32_t seq;
+	int i;
+
+	/* Pairs with the barrier in _odp_timer_run_inline() */
+	odp_mb_full();
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		seq = odp_atomic_load_acq_u32(&inline_thr[i].seq);
+
+		if ((seq & 1) == 0)
+			continue;
+
+		while (odp_atomic_load_acq_u32(&inline_thr[i].seq) == seq)
+			odp_cpu_pause();
+	}
+}
+
 static void odp_timer_pool_del(odp_timer_pool *tp)
 {
-	odp_spinlock_lock(&tp->lock);
 	timer_pool[tp->tp_idx] = NULL;
+	if (tp->param.drive == ODP_TIMER_DRIVE_INLINE) {
+		odp_atomic_dec_u32(&num_inline_pools);
+		inline_thr_wait();
+	}
+
+	odp_spinlock_lock(&tp->lock);
 
 	/* Stop timer triggering */
-	if (tp->param.clk_src == ODP_CLOCK_CPU)
+	if (tp->param.drive == ODP_TIMER_DRIVE_SIGNAL &&
+	    tp->param.clk_src == ODP_CLOCK_CPU)
 		itimer_fini(tp);
 
-	stop_timer_thread(tp);
+	if (has_timer_thread(tp))
+		stop_timer_thread(tp);
 
-	if (tp->num_alloc != 0) {
+	if (timers_in_use(tp) != 0) {
 		/* It's a programming error to attempt to destroy a */
 		/* timer pool which is still in use */
 		ODP_ABORT("%s: timers in use\n", tp->name);
@@ -324,11 +505,89 @@ static void odp_timer_pool_del(odp_timer_pool *tp)
 	odp_atomic_sub_u32(&num_timer_pools, 1);
 }
 
+/* Get a free timer from the thread local free list, refill the list from
+ * the global free list when empty */
+static inline uint32_t timer_cache_get(odp_timer_pool *tp,
+				       timer_cache_t *cache)
+{
+	if (odp_unlikely(cache->num == 0)) {
+		odp_spinlock_lock(&tp->lock);
+		while (cache->num < TIMER_CACHE_BURST &&
+		       tp->num_alloc < tp->param.num_timers) {
+			uint32_t idx = tp->first_free;
+			odp_timer *tim = &tp->timers[idx];
+
+			tp->first_free = get_next_free(tim);
+			tim->queue = ODP_QUEUE_INVALID;
+			cache->idx[cache->num++] = idx;
+			tp->num_alloc++;
+		}
+		if (odp_unlikely(tp->num_alloc >
+				 odp_atomic_load_u32(&tp->high_wm)))
+			/* Handles of cached timers are valid from now on */
+			_odp_atomic_u32_store_mm(&tp->high_wm,
+						 tp->num_alloc,
+						 _ODP_MEMMODEL_RLS);
+		odp_spinlock_unlock(&tp->lock);
+
+		if (cache->num == 0)
+			return TIMER_NONE;
+	}
+
+	return cache->idx[--cache->num];
+}
+
+/* Put a free timer into the thread local free list, return a burst of
+ * timers to the global free list when full */
+static inline void timer_cache_put(odp_timer_pool *tp, timer_cache_t *cache,
+				   uint32_t idx)
+{
+	if (odp_unlikely(cache->num == TIMER_CACHE_SIZE)) {
+		uint32_t i;
+
+		odp_spinlock_lock(&tp->lock);
+		for (i = 0; i < TIMER_CACHE_BURST; i++) {
+			uint32_t free_idx = cache->idx[--cache->num];
+
+			set_next_free(&tp->timers[free_idx], tp->first_free);
+			tp->first_free = free_idx;
+		}
+		tp->num_alloc -= TIMER_CACHE_BURST;
+		odp_spinlock_unlock(&tp->lock);
+	}
+
+	cache->idx[cache->num++] = idx;
+}
+
+static inline odp_timer_t timer_alloc_local(odp_timer_pool *tp,
+					    odp_queue_t queue,
+					    void *user_ptr)
+{
+	uint32_t thr = odp_thread_id();
+	timer_cache_t *cache = &tp->cache[thr];
+	uint32_t idx = timer_cache_get(tp, cache);
+
+	if (odp_unlikely(idx == TIMER_NONE)) {
+		__odp_errno = ENFILE; /* Reusing file table overflow */
+		return ODP_TIMER_INVALID;
+	}
+
+	tp->timers[idx].owner = thr;
+	timer_init(&tp->timers[idx], &tp->tick_buf[idx], queue, user_ptr);
+	cache->num_used++;
+
+	return tp_idx_to_handle(tp, idx);
+}
+
 static inline odp_timer_t timer_alloc(odp_timer_pool *tp,
 				      odp_queue_t queue,
 				      void *user_ptr)
 {
 	odp_timer_t hdl;
+
+	if (tp->param.per_thread)
+		return timer_alloc_local(tp, queue, user_ptr);
+
 	odp_spinlock_lock(&tp->lock);
 	if (odp_likely(tp->num_alloc < tp->param.num_timers)) {
 		tp->num_alloc++;
@@ -358,6 +617,8 @@ static inline odp_timer_t timer_alloc(odp_timer_pool *tp,
 static odp_buffer_t timer_cancel(odp_timer_pool *tp,
 		uint32_t idx,
 		uint64_t new_state);
+static void timer_reclaim(odp_timer_pool *tp, uint32_t thr, uint32_t idx);
+static inline void timer_pending(odp_timer_pool *tp, uint32_t idx);
 
 static inline odp_buffer_t timer_free(odp_timer_pool *tp, uint32_t idx)
 {
@@ -367,6 +628,19 @@ static inline odp_buffer_t timer_free(odp_timer_pool *tp, uint32_t idx)
 	 * grab any timeout buffer */
 	odp_buffer_t old_buf = timer_cancel(tp, idx, TMO_UNUSED);
 
+	if (tp->param.per_thread) {
+		uint32_t thr = odp_thread_id();
+
+		/* Only the owner may unlink the timer from its wheel */
+		if (tim->owner == thr)
+			timer_reclaim(tp, thr, idx);
+		else
+			timer_pending(tp, idx);
+
+		tp->cache[thr].num_used--;
+		return old_buf;
+	}
+
 	/* Destroy timer */
 	timer_fini(tim, &tp->tick_buf[idx]);
 
@@ -559,7 +833,74 @@ static odp_buffer_t timer_cancel(odp_timer_pool *tp,
 	return old_buf;
 }
 
-static unsigned timer_expire(odp_timer_pool *tp, uint32_t idx, uint64_t tick)
+/******************************************************************************
+ * Timeout delivery
+ * Expired timeouts are collected per destination queue and enqueued in
+ * bursts. Only the thread expiring timers of the wheel accesses the batches.
+ *****************************************************************************/
+
+static void tmo_batch_flush(tmo_batch_t *batch)
+{
+	uint32_t i = 0;
+	int rc;
+
+	while (i < batch->num) {
+		rc = odp_queue_enq_multi(batch->queue, &batch->ev[i],
+					 batch->num - i);
+		if (odp_unlikely(rc <= 0)) {
+			for (; i < batch->num; i++)
+				odp_event_free(batch->ev[i]);
+			ODP_ABORT("Failed to enqueue timeout buffer (%d)\n",
+				  rc);
+		}
+		i += rc;
+	}
+
+	batch->num = 0;
+}
+
+static void tmo_flush(timer_wheel_t *wheel)
+{
+	uint32_t i;
+
+	for (i = 0; i < wheel->num_batch; i++)
+		tmo_batch_flush(&wheel->batch[i]);
+
+	wheel->num_batch = 0;
+}
+
+static inline void tmo_deliver(timer_wheel_t *wheel, odp_queue_t queue,
+			       odp_event_t ev)
+{
+	tmo_batch_t *batch;
+	uint32_t i;
+
+	for (i = 0; i < wheel->num_batch; i++)
+		if (wheel->batch[i].queue == queue)
+			break;
+
+	if (odp_unlikely(i == TMO_BATCH_QUEUES)) {
+		/* Keep delivery order per queue */
+		tmo_flush(wheel);
+		i = 0;
+	}
+
+	batch = &wheel->batch[i];
+
+	if (i == wheel->num_batch) {
+		batch->queue = queue;
+		batch->num = 0;
+		wheel->num_batch++;
+	}
+
+	batch->ev[batch->num++] = ev;
+
+	if (batch->num == TMO_BATCH_SIZE)
+		tmo_batch_flush(batch);
+}
+
+static unsigned timer_expire(odp_timer_pool *tp, timer_wheel_t *wheel,
+			     uint32_t idx, uint64_t tick)
 {
 	odp_timer *tim = &tp->timers[idx];
 	tick_buf_t *tb = &tp->tick_buf[idx];
@@ -631,13 +972,7 @@ static unsigned timer_expire(odp_timer_pool *tp, uint32_t idx, uint64_t tick)
 		}
 		/* Else ignore events of other types */
 		/* Post the timeout to the destination queue */
-		int rc = odp_queue_enq(tim->queue,
-				       odp_buffer_to_event(tmo_buf));
-		if (odp_unlikely(rc != 0)) {
-			odp_buffer_free(tmo_buf);
-			ODP_ABORT("Failed to enqueue timeout buffer (%d)\n",
-				  rc);
-		}
+		tmo_deliver(wheel, tim->queue, odp_buffer_to_event(tmo_buf));
 		return 1;
 	} else {
 		/* Else false positive, ignore */
@@ -645,31 +980,309 @@ static unsigned timer_expire(odp_timer_pool *tp, uint32_t idx, uint64_t tick)
 	}
 }
 
-static unsigned odp_timer_pool_expire(odp_timer_pool_t tpid, uint64_t tick)
+/******************************************************************************
+ * Timing wheel
+ * Set operations pass timers to the expiring thread through a mailbox. That
+ * thread places them on the wheel by expiration tick, so that per tick work
+ * depends on the number of set and expiring timers, not on the number of
+ * allocated timers. Timer state in tick_buf remains authoritative: cancelled,
+ * freed and reset timers are dropped or moved when their slot is processed.
+ *
+ * A per thread pool has a wheel per thread. Timers are owned by the thread
+ * which allocated them and are placed directly onto the owner's wheel when
+ * set by the owner. Timers set or freed by other threads pass through the
+ * owner's mailbox, and the owner returns freed timers to its free list.
+ *****************************************************************************/
+
+static inline uint64_t timer_exp_tck(tick_buf_t *tb)
+{
+#if __GCC_ATOMIC_LLONG_LOCK_FREE < 2
+	return tb->exp_tck.v;
+#else
+	return odp_atomic_load_u64(&tb->exp_tck);
+#endif
+}
+
+/* Pass a timer to the mailbox of its wheel */
+static inline void timer_pending(odp_timer_pool *tp, uint32_t idx)
+{
+	odp_timer *tim = &tp->timers[idx];
+	timer_wheel_t *wheel = tp->wheel;
+	uint32_t head;
+
+	if (tp->param.per_thread) {
+		uint32_t owner = tim->owner;
+
+		/* Freed timer, nothing to pass */
+		if (owner == TIMER_NONE)
+			return;
+
+		wheel = &tp->wheel[owner];
+	}
+
+	/* Order expiration tick write before pending flag read. Pairs with
+	 * the barrier in wheel_drain(). */
+	odp_mb_full();
+
+	if (odp_atomic_load_u32(&tim->pending) ||
+	    odp_atomic_xchg_u32(&tim->pending, 1))
+		return;
+
+	/* Lock-free push. The owner takes the whole list at once, so a timer
+	 * cannot be removed and pushed back in between (no ABA problem). */
+	head = odp_atomic_load_u32(&wheel->mbox);
+	do {
+		tim->mbox_next = head;
+	} while (!odp_atomic_cas_rel_u32(&wheel->mbox, &head, idx));
+}
+
+static void wheel_unlink(odp_timer_pool *tp, timer_wheel_t *wheel,
+			 uint32_t idx)
+{
+	timer_node_t *node = &tp->wheel_node[idx];
+
+	if (node->slot == TIMER_NONE)
+		return;
+
+	if (node->prev == TIMER_NONE)
+		wheel->head[node->slot] = node->next;
+	else
+		tp->wheel_node[node->prev].next = node->next;
+
+	if (node->next != TIMER_NONE)
+		tp->wheel_node[node->next].prev = node->prev;
+
+	node->slot = TIMER_NONE;
+	wheel->num--;
+}
+
+static void wheel_link(odp_timer_pool *tp, timer_wheel_t *wheel,
+		       uint32_t idx, uint32_t slot)
+{
+	timer_node_t *node = &tp->wheel_node[idx];
+	uint32_t head = wheel->head[slot];
+
+	node->slot = slot;
+	node->prev = TIMER_NONE;
+	node->next = head;
+
+	if (head != TIMER_NONE)
+		tp->wheel_node[head].prev = idx;
+
+	wheel->head[slot] = idx;
+	wheel->num++;
+}
+
+/* Skip ticks of an empty wheel */
+static inline void wheel_skip(timer_wheel_t *wheel, uint64_t tick)
+{
+	if (wheel->num == 0 && wheel->tck < tick)
+		wheel->tck = tick;
+}
+
+/* Place timer on the wheel by its current expiration tick, or expire it */
+static unsigned wheel_insert(odp_timer_pool *tp, timer_wheel_t *wheel,
+			     uint32_t idx)
+{
+	uint64_t exp_tck = timer_exp_tck(&tp->tick_buf[idx]);
+	uint64_t delta;
+	uint32_t level, slot;
+
+	wheel_unlink(tp, wheel, idx);
+
+	/* Cancelled, expired or freed timer */
+	if (exp_tck & TMO_INACTIVE)
+		return 0;
+
+	if (exp_tck <= wheel->tck) {
+		uint32_t max = tp->param.max_tmo_per_tick;
+		unsigned nexp;
+
+		/* Delivery limit reached, retry on the next tick */
+		if (max && wheel->num_tmo >= max) {
+			wheel_link(tp, wheel, idx,
+				   (wheel->tck + 1) & WHEEL_LEVEL_MASK);
+			return 0;
+		}
+
+		/* Due timer, or a concurrent reset passed again through the
+		 * mailbox */
+		nexp = timer_expire(tp, wheel, idx, wheel->tck);
+		wheel->num_tmo += nexp;
+		return nexp;
+	}
+
+	delta = exp_tck - wheel->tck;
+	slot = WHEEL_OVERFLOW;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		if (delta < (1ULL << (WHEEL_BITS * (level + 1)))) {
+			slot = level * WHEEL_LEVEL_SLOTS +
+			       ((exp_tck >> (WHEEL_BITS * level)) &
+				WHEEL_LEVEL_MASK);
+			break;
+		}
+	}
+
+	wheel_link(tp, wheel, idx, slot);
+	return 0;
+}
+
+/* Expire or move to lower levels all timers of a slot */
+static unsigned wheel_slot_run(odp_timer_pool *tp, timer_wheel_t *wheel,
+			       uint32_t slot)
 {
-	tick_buf_t *array = &tpid->tick_buf[0];
-	uint32_t high_wm = _odp_atomic_u32_load_mm(&tpid->high_wm,
-			_ODP_MEMMODEL_ACQ);
+	uint32_t idx = wheel->head[slot];
+	uint32_t next;
 	unsigned nexp = 0;
-	uint32_t i;
 
-	ODP_ASSERT(high_wm <= tpid->param.num_timers);
-	for (i = 0; i < high_wm;) {
-		/* As a rare occurrence, we can outsmart the HW prefetcher
-		 * and the compiler (GCC -fprefetch-loop-arrays) with some
-		 * tuned manual prefetching (32x16=512B ahead), seems to
-		 * give 30% better performance on ARM C-A15 */
-		__builtin_prefetch(&array[i + 32], 0, 0);
-		/* Non-atomic read for speed */
-		uint64_t exp_tck = array[i++].exp_tck.v;
-		if (odp_unlikely(exp_tck <= tick)) {
-			/* Attempt to expire timer */
-			nexp += timer_expire(tpid, i - 1, tick);
+	/* Detach the list, timers may be linked back into the same slot */
+	wheel->head[slot] = TIMER_NONE;
+
+	while (idx != TIMER_NONE) {
+		next = tp->wheel_node[idx].next;
+		tp->wheel_node[idx].slot = TIMER_NONE;
+		wheel->num--;
+		nexp += wheel_insert(tp, wheel, idx);
+		idx = next;
+	}
+
+	return nexp;
+}
+
+/* Return a freed timer into the free list of the owner thread */
+static void timer_reclaim(odp_timer_pool *tp, uint32_t thr, uint32_t idx)
+{
+	timer_fini(&tp->timers[idx], &tp->tick_buf[idx]);
+	wheel_unlink(tp, &tp->wheel[thr], idx);
+	tp->timers[idx].owner = TIMER_NONE;
+	timer_cache_put(tp, &tp->cache[thr], idx);
+}
+
+/* Handle a timer received through the mailbox */
+static inline unsigned wheel_mbox_timer(odp_timer_pool *tp,
+					timer_wheel_t *wheel, uint32_t idx)
+{
+	odp_timer *tim = &tp->timers[idx];
+	uint32_t thr = wheel - tp->wheel;
+
+	if (!tp->param.per_thread)
+		return wheel_insert(tp, wheel, idx);
+
+	if (tim->owner != thr) {
+		/* Timer was freed and allocated by another thread */
+		timer_pending(tp, idx);
+		return 0;
+	}
+
+	/* Freed by another thread */
+	if (timer_exp_tck(&tp->tick_buf[idx]) == TMO_UNUSED) {
+		timer_reclaim(tp, thr, idx);
+		return 0;
+	}
+
+	return wheel_insert(tp, wheel, idx);
+}
+
+/* Move timers set since the previous call onto the wheel */
+static unsigned wheel_drain(odp_timer_pool *tp, timer_wheel_t *wheel)
+{
+	uint32_t idx[WHEEL_BURST];
+	uint32_t next, num, i;
+	unsigned nexp = 0;
+
+	if (odp_atomic_load_u32(&wheel->mbox) == TIMER_NONE)
+		return 0;
+
+	next = odp_atomic_xchg_u32(&wheel->mbox, TIMER_NONE);
+	odp_mb_acquire();
+
+	while (next != TIMER_NONE) {
+		for (num = 0; num < WHEEL_BURST && next != TIMER_NONE;
+		     num++) {
+			idx[num] = next;
+			next = tp->timers[next].mbox_next;
+			/* Timer may be pushed again after this */
+			odp_atomic_store_rel_u32(&tp->timers[idx[num]].pending,
+						 0);
+		}
+
+		/* Order pending flag clear before expiration tick read */
+		odp_mb_full();
+
+		for (i = 0; i < num; i++)
+			nexp += wheel_mbox_timer(tp, wheel, idx[i]);
+	}
+
+	return nexp;
+}
+
+/* Expire timers up to a tick. The delivery limit applies to the whole call.
+ * When it is reached, the wheel stops at the current tick and catches up on
+ * following calls. */
+static unsigned wheel_expire(odp_timer_pool *tp, timer_wheel_t *wheel,
+			     uint64_t tick)
+{
+	uint32_t max = tp->param.max_tmo_per_tick;
+	unsigned nexp;
+	uint64_t tck;
+	int level, top;
+
+	wheel->num_tmo = 0;
+	nexp = wheel_drain(tp, wheel);
+
+	wheel_skip(wheel, tick);
+
+	while (wheel->tck < tick) {
+		if (max && wheel->num_tmo >= max)
+			break;
+
+		tck = ++wheel->tck;
+
+		/* Cascade upper level slots which are due, highest first */
+		for (top = 0; top < WHEEL_LEVELS; top++)
+			if (tck & ((1ULL << (WHEEL_BITS * (top + 1))) - 1))
+				break;
+
+		for (level = top; level > 0; level--) {
+			uint32_t slot = WHEEL_OVERFLOW;
+
+			if (level < WHEEL_LEVELS)
+				slot = level * WHEEL_LEVEL_SLOTS +
+				       ((tck >> (WHEEL_BITS * level)) &
+					WHEEL_LEVEL_MASK);
+
+			nexp += wheel_slot_run(tp, wheel, slot);
 		}
+
+		nexp += wheel_slot_run(tp, wheel, tck & WHEEL_LEVEL_MASK);
 	}
+
+	tmo_flush(wheel);
 	return nexp;
 }
 
+/* Pass a timer which was set to its wheel */
+static inline void timer_place(odp_timer_pool *tp, uint32_t idx)
+{
+	if (tp->param.per_thread) {
+		uint32_t thr = odp_thread_id();
+		timer_wheel_t *wheel = &tp->wheel[thr];
+
+		/* Set by the owner, before its wheel reached the tick */
+		if (tp->timers[idx].owner == thr) {
+			wheel_skip(wheel, odp_atomic_load_u64(&tp->cur_tick));
+
+			if (timer_exp_tck(&tp->tick_buf[idx]) > wheel->tck) {
+				(void)wheel_insert(tp, wheel, idx);
+				return;
+			}
+		}
+	}
+
+	timer_pending(tp, idx);
+}
+
 /******************************************************************************
  * POSIX timer support
  * Functions that use Linux/POSIX per-process timers and related facilities
@@ -689,18 +1302,10 @@ static void timer_notify(odp_timer_pool *tp)
 		}
 	}
 
-	odp_timer *array = &tp->timers[0];
-	uint32_t i;
-	/* Prefetch initial cache lines (match 32 above) */
-	for (i = 0; i < 32; i += ODP_CACHE_LINE_SIZE / sizeof(array[0]))
-		__builtin_prefetch(&array[i], 0, 0);
 	prev_tick = odp_atomic_fetch_inc_u64(&tp->cur_tick);
 
-	/* Scan timer array, looking for timers to expire */
-	(void)odp_timer_pool_expire(tp, prev_tick + 1);
-
-	/* Else skip scan of timers. cur_tick was updated and next itimer
-	 * invocation will process older expiration ticks as well */
+	/* Expire timers of the new tick */
+	(void)wheel_expire(tp, tp->wheel, prev_tick + 1);
 }
 
 static void *timer_thread(void *arg)
@@ -724,7 +1329,7 @@ static void *timer_thread(void *arg)
 
 	while (1) {
 		ret = sigtimedwait(&sigset, &si, &tmo);
-		if (tp->timer_thread_exit) {
+		if (odp_atomic_load_u32(&tp->timer_thread_exit)) {
 			tp->timer_thread_id = 0;
 			return NULL;
 		}
@@ -787,6 +1392,106 @@ static void itimer_fini(odp_timer_pool *tp)
 			  strerror(errno));
 }
 
+/******************************************************************************
+ * Clock driven timer pools
+ * Inline and poll drive modes derive the current tick from the clock
+ *****************************************************************************/
+
+/* Advance a wheel to the current tick and expire its timers. Only one thread
+ * at a time runs a wheel: the poll thread, an idle thread holding run_lock of
+ * an inline pool, or the owner thread of a per thread wheel. */
+static void timer_pool_run(odp_timer_pool *tp, timer_wheel_t *wheel)
+{
+	uint64_t now = odp_time_to_ns(odp_time_global());
+	uint64_t tick;
+
+	if (odp_likely(now < wheel->next_tick_ns))
+		return;
+
+	tick = (now - tp->start_ns) / tp->param.res_ns;
+	wheel->next_tick_ns = tp->start_ns + (tick + 1) * tp->param.res_ns;
+
+	odp_atomic_max_u64(&tp->cur_tick, tick);
+	(void)wheel_expire(tp, wheel, tick);
+}
+
+void _odp_timer_run_inline(void)
+{
+	uint32_t num = odp_atomic_load_u32(&num_inline_pools);
+	inline_thr_t *thr;
+	uint32_t i, seq;
+
+	if (odp_likely(num == 0))
+		return;
+
+	/* Pools are not destroyed while the sequence number is odd. Only this
+	 * thread writes it, so stores and a local barrier are enough. */
+	thr = &inline_thr[odp_thread_id()];
+	seq = odp_atomic_load_u32(&thr->seq);
+	odp_atomic_store_u32(&thr->seq, seq + 1);
+	odp_mb_full();
+
+	for (i = 0; i < MAX_TIMER_POOLS && num; i++) {
+		odp_timer_pool *tp = timer_pool[i];
+
+		if (tp == NULL || tp->param.drive != ODP_TIMER_DRIVE_INLINE)
+			continue;
+
+		num--;
+
+		if (tp->param.per_thread) {
+			timer_pool_run(tp, &tp->wheel[odp_thread_id()]);
+			continue;
+		}
+
+		/* Some other thread is already processing timers */
+		if (odp_spinlock_is_locked(&tp->run_lock) ||
+		    !odp_spinlock_trylock(&tp->run_lock))
+			continue;
+
+		timer_pool_run(tp, tp->wheel);
+		odp_spinlock_unlock(&tp->run_lock);
+	}
+
+	odp_atomic_store_rel_u32(&thr->seq, seq + 2);
+}
+
+static void *poll_thread(void *arg)
+{
+	odp_timer_pool *tp = (odp_timer_pool *)arg;
+
+	while (!odp_atomic_load_u32(&tp->timer_thread_exit)) {
+		timer_pool_run(tp, tp->wheel);
+		odp_cpu_pause();
+	}
+
+	return NULL;
+}
+
+static void poll_thread_init(odp_timer_pool *tp)
+{
+	cpu_set_t cpuset;
+	int ret;
+
+	ODP_DBG("Creating poll thread for timer pool %s, period %"
+		PRIu64" ns\n", tp->name, tp->param.res_ns);
+
+	ret = pthread_create(&tp->timer_thread, NULL, poll_thread, tp);
+	if (ret)
+		ODP_ABORT("unable to create timer thread\n");
+
+	if (tp->param.drive_cpu < 0)
+		return;
+
+	CPU_ZERO(&cpuset);
+	CPU_SET(tp->param.drive_cpu, &cpuset);
+
+	if (pthread_setaffinity_np(tp->timer_thread, sizeof(cpu_set_t),
+				   &cpuset))
+		ODP_ERR("%s: timer thread not pinned to CPU %i\n",
+			tp->name, tp->param.drive_cpu);
+}
+
 /******************************************************************************
  * Public API functions
  * Some parameter checks and error messages
@@ -796,13 +1501,45 @@ odp_timer_pool_t
 odp_timer_pool_create(const char *name,
 		      const odp_timer_pool_param_t *param)
 {
+	odp_timer_pool_param_t tp_param = *param;
+
 	/* Verify that buffer pool can be used for timeouts */
 	/* Verify that we have a valid (non-zero) timer resolution */
 	if (param->res_ns == 0) {
 		__odp_errno = EINVAL;
 		return ODP_TIMER_POOL_INVALID;
 	}
-	return odp_timer_pool_new(name, param);
+	/* Drive fields are left uninitialized by applications which do not
+	 * call odp_timer_pool_param_init(). Those get the signal driven
+	 * timer thread, as before the drive modes. */
+	if (tp_param.drive != ODP_TIMER_DRIVE_SIGNAL &&
+	    tp_param.drive != ODP_TIMER_DRIVE_INLINE &&
+	    tp_param.drive != ODP_TIMER_DRIVE_POLL) {
+		tp_param.drive = ODP_TIMER_DRIVE_SIGNAL;
+		tp_param.per_thread = 0;
+	}
+	if (tp_param.drive_cpu < 0 || tp_param.drive_cpu >= CPU_SETSIZE)
+		tp_param.drive_cpu = -1;
+	/* A limit of all timers never defers a timeout. Such values, e.g.
+	 * left uninitialized, disable the limit. */
+	if (tp_param.max_tmo_per_tick >= tp_param.num_timers)
+		tp_param.max_tmo_per_tick = 0;
+	/* Per thread wheels are run by their owners */
+	if (tp_param.per_thread && tp_param.drive != ODP_TIMER_DRIVE_INLINE) {
+		__odp_errno = EINVAL;
+		return ODP_TIMER_POOL_INVALID;
+	}
+	return odp_timer_pool_new(name, &tp_param);
+}
+
+void odp_timer_pool_param_init(odp_timer_pool_param_t *param)
+{
+	memset(param, 0, sizeof(odp_timer_pool_param_t));
+	param->clk_src   = ODP_CLOCK_CPU;
+	param->drive     = ODP_TIMER_DRIVE_SIGNAL;
+	param->drive_cpu = -1;
+	param->max_tmo_per_tick = 0;
+	param->per_thread = false;
 }
 
 void odp_timer_pool_start(void)
@@ -835,7 +1572,7 @@ int odp_timer_pool_info(odp_timer_pool_t tpid,
 			odp_timer_pool_info_t *buf)
 {
 	buf->param = tpid->param;
-	buf->cur_timers = tpid->num_alloc;
+	buf->cur_timers = timers_in_use(tpid);
 	buf->hwm_timers = odp_atomic_load_u32(&tpid->high_wm);
 	buf->name = tpid->name;
 	return 0;
@@ -883,10 +1620,12 @@ int odp_timer_set_abs(odp_timer_t hdl,
 		return ODP_TIMER_TOOEARLY;
 	if (odp_unlikely(abs_tck > cur_tick + tp->max_rel_tck))
 		return ODP_TIMER_TOOLATE;
-	if (timer_reset(idx, abs_tck, (odp_buffer_t *)tmo_ev, tp))
+	if (timer_reset(idx, abs_tck, (odp_buffer_t *)tmo_ev, tp)) {
+		timer_place(tp, idx);
 		return ODP_TIMER_SUCCESS;
-	else
+	} else {
 		return ODP_TIMER_NOEVENT;
+	}
 }
 
 int odp_timer_set_rel(odp_timer_t hdl,
@@ -900,10 +1639,12 @@ int odp_timer_set_rel(odp_timer_t hdl,
 		return ODP_TIMER_TOOEARLY;
 	if (odp_unlikely(rel_tck > tp->max_rel_tck))
 		return ODP_TIMER_TOOLATE;
-	if (timer_reset(idx, abs_tck, (odp_buffer_t *)tmo_ev, tp))
+	if (timer_reset(idx, abs_tck, (odp_buffer_t *)tmo_ev, tp)) {
+		timer_place(tp, idx);
 		return ODP_TIMER_SUCCESS;
-	else
+	} else {
 		return ODP_TIMER_NOEVENT;
+	}
 }
 
 int odp_timer_cancel(odp_timer_t hdl, odp_event_t *tmo_ev)
@@ -991,14 +1732,18 @@ void odp_timeout_free(odp_timeout_t tmo)
 
 int odp_timer_init_global(void)
 {
-#ifndef ODP_ATOMIC_U128
 	uint32_t i;
+
+#ifndef ODP_ATOMIC_U128
 	for (i = 0; i < NUM_LOCKS; i++)
 		_odp_atomic_flag_clear(&locks[i]);
 #else
 	ODP_DBG("Using lock-less timer implementation\n");
 #endif
 	odp_atomic_init_u32(&num_timer_pools, 0);
+	odp_atomic_init_u32(&num_inline_pools, 0);
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		odp_atomic_init_u32(&inline_thr[i].seq, 0);
 
 	block_sigalarm();
 
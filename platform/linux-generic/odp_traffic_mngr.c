@@ -88,7 +88,7 @@ static odp_ticketlock_t tm_profile_lock;
 static odp_barrier_t tm_first_enq;
 
 static int g_main_thread_cpu = -1;
-static int g_tm_cpu_num;
+static uint32_t g_tm_cpu_threads[ODP_CPUMASK_SIZE];
 
 /* Forward function declarations. */
 static void tm_queue_cnts_decrement(tm_system_t *tm_system,
@@ -324,30 +324,33 @@ static int input_work_queue_append(tm_system_t *tm_system,
 	return 0;
 }
 
-static int input_work_queue_remove(input_work_queue_t *input_work_queue,
-				   input_work_item_t *work_item)
+static uint32_t input_work_queue_remove(input_work_queue_t *input_work_queue,
+					input_work_item_t work_items[],
+					uint32_t max_items)
 {
-	input_work_item_t *entry_ptr;
-	uint32_t queue_cnt, head_idx;
+	uint32_t queue_cnt, head_idx, num, idx;
 
 	queue_cnt = odp_atomic_load_u64(&input_work_queue->queue_cnt);
 	if (queue_cnt == 0)
-		return -1;
+		return 0;
 
+	/* Remove up to max_items work items while holding the lock once. */
+	num = MIN(queue_cnt, max_items);
 	odp_ticketlock_lock(&input_work_queue->lock);
 	head_idx = input_work_queue->head_idx;
-	entry_ptr = &input_work_queue->work_ring[head_idx];
 
-	*work_item = *entry_ptr;
-	head_idx++;
-	if (INPUT_WORK_RING_SIZE <= head_idx)
-		head_idx = 0;
+	for (idx = 0; idx < num; idx++) {
+		work_items[idx] = input_work_queue->work_ring[head_idx];
+		head_idx++;
+		if (INPUT_WORK_RING_SIZE <= head_idx)
+			head_idx = 0;
+	}
 
-	input_work_queue->total_dequeues++;
+	input_work_queue->total_dequeues += num;
 	input_work_queue->head_idx = head_idx;
 	odp_ticketlock_unlock(&input_work_queue->lock);
-	odp_atomic_dec_u64(&input_work_queue->queue_cnt);
-	return 0;
+	odp_atomic_sub_u64(&input_work_queue->queue_cnt, num);
+	return num;
 }
 
 static tm_system_t *tm_system_alloc(void)
@@ -1871,6 +1874,13 @@ static void tm_queue_cnts_decrement(tm_system_t *tm_system,
 	odp_atomic_sub_u64(&queue_cnts->byte_cnt, frame_len);
 }
 
+static inline int tm_first_enq_claim(tm_system_group_t *tm_group)
+{
+	uint32_t zero = 0;
+
+	return odp_atomic_cas_u32(&tm_group->first_enq, &zero, 1);
+}
+
 static int tm_enqueue(tm_system_t *tm_system,
 		      tm_queue_obj_t *tm_queue_obj,
 		      odp_packet_t pkt)
@@ -1883,11 +1893,12 @@ static int tm_enqueue(tm_system_t *tm_system,
 	uint32_t frame_len, pkt_depth;
 	int rc;
 
+	/* The first enqueue releases the service thread. Only the thread
+	 * which claims it meets the service thread at the barrier. */
 	tm_group = GET_TM_GROUP(tm_system->odp_tm_group);
-	if (tm_group->first_enq == 0) {
+	if (odp_unlikely(odp_atomic_load_u32(&tm_group->first_enq) == 0) &&
+	    tm_first_enq_claim(tm_group))
 		odp_barrier_wait(&tm_group->tm_group_barrier);
-		tm_group->first_enq = 1;
-	}
 
 	pkt_color = odp_packet_color(pkt);
 	drop_eligible = odp_packet_drop_eligible(pkt);
@@ -2101,6 +2112,26 @@ static void tm_egress_marking(tm_system_t *tm_system, odp_packet_t odp_pkt)
 	}
 }
 
+static void tm_egress_flush(tm_system_t *tm_system)
+{
+	uint32_t num;
+	int      sent;
+
+	num = tm_system->num_egress_pkts;
+	if (num == 0)
+		return;
+
+	sent = odp_pktout_send(tm_system->pktout, tm_system->egress_pkts, num);
+	if (sent < 0)
+		sent = 0;
+
+	if ((uint32_t)sent < num)
+		odp_packet_free_multi(&tm_system->egress_pkts[sent],
+				      num - sent);
+
+	tm_system->num_egress_pkts = 0;
+}
+
 static void tm_send_pkt(tm_system_t *tm_system, uint32_t max_sends)
 {
 	tm_queue_obj_t *tm_queue_obj;
@@ -2124,12 +2155,18 @@ static void tm_send_pkt(tm_system_t *tm_system, uint32_t max_sends)
 			tm_egress_marking(tm_system, odp_pkt);
 
 		tm_system->egress_pkt_desc = EMPTY_PKT_DESC;
-		if (tm_system->egress.egress_kind == ODP_TM_EGRESS_PKT_IO)
-			odp_pktout_send(tm_system->pktout, &odp_pkt, 1);
-		else if (tm_system->egress.egress_kind == ODP_TM_EGRESS_FN)
+		if (tm_system->egress.egress_kind == ODP_TM_EGRESS_PKT_IO) {
+			/* Pkts are sent to the pktio in bursts, see
+			 * tm_egress_flush(). */
+			tm_system->egress_pkts[tm_system->num_egress_pkts++] =
+				odp_pkt;
+			if (tm_system->num_egress_pkts == tm_system->burst)
+				tm_egress_flush(tm_system);
+		} else if (tm_system->egress.egress_kind == ODP_TM_EGRESS_FN) {
 			tm_system->egress.egress_fcn(odp_pkt);
-		else
+		} else {
 			return;
+		}
 
 		tm_queue_obj->sent_pkt = tm_queue_obj->pkt;
 		tm_queue_obj->sent_pkt_desc = tm_queue_obj->in_pkt_desc;
@@ -2147,28 +2184,28 @@ static int tm_process_input_work_queue(tm_system_t *tm_system,
 				       input_work_queue_t *input_work_queue,
 				       uint32_t pkts_to_process)
 {
-	input_work_item_t work_item;
+	input_work_item_t work_items[TM_MAX_BURST];
 	tm_queue_obj_t *tm_queue_obj;
 	tm_shaper_obj_t *shaper_obj;
 	odp_packet_t pkt;
 	pkt_desc_t *pkt_desc;
-	uint32_t cnt;
+	uint32_t num, idx;
 	int rc;
 
-	for (cnt = 1; cnt <= pkts_to_process; cnt++) {
-		rc = input_work_queue_remove(input_work_queue, &work_item);
-		if (rc < 0) {
-			ODP_DBG("%s input_work_queue_remove() failed\n",
-				__func__);
-			return rc;
-		}
+	num = input_work_queue_remove(input_work_queue, work_items,
+				      MIN(pkts_to_process, TM_MAX_BURST));
+	if (num == 0) {
+		ODP_DBG("%s input_work_queue_remove() failed\n", __func__);
+		return -1;
+	}
 
+	for (idx = 0; idx < num; idx++) {
 		tm_queue_obj =
-			tm_system->queue_num_tbl[work_item.queue_num - 1];
-		pkt = work_item.pkt;
+			tm_system->queue_num_tbl[work_items[idx].queue_num - 1];
+		pkt = work_items[idx].pkt;
 		if (!tm_queue_obj) {
 			odp_packet_free(pkt);
-			return 0;
+			continue;
 		}
 
 		tm_queue_obj->pkts_rcvd_cnt++;
@@ -2191,17 +2228,17 @@ static int tm_process_input_work_queue(tm_system_t *tm_system,
 			rc = tm_propagate_pkt_desc(tm_system, shaper_obj,
 						   pkt_desc,
 						   tm_queue_obj->priority);
-			if (0 < rc)
-				return 1;  /* Send through spigot */
+			if (0 < rc)  /* Send through spigot */
+				tm_send_pkt(tm_system, tm_system->burst);
 		}
 	}
 
-	return 0;
+	return num;
 }
 
 static int tm_process_expired_timers(tm_system_t *tm_system,
 				     _odp_timer_wheel_t _odp_int_timer_wheel,
-				     uint64_t current_time ODP_UNUSED)
+				     uint32_t max_timers)
 {
 	tm_shaper_obj_t *shaper_obj;
 	tm_queue_obj_t *tm_queue_obj;
@@ -2211,7 +2248,7 @@ static int tm_process_expired_timers(tm_system_t *tm_system,
 	uint8_t priority;
 
 	work_done = 0;
-	for (cnt = 1; cnt <= 2; cnt++) {
+	for (cnt = 1; cnt <= max_timers; cnt++) {
 		timer_context =
 			_odp_timer_wheel_next_expired(_odp_int_timer_wheel);
 		if (!timer_context)
@@ -2244,7 +2281,7 @@ static int tm_process_expired_timers(tm_system_t *tm_system,
 				      pkt_desc, priority);
 		work_done++;
 		if (tm_system->egress_pkt_desc.queue_num != 0)
-			tm_send_pkt(tm_system, 2);
+			tm_send_pkt(tm_system, tm_system->burst);
 	}
 
 	return work_done;
@@ -2253,9 +2290,7 @@ static int tm_process_expired_timers(tm_system_t *tm_system,
 static volatile uint64_t busy_wait_counter;
 
 static odp_bool_t       main_loop_running;
-static odp_atomic_u64_t atomic_request_cnt;
-static odp_atomic_u64_t currently_serving_cnt;
-static odp_atomic_u64_t atomic_done_cnt;
+static odp_ticketlock_t tm_request_lock;
 
 static void busy_wait(uint32_t iterations)
 {
@@ -2265,43 +2300,87 @@ static void busy_wait(uint32_t iterations)
 		busy_wait_counter++;
 }
 
-static void signal_request(void)
+static void tm_group_request(tm_system_group_t *tm_group)
 {
 	uint64_t my_request_num, serving_cnt;
 
-	my_request_num = odp_atomic_fetch_inc_u64(&atomic_request_cnt) + 1;
+	my_request_num = odp_atomic_fetch_inc_u64(&tm_group->request_cnt) + 1;
 
-	serving_cnt = odp_atomic_load_u64(&currently_serving_cnt);
+	serving_cnt = odp_atomic_load_u64(&tm_group->serving_cnt);
 	while (serving_cnt != my_request_num) {
 		busy_wait(100);
-		serving_cnt = odp_atomic_load_u64(&currently_serving_cnt);
+		serving_cnt = odp_atomic_load_u64(&tm_group->serving_cnt);
 	}
 }
 
-static void check_for_request(void)
+static void tm_group_request_done(tm_system_group_t *tm_group)
+{
+	odp_atomic_inc_u64(&tm_group->done_cnt);
+}
+
+static odp_bool_t check_for_request(tm_system_group_t *tm_group)
 {
 	uint64_t request_num, serving_cnt, done_cnt;
 
-	request_num = odp_atomic_load_u64(&atomic_request_cnt);
-	serving_cnt = odp_atomic_load_u64(&currently_serving_cnt);
+	request_num = odp_atomic_load_u64(&tm_group->request_cnt);
+	serving_cnt = odp_atomic_load_u64(&tm_group->serving_cnt);
 	if (serving_cnt == request_num)
-		return;
+		return false;
 
 	/* Signal the other requesting thread to proceed and then
 	 * wait for their done indication */
-	odp_atomic_inc_u64(&currently_serving_cnt);
+	odp_atomic_inc_u64(&tm_group->serving_cnt);
 	busy_wait(100);
 
-	done_cnt = odp_atomic_load_u64(&atomic_done_cnt);
-	while (done_cnt != request_num) {
+	done_cnt = odp_atomic_load_u64(&tm_group->done_cnt);
+	while (done_cnt != serving_cnt + 1) {
 		busy_wait(100);
-		done_cnt = odp_atomic_load_u64(&atomic_done_cnt);
+		done_cnt = odp_atomic_load_u64(&tm_group->done_cnt);
 	}
+
+	return true;
+}
+
+/* Profiles can be shared by tm_systems of different tm_groups, so profile
+ * changes park the service threads of all tm_groups that have seen their
+ * first enqueue (i.e. whose service thread is running).  Requests are
+ * serialized by tm_request_lock, so that two requesting threads never wait
+ * for each other while each holding some of the tm_groups. */
+static void signal_request(void)
+{
+	tm_system_group_t *tm_group;
+
+	odp_ticketlock_lock(&tm_request_lock);
+	tm_group = tm_group_list;
+	if (tm_group == NULL)
+		return;
+
+	do {
+		tm_group->requested =
+			odp_atomic_load_u32(&tm_group->first_enq) != 0;
+		if (tm_group->requested)
+			tm_group_request(tm_group);
+
+		tm_group = tm_group->next;
+	} while (tm_group != tm_group_list);
 }
 
 static void signal_request_done(void)
 {
-	odp_atomic_inc_u64(&atomic_done_cnt);
+	tm_system_group_t *tm_group;
+
+	tm_group = tm_group_list;
+	if (tm_group != NULL) {
+		do {
+			if (tm_group->requested)
+				tm_group_request_done(tm_group);
+
+			tm_group->requested = false;
+			tm_group = tm_group->next;
+		} while (tm_group != tm_group_list);
+	}
+
+	odp_ticketlock_unlock(&tm_request_lock);
 }
 
 static int thread_affinity_get(odp_cpumask_t *odp_cpu_mask)
@@ -2333,7 +2412,7 @@ static void *tm_system_thread(void *arg)
 	tm_system_group_t  *tm_group;
 	tm_system_t *tm_system;
 	uint64_t current_ns;
-	uint32_t destroying, work_queue_cnt, timer_cnt;
+	uint32_t work_queue_cnt, timer_cnt;
 	int rc;
 
 	rc = odp_init_local((odp_instance_t)odp_global_data.main_pid,
@@ -2341,23 +2420,32 @@ static void *tm_system_thread(void *arg)
 	ODP_ASSERT(rc == 0);
 	tm_group = arg;
 
-	tm_system = tm_group->first_tm_system;
-	_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
-	input_work_queue = tm_system->input_work_queue;
-
 	/* Wait here until we have seen the first enqueue operation. */
 	odp_barrier_wait(&tm_group->tm_group_barrier);
 	main_loop_running = true;
 
-	destroying = odp_atomic_load_u64(&tm_system->destroying);
-
 	current_ns = odp_time_to_ns(odp_time_local());
-	_odp_timer_wheel_start(_odp_int_timer_wheel, current_ns);
+	tm_system = tm_group->first_tm_system;
+	do {
+		_odp_timer_wheel_start(tm_system->_odp_int_timer_wheel,
+				       current_ns);
+		tm_system = tm_system->next;
+	} while (tm_system != tm_group->first_tm_system);
 
-	while (destroying == 0) {
+	while (1) {
 		/* See if another thread wants to make a configuration
-		 * change. */
-		check_for_request();
+		 * change.  Since that may have been the addition or removal
+		 * of a tm_system, restart from the first tm_system after. */
+		if (check_for_request(tm_group))
+			tm_system = tm_group->first_tm_system;
+
+		/* Set when the last tm_system of the tm_group is destroyed.
+		 * Others are removed while this thread is parked above. */
+		if (odp_unlikely(odp_atomic_load_u32(&tm_group->thread_exit)))
+			break;
+
+		_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
+		input_work_queue = tm_system->input_work_queue;
 
 		current_ns = odp_time_to_ns(odp_time_local());
 		tm_system->current_time = current_ns;
@@ -2369,7 +2457,7 @@ static void *tm_system_thread(void *arg)
 			timer_cnt = 1;
 			(void)tm_process_expired_timers(tm_system,
 							_odp_int_timer_wheel,
-							current_ns);
+							tm_system->burst);
 		} else {
 			timer_cnt =
 				_odp_timer_wheel_count(_odp_int_timer_wheel);
@@ -2382,25 +2470,24 @@ static void *tm_system_thread(void *arg)
 
 		if (work_queue_cnt != 0) {
 			tm_process_input_work_queue(tm_system,
-						    input_work_queue, 1);
+						    input_work_queue,
+						    tm_system->burst);
 		}
 
 		if (tm_system->egress_pkt_desc.queue_num != 0)
-			tm_send_pkt(tm_system, 1);
+			tm_send_pkt(tm_system, tm_system->burst);
+
+		tm_egress_flush(tm_system);
 
 		current_ns = odp_time_to_ns(odp_time_local());
 		tm_system->current_time = current_ns;
 		tm_system->is_idle = (timer_cnt == 0) &&
 			(work_queue_cnt == 0);
-		destroying = odp_atomic_load_u64(&tm_system->destroying);
 
 		/* Advance to the next tm_system in the tm_system_group. */
 		tm_system = tm_system->next;
-		_odp_int_timer_wheel = tm_system->_odp_int_timer_wheel;
-		input_work_queue = tm_system->input_work_queue;
 	}
 
-	odp_barrier_wait(&tm_system->tm_system_destroy_barrier);
 	odp_term_local();
 	return NULL;
 }
@@ -2452,6 +2539,7 @@ int odp_tm_capabilities(odp_tm_capabilities_t capabilities[] ODP_UNUSED,
 
 	cap_ptr->max_tm_queues                 = ODP_TM_MAX_TM_QUEUES;
 	cap_ptr->max_levels                    = ODP_TM_MAX_LEVELS;
+	cap_ptr->max_burst                     = TM_MAX_BURST;
 	cap_ptr->tm_queue_shaper_supported     = true;
 	cap_ptr->egress_fcn_supported          = true;
 	cap_ptr->tm_queue_wred_supported       = true;
@@ -2491,10 +2579,12 @@ static void tm_system_capabilities_set(odp_tm_capabilities_t *cap_ptr,
 	odp_bool_t                   shaper_supported, wred_supported;
 	odp_bool_t                   dual_slope;
 	uint32_t                     num_levels, level_idx, max_nodes;
-	uint32_t                     max_queues, max_fanin;
+	uint32_t                     max_queues, max_fanin, max_burst;
 	uint8_t                      max_priority, min_weight, max_weight;
 
 	num_levels = MAX(MIN(req_ptr->num_levels, ODP_TM_MAX_LEVELS), 1);
+	max_burst  = req_ptr->max_burst ?
+		MIN(req_ptr->max_burst, TM_MAX_BURST) : TM_DEFAULT_BURST;
 	memset(cap_ptr, 0, sizeof(odp_tm_capabilities_t));
 
 	max_queues       = MIN(req_ptr->max_tm_queues,
@@ -2505,6 +2595,7 @@ static void tm_system_capabilities_set(odp_tm_capabilities_t *cap_ptr,
 
 	cap_ptr->max_tm_queues                 = max_queues;
 	cap_ptr->max_levels                    = num_levels;
+	cap_ptr->max_burst                     = max_burst;
 	cap_ptr->tm_queue_shaper_supported     = shaper_supported;
 	cap_ptr->tm_queue_wred_supported       = wred_supported;
 	cap_ptr->tm_queue_dual_slope_supported = dual_slope;
@@ -2582,39 +2673,45 @@ static int affinitize_main_thread(void)
 	return rc;
 }
 
-static uint32_t tm_thread_cpu_select(void)
+static void tm_thread_cpus_get(odp_cpumask_t *odp_cpu_mask)
 {
-	odp_cpumask_t odp_cpu_mask;
-	int           cpu_count, cpu;
+	int cpu_count;
 
-	odp_cpumask_default_worker(&odp_cpu_mask, 0);
+	odp_cpumask_default_worker(odp_cpu_mask, 0);
 	if ((g_main_thread_cpu != -1) &&
-	    odp_cpumask_isset(&odp_cpu_mask, g_main_thread_cpu))
-		odp_cpumask_clr(&odp_cpu_mask, g_main_thread_cpu);
+	    odp_cpumask_isset(odp_cpu_mask, g_main_thread_cpu))
+		odp_cpumask_clr(odp_cpu_mask, g_main_thread_cpu);
 
-	cpu_count = odp_cpumask_count(&odp_cpu_mask);
+	cpu_count = odp_cpumask_count(odp_cpu_mask);
 	if (cpu_count < 1) {
-		odp_cpumask_all_available(&odp_cpu_mask);
+		odp_cpumask_all_available(odp_cpu_mask);
 		if ((g_main_thread_cpu != -1) &&
-		    odp_cpumask_isset(&odp_cpu_mask, g_main_thread_cpu))
-			cpu_count = odp_cpumask_count(&odp_cpu_mask);
+		    odp_cpumask_isset(odp_cpu_mask, g_main_thread_cpu))
+			cpu_count = odp_cpumask_count(odp_cpu_mask);
 
 		if (cpu_count < 1)
-			odp_cpumask_all_available(&odp_cpu_mask);
+			odp_cpumask_all_available(odp_cpu_mask);
 	}
+}
 
-	if (g_tm_cpu_num == 0) {
-		cpu = odp_cpumask_first(&odp_cpu_mask);
-	} else {
-		cpu = odp_cpumask_next(&odp_cpu_mask, g_tm_cpu_num);
-		if (cpu == -1) {
-			g_tm_cpu_num = 0;
-			cpu = odp_cpumask_first(&odp_cpu_mask);
-		}
+static uint32_t tm_thread_cpu_select(void)
+{
+	odp_cpumask_t odp_cpu_mask;
+	int           cpu, min_cpu;
+
+	/* Pick the cpu used by the fewest tm_group threads, so that each
+	 * thread gets a cpu of its own as long as there are enough cpus. */
+	tm_thread_cpus_get(&odp_cpu_mask);
+	min_cpu = odp_cpumask_first(&odp_cpu_mask);
+	cpu     = min_cpu;
+	while (cpu >= 0) {
+		if (g_tm_cpu_threads[cpu] < g_tm_cpu_threads[min_cpu])
+			min_cpu = cpu;
+
+		cpu = odp_cpumask_next(&odp_cpu_mask, cpu);
 	}
 
-	g_tm_cpu_num++;
-	return cpu;
+	return min_cpu;
 }
 
 static int tm_thread_create(tm_system_group_t *tm_group)
@@ -2632,10 +2729,14 @@ static int tm_thread_create(tm_system_group_t *tm_group)
 
 	rc = pthread_create(&tm_group->thread, &tm_group->attr,
 			    tm_system_thread, tm_group);
-	if (rc != 0)
+	if (rc != 0) {
 		ODP_DBG("Failed to start thread on cpu num=%u\n", cpu_num);
+		return rc;
+	}
 
-	return rc;
+	tm_group->cpu = cpu_num;
+	g_tm_cpu_threads[cpu_num]++;
+	return 0;
 }
 
 static _odp_tm_group_t _odp_tm_group_create(const char *name ODP_UNUSED)
@@ -2645,8 +2746,15 @@ static _odp_tm_group_t _odp_tm_group_create(const char *name ODP_UNUSED)
 	tm_group = malloc(sizeof(tm_system_group_t));
 	memset(tm_group, 0, sizeof(tm_system_group_t));
 	odp_barrier_init(&tm_group->tm_group_barrier, 2);
-
-	/* Add this group to the tm_group_list linked list. */
+	odp_atomic_init_u64(&tm_group->request_cnt, 0);
+	odp_atomic_init_u64(&tm_group->serving_cnt, 0);
+	odp_atomic_init_u64(&tm_group->done_cnt, 0);
+	odp_atomic_init_u32(&tm_group->thread_exit, 0);
+	odp_atomic_init_u32(&tm_group->first_enq, 0);
+
+	/* Add this group to the tm_group_list linked list. signal_request()
+	 * walks the list while holding tm_request_lock. */
+	odp_ticketlock_lock(&tm_request_lock);
 	if (tm_group_list == NULL) {
 		tm_group_list  = tm_group;
 		tm_group->next = tm_group;
@@ -2660,6 +2768,7 @@ static _odp_tm_group_t _odp_tm_group_create(const char *name ODP_UNUSED)
 		tm_group->prev        = first_tm_group;
 	}
 
+	odp_ticketlock_unlock(&tm_request_lock);
 	return MAKE_ODP_TM_SYSTEM_GROUP(tm_group);
 }
 
@@ -2669,20 +2778,16 @@ static void _odp_tm_group_destroy(_odp_tm_group_t odp_tm_group)
 	int                rc;
 
 	tm_group = GET_TM_GROUP(odp_tm_group);
-
-	/* Wait for the thread to exit. */
 	ODP_ASSERT(tm_group->num_tm_systems <= 1);
-	rc = pthread_join(tm_group->thread, NULL);
-	ODP_ASSERT(rc == 0);
-	pthread_attr_destroy(&tm_group->attr);
-	if (g_tm_cpu_num > 0)
-		g_tm_cpu_num--;
 
-	/* Remove this group from the tm_group_list linked list. Special case
-	 * when this is the last tm_group in the linked list. */
+	/* Remove this group from the tm_group_list linked list before the
+	 * thread exits, so that signal_request() never waits for a thread
+	 * which is gone.  Special case when this is the last tm_group in the
+	 * linked list. */
+	odp_ticketlock_lock(&tm_request_lock);
 	prev_tm_group = tm_group->prev;
 	next_tm_group = tm_group->next;
-	if (prev_tm_group == next_tm_group) {
+	if (prev_tm_group == tm_group) {
 		ODP_ASSERT(tm_group_list == tm_group);
 		tm_group_list = NULL;
 	} else {
@@ -2694,6 +2799,19 @@ static void _odp_tm_group_destroy(_odp_tm_group_t odp_tm_group)
 
 	tm_group->prev = NULL;
 	tm_group->next = NULL;
+	odp_ticketlock_unlock(&tm_request_lock);
+
+	/* Tell the thread to exit. If no pkt was ever enqueued, the thread is
+	 * still waiting for the first enqueue operation, so claim it and
+	 * release the thread. Otherwise the enqueuing thread releases it. */
+	odp_atomic_store_u32(&tm_group->thread_exit, 1);
+	if (tm_first_enq_claim(tm_group))
+		odp_barrier_wait(&tm_group->tm_group_barrier);
+
+	rc = pthread_join(tm_group->thread, NULL);
+	ODP_ASSERT(rc == 0);
+	pthread_attr_destroy(&tm_group->attr);
+	g_tm_cpu_threads[tm_group->cpu]--;
 	free(tm_group);
 }
 
@@ -2701,12 +2819,25 @@ static int _odp_tm_group_add(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 {
 	tm_system_group_t *tm_group;
 	tm_system_t       *tm_system, *first_tm_system, *second_tm_system;
+	odp_bool_t         parked;
 
 	tm_group  = GET_TM_GROUP(odp_tm_group);
 	tm_system = GET_TM_SYSTEM(odp_tm);
-	tm_group->num_tm_systems++;
 	tm_system->odp_tm_group = odp_tm_group;
 
+	/* If the service thread of this group is already running, park it
+	 * while this tm_system is linked in. */
+	odp_ticketlock_lock(&tm_request_lock);
+	parked = tm_group->num_tm_systems != 0 &&
+		 odp_atomic_load_u32(&tm_group->first_enq) != 0;
+	if (parked) {
+		tm_group_request(tm_group);
+		_odp_timer_wheel_start(tm_system->_odp_int_timer_wheel,
+				       odp_time_to_ns(odp_time_local()));
+	}
+
+	tm_group->num_tm_systems++;
+
 	/* Link this tm_system into the circular linked list of all tm_systems
 	 * belonging to the same tm_group. */
 	if (tm_group->num_tm_systems == 1) {
@@ -2723,6 +2854,11 @@ static int _odp_tm_group_add(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 		tm_group->first_tm_system = tm_system;
 	}
 
+	if (parked)
+		tm_group_request_done(tm_group);
+
+	odp_ticketlock_unlock(&tm_request_lock);
+
 	/* If this is the first tm_system associated with this group, then
 	 * create the service thread and the input work queue. */
 	if (tm_group->num_tm_systems >= 2)
@@ -2736,6 +2872,7 @@ static int _odp_tm_group_remove(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 {
 	tm_system_group_t *tm_group;
 	tm_system_t       *tm_system, *prev_tm_system, *next_tm_system;
+	odp_bool_t         parked;
 
 	tm_group  = GET_TM_GROUP(odp_tm_group);
 	tm_system = GET_TM_SYSTEM(odp_tm);
@@ -2746,7 +2883,22 @@ static int _odp_tm_group_remove(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 	    (tm_group->first_tm_system == NULL))
 		return -1;
 
-	/* Remove this tm_system from the tm_group linked list. */
+	/* If this is the last tm_system associated with this group then
+	 * destroy the group (and thread etc). */
+	if (tm_group->num_tm_systems == 1) {
+		_odp_tm_group_destroy(odp_tm_group);
+		tm_system->next = NULL;
+		tm_system->prev = NULL;
+		return 0;
+	}
+
+	/* Otherwise park the service thread while this tm_system is removed
+	 * from the tm_group linked list. */
+	odp_ticketlock_lock(&tm_request_lock);
+	parked = odp_atomic_load_u32(&tm_group->first_enq) != 0;
+	if (parked)
+		tm_group_request(tm_group);
+
 	if (tm_group->first_tm_system == tm_system)
 		tm_group->first_tm_system = tm_system->next;
 
@@ -2758,11 +2910,10 @@ static int _odp_tm_group_remove(_odp_tm_group_t odp_tm_group, odp_tm_t odp_tm)
 	tm_system->prev      = NULL;
 	tm_group->num_tm_systems--;
 
-	/* If this is the last tm_system associated with this group then
-	 * destroy the group (and thread etc). */
-	if (tm_group->num_tm_systems == 0)
-		_odp_tm_group_destroy(odp_tm_group);
+	if (parked)
+		tm_group_request_done(tm_group);
 
+	odp_ticketlock_unlock(&tm_request_lock);
 	return 0;
 }
 
@@ -2770,56 +2921,36 @@ static int tm_group_attach(odp_tm_t odp_tm)
 {
 	tm_system_group_t *tm_group, *min_tm_group;
 	_odp_tm_group_t    odp_tm_group;
-	odp_cpumask_t      all_cpus, worker_cpus;
-	uint32_t           total_cpus, avail_cpus;
-
-	/* If this platform has a small number of cpu's then allocate one
-	 * tm_group and assign all tm_system's to this tm_group.  Otherwise in
-	 * the case of a manycore platform try to allocate one tm_group per
-	 * tm_system, as long as there are still extra cpu's left.  If not
-	 * enough cpu's left than allocate this tm_system to the next tm_group
-	 * in a round robin fashion. */
-	odp_cpumask_all_available(&all_cpus);
-	odp_cpumask_default_worker(&worker_cpus, 0);
-	total_cpus = odp_cpumask_count(&all_cpus);
-	avail_cpus = odp_cpumask_count(&worker_cpus);
-
-	if (total_cpus < 24) {
-		tm_group     = tm_group_list;
-		odp_tm_group = MAKE_ODP_TM_SYSTEM_GROUP(tm_group);
-		if (tm_group == NULL)
-			odp_tm_group = _odp_tm_group_create("");
-
-		_odp_tm_group_add(odp_tm_group, odp_tm);
-		return 0;
-	}
-
-	/* Manycore case. */
-	if ((tm_group_list == NULL) || (avail_cpus > 1)) {
-		odp_tm_group = _odp_tm_group_create("");
-		_odp_tm_group_add(odp_tm_group, odp_tm);
-		return 0;
-	}
-
-	/* Pick a tm_group according to the smallest number of tm_systems. */
-	tm_group     = tm_group_list;
-	min_tm_group = NULL;
+	odp_cpumask_t      tm_cpus;
+	uint32_t           num_tm_groups, avail_cpus;
+
+	/* Give each tm_system a tm_group of its own - and so a service thread
+	 * pinned to a cpu of its own - as long as there are more cpu's
+	 * available for service threads than there are tm_groups.  Otherwise
+	 * add this tm_system to the tm_group serving the fewest tm_systems. */
+	tm_thread_cpus_get(&tm_cpus);
+	avail_cpus = odp_cpumask_count(&tm_cpus);
+
+	num_tm_groups = 0;
+	min_tm_group  = NULL;
+	tm_group      = tm_group_list;
 	while (tm_group != NULL) {
-		if (min_tm_group == NULL)
-			min_tm_group = tm_group;
-		else if (tm_group->num_tm_systems <
-			 min_tm_group->num_tm_systems)
+		if ((min_tm_group == NULL) ||
+		    (tm_group->num_tm_systems < min_tm_group->num_tm_systems))
 			min_tm_group = tm_group;
 
+		num_tm_groups++;
 		tm_group = tm_group->next;
+		if (tm_group == tm_group_list)
+			break;
 	}
 
-	if (min_tm_group == NULL)
-		return -1;
+	if ((min_tm_group == NULL) || (num_tm_groups < avail_cpus))
+		odp_tm_group = _odp_tm_group_create("");
+	else
+		odp_tm_group = MAKE_ODP_TM_SYSTEM_GROUP(min_tm_group);
 
-	odp_tm_group = MAKE_ODP_TM_SYSTEM_GROUP(tm_group);
-	_odp_tm_group_add(odp_tm_group, odp_tm);
-	return 0;
+	return _odp_tm_group_add(odp_tm_group, odp_tm);
 }
 
 odp_tm_t odp_tm_create(const char            *name,
@@ -2869,6 +3000,7 @@ odp_tm_t odp_tm_create(const char            *name,
 
 	tm_system_capabilities_set(&tm_system->capabilities,
 				   &tm_system->requirements);
+	tm_system->burst = tm_system->capabilities.max_burst;
 
 	malloc_len = max_tm_queues * sizeof(tm_queue_obj_t *);
 	tm_system->queue_num_tbl = malloc(malloc_len);
@@ -2988,20 +3120,23 @@ int odp_tm_destroy(odp_tm_t odp_tm)
 	/* First mark the tm_system as being in the destroying state so that
 	 * all new pkts are prevented from coming in.
 	 */
-	odp_barrier_init(&tm_system->tm_system_destroy_barrier, 2);
 	odp_atomic_inc_u64(&tm_system->destroying);
-	odp_barrier_wait(&tm_system->tm_system_destroy_barrier);
 
 	/* Remove ourselves from the group.  If we are the last tm_system in
 	 * this group, odp_tm_group_remove will destroy any service threads
-	 * allocated by this group. */
+	 * allocated by this group.  Otherwise the service thread is parked
+	 * while we are removed from the group.  tm_create_lock keeps
+	 * tm_group_attach() from picking a group being destroyed. */
+	odp_ticketlock_lock(&tm_create_lock);
 	_odp_tm_group_remove(tm_system->odp_tm_group, odp_tm);
+	odp_ticketlock_unlock(&tm_create_lock);
 
 	input_work_queue_destroy(tm_system->input_work_queue);
 	_odp_sorted_pool_destroy(tm_system->_odp_int_sorted_pool);
 	_odp_queue_pool_destroy(tm_system->_odp_int_queue_pool);
 	_odp_timer_wheel_destroy(tm_system->_odp_int_timer_wheel);
 
+	_odp_int_name_tbl_delete(tm_system->name_tbl_id);
 	tm_system_free(tm_system);
 	return 0;
 }
@@ -4669,11 +4804,8 @@ int odp_tm_init_global(void)
 {
 	odp_ticketlock_init(&tm_create_lock);
 	odp_ticketlock_init(&tm_profile_lock);
+	odp_ticketlock_init(&tm_request_lock);
 	odp_barrier_init(&tm_first_enq, 2);
-
-	odp_atomic_init_u64(&atomic_request_cnt, 0);
-	odp_atomic_init_u64(&currently_serving_cnt, 0);
-	odp_atomic_init_u64(&atomic_done_cnt, 0);
 	return 0;
 }
 
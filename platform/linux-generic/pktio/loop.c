@@ -129,10 +129,13 @@ static int loopback_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 
 		pkt_hdr->input = pktio_entry->s.handle;
 
-		if (pktio_cls_enabled(pktio_entry))
+		if (pktio_cls_enabled(pktio_entry)) {
 			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
-		else
+		} else {
+			/* Parser metadata is left over from the sender */
+			packet_parser_reset(&pkt_hdr->p);
 			packet_parse_l2(&pkt_hdr->p, pkt_len);
+		}
 
 		packet_set_ts(pkt_hdr, ts);
 
@@ -641,6 +641,12 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 
 	if (pktio_cls_enabled(pktio_entry)) {
 		struct iovec iovecs[ODP_PACKET_SOCKET_MAX_BURST_RX];
+		uint8_t *base[ODP_PACKET_SOCKET_MAX_BURST_RX];
+		uint16_t pkt_len[ODP_PACKET_SOCKET_MAX_BURST_RX];
+		uint32_t seg_len[ODP_PACKET_SOCKET_MAX_BURST_RX];
+		odp_pool_t pool[ODP_PACKET_SOCKET_MAX_BURST_RX];
+		odp_packet_hdr_t parsed_hdr[ODP_PACKET_SOCKET_MAX_BURST_RX];
+		int num_pkt = 0;
 
 		for (i = 0; i < (int)len; i++) {
 			msgvec[i].msg_hdr.msg_iovlen = 1;
@@ -657,37 +663,46 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 			ts_val = odp_time_global();
 
 		for (i = 0; i < recv_msgs; i++) {
-			odp_packet_hdr_t *pkt_hdr;
-			odp_packet_t pkt;
-			odp_pool_t pool = pkt_sock->pool;
-			odp_packet_hdr_t parsed_hdr;
-			void *base = msgvec[i].msg_hdr.msg_iov->iov_base;
-			struct ethhdr *eth_hdr = base;
-			uint16_t pkt_len = msgvec[i].msg_len;
-			int num;
+			void *pkt_base = msgvec[i].msg_hdr.msg_iov->iov_base;
+			struct ethhdr *eth_hdr = pkt_base;
 
 			/* Don't receive packets sent by ourselves */
 			if (odp_unlikely(ethaddrs_equal(pkt_sock->if_mac,
 							eth_hdr->h_source)))
 				continue;
 
-			if (cls_classify_packet(pktio_entry, base, pkt_len,
-						pkt_len, &pool, &parsed_hdr))
+			base[num_pkt] = pkt_base;
+			pkt_len[num_pkt] = msgvec[i].msg_len;
+			seg_len[num_pkt] = msgvec[i].msg_len;
+			num_pkt++;
+		}
+
+		if (num_pkt)
+			cls_classify_packet_multi(pktio_entry, base, pkt_len,
+						  seg_len, num_pkt, pool,
+						  parsed_hdr);
+
+		for (i = 0; i < num_pkt; i++) {
+			odp_packet_hdr_t *pkt_hdr;
+			odp_packet_t pkt;
+			int num;
+
+			if (pool[i] == ODP_POOL_INVALID)
 				continue;
 
-			num = packet_alloc_multi(pool, pkt_len, &pkt, 1);
+			num = packet_alloc_multi(pool[i], pkt_len[i], &pkt, 1);
 			if (num != 1)
 				continue;
 
 			pkt_hdr = odp_packet_hdr(pkt);
 
-			if (odp_packet_copy_from_mem(pkt, 0, pkt_len,
-						     base) != 0) {
+			if (odp_packet_copy_from_mem(pkt, 0, pkt_len[i],
+						     base[i]) != 0) {
 				odp_packet_free(pkt);
 				continue;
 			}
 			pkt_hdr->input = pktio_entry->s.handle;
-			copy_packet_cls_metadata(&parsed_hdr, pkt_hdr);
+			copy_packet_cls_metadata(&parsed_hdr[i], pkt_hdr);
 			packet_set_ts(pkt_hdr, ts);
 
 			pkt_table[nb_rx++] = pkt;
@@ -695,11 +710,17 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 	} else {
 		struct iovec iovecs[ODP_PACKET_SOCKET_MAX_BURST_RX]
 				   [MAX_SEGS];
+		pool_t *pool = pool_entry_from_hdl(pkt_sock->pool);
+		uint32_t alloc_len = pkt_sock->mtu;
+
+		/* Frames longer than the pool maximum are dropped */
+		if (alloc_len > pool->max_len)
+			alloc_len = pool->max_len;
 
 		for (i = 0; i < (int)len; i++) {
 			int num;
 
-			num = packet_alloc_multi(pkt_sock->pool, pkt_sock->mtu,
+			num = packet_alloc_multi(pkt_sock->pool, alloc_len,
 						 &pkt_table[i], 1);
 
 			if (odp_unlikely(num != 1)) {
@@ -738,6 +759,13 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 				continue;
 			}
 
+			if (odp_unlikely(msgvec[i].msg_hdr.msg_flags &
+					 MSG_TRUNC)) {
+				pkt_sock->in_errors++;
+				odp_packet_free(pkt);
+				continue;
+			}
+
 			/* Parse and set packet header data */
 			ret = odp_packet_trunc_tail(&pkt, odp_packet_len(pkt) -
 						    msgvec[i].msg_len,
@@ -799,8 +827,9 @@ static int sock_mmsg_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
 	int sockfd;
 	int n, i;
 
+	/* Send at most one burst, the rest is left to the caller */
 	if (odp_unlikely(len > ODP_PACKET_SOCKET_MAX_BURST_TX))
-		return -1;
+		len = ODP_PACKET_SOCKET_MAX_BURST_TX;
 
 	odp_ticketlock_lock(&pktio_entry->s.txl);
 
@@ -897,18 +926,24 @@ static int sock_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
 static int sock_stats(pktio_entry_t *pktio_entry,
 		      odp_pktio_stats_t *stats)
 {
-	if (pktio_entry->s.stats_type == STATS_UNSUPPORTED) {
+	pkt_sock_t *pkt_sock = &pktio_entry->s.pkt_sock;
+	int ret = 0;
+
+	if (pktio_entry->s.stats_type == STATS_UNSUPPORTED)
 		memset(stats, 0, sizeof(*stats));
-		return 0;
-	}
+	else
+		ret = sock_stats_fd(pktio_entry, stats, pkt_sock->sockfd);
+
+	/* Frames dropped by the driver are not seen by the kernel */
+	stats->in_errors += pkt_sock->in_errors;
 
-	return sock_stats_fd(pktio_entry,
-			     stats,
-			     pktio_entry->s.pkt_sock.sockfd);
+	return ret;
 }
 
 static int sock_stats_reset(pktio_entry_t *pktio_entry)
 {
+	pktio_entry->s.pkt_sock.in_errors = 0;
+
 	if (pktio_entry->s.stats_type == STATS_UNSUPPORTED) {
 		memset(&pktio_entry->s.stats, 0,
 		       sizeof(odp_pktio_stats_t));
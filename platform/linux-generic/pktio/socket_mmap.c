@@ -36,17 +36,53 @@
 #include <protocols/ip.h>
 
 static int disable_pktio; /** !0 this pktio disabled, 0 enabled */
-
-static int set_pkt_sock_fanout_mmap(pkt_sock_mmap_t *const pkt_sock,
-				    int sock_group_idx)
+/** Fanout mode of multi-queue sockets, when flow hashing is not requested */
+static int fanout_mode = PACKET_FANOUT_HASH;
+
+ODP_STATIC_ASSERT(ODP_PACKET_SOCKET_MMAP_MAX_QUEUES <= PKTIO_MAX_QUEUES,
+		  "ERR_MMAP_MAX_QUEUES");
+
+/* TPACKET_V3 Rx block size in bytes */
+#define MMAP_V3_BLOCK_SIZE (256 * 1024)
+
+/* TPACKET_V3 Rx block retire timeout in msec. Kernel hands a block over to
+ * user space when it is full, or when the timeout expires. Kernel timer runs
+ * in jiffies, a too short timeout may retire a block right after it was
+ * opened and split a burst of packets into two blocks. */
+#define MMAP_V3_BLOCK_TOV 10
+
+/* Rx ring block of a zero copy socket. Packets attached to block memory hold
+ * a reference to the block, the block is returned to the kernel when the
+ * last one has been freed. */
+typedef struct mmap_block_t {
+	packet_ext_t ext;
+	struct tpacket_block_desc *desc;
+	struct mmap_rx_mem_t *mem;
+} mmap_block_t;
+
+/* Ring memory mapping and Rx blocks of a TPACKET_V3 socket. The socket and
+ * each block held by zero copy packets own a reference. The memory is
+ * unmapped when the last reference is dropped, so packets may outlive the
+ * socket. */
+typedef struct mmap_rx_mem_t {
+	odp_atomic_u32_t ref_count;
+	/* Socket closed, blocks are not returned to the kernel anymore */
+	odp_atomic_u32_t closed;
+	uint8_t *base;
+	size_t len;
+	mmap_block_t block[];
+} mmap_rx_mem_t;
+
+static int set_pkt_sock_fanout_mmap(pkt_mmap_queue_t *const queue,
+				    int sock_group_idx, int mode)
 {
-	int sockfd = pkt_sock->sockfd;
+	int sockfd = queue->sockfd;
 	int val;
 	int err;
 	uint16_t fanout_group;
 
 	fanout_group = (uint16_t)(sock_group_idx & 0xffff);
-	val = (PACKET_FANOUT_HASH << 16) | fanout_group;
+	val = (mode << 16) | fanout_group;
 
 	err = setsockopt(sockfd, SOL_PACKET, PACKET_FANOUT, &val, sizeof(val));
 	if (err != 0) {
@@ -64,14 +100,14 @@ union frame_map {
 		ODP_ALIGNED(TPACKET_ALIGN(sizeof(struct tpacket2_hdr)));
 	} *v2;
 
+	struct tpacket3_hdr *v3;
+
 	void *raw;
 };
 
-static int mmap_pkt_socket(void)
+static int mmap_pkt_socket(int ver, uint16_t proto)
 {
-	int ver = TPACKET_V2;
-
-	int ret, sock = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	int ret, sock = socket(PF_PACKET, SOCK_RAW, proto);
 
 	if (sock == -1) {
 		__odp_errno = errno;
@@ -90,6 +126,22 @@ static int mmap_pkt_socket(void)
 	return sock;
 }
 
+/* Check if kernel supports TPACKET_V3 rings */
+static int mmap_v3_supported(void)
+{
+	int ver = TPACKET_V3;
+	int sock = socket(PF_PACKET, SOCK_RAW, 0);
+	int ret;
+
+	if (sock == -1)
+		return 0;
+
+	ret = setsockopt(sock, SOL_PACKET, PACKET_VERSION, &ver, sizeof(ver));
+	close(sock);
+
+	return ret == 0;
+}
+
 static inline int mmap_rx_kernel_ready(struct tpacket2_hdr *hdr)
 {
 	return ((hdr->tp_status & TP_STATUS_USER) == TP_STATUS_USER);
@@ -101,17 +153,59 @@ static inline void mmap_rx_user_ready(struct tpacket2_hdr *hdr)
 	__sync_synchronize();
 }
 
-static inline int mmap_tx_kernel_ready(struct tpacket2_hdr *hdr)
+/* Tx frame status word of the ring version in use */
+static inline uint32_t *mmap_tx_status(struct ring *ring, union frame_map ppd)
 {
-	return !(hdr->tp_status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING));
+	if (ring->version == TPACKET_V3)
+		return &ppd.v3->tp_status;
+
+	return &ppd.v2->tp_h.tp_status;
 }
 
-static inline void mmap_tx_user_ready(struct tpacket2_hdr *hdr)
+static inline int mmap_tx_kernel_ready(struct ring *ring, union frame_map ppd)
 {
-	hdr->tp_status = TP_STATUS_SEND_REQUEST;
+	return !(*mmap_tx_status(ring, ppd) &
+		 (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING));
+}
+
+static inline void mmap_tx_user_ready(struct ring *ring, union frame_map ppd)
+{
+	*mmap_tx_status(ring, ppd) = TP_STATUS_SEND_REQUEST;
 	__sync_synchronize();
 }
 
+static inline int mmap_block_kernel_ready(struct tpacket_block_desc *desc)
+{
+	return ((desc->hdr.bh1.block_status & TP_STATUS_USER) ==
+		TP_STATUS_USER);
+}
+
+static inline void mmap_block_user_ready(struct tpacket_block_desc *desc)
+{
+	odp_mb_release();
+	desc->hdr.bh1.block_status = TP_STATUS_KERNEL;
+}
+
+static void mmap_rx_mem_unref(mmap_rx_mem_t *mem)
+{
+	if (odp_atomic_fetch_dec_u32(&mem->ref_count) != 1)
+		return;
+
+	munmap(mem->base, mem->len);
+	free(mem);
+}
+
+static void mmap_block_release(packet_ext_t *ext)
+{
+	mmap_block_t *block = (mmap_block_t *)ext;
+	mmap_rx_mem_t *mem = block->mem;
+
+	if (!odp_atomic_load_u32(&mem->closed))
+		mmap_block_user_ready(block->desc);
+
+	mmap_rx_mem_unref(mem);
+}
+
 static uint8_t *pkt_mmap_vlan_insert(uint8_t *l2_hdr_ptr,
 				     uint16_t  mac_offset,
 				     uint16_t  vlan_tci,
@@ -143,111 +237,308 @@ static uint8_t *pkt_mmap_vlan_insert(uint8_t *l2_hdr_ptr,
 	return l2_hdr_ptr;
 }
 
+/* Fill in a received packet from ring memory. Returns 0 on success, or -1 when
+ * the packet was dropped (and freed). */
+static inline int mmap_rx_fill(pktio_entry_t *pktio_entry, packet_ext_t *ext,
+			       odp_packet_t pkt, uint8_t *pkt_buf,
+			       uint32_t pkt_len, odp_packet_hdr_t *parsed_hdr,
+			       odp_time_t *ts)
+{
+	odp_packet_hdr_t *hdr = odp_packet_hdr(pkt);
+
+	if (ext) {
+		packet_ext_attach(hdr, ext, pkt_buf, pkt_len);
+	} else {
+		/* Packets of a batch were allocated with the maximum length */
+		if (hdr->frame_len > pkt_len)
+			pull_tail(hdr, hdr->frame_len - pkt_len);
+
+		if (odp_packet_copy_from_mem(pkt, 0, pkt_len, pkt_buf) != 0) {
+			odp_packet_free(pkt);
+			return -1;
+		}
+	}
+
+	hdr->input = pktio_entry->s.handle;
+
+	if (parsed_hdr)
+		copy_packet_cls_metadata(parsed_hdr, hdr);
+	else
+		packet_parse_l2(&hdr->p, pkt_len);
+
+	packet_set_ts(hdr, ts);
+
+	return 0;
+}
+
+/* Create packets of 'num' frames located in ring memory. Packets are
+ * allocated with one call, unless the classifier selects the pool per
+ * packet. With 'ext', packets refer to ring memory instead of a copy. */
+static inline unsigned mmap_rx_pkts(pktio_entry_t *pktio_entry,
+				    pkt_sock_mmap_t *pkt_sock,
+				    packet_ext_t *ext, uint8_t *pkt_buf[],
+				    int pkt_len[], unsigned num,
+				    odp_packet_t pkt_table[], odp_time_t *ts)
+{
+	odp_packet_t pkt[num];
+	pool_t *pkt_pool = pool_entry_from_hdl(pkt_sock->pool);
+	uint32_t alloc_len = 0;
+	unsigned i, nb_rx;
+	int nb_pkt;
+
+	if (num == 0)
+		return 0;
+
+	if (pktio_cls_enabled(pktio_entry)) {
+		odp_packet_hdr_t parsed_hdr[num];
+		odp_pool_t pool[num];
+		uint16_t len[num];
+		uint32_t seg_len[num];
+
+		for (i = 0; i < num; i++) {
+			len[i] = pkt_len[i];
+			seg_len[i] = pkt_len[i];
+		}
+
+		if (cls_classify_packet_multi(pktio_entry, pkt_buf, len,
+					      seg_len, num, pool,
+					      parsed_hdr) == 0)
+			return 0;
+
+		for (i = 0, nb_rx = 0; i < num; i++) {
+			if (pool[i] == ODP_POOL_INVALID)
+				continue;
+
+			if (packet_alloc_multi(pool[i], ext ? 0 : pkt_len[i],
+					       &pkt_table[nb_rx], 1) != 1)
+				continue;
+
+			if (mmap_rx_fill(pktio_entry, ext, pkt_table[nb_rx],
+					 pkt_buf[i], pkt_len[i],
+					 &parsed_hdr[i], ts) == 0)
+				nb_rx++;
+		}
+
+		return nb_rx;
+	}
+
+	if (!ext) {
+		for (i = 0; i < num; i++)
+			if ((uint32_t)pkt_len[i] > alloc_len)
+				alloc_len = pkt_len[i];
+	}
+
+	/* Multi-segment packets cannot be shortened after allocation */
+	if (odp_likely(alloc_len <= pkt_pool->max_seg_len)) {
+		nb_pkt = packet_alloc_multi(pkt_sock->pool, alloc_len, pkt,
+					    num);
+	} else {
+		for (nb_pkt = 0; nb_pkt < (int)num; nb_pkt++)
+			if (packet_alloc_multi(pkt_sock->pool, pkt_len[nb_pkt],
+					       &pkt[nb_pkt], 1) != 1)
+				break;
+	}
+
+	for (i = 0, nb_rx = 0; i < (unsigned)nb_pkt; i++) {
+		if (mmap_rx_fill(pktio_entry, ext, pkt[i], pkt_buf[i],
+				 pkt_len[i], NULL, ts) == 0)
+			pkt_table[nb_rx++] = pkt[i];
+	}
+
+	return nb_rx;
+}
+
 static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 				      pkt_sock_mmap_t *pkt_sock,
+				      pkt_mmap_queue_t *queue,
 				      odp_packet_t pkt_table[], unsigned len,
 				      unsigned char if_mac[])
 {
 	union frame_map ppd;
 	odp_time_t ts_val;
 	odp_time_t *ts = NULL;
-	unsigned frame_num, next_frame_num;
-	uint8_t *pkt_buf;
-	int pkt_len;
+	unsigned frame_num, first_frame;
+	uint8_t *pkt_buf[len];
+	int pkt_len[len];
 	struct ethhdr *eth_hdr;
-	unsigned i;
+	unsigned i, num;
 	unsigned nb_rx;
 	struct ring *ring;
-	int ret;
 
-	if (pktio_entry->s.config.pktin.bit.ts_all ||
-	    pktio_entry->s.config.pktin.bit.ts_ptp)
-		ts = &ts_val;
-
-	ring  = &pkt_sock->rx_ring;
+	ring  = &queue->rx_ring;
 	frame_num = ring->frame_num;
+	first_frame = frame_num;
 
-	for (i = 0, nb_rx = 0; i < len; i++) {
-		odp_packet_hdr_t *hdr;
-		odp_packet_hdr_t parsed_hdr;
-		odp_pool_t pool = pkt_sock->pool;
-		int num;
-
+	/* Locate ready frames, skip packets sent by ourselves */
+	for (i = 0, num = 0; i < len; i++) {
 		if (!mmap_rx_kernel_ready(ring->rd[frame_num].iov_base))
 			break;
 
-		if (ts != NULL)
-			ts_val = odp_time_global();
-
 		ppd.raw = ring->rd[frame_num].iov_base;
-		next_frame_num = (frame_num + 1) % ring->rd_num;
+		frame_num = (frame_num + 1) % ring->rd_num;
 
-		pkt_buf = (uint8_t *)ppd.raw + ppd.v2->tp_h.tp_mac;
-		pkt_len = ppd.v2->tp_h.tp_snaplen;
+		pkt_buf[num] = (uint8_t *)ppd.raw + ppd.v2->tp_h.tp_mac;
+		pkt_len[num] = ppd.v2->tp_h.tp_snaplen;
 
-		/* Don't receive packets sent by ourselves */
-		eth_hdr = (struct ethhdr *)pkt_buf;
-		if (odp_unlikely(ethaddrs_equal(if_mac,
-						eth_hdr->h_source))) {
-			mmap_rx_user_ready(ppd.raw); /* drop */
-			frame_num = next_frame_num;
+		eth_hdr = (struct ethhdr *)(void *)pkt_buf[num];
+		if (odp_unlikely(ethaddrs_equal(if_mac, eth_hdr->h_source)))
 			continue;
-		}
 
-		if (ppd.v2->tp_h.tp_status & TP_STATUS_VLAN_VALID)
-			pkt_buf = pkt_mmap_vlan_insert(pkt_buf,
-						       ppd.v2->tp_h.tp_mac,
-						       ppd.v2->tp_h.tp_vlan_tci,
-						       &pkt_len);
-
-		if (pktio_cls_enabled(pktio_entry)) {
-			if (cls_classify_packet(pktio_entry, pkt_buf, pkt_len,
-						pkt_len, &pool, &parsed_hdr)) {
-				mmap_rx_user_ready(ppd.raw); /* drop */
-				frame_num = next_frame_num;
-				continue;
-			}
+		if (ppd.v2->tp_h.tp_status & TP_STATUS_VLAN_VALID) {
+			uint16_t tci = ppd.v2->tp_h.tp_vlan_tci;
+
+			pkt_buf[num] = pkt_mmap_vlan_insert(pkt_buf[num],
+							    ppd.v2->tp_h.tp_mac,
+							    tci, &pkt_len[num]);
 		}
 
-		num = packet_alloc_multi(pool, pkt_len, &pkt_table[nb_rx], 1);
+		num++;
+	}
+
+	if (i == 0)
+		return 0;
+
+	odp_mb_acquire();
+
+	if (pktio_entry->s.config.pktin.bit.ts_all ||
+	    pktio_entry->s.config.pktin.bit.ts_ptp) {
+		ts_val = odp_time_global();
+		ts = &ts_val;
+	}
+
+	nb_rx = mmap_rx_pkts(pktio_entry, pkt_sock, NULL, pkt_buf, pkt_len,
+			     num, pkt_table, ts);
+
+	/* Packets have been copied, return frames to the kernel */
+	for (num = i, i = 0; i < num; i++) {
+		mmap_rx_user_ready(ring->rd[first_frame].iov_base);
+		first_frame = (first_frame + 1) % ring->rd_num;
+	}
+
+	ring->frame_num = frame_num;
+	return nb_rx;
+}
+
+/* Receive up to 'len' packets from the current block of a TPACKET_V3 ring */
+static inline unsigned pkt_mmap_v3_rx_block(pktio_entry_t *pktio_entry,
+					    pkt_sock_mmap_t *pkt_sock,
+					    pkt_mmap_queue_t *queue,
+					    odp_packet_t pkt_table[],
+					    unsigned len, odp_time_t *ts)
+{
+	struct ring *ring = &queue->rx_ring;
+	struct tpacket3_hdr *tp_hdr;
+	packet_ext_t *ext = NULL;
+	uint8_t *pkt_buf[len];
+	int pkt_len[len];
+	unsigned i, num;
+
+	if (len > ring->blk_left)
+		len = ring->blk_left;
+
+	ring->blk_left -= len;
+
+	/* Locate packets, skip packets sent by ourselves */
+	for (i = 0, num = 0; i < len; i++) {
+		struct ethhdr *eth_hdr;
+
+		tp_hdr = (struct tpacket3_hdr *)(void *)ring->blk_pkt;
+		ring->blk_pkt += tp_hdr->tp_next_offset;
+
+		pkt_buf[num] = (uint8_t *)tp_hdr + tp_hdr->tp_mac;
+		pkt_len[num] = tp_hdr->tp_snaplen;
 
-		if (odp_unlikely(num != 1)) {
-			pkt_table[nb_rx] = ODP_PACKET_INVALID;
-			mmap_rx_user_ready(ppd.raw); /* drop */
-			frame_num = next_frame_num;
+		eth_hdr = (struct ethhdr *)(void *)pkt_buf[num];
+		if (odp_unlikely(ethaddrs_equal(pkt_sock->if_mac,
+						eth_hdr->h_source)))
 			continue;
+
+		if (tp_hdr->tp_status & TP_STATUS_VLAN_VALID) {
+			uint16_t tci = tp_hdr->hv1.tp_vlan_tci;
+
+			pkt_buf[num] = pkt_mmap_vlan_insert(pkt_buf[num],
+							    tp_hdr->tp_mac,
+							    tci, &pkt_len[num]);
 		}
-		hdr = odp_packet_hdr(pkt_table[nb_rx]);
-		ret = odp_packet_copy_from_mem(pkt_table[nb_rx], 0,
-					       pkt_len, pkt_buf);
-		if (ret != 0) {
-			odp_packet_free(pkt_table[nb_rx]);
-			mmap_rx_user_ready(ppd.raw); /* drop */
-			frame_num = next_frame_num;
-			continue;
+
+		num++;
+	}
+
+	if (num == 0)
+		return 0;
+
+	if (pkt_sock->zero_copy)
+		ext = &queue->rx_mem->block[ring->frame_num].ext;
+
+	return mmap_rx_pkts(pktio_entry, pkt_sock, ext, pkt_buf, pkt_len, num,
+			    pkt_table, ts);
+}
+
+static inline unsigned pkt_mmap_v3_rx(pktio_entry_t *pktio_entry,
+				      pkt_sock_mmap_t *pkt_sock,
+				      pkt_mmap_queue_t *queue,
+				      odp_packet_t pkt_table[], unsigned len)
+{
+	struct ring *ring = &queue->rx_ring;
+	struct tpacket_block_desc *desc;
+	mmap_block_t *block;
+	odp_time_t ts_val;
+	odp_time_t *ts = NULL;
+	unsigned nb_rx = 0;
+
+	if (pktio_entry->s.config.pktin.bit.ts_all ||
+	    pktio_entry->s.config.pktin.bit.ts_ptp)
+		ts = &ts_val;
+
+	while (nb_rx < len) {
+		block = &queue->rx_mem->block[ring->frame_num];
+		desc  = block->desc;
+
+		/* Start a new block */
+		if (ring->blk_pkt == NULL) {
+			if (!mmap_block_kernel_ready(desc))
+				break;
+
+			odp_mb_acquire();
+
+			ring->blk_pkt  = (uint8_t *)desc +
+					 desc->hdr.bh1.offset_to_first_pkt;
+			ring->blk_left = desc->hdr.bh1.num_pkts;
+
+			/* Rx holds a reference until the block is done. The
+			 * block holds a reference to ring memory. */
+			if (pkt_sock->zero_copy) {
+				odp_atomic_store_u32(&block->ext.ref_count, 1);
+				odp_atomic_inc_u32(&queue->rx_mem->ref_count);
+			}
+
+			if (ts != NULL)
+				ts_val = odp_time_global();
 		}
-		hdr->input = pktio_entry->s.handle;
 
-		if (pktio_cls_enabled(pktio_entry))
-			copy_packet_cls_metadata(&parsed_hdr, hdr);
-		else
-			packet_parse_l2(&hdr->p, pkt_len);
+		nb_rx += pkt_mmap_v3_rx_block(pktio_entry, pkt_sock, queue,
+					      &pkt_table[nb_rx], len - nb_rx,
+					      ts);
 
-		packet_set_ts(hdr, ts);
+		if (ring->blk_left)
+			continue;
 
-		mmap_rx_user_ready(ppd.raw);
-		frame_num = next_frame_num;
+		/* Block done, return it to the kernel */
+		if (pkt_sock->zero_copy)
+			packet_ext_unref(&block->ext);
+		else
+			mmap_block_user_ready(desc);
 
-		nb_rx++;
+		ring->blk_pkt = NULL;
+		ring->frame_num = (ring->frame_num + 1) % ring->rd_num;
 	}
 
-	ring->frame_num = frame_num;
 	return nb_rx;
 }
 
-static inline unsigned pkt_mmap_v2_tx(int sock, struct ring *ring,
-				      const odp_packet_t pkt_table[],
-				      unsigned len)
+static inline unsigned pkt_mmap_tx(int sock, struct ring *ring,
+				   const odp_packet_t pkt_table[],
+				   unsigned len)
 {
 	union frame_map ppd;
 	uint32_t pkt_len;
@@ -265,19 +556,26 @@ static inline unsigned pkt_mmap_v2_tx(int sock, struct ring *ring,
 
 	while (i < len) {
 		ppd.raw = ring->rd[frame_num].iov_base;
-		if (!odp_unlikely(mmap_tx_kernel_ready(ppd.raw)))
+		if (!odp_unlikely(mmap_tx_kernel_ready(ring, ppd)))
 			break;
 
 		pkt_len = odp_packet_len(pkt_table[i]);
-		ppd.v2->tp_h.tp_snaplen = pkt_len;
-		ppd.v2->tp_h.tp_len = pkt_len;
 		total_len += pkt_len;
 
-		buf = (uint8_t *)ppd.raw + TPACKET2_HDRLEN -
-		       sizeof(struct sockaddr_ll);
+		if (ring->version == TPACKET_V3) {
+			ppd.v3->tp_snaplen = pkt_len;
+			ppd.v3->tp_len = pkt_len;
+			buf = (uint8_t *)ppd.raw + TPACKET3_HDRLEN -
+			       sizeof(struct sockaddr_ll);
+		} else {
+			ppd.v2->tp_h.tp_snaplen = pkt_len;
+			ppd.v2->tp_h.tp_len = pkt_len;
+			buf = (uint8_t *)ppd.raw + TPACKET2_HDRLEN -
+			       sizeof(struct sockaddr_ll);
+		}
 		odp_packet_copy_to_mem(pkt_table[i], 0, pkt_len, buf);
 
-		mmap_tx_user_ready(ppd.raw);
+		mmap_tx_user_ready(ring, ppd);
 
 		if (++frame_num >= frame_count)
 			frame_num = 0;
@@ -297,16 +595,19 @@ static inline unsigned pkt_mmap_v2_tx(int sock, struct ring *ring,
 		ring->frame_num = frame_num;
 	} else if (ret == -1) {
 		for (frame_num = first_frame_num, n = 0; n < i; ++n) {
-			struct tpacket2_hdr *hdr = ring->rd[frame_num].iov_base;
+			uint32_t *status;
+
+			ppd.raw = ring->rd[frame_num].iov_base;
+			status  = mmap_tx_status(ring, ppd);
 
-			if (odp_likely(hdr->tp_status == TP_STATUS_AVAILABLE ||
-				       hdr->tp_status == TP_STATUS_SENDING)) {
+			if (odp_likely(*status == TP_STATUS_AVAILABLE ||
+				       *status == TP_STATUS_SENDING)) {
 				nb_tx++;
 			} else {
 				/* The remaining frames weren't sent, clear
 				 * their status to indicate we're not waiting
 				 * for the kernel to process them. */
-				hdr->tp_status = TP_STATUS_AVAILABLE;
+				*status = TP_STATUS_AVAILABLE;
 			}
 
 			if (++frame_num >= frame_count)
@@ -343,9 +644,11 @@ static inline unsigned pkt_mmap_v2_tx(int sock, struct ring *ring,
 	return nb_tx;
 }
 
-static void mmap_fill_ring(struct ring *ring, odp_pool_t pool_hdl, int fanout)
+static void mmap_fill_ring(struct ring *ring, odp_pool_t pool_hdl, int fanout,
+			   unsigned num_queues)
 {
 	int pz = getpagesize();
+	uint32_t num_frames, block_frames;
 	pool_t *pool;
 
 	if (pool_hdl == ODP_POOL_INVALID)
@@ -358,21 +661,29 @@ static void mmap_fill_ring(struct ring *ring, odp_pool_t pool_hdl, int fanout)
 				   TPACKET_HDRLEN + TPACKET_ALIGNMENT +
 				   + (pz - 1)) & (-pz);
 
-	/* Calculate how many pages do we need to hold all pool packets
-	*  and align size to page boundary.
-	*/
-	ring->req.tp_block_size = (ring->req.tp_frame_size *
-				   pool->num + (pz - 1)) & (-pz);
-
 	if (!fanout) {
 		/* Single socket is in use. Use 1 block with buf_num frames. */
-		ring->req.tp_block_nr = 1;
+		num_frames = pool->num;
 	} else {
 		/* Fanout is in use, more likely taffic split accodring to
-		 * number of cpu threads. Use cpu blocks and buf_num frames. */
-		ring->req.tp_block_nr = odp_cpu_count();
+		 * number of cpu threads. Use cpu blocks of buf_num frames,
+		 * divided between sockets of all queues. */
+		num_frames = pool->num * odp_cpu_count() / num_queues;
 	}
 
+	if (num_frames < ODP_PACKET_SOCKET_MAX_BURST_RX)
+		num_frames = ODP_PACKET_SOCKET_MAX_BURST_RX;
+
+	block_frames = num_frames < pool->num ? num_frames : pool->num;
+
+	/* Calculate how many pages do we need to hold block frames
+	*  and align size to page boundary.
+	*/
+	ring->req.tp_block_size = (ring->req.tp_frame_size *
+				   block_frames + (pz - 1)) & (-pz);
+	ring->req.tp_block_nr = (num_frames + block_frames - 1) /
+				block_frames;
+
 	ring->req.tp_frame_nr = ring->req.tp_block_size /
 				ring->req.tp_frame_size * ring->req.tp_block_nr;
 
@@ -381,16 +692,56 @@ static void mmap_fill_ring(struct ring *ring, odp_pool_t pool_hdl, int fanout)
 	ring->flen = ring->req.tp_frame_size;
 }
 
-static int mmap_setup_ring(int sock, struct ring *ring, int type,
-			   odp_pool_t pool_hdl, int fanout)
+/* TPACKET_V3 Rx ring has the same amount of memory as the frame based ring,
+ * but it is divided into blocks of variable size packets. Ring descriptors
+ * point to blocks. With zero copy, each packet in use may hold a block, so
+ * there is a block per frame to not run out of blocks before pool buffers. */
+static void mmap_fill_ring_v3(struct ring *ring, odp_pool_t pool_hdl,
+			      int fanout, unsigned num_queues, int zero_copy_rx)
 {
+	uint32_t frame_size, block_size;
+	uint64_t mem_size;
+
+	mmap_fill_ring(ring, pool_hdl, fanout, num_queues);
+
+	frame_size = ring->req.tp_frame_size;
+	mem_size   = ring->mm_len;
+
+	/* Block size is a multiple of the frame size (and page size) */
+	block_size = (MMAP_V3_BLOCK_SIZE / frame_size) * frame_size;
+	if (block_size == 0 || zero_copy_rx)
+		block_size = frame_size;
+
+	ring->req.tp_block_size = block_size;
+	ring->req.tp_block_nr   = (mem_size + block_size - 1) / block_size;
+	ring->req.tp_frame_nr   = block_size / frame_size *
+				  ring->req.tp_block_nr;
+	ring->req.tp_retire_blk_tov   = MMAP_V3_BLOCK_TOV;
+	ring->req.tp_sizeof_priv      = 0;
+	ring->req.tp_feature_req_word = 0;
+
+	ring->mm_len = (size_t)block_size * ring->req.tp_block_nr;
+	ring->rd_num = ring->req.tp_block_nr;
+	ring->flen   = block_size;
+}
+
+static int mmap_setup_ring(pkt_sock_mmap_t *pkt_sock, pkt_mmap_queue_t *queue,
+			   struct ring *ring, int type, unsigned num_queues)
+{
+	int sock = queue->sockfd;
 	int ret = 0;
 
+	memset(ring, 0, sizeof(struct ring));
 	ring->sock = sock;
 	ring->type = type;
-	ring->version = TPACKET_V2;
+	ring->version = pkt_sock->version;
 
-	mmap_fill_ring(ring, pool_hdl, fanout);
+	if (ring->version == TPACKET_V3 && type == PACKET_RX_RING)
+		mmap_fill_ring_v3(ring, pkt_sock->pool, pkt_sock->fanout,
+				  num_queues, pkt_sock->zero_copy);
+	else
+		mmap_fill_ring(ring, pkt_sock->pool, pkt_sock->fanout,
+			       num_queues);
 
 	ret = setsockopt(sock, SOL_PACKET, type, &ring->req, sizeof(ring->req));
 	if (ret == -1) {
@@ -410,70 +761,127 @@ static int mmap_setup_ring(int sock, struct ring *ring, int type,
 	return 0;
 }
 
-static int mmap_sock(pkt_sock_mmap_t *pkt_sock)
+static int mmap_sock(pkt_mmap_queue_t *queue)
 {
 	int i;
-	int sock = pkt_sock->sockfd;
+	int sock = queue->sockfd;
 
 	/* map rx + tx buffer to userspace : they are in this order */
-	pkt_sock->mmap_len =
-		pkt_sock->rx_ring.req.tp_block_size *
-		pkt_sock->rx_ring.req.tp_block_nr +
-		pkt_sock->tx_ring.req.tp_block_size *
-		pkt_sock->tx_ring.req.tp_block_nr;
-
-	pkt_sock->mmap_base =
-		mmap(NULL, pkt_sock->mmap_len, PROT_READ | PROT_WRITE,
+	queue->mmap_len =
+		queue->rx_ring.req.tp_block_size *
+		queue->rx_ring.req.tp_block_nr +
+		queue->tx_ring.req.tp_block_size *
+		queue->tx_ring.req.tp_block_nr;
+
+	/* Block based rings own the mapping through Rx memory */
+	if (queue->rx_ring.version == TPACKET_V3) {
+		queue->rx_mem = malloc(sizeof(mmap_rx_mem_t) +
+				       queue->rx_ring.rd_num *
+				       sizeof(mmap_block_t));
+		if (!queue->rx_mem) {
+			__odp_errno = errno;
+			ODP_ERR("malloc(): %s\n", strerror(errno));
+			return -1;
+		}
+	}
+
+	queue->mmap_base =
+		mmap(NULL, queue->mmap_len, PROT_READ | PROT_WRITE,
 		     MAP_SHARED | MAP_LOCKED | MAP_POPULATE, sock, 0);
 
-	if (pkt_sock->mmap_base == MAP_FAILED) {
+	if (queue->mmap_base == MAP_FAILED) {
+		queue->mmap_base = NULL;
 		__odp_errno = errno;
 		ODP_ERR("mmap rx&tx buffer failed: %s\n", strerror(errno));
 		return -1;
 	}
 
-	pkt_sock->rx_ring.mm_space = pkt_sock->mmap_base;
-	memset(pkt_sock->rx_ring.rd, 0, pkt_sock->rx_ring.rd_len);
-	for (i = 0; i < pkt_sock->rx_ring.rd_num; ++i) {
-		pkt_sock->rx_ring.rd[i].iov_base =
-			pkt_sock->rx_ring.mm_space
-			+ (i * pkt_sock->rx_ring.flen);
-		pkt_sock->rx_ring.rd[i].iov_len = pkt_sock->rx_ring.flen;
+	queue->rx_ring.mm_space = queue->mmap_base;
+	memset(queue->rx_ring.rd, 0, queue->rx_ring.rd_len);
+	for (i = 0; i < queue->rx_ring.rd_num; ++i) {
+		queue->rx_ring.rd[i].iov_base =
+			queue->rx_ring.mm_space
+			+ (i * queue->rx_ring.flen);
+		queue->rx_ring.rd[i].iov_len = queue->rx_ring.flen;
 	}
 
-	pkt_sock->tx_ring.mm_space =
-		pkt_sock->mmap_base + pkt_sock->rx_ring.mm_len;
-	memset(pkt_sock->tx_ring.rd, 0, pkt_sock->tx_ring.rd_len);
-	for (i = 0; i < pkt_sock->tx_ring.rd_num; ++i) {
-		pkt_sock->tx_ring.rd[i].iov_base =
-			pkt_sock->tx_ring.mm_space
-			+ (i * pkt_sock->tx_ring.flen);
-		pkt_sock->tx_ring.rd[i].iov_len = pkt_sock->tx_ring.flen;
+	if (queue->rx_mem) {
+		mmap_rx_mem_t *mem = queue->rx_mem;
+
+		odp_atomic_init_u32(&mem->ref_count, 1);
+		odp_atomic_init_u32(&mem->closed, 0);
+		mem->base = queue->mmap_base;
+		mem->len  = queue->mmap_len;
+
+		for (i = 0; i < queue->rx_ring.rd_num; ++i) {
+			mmap_block_t *block = &mem->block[i];
+
+			odp_atomic_init_u32(&block->ext.ref_count, 0);
+			block->ext.release = mmap_block_release;
+			block->desc = queue->rx_ring.rd[i].iov_base;
+			block->mem  = mem;
+		}
+	}
+
+	queue->tx_ring.mm_space =
+		queue->mmap_base + queue->rx_ring.mm_len;
+	memset(queue->tx_ring.rd, 0, queue->tx_ring.rd_len);
+	for (i = 0; i < queue->tx_ring.rd_num; ++i) {
+		queue->tx_ring.rd[i].iov_base =
+			queue->tx_ring.mm_space
+			+ (i * queue->tx_ring.flen);
+		queue->tx_ring.rd[i].iov_len = queue->tx_ring.flen;
 	}
 
 	return 0;
 }
 
-static void mmap_unmap_sock(pkt_sock_mmap_t *pkt_sock)
+static void mmap_unmap_sock(pkt_sock_mmap_t *pkt_sock, pkt_mmap_queue_t *queue)
 {
-	munmap(pkt_sock->mmap_base, pkt_sock->mmap_len);
-	free(pkt_sock->rx_ring.rd);
-	free(pkt_sock->tx_ring.rd);
+	mmap_rx_mem_t *mem = queue->rx_mem;
+
+	if (mem && queue->mmap_base) {
+		/* Zero copy packets which have not been freed yet keep ring
+		 * memory mapped until the last one of them is freed */
+		odp_atomic_store_u32(&mem->closed, 1);
+
+		/* Rx holds a reference to the block being read */
+		if (pkt_sock->zero_copy && queue->rx_ring.blk_pkt) {
+			uint32_t cur = queue->rx_ring.frame_num;
+
+			packet_ext_unref(&mem->block[cur].ext);
+		}
+
+		mmap_rx_mem_unref(mem);
+	} else {
+		if (queue->mmap_base)
+			munmap(queue->mmap_base, queue->mmap_len);
+		free(mem);
+	}
+
+	free(queue->rx_ring.rd);
+	free(queue->tx_ring.rd);
+	queue->mmap_base = NULL;
+	queue->rx_ring.rd = NULL;
+	queue->tx_ring.rd = NULL;
+	queue->rx_ring.blk_pkt = NULL;
+	queue->rx_mem = NULL;
 }
 
-static int mmap_bind_sock(pkt_sock_mmap_t *pkt_sock, const char *netdev)
+static int mmap_bind_sock(pkt_mmap_queue_t *queue, int if_idx,
+			  uint16_t proto)
 {
 	int ret;
 
-	pkt_sock->ll.sll_family = PF_PACKET;
-	pkt_sock->ll.sll_protocol = htons(ETH_P_ALL);
-	pkt_sock->ll.sll_ifindex = if_nametoindex(netdev);
-	pkt_sock->ll.sll_hatype = 0;
-	pkt_sock->ll.sll_pkttype = 0;
-	pkt_sock->ll.sll_halen = 0;
+	queue->ll.sll_family = PF_PACKET;
+	queue->ll.sll_protocol = proto;
+	queue->ll.sll_ifindex = if_idx;
+	queue->ll.sll_hatype = 0;
+	queue->ll.sll_pkttype = 0;
+	queue->ll.sll_halen = 0;
 
-	ret = bind(pkt_sock->sockfd, (struct sockaddr *)&pkt_sock->ll,
-		   sizeof(pkt_sock->ll));
+	ret = bind(queue->sockfd, (struct sockaddr *)&queue->ll,
+		   sizeof(queue->ll));
 	if (ret == -1) {
 		__odp_errno = errno;
 		ODP_ERR("bind(to IF): %s\n", strerror(errno));
@@ -483,26 +891,156 @@ static int mmap_bind_sock(pkt_sock_mmap_t *pkt_sock, const char *netdev)
 	return 0;
 }
 
-static int sock_mmap_close(pktio_entry_t *entry)
+static int mmap_close_sock(pkt_sock_mmap_t *pkt_sock, pkt_mmap_queue_t *queue)
 {
-	pkt_sock_mmap_t *const pkt_sock = &entry->s.pkt_sock_mmap;
-
-	mmap_unmap_sock(pkt_sock);
-	if (pkt_sock->sockfd != -1 && close(pkt_sock->sockfd) != 0) {
+	mmap_unmap_sock(pkt_sock, queue);
+	if (queue->sockfd != -1 && close(queue->sockfd) != 0) {
 		__odp_errno = errno;
 		ODP_ERR("close(sockfd): %s\n", strerror(errno));
 		return -1;
 	}
 
+	queue->sockfd = -1;
+	return 0;
+}
+
+/* Open packet socket of a queue and set up its rings. Sockets without an Rx
+ * ring do not receive packets and are not part of the fanout group. */
+static int mmap_open_sock(pkt_sock_mmap_t *pkt_sock, pkt_mmap_queue_t *queue,
+			  int rx, int tx)
+{
+	uint16_t proto = rx ? htons(ETH_P_ALL) : 0;
+
+	memset(&queue->rx_ring, 0, sizeof(struct ring));
+	memset(&queue->tx_ring, 0, sizeof(struct ring));
+
+	queue->sockfd = mmap_pkt_socket(pkt_sock->version, proto);
+	if (queue->sockfd == -1)
+		return -1;
+
+	if (mmap_bind_sock(queue, pkt_sock->if_idx, proto))
+		goto error;
+
+	if (tx && mmap_setup_ring(pkt_sock, queue, &queue->tx_ring,
+				  PACKET_TX_RING, pkt_sock->num_tx_queues))
+		goto error;
+
+	if (rx && mmap_setup_ring(pkt_sock, queue, &queue->rx_ring,
+				  PACKET_RX_RING, pkt_sock->num_rx_queues))
+		goto error;
+
+	if (mmap_sock(queue))
+		goto error;
+
+	if (rx && pkt_sock->fanout &&
+	    set_pkt_sock_fanout_mmap(queue, pkt_sock->if_idx,
+				     pkt_sock->fanout_mode))
+		goto error;
+
+	return 0;
+
+error:
+	mmap_close_sock(pkt_sock, queue);
+	return -1;
+}
+
+/* (Re)create sockets of all pktin/pktout queues */
+static int mmap_queues_open(pktio_entry_t *pktio_entry, unsigned num_rx,
+			    unsigned num_tx, int mode)
+{
+	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	unsigned num = num_rx > num_tx ? num_rx : num_tx;
+	unsigned i;
+	int ret = 0;
+
+	for (i = 0; i < pkt_sock->num_queues; i++)
+		ret |= mmap_close_sock(pkt_sock, &pkt_sock->queue[i]);
+
+	pkt_sock->num_queues    = 0;
+	pkt_sock->num_rx_queues = num_rx;
+	pkt_sock->num_tx_queues = num_tx;
+	pkt_sock->fanout_mode   = mode;
+
+	if (ret)
+		return -1;
+
+	for (i = 0; i < num; i++) {
+		if (mmap_open_sock(pkt_sock, &pkt_sock->queue[i],
+				   i < num_rx, i < num_tx)) {
+			ODP_ERR("%s: queue %u socket setup failed\n",
+				pktio_entry->s.name, i);
+			return -1;
+		}
+		pkt_sock->num_queues++;
+	}
+
 	return 0;
 }
 
+/* Set up a socket per pktin/pktout queue. Ring memory is divided between
+ * queues, so all sockets are recreated when the number of queues changes. */
+static int mmap_queues_config(pktio_entry_t *pktio_entry, unsigned num_rx,
+			      unsigned num_tx, int mode)
+{
+	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	unsigned num = num_rx > num_tx ? num_rx : num_tx;
+
+	if (num_rx == pkt_sock->num_rx_queues &&
+	    num_tx == pkt_sock->num_tx_queues &&
+	    mode == pkt_sock->fanout_mode && num == pkt_sock->num_queues)
+		return 0;
+
+	return mmap_queues_open(pktio_entry, num_rx, num_tx, mode);
+}
+
+/* Zero copy Rx needs block based TPACKET_V3 rings, which are set up when
+ * sockets are opened. Otherwise, frame based rings are used since kernel holds
+ * a partially filled block until the block timeout. */
+static int sock_mmap_config(pktio_entry_t *pktio_entry,
+			    const odp_pktio_config_t *config)
+{
+	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	int zero_copy = config->pktin.bit.zero_copy;
+	unsigned num_rx = pkt_sock->num_rx_queues;
+	unsigned num_tx = pkt_sock->num_tx_queues;
+	int mode = pkt_sock->fanout_mode;
+
+	if (zero_copy == pkt_sock->zero_copy)
+		return 0;
+
+	pkt_sock->zero_copy = zero_copy;
+	pkt_sock->version   = zero_copy ? TPACKET_V3 : TPACKET_V2;
+
+	if (mmap_queues_open(pktio_entry, num_rx, num_tx, mode) == 0)
+		return 0;
+
+	ODP_ERR("%s: zero copy Rx setup failed\n", pktio_entry->s.name);
+	pkt_sock->zero_copy = 0;
+	pkt_sock->version   = TPACKET_V2;
+	(void)mmap_queues_open(pktio_entry, num_rx, num_tx, mode);
+	return -1;
+}
+
+static int sock_mmap_close(pktio_entry_t *entry)
+{
+	pkt_sock_mmap_t *const pkt_sock = &entry->s.pkt_sock_mmap;
+	unsigned i;
+	int ret = 0;
+
+	for (i = 0; i < pkt_sock->num_queues; i++)
+		ret |= mmap_close_sock(pkt_sock, &pkt_sock->queue[i]);
+
+	pkt_sock->num_queues = 0;
+
+	return ret ? -1 : 0;
+}
+
 static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 			  pktio_entry_t *pktio_entry,
 			  const char *netdev, odp_pool_t pool)
 {
-	int if_idx;
 	int ret = 0;
+	unsigned i;
 	odp_pktio_stats_t cur_stats;
 
 	if (disable_pktio)
@@ -513,8 +1051,13 @@ static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 
 	/* Init pktio entry */
 	memset(pkt_sock, 0, sizeof(*pkt_sock));
-	/* set sockfd to -1, because a valid socked might be initialized to 0 */
-	pkt_sock->sockfd = -1;
+	for (i = 0; i < ODP_PACKET_SOCKET_MMAP_MAX_QUEUES; i++) {
+		/* set sockfd to -1, because a valid socked might be
+		 * initialized to 0 */
+		pkt_sock->queue[i].sockfd = -1;
+		odp_ticketlock_init(&pkt_sock->queue[i].rx_lock);
+		odp_ticketlock_init(&pkt_sock->queue[i].tx_lock);
+	}
 
 	if (pool == ODP_POOL_INVALID)
 		return -1;
@@ -523,47 +1066,33 @@ static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 	pkt_sock->frame_offset = 0;
 
 	pkt_sock->pool = pool;
-	pkt_sock->sockfd = mmap_pkt_socket();
-	if (pkt_sock->sockfd == -1)
-		goto error;
-
-	ret = mmap_bind_sock(pkt_sock, netdev);
-	if (ret != 0)
-		goto error;
+	pkt_sock->fanout = fanout;
+	pkt_sock->fanout_mode = fanout_mode;
+	pkt_sock->num_rx_queues = 1;
+	pkt_sock->num_tx_queues = 1;
 
-	ret = mmap_setup_ring(pkt_sock->sockfd, &pkt_sock->tx_ring,
-			      PACKET_TX_RING, pool, fanout);
-	if (ret != 0)
-		goto error;
+	pkt_sock->if_idx = if_nametoindex(netdev);
+	if (pkt_sock->if_idx == 0) {
+		__odp_errno = errno;
+		ODP_ERR("if_nametoindex(): %s\n", strerror(errno));
+		return -1;
+	}
 
-	ret = mmap_setup_ring(pkt_sock->sockfd, &pkt_sock->rx_ring,
-			      PACKET_RX_RING, pool, fanout);
+	/* Zero copy Rx is enabled through pktio config */
+	pkt_sock->version = TPACKET_V2;
+	ret = mmap_open_sock(pkt_sock, &pkt_sock->queue[0], 1, 1);
 	if (ret != 0)
 		goto error;
 
-	ret = mmap_sock(pkt_sock);
-	if (ret != 0)
-		goto error;
+	pkt_sock->num_queues = 1;
+	pkt_sock->v3_supported = mmap_v3_supported();
 
-	ret = mac_addr_get_fd(pkt_sock->sockfd, netdev, pkt_sock->if_mac);
+	ret = mac_addr_get_fd(pkt_sock->queue[0].sockfd, netdev,
+			      pkt_sock->if_mac);
 	if (ret != 0)
 		goto error;
 
-	if_idx = if_nametoindex(netdev);
-	if (if_idx == 0) {
-		__odp_errno = errno;
-		ODP_ERR("if_nametoindex(): %s\n", strerror(errno));
-		goto error;
-	}
-
-	pkt_sock->fanout = fanout;
-	if (fanout) {
-		ret = set_pkt_sock_fanout_mmap(pkt_sock, if_idx);
-		if (ret != 0)
-			goto error;
-	}
-
-	ret = ethtool_stats_get_fd(pktio_entry->s.pkt_sock_mmap.sockfd,
+	ret = ethtool_stats_get_fd(pkt_sock->queue[0].sockfd,
 				   pktio_entry->s.name,
 				   &cur_stats);
 	if (ret != 0) {
@@ -579,8 +1108,7 @@ static int sock_mmap_open(odp_pktio_t id ODP_UNUSED,
 		pktio_entry->s.stats_type = STATS_ETHTOOL;
 	}
 
-	ret = sock_stats_reset_fd(pktio_entry,
-				  pktio_entry->s.pkt_sock_mmap.sockfd);
+	ret = sock_stats_reset_fd(pktio_entry, pkt_sock->queue[0].sockfd);
 	if (ret != 0)
 		goto error;
 
@@ -591,38 +1119,90 @@ error:
 	return -1;
 }
 
-static int sock_mmap_recv(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+static int sock_mmap_input_queues_config(pktio_entry_t *pktio_entry,
+					 const odp_pktin_queue_param_t *p)
+{
+	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	odp_pktin_mode_t mode = pktio_entry->s.param.in_mode;
+	int fanout = fanout_mode;
+
+	/* Scheduler synchronizes input queue polls. Only single thread
+	 * at a time polls a queue */
+	if (mode == ODP_PKTIN_MODE_SCHED)
+		pkt_sock->lockless_rx = 1;
+	else
+		pkt_sock->lockless_rx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	/* Kernel hashes flows of all protocols */
+	if (p->hash_enable)
+		fanout = PACKET_FANOUT_HASH;
+
+	return mmap_queues_config(pktio_entry, p->num_queues,
+				  pkt_sock->num_tx_queues, fanout);
+}
+
+static int sock_mmap_output_queues_config(pktio_entry_t *pktio_entry,
+					  const odp_pktout_queue_param_t *p)
+{
+	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+
+	pkt_sock->lockless_tx = (p->op_mode == ODP_PKTIO_OP_MT_UNSAFE);
+
+	return mmap_queues_config(pktio_entry, pkt_sock->num_rx_queues,
+				  p->num_queues, pkt_sock->fanout_mode);
+}
+
+static int sock_mmap_recv(pktio_entry_t *pktio_entry, int index,
 			  odp_packet_t pkt_table[], int len)
 {
 	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	pkt_mmap_queue_t *queue = &pkt_sock->queue[index];
 	int ret;
 
-	odp_ticketlock_lock(&pktio_entry->s.rxl);
-	ret = pkt_mmap_v2_rx(pktio_entry, pkt_sock, pkt_table, len,
-			     pkt_sock->if_mac);
-	odp_ticketlock_unlock(&pktio_entry->s.rxl);
+	if (!pkt_sock->lockless_rx)
+		odp_ticketlock_lock(&queue->rx_lock);
+
+	if (pkt_sock->version == TPACKET_V3)
+		ret = pkt_mmap_v3_rx(pktio_entry, pkt_sock, queue, pkt_table,
+				     len);
+	else
+		ret = pkt_mmap_v2_rx(pktio_entry, pkt_sock, queue, pkt_table,
+				     len, pkt_sock->if_mac);
+
+	if (!pkt_sock->lockless_rx)
+		odp_ticketlock_unlock(&queue->rx_lock);
 
 	return ret;
 }
 
-static int sock_mmap_send(pktio_entry_t *pktio_entry, int index ODP_UNUSED,
+static int sock_mmap_send(pktio_entry_t *pktio_entry, int index,
 			  const odp_packet_t pkt_table[], int len)
 {
-	int ret;
 	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+	pkt_mmap_queue_t *queue = &pkt_sock->queue[index];
+	int ret;
+
+	if (!pkt_sock->lockless_tx)
+		odp_ticketlock_lock(&queue->tx_lock);
 
-	odp_ticketlock_lock(&pktio_entry->s.txl);
-	ret = pkt_mmap_v2_tx(pkt_sock->tx_ring.sock, &pkt_sock->tx_ring,
-			     pkt_table, len);
-	odp_ticketlock_unlock(&pktio_entry->s.txl);
+	ret = pkt_mmap_tx(queue->tx_ring.sock, &queue->tx_ring,
+			  pkt_table, len);
+
+	if (!pkt_sock->lockless_tx)
+		odp_ticketlock_unlock(&queue->tx_lock);
 
 	return ret;
 }
 
+/* Socket of queue 0 is used for interface control */
+static inline int mmap_ctrl_sock(pktio_entry_t *pktio_entry)
+{
+	return pktio_entry->s.pkt_sock_mmap.queue[0].sockfd;
+}
+
 static uint32_t sock_mmap_mtu_get(pktio_entry_t *pktio_entry)
 {
-	return mtu_get_fd(pktio_entry->s.pkt_sock_mmap.sockfd,
-			  pktio_entry->s.name);
+	return mtu_get_fd(mmap_ctrl_sock(pktio_entry), pktio_entry->s.name);
 }
 
 static int sock_mmap_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
@@ -634,34 +1214,37 @@ static int sock_mmap_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
 static int sock_mmap_promisc_mode_set(pktio_entry_t *pktio_entry,
 				      odp_bool_t enable)
 {
-	return promisc_mode_set_fd(pktio_entry->s.pkt_sock_mmap.sockfd,
+	return promisc_mode_set_fd(mmap_ctrl_sock(pktio_entry),
 				   pktio_entry->s.name, enable);
 }
 
 static int sock_mmap_promisc_mode_get(pktio_entry_t *pktio_entry)
 {
-	return promisc_mode_get_fd(pktio_entry->s.pkt_sock_mmap.sockfd,
+	return promisc_mode_get_fd(mmap_ctrl_sock(pktio_entry),
 				   pktio_entry->s.name);
 }
 
 static int sock_mmap_link_status(pktio_entry_t *pktio_entry)
 {
-	return link_status_fd(pktio_entry->s.pkt_sock_mmap.sockfd,
+	return link_status_fd(mmap_ctrl_sock(pktio_entry),
 			      pktio_entry->s.name);
 }
 
-static int sock_mmap_capability(pktio_entry_t *pktio_entry ODP_UNUSED,
+static int sock_mmap_capability(pktio_entry_t *pktio_entry,
 				odp_pktio_capability_t *capa)
 {
+	pkt_sock_mmap_t *const pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+
 	memset(capa, 0, sizeof(odp_pktio_capability_t));
 
-	capa->max_input_queues  = 1;
-	capa->max_output_queues = 1;
+	capa->max_input_queues  = ODP_PACKET_SOCKET_MMAP_MAX_QUEUES;
+	capa->max_output_queues = ODP_PACKET_SOCKET_MMAP_MAX_QUEUES;
 	capa->set_op.op.promisc_mode = 1;
 
 	odp_pktio_config_init(&capa->config);
 	capa->config.pktin.bit.ts_all = 1;
 	capa->config.pktin.bit.ts_ptp = 1;
+	capa->config.pktin.bit.zero_copy = pkt_sock->v3_supported;
 	return 0;
 }
 
@@ -675,7 +1258,7 @@ static int sock_mmap_stats(pktio_entry_t *pktio_entry,
 
 	return sock_stats_fd(pktio_entry,
 			     stats,
-			     pktio_entry->s.pkt_sock_mmap.sockfd);
+			     mmap_ctrl_sock(pktio_entry));
 }
 
 static int sock_mmap_stats_reset(pktio_entry_t *pktio_entry)
@@ -687,11 +1270,13 @@ static int sock_mmap_stats_reset(pktio_entry_t *pktio_entry)
 	}
 
 	return sock_stats_reset_fd(pktio_entry,
-				   pktio_entry->s.pkt_sock_mmap.sockfd);
+				   mmap_ctrl_sock(pktio_entry));
 }
 
 static int sock_mmap_init_global(void)
 {
+	const char *env;
+
 	if (getenv("ODP_PKTIO_DISABLE_SOCKET_MMAP")) {
 		ODP_PRINT("PKTIO: socket mmap skipped,"
 				" enabled export ODP_PKTIO_DISABLE_SOCKET_MMAP=1.\n");
@@ -700,6 +1285,24 @@ static int sock_mmap_init_global(void)
 		ODP_PRINT("PKTIO: initialized socket mmap,"
 				" use export ODP_PKTIO_DISABLE_SOCKET_MMAP=1 to disable.\n");
 	}
+
+	env = getenv("ODP_PKTIO_SOCKET_MMAP_FANOUT");
+	if (env) {
+		if (!strcmp(env, "hash")) {
+			fanout_mode = PACKET_FANOUT_HASH;
+		} else if (!strcmp(env, "lb")) {
+			fanout_mode = PACKET_FANOUT_LB;
+		} else if (!strcmp(env, "cpu")) {
+			fanout_mode = PACKET_FANOUT_CPU;
+		} else if (!strcmp(env, "qm")) {
+			fanout_mode = PACKET_FANOUT_QM;
+		} else {
+			ODP_ERR("Bad ODP_PKTIO_SOCKET_MMAP_FANOUT: %s\n", env);
+			return -1;
+		}
+		ODP_PRINT("PKTIO: socket mmap fanout mode %s\n", env);
+	}
+
 	return 0;
 }
 
@@ -725,7 +1328,7 @@ const pktio_if_ops_t sock_mmap_pktio_ops = {
 	.capability = sock_mmap_capability,
 	.pktin_ts_res = NULL,
 	.pktin_ts_from_ns = NULL,
-	.config = NULL,
-	.input_queues_config = NULL,
-	.output_queues_config = NULL,
+	.config = sock_mmap_config,
+	.input_queues_config = sock_mmap_input_queues_config,
+	.output_queues_config = sock_mmap_output_queues_config,
 };
@@ -10,12 +10,21 @@
  * @example odp_bench_packet.c  Microbenchmarks for packet functions
  */
 
+/** enable syscall() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include <stdlib.h>
+#include <string.h>
 #include <getopt.h>
 #include <unistd.h>
 #include <errno.h>
 #include <inttypes.h>
 #include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
 
 #include <test_debug.h>
 
@@ -63,6 +72,9 @@
 /** Default burst size for *_multi operations */
 #define TEST_DEF_BURST 8
 
+/** Size of the buffer written to evict test data from CPU caches */
+#define TEST_CACHE_FLUSH_SIZE (32 * 1024 * 1024)
+
 /** Get rid of path in filename - only for unix-type paths using '/' */
 #define NO_PATH(file_name) (strrchr((file_name), '/') ? \
 			    strrchr((file_name), '/') + 1 : (file_name))
@@ -86,6 +98,7 @@ const uint32_t test_packet_len[] = {WARM_UP, TEST_MIN_PKT_SIZE, 128, 256, 512,
 typedef struct {
 	int bench_idx;   /** Benchmark index to run indefinitely */
 	int burst_size;  /** Burst size for *_multi operations */
+	int cache_miss;  /** Measure cache misses with cold caches */
 } appl_args_t;
 
 /**
@@ -168,6 +181,8 @@ static args_t *gbl_args;
 static odp_barrier_t barrier;
 /** Break worker loop if set to 1 */
 static int exit_thread;
+/** Buffer for evicting test data from CPU caches */
+static uint8_t *cache_flush_buf;
 
 static void sig_handler(int signo ODP_UNUSED)
 {
@@ -202,6 +217,34 @@ static void run_indef(args_t *args, int idx)
 	}
 }
 
+/**
+ * Open CPU cache miss counter of the calling thread
+ *
+ * @return File descriptor of the counter, or -1 when not available
+ */
+static int cache_miss_open(void)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.type           = PERF_TYPE_HARDWARE;
+	attr.size           = sizeof(attr);
+	attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled       = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv     = 1;
+
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/**
+ * Write over a large buffer to evict packets from CPU caches
+ */
+static void cache_flush(void)
+{
+	memset(cache_flush_buf, exit_thread, TEST_CACHE_FLUSH_SIZE);
+}
+
 /**
  * Master function for running the microbenchmarks
  */
@@ -211,14 +254,27 @@ static int run_benchmarks(void *arg)
 	args_t *args = arg;
 	int num_sizes = sizeof(test_packet_len) / sizeof(test_packet_len[0]);
 	double results[gbl_args->num_bench][num_sizes];
+	double misses[gbl_args->num_bench][num_sizes];
+	int cache_fd = -1;
 
 	memset(results, 0, sizeof(results));
+	memset(misses, 0, sizeof(misses));
 
-	printf("\nRunning benchmarks (cycles per call)\n"
-	       "------------------------------------\n");
+	if (args->appl.cache_miss) {
+		cache_fd = cache_miss_open();
+
+		if (cache_fd < 0)
+			printf("\nCache miss counter not available (%s), "
+			       "running with cold caches\n", strerror(errno));
+	}
+
+	printf("\nRunning benchmarks (cycles per call%s)\n"
+	       "------------------------------------\n",
+	       cache_fd >= 0 ? ", cache misses per call" : "");
 
 	for (i = 0; i < num_sizes; i++) {
 		uint64_t tot_cycles = 0;
+		uint64_t tot_misses = 0;
 
 		printf("\nPacket length: %6d bytes\n"
 		       "---------------------------\n", test_packet_len[i]);
@@ -236,6 +292,8 @@ static int run_benchmarks(void *arg)
 				continue;
 			} else if (args->appl.bench_idx &&
 				   (j + 1) == args->appl.bench_idx) {
+				if (cache_fd >= 0)
+					close(cache_fd);
 				run_indef(args, j);
 				return 0;
 			}
@@ -247,16 +305,35 @@ static int run_benchmarks(void *arg)
 			if (args->bench[j].init != NULL)
 				args->bench[j].init();
 
+			if (args->appl.cache_miss)
+				cache_flush();
+
+			if (cache_fd >= 0) {
+				ioctl(cache_fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(cache_fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+
 			c1 = odp_cpu_cycles();
 			ret = args->bench[j].run();
 			c2 = odp_cpu_cycles();
 
+			if (cache_fd >= 0) {
+				uint64_t count = 0;
+
+				ioctl(cache_fd, PERF_EVENT_IOC_DISABLE, 0);
+				if (read(cache_fd, &count, sizeof(count)) ==
+				    sizeof(count))
+					tot_misses += count;
+			}
+
 			if (args->bench[j].term != NULL)
 				args->bench[j].term();
 
 			if (!ret) {
 				LOG_ERR("Benchmark %s failed\n", desc);
 				args->bench_failed = 1;
+				if (cache_fd >= 0)
+					close(cache_fd);
 				return -1;
 			}
 
@@ -271,12 +348,20 @@ static int run_benchmarks(void *arg)
 					 (TEST_SIZE_RUN_COUNT *
 					  TEST_REPEAT_COUNT);
 				results[j][i] = cycles;
+				misses[j][i] = ((double)tot_misses) /
+					       (TEST_SIZE_RUN_COUNT *
+						TEST_REPEAT_COUNT);
 
-				printf("%-30s: %8.1f\n", desc, cycles);
+				if (cache_fd >= 0)
+					printf("%-30s: %8.1f %8.2f\n", desc,
+					       cycles, misses[j][i]);
+				else
+					printf("%-30s: %8.1f\n", desc, cycles);
 
 				j++;
 				k = 0;
 				tot_cycles = 0;
+				tot_misses = 0;
 			}
 		}
 	}
@@ -299,6 +384,20 @@ static int run_benchmarks(void *arg)
 			printf("%8.1f  ", results[i][j]);
 	}
 	printf("\n\n");
+
+	if (cache_fd < 0)
+		return 0;
+
+	printf("Cache misses per call\n");
+	for (i = 0; i < gbl_args->num_bench; i++) {
+		printf("\n[%02d] %-30s", i + 1, args->bench[i].desc != NULL ?
+		       args->bench[i].desc : args->bench[i].name);
+
+		for (j = 0; j < num_sizes; j++)
+			printf("%8.2f  ", misses[i][j]);
+	}
+	printf("\n\n");
+	close(cache_fd);
 	return 0;
 }
 
@@ -420,6 +519,109 @@ static void free_packets_twice(void)
 	odp_packet_free_multi(gbl_args->pkt2_tbl, TEST_REPEAT_COUNT);
 }
 
+/** Ethernet + IPv4 + UDP test packet headers */
+static const uint8_t test_udp_hdr[] = {
+	0x00, 0x00, 0x09, 0x00, 0x05, 0x00, 0x00, 0x00,
+	0x09, 0x00, 0x04, 0x00, 0x08, 0x00, 0x45, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x40, 0x11,
+	0x00, 0x00, 0x0A, 0x00, 0x00, 0x01, 0x0A, 0x00,
+	0x00, 0x02, 0x04, 0xD2, 0x16, 0x2E, 0x00, 0x00,
+	0x00, 0x00
+};
+
+/** VXLAN encapsulated Ethernet + IPv4 + UDP test packet headers */
+static const uint8_t test_vxlan_hdr[] = {
+	0x00, 0x00, 0x09, 0x00, 0x05, 0x00, 0x00, 0x00,
+	0x09, 0x00, 0x04, 0x00, 0x08, 0x00, 0x45, 0x00,
+	0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x40, 0x11,
+	0x00, 0x00, 0x0A, 0x00, 0x00, 0x01, 0x0A, 0x00,
+	0x00, 0x02, 0x30, 0x39, 0x12, 0xB5, 0x00, 0x00,
+	0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x12,
+	0x34, 0x00, 0x00, 0x00, 0x09, 0x00, 0x05, 0x01,
+	0x00, 0x00, 0x09, 0x00, 0x04, 0x01, 0x08, 0x00,
+	0x45, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+	0x40, 0x11, 0x00, 0x00, 0xC0, 0xA8, 0x00, 0x01,
+	0xC0, 0xA8, 0x00, 0x02, 0x04, 0xD2, 0x16, 0x2E,
+	0x00, 0x00, 0x00, 0x00
+};
+
+/** Offset of inner IPv4 header in VXLAN test packet */
+#define TEST_VXLAN_INNER_L3_OFFSET 64
+
+static void set_ipv4_udp_len(uint8_t *data, uint32_t l3_offset, uint32_t len)
+{
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(data + l3_offset);
+	odph_udphdr_t *udp = (odph_udphdr_t *)(data + l3_offset +
+					       ODPH_IPV4HDR_LEN);
+
+	ip->tot_len = odp_cpu_to_be_16(len - l3_offset);
+	udp->length = odp_cpu_to_be_16(len - l3_offset - ODPH_IPV4HDR_LEN);
+}
+
+static void create_parse_packets(const uint8_t *hdr, uint32_t hdr_len,
+				 int num)
+{
+	int i;
+	uint32_t len = gbl_args->pkt.len;
+	uint8_t *data = gbl_args->data_tbl[0];
+	odp_packet_t *pkt_tbl = gbl_args->pkt_tbl;
+
+	if (len < hdr_len)
+		len = hdr_len;
+
+	memcpy(data, hdr, hdr_len);
+	set_ipv4_udp_len(data, ODPH_ETHHDR_LEN, len);
+	if (hdr_len > TEST_VXLAN_INNER_L3_OFFSET)
+		set_ipv4_udp_len(data, TEST_VXLAN_INNER_L3_OFFSET, len);
+
+	allocate_test_packets(len, pkt_tbl, num);
+
+	for (i = 0; i < num; i++) {
+		if (odp_packet_copy_from_mem(pkt_tbl[i], 0, hdr_len, data))
+			LOG_ABORT("Copying test packet headers failed\n");
+	}
+}
+
+static void create_udp_packets(void)
+{
+	create_parse_packets(test_udp_hdr, sizeof(test_udp_hdr),
+			     TEST_REPEAT_COUNT);
+}
+
+static void create_udp_packets_multi(void)
+{
+	create_parse_packets(test_udp_hdr, sizeof(test_udp_hdr),
+			     TEST_REPEAT_COUNT * gbl_args->appl.burst_size);
+}
+
+static void create_fwd_packets(void)
+{
+	odp_packet_parse_param_t param;
+	int i;
+
+	create_parse_packets(test_udp_hdr, sizeof(test_udp_hdr),
+			     TEST_REPEAT_COUNT);
+
+	param.last_layer = ODP_PROTO_LAYER_ALL;
+
+	for (i = 0; i < TEST_REPEAT_COUNT; i++) {
+		if (odp_packet_parse(gbl_args->pkt_tbl[i], &param))
+			LOG_ABORT("Parsing test packet failed\n");
+	}
+}
+
+static void create_vxlan_packets(void)
+{
+	create_parse_packets(test_vxlan_hdr, sizeof(test_vxlan_hdr),
+			     TEST_REPEAT_COUNT);
+}
+
+static void create_vxlan_packets_multi(void)
+{
+	create_parse_packets(test_vxlan_hdr, sizeof(test_vxlan_hdr),
+			     TEST_REPEAT_COUNT * gbl_args->appl.burst_size);
+}
+
 static int bench_empty(void)
 {
 	int i;
@@ -1212,6 +1414,68 @@ static int bench_packet_ts_set(void)
 	return i;
 }
 
+static int bench_packet_parse(void)
+{
+	odp_packet_parse_param_t param;
+	int i;
+	int ret = 0;
+
+	param.last_layer = ODP_PROTO_LAYER_ALL;
+
+	for (i = 0; i < TEST_REPEAT_COUNT; i++)
+		ret += odp_packet_parse(gbl_args->pkt_tbl[i], &param);
+
+	return !ret;
+}
+
+static int bench_packet_parse_multi(void)
+{
+	odp_packet_parse_param_t param;
+	int burst_size = gbl_args->appl.burst_size;
+	odp_packet_t *pkt_tbl = gbl_args->pkt_tbl;
+	int i;
+	int ret = 0;
+
+	param.last_layer = ODP_PROTO_LAYER_ALL;
+
+	for (i = 0; i < TEST_REPEAT_COUNT; i++)
+		ret += odp_packet_parse_multi(&pkt_tbl[i * burst_size],
+					      burst_size, &param);
+
+	return ret == TEST_REPEAT_COUNT * burst_size;
+}
+
+/**
+ * Read packet metadata that receive, classification and transmit of a
+ * forwarded packet need
+ */
+static int bench_packet_forward(void)
+{
+	odp_packet_t *pkt_tbl = gbl_args->pkt_tbl;
+	int i;
+	uint32_t ret = 0;
+
+	for (i = 0; i < TEST_REPEAT_COUNT; i++) {
+		odp_packet_t pkt = pkt_tbl[i];
+
+		/* Receive */
+		ret += odp_packet_input(pkt) == ODP_PKTIO_INVALID;
+
+		/* Classify */
+		if (odp_packet_has_ipv4(pkt) && odp_packet_has_udp(pkt))
+			ret += odp_packet_l3_offset(pkt) +
+			       odp_packet_l4_offset(pkt);
+
+		/* Transmit */
+		ret += odp_packet_len(pkt);
+		gbl_args->ptr_tbl[i] = odp_packet_data(pkt);
+	}
+
+	gbl_args->output_tbl[0] = ret;
+
+	return i;
+}
+
 /**
  * Prinf usage information
  */
@@ -1225,6 +1489,8 @@ static void usage(char *progname)
 	       "\n"
 	       "Optional OPTIONS:\n"
 	       "  -b, --burst      Test packet burst size.\n"
+	       "  -c, --cache      Evict caches before each run and report\n"
+	       "                   cache misses per call.\n"
 	       "  -i, --index      Benchmark index to run indefinitely.\n"
 	       "  -h, --help       Display help and exit.\n\n"
 	       "\n", NO_PATH(progname), NO_PATH(progname));
@@ -1243,12 +1509,13 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 	int long_index;
 	static const struct option longopts[] = {
 		{"burst", required_argument, NULL, 'b'},
+		{"cache", no_argument, NULL, 'c'},
 		{"help", no_argument, NULL, 'h'},
 		{"index", required_argument, NULL, 'i'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts =  "b:i:h";
+	static const char *shortopts =  "b:ci:h";
 
 	/* Let helper collect its own arguments (e.g. --odph_proc) */
 	odph_parse_options(argc, argv, shortopts, longopts);
@@ -1257,6 +1524,7 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 
 	appl_args->bench_idx = 0; /* Run all benchmarks */
 	appl_args->burst_size = TEST_DEF_BURST;
+	appl_args->cache_miss = 0;
 
 	while (1) {
 		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
@@ -1268,6 +1536,9 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		case 'b':
 			appl_args->burst_size = atoi(optarg);
 			break;
+		case 'c':
+			appl_args->cache_miss = 1;
+			break;
 		case 'h':
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -1445,6 +1716,17 @@ bench_info_t test_suite[] = {
 		BENCH_INFO(bench_packet_ts, create_packets, free_packets, NULL),
 		BENCH_INFO(bench_packet_ts_set, create_packets, free_packets,
 			   NULL),
+		BENCH_INFO(bench_packet_parse, create_udp_packets, free_packets,
+			   "bench_packet_parse_udp"),
+		BENCH_INFO(bench_packet_parse_multi, create_udp_packets_multi,
+			   free_packets_multi, "bench_packet_parse_multi_udp"),
+		BENCH_INFO(bench_packet_parse, create_vxlan_packets,
+			   free_packets, "bench_packet_parse_vxlan"),
+		BENCH_INFO(bench_packet_parse_multi, create_vxlan_packets_multi,
+			   free_packets_multi,
+			   "bench_packet_parse_multi_vxlan"),
+		BENCH_INFO(bench_packet_forward, create_fwd_packets,
+			   free_packets, NULL),
 };
 
 /**
@@ -1499,6 +1781,14 @@ int main(int argc, char *argv[])
 	/* Parse and store the application arguments */
 	parse_args(argc, argv, &gbl_args->appl);
 
+	if (gbl_args->appl.cache_miss) {
+		cache_flush_buf = malloc(TEST_CACHE_FLUSH_SIZE);
+		if (cache_flush_buf == NULL) {
+			LOG_ERR("Error: cache flush buffer alloc failed.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	/* Print both system and application information */
 	print_info(NO_PATH(argv[0]), &gbl_args->appl);
 
@@ -1587,6 +1877,8 @@ int main(int argc, char *argv[])
 
 	ret = gbl_args->bench_failed;
 
+	free(cache_flush_buf);
+
 	if (odp_pool_destroy(gbl_args->pool)) {
 		LOG_ERR("Error: pool destroy\n");
 		exit(EXIT_FAILURE);
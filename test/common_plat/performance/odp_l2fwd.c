@@ -104,6 +104,8 @@ typedef struct {
 	int src_change;		/**< Change source eth addresses */
 	int error_check;        /**< Check packet errors */
 	int sched_mode;         /**< Scheduler mode */
+	int poll_affinity;      /**< Poll each input queue from one thread */
+	int vector_size;        /**< Packet vector size, 0: no vectors */
 } appl_args_t;
 
 static int exit_threads;	/**< Break workers loop if set to 1 */
@@ -181,6 +183,9 @@ typedef struct {
 	 *  mode. */
 	uint8_t dst_port_from_idx[MAX_PKTIO_INDEXES];
 
+	/** Packet vector pool. Used by the sched mode. */
+	odp_pool_t vector_pool;
+
 } args_t;
 
 /** Global pointer to args */
@@ -276,6 +281,68 @@ static inline int event_queue_send(odp_queue_t queue, odp_packet_t *pkt_tbl,
 	return sent;
 }
 
+/**
+ * Forward a burst of scheduled packets
+ *
+ * Packets of a burst are from the same input queue and thus from the same
+ * interface.
+ *
+ * @param pkt_tbl          Array of packets, modified when dropping errors
+ * @param pkts             Number of packets in pkt_tbl[]
+ * @param stats            Thread statistics
+ * @param pktout           Output queues of the interfaces
+ * @param tx_queue         Output event queues of the interfaces
+ * @param use_event_queue  Send through output event queues
+ */
+static inline void sched_forward(odp_packet_t pkt_tbl[], int pkts,
+				 stats_t *stats, odp_pktout_queue_t pktout[],
+				 odp_queue_t tx_queue[], int use_event_queue)
+{
+	int sent;
+	unsigned tx_drops;
+	int src_idx, dst_idx;
+	int i;
+
+	if (gbl_args->appl.error_check) {
+		int rx_drops;
+
+		/* Drop packets with errors */
+		rx_drops = drop_err_pkts(pkt_tbl, pkts);
+
+		if (odp_unlikely(rx_drops)) {
+			stats->s.rx_drops += rx_drops;
+			if (pkts == rx_drops)
+				return;
+
+			pkts -= rx_drops;
+		}
+	}
+
+	/* packets from the same queue are from the same interface */
+	src_idx = odp_packet_input_index(pkt_tbl[0]);
+	assert(src_idx >= 0);
+	dst_idx = gbl_args->dst_port_from_idx[src_idx];
+	fill_eth_addrs(pkt_tbl, pkts, dst_idx);
+
+	if (odp_unlikely(use_event_queue))
+		sent = event_queue_send(tx_queue[dst_idx], pkt_tbl, pkts);
+	else
+		sent = odp_pktout_send(pktout[dst_idx], pkt_tbl, pkts);
+
+	sent     = odp_unlikely(sent < 0) ? 0 : sent;
+	tx_drops = pkts - sent;
+
+	if (odp_unlikely(tx_drops)) {
+		stats->s.tx_drops += tx_drops;
+
+		/* Drop rejected packets */
+		for (i = sent; i < pkts; i++)
+			odp_packet_free(pkt_tbl[i]);
+	}
+
+	stats->s.packets += pkts;
+}
+
 /**
  * Packet IO worker thread using scheduled queues
  *
@@ -285,7 +352,6 @@ static int run_worker_sched_mode(void *arg)
 {
 	int pkts;
 	int thr;
-	int dst_idx;
 	int i;
 	int pktio, num_pktio;
 	odp_pktout_queue_t pktout[MAX_PKTIOS];
@@ -293,6 +359,7 @@ static int run_worker_sched_mode(void *arg)
 	thread_args_t *thr_args = arg;
 	stats_t *stats = thr_args->stats;
 	int use_event_queue = gbl_args->appl.out_mode;
+	int use_vector = gbl_args->appl.vector_size;
 	pktin_mode_t in_mode = gbl_args->appl.in_mode;
 
 	thr = odp_thread_id();
@@ -309,10 +376,11 @@ static int run_worker_sched_mode(void *arg)
 		pktout[pktio]   = thr_args->pktio[pktio].pktout;
 	}
 
-	printf("[%02i] PKTIN_SCHED_%s, %s\n", thr,
+	printf("[%02i] PKTIN_SCHED_%s, %s%s\n", thr,
 	       (in_mode == SCHED_PARALLEL) ? "PARALLEL" :
 	       ((in_mode == SCHED_ATOMIC) ? "ATOMIC" : "ORDERED"),
-	       (use_event_queue) ? "PKTOUT_QUEUE" : "PKTOUT_DIRECT");
+	       (use_event_queue) ? "PKTOUT_QUEUE" : "PKTOUT_DIRECT",
+	       (use_vector) ? ", VECTOR" : "");
 
 	odp_barrier_wait(&barrier);
 
@@ -320,9 +388,7 @@ static int run_worker_sched_mode(void *arg)
 	while (!exit_threads) {
 		odp_event_t  ev_tbl[MAX_PKT_BURST];
 		odp_packet_t pkt_tbl[MAX_PKT_BURST];
-		int sent;
-		unsigned tx_drops;
-		int src_idx;
+		int num_pkt = 0;
 
 		pkts = odp_schedule_multi(NULL, ODP_SCHED_NO_WAIT, ev_tbl,
 					  MAX_PKT_BURST);
@@ -330,48 +396,41 @@ static int run_worker_sched_mode(void *arg)
 		if (pkts <= 0)
 			continue;
 
-		for (i = 0; i < pkts; i++)
-			pkt_tbl[i] = odp_packet_from_event(ev_tbl[i]);
-
-		if (gbl_args->appl.error_check) {
-			int rx_drops;
-
-			/* Drop packets with errors */
-			rx_drops = drop_err_pkts(pkt_tbl, pkts);
+		if (odp_likely(!use_vector)) {
+			for (i = 0; i < pkts; i++)
+				pkt_tbl[i] = odp_packet_from_event(ev_tbl[i]);
 
-			if (odp_unlikely(rx_drops)) {
-				stats->s.rx_drops += rx_drops;
-				if (pkts == rx_drops)
-					continue;
-
-				pkts -= rx_drops;
-			}
+			sched_forward(pkt_tbl, pkts, stats, pktout, tx_queue,
+				      use_event_queue);
+			continue;
 		}
 
-		/* packets from the same queue are from the same interface */
-		src_idx = odp_packet_input_index(pkt_tbl[0]);
-		assert(src_idx >= 0);
-		dst_idx = gbl_args->dst_port_from_idx[src_idx];
-		fill_eth_addrs(pkt_tbl, pkts, dst_idx);
-
-		if (odp_unlikely(use_event_queue))
-			sent = event_queue_send(tx_queue[dst_idx], pkt_tbl,
-						pkts);
-		else
-			sent = odp_pktout_send(pktout[dst_idx], pkt_tbl, pkts);
+		/* Forward packet vectors directly from their tables and
+		 * collect packet events into a burst of their own */
+		for (i = 0; i < pkts; i++) {
+			odp_packet_vector_t pktv;
+			odp_packet_t *vec_tbl;
+			uint32_t num;
+
+			if (odp_event_type(ev_tbl[i]) == ODP_EVENT_PACKET) {
+				pkt_tbl[num_pkt++] =
+					odp_packet_from_event(ev_tbl[i]);
+				continue;
+			}
 
-		sent     = odp_unlikely(sent < 0) ? 0 : sent;
-		tx_drops = pkts - sent;
+			pktv = odp_packet_vector_from_event(ev_tbl[i]);
+			num  = odp_packet_vector_tbl(pktv, &vec_tbl);
 
-		if (odp_unlikely(tx_drops)) {
-			stats->s.tx_drops += tx_drops;
+			if (num)
+				sched_forward(vec_tbl, num, stats, pktout,
+					      tx_queue, use_event_queue);
 
-			/* Drop rejected packets */
-			for (i = sent; i < pkts; i++)
-				odp_packet_free(pkt_tbl[i]);
+			odp_packet_vector_free(pktv);
 		}
 
-		stats->s.packets += pkts;
+		if (num_pkt)
+			sched_forward(pkt_tbl, num_pkt, stats, pktout,
+				      tx_queue, use_event_queue);
 	}
 
 	/* Make sure that latest stat writes are visible to other threads */
@@ -651,6 +710,20 @@ static int create_pktio(const char *dev, int idx, int num_rx, int num_tx,
 		pktin_param.queue_param.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
 		pktin_param.queue_param.sched.sync  = sync_mode;
 		pktin_param.queue_param.sched.group = ODP_SCHED_GROUP_ALL;
+		pktin_param.poll_affinity.per_thread =
+			gbl_args->appl.poll_affinity;
+
+		if (gbl_args->appl.vector_size) {
+			if (!capa.vector.supported) {
+				LOG_ERR("Error: no packet vectors %s\n", dev);
+				return -1;
+			}
+
+			pktin_param.vector.enable   = 1;
+			pktin_param.vector.pool     = gbl_args->vector_pool;
+			pktin_param.vector.max_size =
+				gbl_args->appl.vector_size;
+		}
 	}
 
 	if (num_rx > (int)capa.max_input_queues) {
@@ -1048,6 +1121,13 @@ static void usage(char *progname)
 	       "                    Requires also the -d flag to be set\n"
 	       "  -e, --error_check 0: Don't check packet errors (default)\n"
 	       "                    1: Check packet errors\n"
+	       "  -p, --poll_affinity 0: Any thread polls any input queue (default)\n"
+	       "                      1: Each input queue is polled by a single thread\n"
+	       "                      Scheduler modes only. Use e.g. 'perf stat -e\n"
+	       "                      cache-misses' to compare cache behaviour.\n"
+	       "  -v, --vector <size>  Receive packets as packet vectors of up to\n"
+	       "                       <size> packets. Scheduler modes only.\n"
+	       "                       0: Packet events (default)\n"
 	       "  -h, --help           Display help and exit.\n\n"
 	       "\n", NO_PATH(progname), NO_PATH(progname), MAX_PKTIOS
 	    );
@@ -1079,11 +1159,13 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		{"dst_change", required_argument, NULL, 'd'},
 		{"src_change", required_argument, NULL, 's'},
 		{"error_check", required_argument, NULL, 'e'},
+		{"poll_affinity", required_argument, NULL, 'p'},
+		{"vector", required_argument, NULL, 'v'},
 		{"help", no_argument, NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts =  "+c:+t:+a:i:m:o:r:d:s:e:h";
+	static const char *shortopts =  "+c:+t:+a:i:m:o:r:d:s:e:p:v:h";
 
 	/* let helper collect its own arguments (e.g. --odph_proc) */
 	odph_parse_options(argc, argv, shortopts, longopts);
@@ -1093,6 +1175,8 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 	appl_args->dst_change = 1; /* change eth dst address by default */
 	appl_args->src_change = 1; /* change eth src address by default */
 	appl_args->error_check = 0; /* don't check packet errors by default */
+	appl_args->poll_affinity = 0; /* any thread polls any queue */
+	appl_args->vector_size = 0; /* packets are received as packet events */
 
 	opterr = 0; /* do not issue errors on helper options */
 
@@ -1217,6 +1301,12 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		case 'e':
 			appl_args->error_check = atoi(optarg);
 			break;
+		case 'p':
+			appl_args->poll_affinity = atoi(optarg);
+			break;
+		case 'v':
+			appl_args->vector_size = atoi(optarg);
+			break;
 		case 'h':
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -1287,6 +1377,9 @@ static void print_info(char *progname, appl_args_t *appl_args)
 	else
 		printf("PKTOUT_DIRECT");
 
+	if (appl_args->vector_size)
+		printf(", VECTOR %i", appl_args->vector_size);
+
 	printf("\n\n");
 	fflush(NULL);
 }
@@ -1355,6 +1448,10 @@ int main(int argc, char *argv[])
 	if (sched_mode(gbl_args->appl.in_mode))
 		gbl_args->appl.sched_mode = 1;
 
+	/* Packet vectors are delivered only through the scheduler */
+	if (!gbl_args->appl.sched_mode)
+		gbl_args->appl.vector_size = 0;
+
 	/* Print both system and application information */
 	print_info(NO_PATH(argv[0]), &gbl_args->appl);
 
@@ -1393,6 +1490,24 @@ int main(int argc, char *argv[])
 	}
 	odp_pool_print(pool);
 
+	/* Create packet vector pool */
+	gbl_args->vector_pool = ODP_POOL_INVALID;
+
+	if (gbl_args->appl.vector_size) {
+		odp_pool_param_init(&params);
+		params.vector.num      = SHM_PKT_POOL_SIZE;
+		params.vector.max_size = gbl_args->appl.vector_size;
+		params.type            = ODP_POOL_VECTOR;
+
+		gbl_args->vector_pool = odp_pool_create("vector pool",
+							&params);
+
+		if (gbl_args->vector_pool == ODP_POOL_INVALID) {
+			LOG_ERR("Error: vector pool create failed.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	if (odp_pktio_max_index() >= MAX_PKTIO_INDEXES)
 		LOG_DBG("Warning: max pktio index (%u) is too large\n",
 			odp_pktio_max_index());
@@ -1511,6 +1626,12 @@ int main(int argc, char *argv[])
 		exit(EXIT_FAILURE);
 	}
 
+	if (gbl_args->vector_pool != ODP_POOL_INVALID &&
+	    odp_pool_destroy(gbl_args->vector_pool)) {
+		LOG_ERR("Error: vector pool destroy\n");
+		exit(EXIT_FAILURE);
+	}
+
 	if (odp_shm_free(shm)) {
 		LOG_ERR("Error: shm free\n");
 		exit(EXIT_FAILURE);
@@ -138,6 +138,7 @@ typedef struct {
 	int num_rx_q;		/**< Number of input queues per interface */
 	int num_flows;		/**< Number of packet flows */
 	int extra_rounds;	/**< Number of extra input processing rounds */
+	int var_rounds;		/**< Max number of random extra rounds */
 	char **if_names;	/**< Array of pointers to interface names */
 	odph_ethaddr_t addrs[MAX_PKTIOS]; /**< Array of dst addresses */
 	pktin_mode_t in_mode;	/**< Packet input mode */
@@ -148,6 +149,9 @@ typedef struct {
 
 static int exit_threads;	/**< Break workers loop if set to 1 */
 
+/** Random state for variable input processing */
+static __thread uint32_t var_seed = 1;
+
 /**
  * Queue context
  */
@@ -452,6 +456,7 @@ static inline void process_input(odp_event_t ev_tbl[], int num, stats_t *stats,
 		odp_packet_t pkt;
 		packet_hdr_t hdr;
 		int  flow_idx;
+		int  rounds;
 
 		pkt = odp_packet_from_event(ev_tbl[i]);
 
@@ -475,7 +480,17 @@ static inline void process_input(odp_event_t ev_tbl[], int num, stats_t *stats,
 		flow_tbl[pkts] = flow;
 
 		/* Simulate "fat pipe" processing by generating extra work */
-		for (j = 0; j < gbl_args->appl.extra_rounds; j++)
+		rounds = gbl_args->appl.extra_rounds;
+
+		/* Vary processing time per packet, so that packets complete
+		 * out of order */
+		if (gbl_args->appl.var_rounds) {
+			var_seed = var_seed * 1103515245 + 12345;
+			rounds += (var_seed >> 16) %
+				  (gbl_args->appl.var_rounds + 1);
+		}
+
+		for (j = 0; j < rounds; j++)
 			flow->crc = dummy_hash_crc32c(odp_packet_data(pkt),
 						      odp_packet_len(pkt), 0);
 		pkts++;
@@ -819,6 +834,8 @@ static void usage(char *progname)
 	       "  -r, --num_rx_q    Number of RX queues per interface\n"
 	       "  -f, --num_flows   Number of packet flows\n"
 	       "  -e, --extra_input <number>  Number of extra input processing rounds\n"
+	       "  -v, --var_input <number>    Max number of random extra input processing\n"
+	       "                              rounds added per packet (default 0)\n"
 	       "  -c, --count <number>        CPU count.\n"
 	       "  -t, --time  <number>        Time in seconds to run.\n"
 	       "  -a, --accuracy <number>     Statistics print interval in seconds\n"
@@ -854,11 +871,12 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		{"num_rx_q", required_argument, NULL, 'r'},
 		{"num_flows", required_argument, NULL, 'f'},
 		{"extra_input", required_argument, NULL, 'e'},
+		{"var_input", required_argument, NULL, 'v'},
 		{"help", no_argument, NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts =  "+c:+t:+a:i:m:d:r:f:e:h";
+	static const char *shortopts =  "+c:+t:+a:i:m:d:r:f:e:v:h";
 
 	/* let helper collect its own arguments (e.g. --odph_proc) */
 	odph_parse_options(argc, argv, shortopts, longopts);
@@ -868,6 +886,7 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 	appl_args->num_rx_q = DEF_NUM_RX_QUEUES;
 	appl_args->num_flows = DEF_NUM_FLOWS;
 	appl_args->extra_rounds = DEF_EXTRA_ROUNDS;
+	appl_args->var_rounds = 0;
 
 	opterr = 0; /* do not issue errors on helper options */
 
@@ -983,6 +1002,9 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		case 'e':
 			appl_args->extra_rounds = atoi(optarg);
 			break;
+		case 'v':
+			appl_args->var_rounds = atoi(optarg);
+			break;
 		case 'h':
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -1004,6 +1026,9 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		exit(EXIT_FAILURE);
 	}
 
+	if (appl_args->var_rounds < 0)
+		appl_args->var_rounds = 0;
+
 	if (appl_args->if_count == 0 || appl_args->num_flows == 0 ||
 	    appl_args->num_rx_q == 0) {
 		usage(argv[0]);
@@ -1249,11 +1274,12 @@ int main(int argc, char *argv[])
 	       "Input queues: %d\n"
 	       "Mode:         %s\n"
 	       "Flows:        %d\n"
-	       "Extra rounds: %d\n\n", gbl_args->appl.num_rx_q,
+	       "Extra rounds: %d\n"
+	       "Var rounds:   %d\n\n", gbl_args->appl.num_rx_q,
 	       (in_mode == SCHED_ATOMIC) ? "PKTIN_SCHED_ATOMIC" :
 	       (in_mode == SCHED_PARALLEL ? "PKTIN_SCHED_PARALLEL" :
 	       "PKTIN_SCHED_ORDERED"), gbl_args->appl.num_flows,
-	       gbl_args->appl.extra_rounds);
+	       gbl_args->appl.extra_rounds, gbl_args->appl.var_rounds);
 
 	memset(thread_tbl, 0, sizeof(thread_tbl));
 
@@ -0,0 +1,623 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_sched_groups.c  ODP schedule group scalability benchmark
+ *
+ * Creates many schedule groups with scheduled queues in each. Every worker
+ * thread joins only a few of the groups, so most of the queues are not
+ * eligible for a worker. Events received by a worker are enqueued back to
+ * the source queue. The benchmark reports how many events and schedule calls
+ * workers manage per second.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <test_debug.h>
+
+/* ODP main header */
+#include <odp_api.h>
+
+/* ODP helper for Linux apps */
+#include <odp/helper/odph_api.h>
+
+/* GNU lib C */
+#include <getopt.h>
+
+#define MAX_WORKERS	  64		/**< Maximum number of worker threads */
+#define MAX_GROUPS	  200		/**< Maximum number of schedule groups */
+#define MAX_QUEUES_PER_GROUP 16		/**< Maximum queues per group */
+#define MAX_BURST	  32		/**< Maximum schedule burst size */
+#define EVENT_POOL_SIZE	  (256 * 1024)	/**< Event pool size */
+#define TIME_CHECK_MASK	  0xff		/**< Read time every 256 rounds */
+
+/* Default values for command line arguments */
+#define NUM_GROUPS	  64 /**< Number of schedule groups */
+#define GROUPS_PER_THREAD  1 /**< Number of groups a worker joins */
+#define QUEUES_PER_GROUP   1 /**< Number of queues per group */
+#define EVENTS_PER_QUEUE  32 /**< Number of events per queue */
+#define BURST_SIZE	  16 /**< Schedule burst size */
+#define TEST_SEC	   2 /**< Test duration in seconds */
+
+/** Test arguments */
+typedef struct {
+	int cpu_count;		 /**< CPU count */
+	int num_groups;		 /**< Number of schedule groups */
+	int groups_per_thread;	 /**< Number of groups a worker joins */
+	int queues_per_group;	 /**< Number of queues per group */
+	int events_per_queue;	 /**< Number of events per queue */
+	int burst_size;		 /**< Schedule burst size */
+	int test_sec;		 /**< Test duration in seconds */
+	odp_schedule_sync_t sync_type; /**< Scheduler sync type */
+} test_args_t;
+
+/** Per worker statistics (cache line aligned) */
+typedef struct {
+	/** Number of received events */
+	uint64_t events ODP_ALIGNED_CACHE;
+	uint64_t calls;       /**< Number of schedule calls */
+	uint64_t empty_calls; /**< Number of calls that returned no events */
+	uint64_t nsec;        /**< Test duration */
+} test_stat_t;
+
+/** Test global variables */
+typedef struct {
+	test_stat_t	 stat[MAX_WORKERS]; /**< Worker statistics */
+	odp_barrier_t    barrier; /**< Barrier for thread synchronization */
+	odp_atomic_u32_t worker_idx; /**< Next free worker index */
+	odp_pool_t       pool;	  /**< Pool for allocating test events */
+	test_args_t      args;	  /**< Parsed command line arguments */
+	/** Schedule groups */
+	odp_schedule_group_t group[MAX_GROUPS];
+	/** Scheduled queues */
+	odp_queue_t      queue[MAX_GROUPS][MAX_QUEUES_PER_GROUP];
+} test_globals_t;
+
+/**
+ * Join or leave the schedule groups of a worker
+ *
+ * Worker 'idx' is a member of groups idx * groups_per_thread ...
+ * (idx + 1) * groups_per_thread - 1 (modulo number of groups).
+ */
+static int worker_groups(test_globals_t *globals, int idx, int join)
+{
+	odp_thrmask_t thrmask;
+	int i, grp;
+	int ret = 0;
+
+	odp_thrmask_zero(&thrmask);
+	odp_thrmask_set(&thrmask, odp_thread_id());
+
+	for (i = 0; i < globals->args.groups_per_thread; i++) {
+		grp = (idx * globals->args.groups_per_thread + i) %
+		      globals->args.num_groups;
+
+		if (join)
+			ret += odp_schedule_group_join(globals->group[grp],
+						       &thrmask);
+		else
+			ret += odp_schedule_group_leave(globals->group[grp],
+							&thrmask);
+	}
+
+	return ret;
+}
+
+/**
+ * Worker thread
+ */
+static int run_thread(void *arg ODP_UNUSED)
+{
+	odp_shm_t shm;
+	test_globals_t *globals;
+	test_stat_t *stat;
+	odp_event_t ev[MAX_BURST];
+	odp_queue_t src_queue;
+	odp_time_t start, end, cur;
+	uint64_t events = 0;
+	uint64_t calls = 0;
+	uint64_t empty_calls = 0;
+	int idx, num, sent;
+
+	shm = odp_shm_lookup("test_globals");
+	globals = odp_shm_addr(shm);
+
+	if (globals == NULL) {
+		LOG_ERR("Shared mem lookup failed\n");
+		return -1;
+	}
+
+	idx  = odp_atomic_fetch_inc_u32(&globals->worker_idx);
+	stat = &globals->stat[idx];
+
+	if (worker_groups(globals, idx, 1)) {
+		LOG_ERR("Group join failed\n");
+		return -1;
+	}
+
+	odp_barrier_wait(&globals->barrier);
+
+	start = odp_time_local();
+	end   = odp_time_sum(start,
+			     odp_time_local_from_ns(globals->args.test_sec *
+						    ODP_TIME_SEC_IN_NS));
+
+	cur = start;
+
+	while (1) {
+		num = odp_schedule_multi(&src_queue, ODP_SCHED_NO_WAIT, ev,
+					 globals->args.burst_size);
+		calls++;
+
+		if (num > 0) {
+			events += num;
+			sent = odp_queue_enq_multi(src_queue, ev, num);
+
+			if (sent < 0)
+				sent = 0;
+
+			if (odp_unlikely(sent < num)) {
+				LOG_ERR("Enqueue failed\n");
+				while (sent < num)
+					odp_event_free(ev[sent++]);
+			}
+		} else {
+			empty_calls++;
+		}
+
+		if ((calls & TIME_CHECK_MASK) == 0) {
+			cur = odp_time_local();
+
+			if (odp_time_cmp(cur, end) > 0)
+				break;
+		}
+	}
+
+	stat->nsec        = odp_time_to_ns(odp_time_diff(cur, start));
+	stat->events      = events;
+	stat->calls       = calls;
+	stat->empty_calls = empty_calls;
+
+	/* Release scheduling context and locally pre-scheduled events */
+	odp_schedule_pause();
+
+	while (1) {
+		num = odp_schedule_multi(&src_queue, ODP_SCHED_NO_WAIT, ev,
+					 MAX_BURST);
+		if (num <= 0)
+			break;
+
+		sent = odp_queue_enq_multi(src_queue, ev, num);
+		if (sent < 0)
+			sent = 0;
+		while (sent < num)
+			odp_event_free(ev[sent++]);
+	}
+
+	odp_schedule_resume();
+
+	if (worker_groups(globals, idx, 0)) {
+		LOG_ERR("Group leave failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Free all events from scheduled queues
+ *
+ * Retry to be sure that all events have been scheduled.
+ */
+static void clear_sched_queues(test_globals_t *globals)
+{
+	odp_thrmask_t thrmask;
+	odp_event_t ev;
+	uint64_t wait;
+	int i;
+
+	odp_thrmask_zero(&thrmask);
+	odp_thrmask_set(&thrmask, odp_thread_id());
+
+	for (i = 0; i < globals->args.num_groups; i++)
+		odp_schedule_group_join(globals->group[i], &thrmask);
+
+	while (1) {
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+
+		if (ev == ODP_EVENT_INVALID) {
+			wait = odp_schedule_wait_time(ODP_TIME_MSEC_IN_NS);
+			ev   = odp_schedule(NULL, wait);
+			if (ev == ODP_EVENT_INVALID)
+				break;
+		}
+
+		odp_event_free(ev);
+	}
+
+	for (i = 0; i < globals->args.num_groups; i++)
+		odp_schedule_group_leave(globals->group[i], &thrmask);
+}
+
+/**
+ * Print worker statistics
+ */
+static void print_results(test_globals_t *globals, int num_workers)
+{
+	uint64_t events = 0;
+	uint64_t calls = 0;
+	uint64_t empty = 0;
+	double ev_per_sec = 0;
+	double calls_per_sec = 0;
+	int i;
+
+	printf("\nWorker   Mevents/sec   Mcalls/sec   empty calls\n");
+	printf("-----------------------------------------------\n");
+
+	for (i = 0; i < num_workers; i++) {
+		test_stat_t *stat = &globals->stat[i];
+		double sec = (double)stat->nsec / ODP_TIME_SEC_IN_NS;
+
+		if (sec == 0)
+			continue;
+
+		printf("%6i %13.3f %12.3f %12.1f%%\n", i,
+		       stat->events / sec / 1000000,
+		       stat->calls / sec / 1000000,
+		       stat->calls ? 100.0 * stat->empty_calls / stat->calls :
+				     0.0);
+
+		events += stat->events;
+		calls  += stat->calls;
+		empty  += stat->empty_calls;
+		ev_per_sec    += stat->events / sec;
+		calls_per_sec += stat->calls / sec;
+	}
+
+	printf("-----------------------------------------------\n");
+	printf(" total %13.3f %12.3f %12.1f%%\n\n", ev_per_sec / 1000000,
+	       calls_per_sec / 1000000, calls ? 100.0 * empty / calls : 0.0);
+	printf("Events per schedule call: %.2f\n\n",
+	       calls ? (double)events / calls : 0.0);
+}
+
+/**
+ * Print usage information
+ */
+static void usage(void)
+{
+	printf("\n"
+	       "OpenDataPlane schedule group scalability benchmark.\n"
+	       "\n"
+	       "Usage: ./odp_sched_groups [options]\n"
+	       "Optional OPTIONS:\n"
+	       "  -c, --count <number>  CPU count\n"
+	       "  -g, --groups <number> Number of schedule groups (default %i)\n"
+	       "  -m, --member <number> Number of groups each worker joins\n"
+	       "                        (default %i)\n"
+	       "  -q, --queues <number> Number of queues per group (default %i)\n"
+	       "  -e, --events <number> Number of events per queue (default %i)\n"
+	       "  -b, --burst <number>  Schedule burst size (default %i)\n"
+	       "  -t, --time <sec>      Test duration in seconds (default %i)\n"
+	       "  -s, --sync  Scheduled queues' sync type\n"
+	       "               0: ODP_SCHED_SYNC_PARALLEL (default)\n"
+	       "               1: ODP_SCHED_SYNC_ATOMIC\n"
+	       "               2: ODP_SCHED_SYNC_ORDERED\n"
+	       "  -h, --help   Display help and exit.\n\n",
+	       NUM_GROUPS, GROUPS_PER_THREAD, QUEUES_PER_GROUP,
+	       EVENTS_PER_QUEUE, BURST_SIZE, TEST_SEC);
+}
+
+/**
+ * Parse arguments
+ *
+ * @param argc  Argument count
+ * @param argv  Argument vector
+ * @param args  Test arguments
+ */
+static void parse_args(int argc, char *argv[], test_args_t *args)
+{
+	int opt;
+	int long_index;
+	int i;
+
+	static const struct option longopts[] = {
+		{"count", required_argument, NULL, 'c'},
+		{"groups", required_argument, NULL, 'g'},
+		{"member", required_argument, NULL, 'm'},
+		{"queues", required_argument, NULL, 'q'},
+		{"events", required_argument, NULL, 'e'},
+		{"burst", required_argument, NULL, 'b'},
+		{"time", required_argument, NULL, 't'},
+		{"sync", required_argument, NULL, 's'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts = "+c:g:m:q:e:b:t:s:h";
+
+	/* Let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	args->num_groups = NUM_GROUPS;
+	args->groups_per_thread = GROUPS_PER_THREAD;
+	args->queues_per_group = QUEUES_PER_GROUP;
+	args->events_per_queue = EVENTS_PER_QUEUE;
+	args->burst_size = BURST_SIZE;
+	args->test_sec = TEST_SEC;
+	args->sync_type = ODP_SCHED_SYNC_PARALLEL;
+
+	opterr = 0; /* Do not issue errors on helper options */
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'c':
+			args->cpu_count = atoi(optarg);
+			break;
+		case 'g':
+			args->num_groups = atoi(optarg);
+			break;
+		case 'm':
+			args->groups_per_thread = atoi(optarg);
+			break;
+		case 'q':
+			args->queues_per_group = atoi(optarg);
+			break;
+		case 'e':
+			args->events_per_queue = atoi(optarg);
+			break;
+		case 'b':
+			args->burst_size = atoi(optarg);
+			break;
+		case 't':
+			args->test_sec = atoi(optarg);
+			break;
+		case 's':
+			i = atoi(optarg);
+			if (i == 1)
+				args->sync_type = ODP_SCHED_SYNC_ATOMIC;
+			else if (i == 2)
+				args->sync_type = ODP_SCHED_SYNC_ORDERED;
+			else
+				args->sync_type = ODP_SCHED_SYNC_PARALLEL;
+			break;
+		case 'h':
+			usage();
+			exit(EXIT_SUCCESS);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	/* Make sure arguments are valid */
+	if (args->cpu_count > MAX_WORKERS)
+		args->cpu_count = MAX_WORKERS;
+	if (args->num_groups > MAX_GROUPS)
+		args->num_groups = MAX_GROUPS;
+	if (args->queues_per_group > MAX_QUEUES_PER_GROUP)
+		args->queues_per_group = MAX_QUEUES_PER_GROUP;
+	if (args->burst_size > MAX_BURST)
+		args->burst_size = MAX_BURST;
+	if (args->groups_per_thread > args->num_groups)
+		args->groups_per_thread = args->num_groups;
+
+	if (args->num_groups < 1 || args->groups_per_thread < 1 ||
+	    args->queues_per_group < 1 || args->events_per_queue < 1 ||
+	    args->burst_size < 1 || args->test_sec < 1) {
+		printf("Bad arguments\n");
+		usage();
+		exit(EXIT_FAILURE);
+	}
+
+	if ((uint64_t)args->num_groups * args->queues_per_group *
+	    args->events_per_queue > EVENT_POOL_SIZE) {
+		printf("Too many events\n");
+		usage();
+		exit(EXIT_FAILURE);
+	}
+}
+
+/**
+ * Test main function
+ */
+int main(int argc, char *argv[])
+{
+	odp_instance_t instance;
+	odph_odpthread_t *thread_tbl;
+	odph_odpthread_params_t thr_params;
+	odp_cpumask_t cpumask;
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	odp_shm_t shm;
+	odp_thrmask_t zero_mask;
+	test_globals_t *globals;
+	test_args_t args;
+	char cpumaskstr[ODP_CPUMASK_STR_SIZE];
+	int i, j, k;
+	int ret = 0;
+	int num_workers = 0;
+
+	printf("\nODP schedule group benchmark starts\n\n");
+
+	memset(&args, 0, sizeof(args));
+	parse_args(argc, argv, &args);
+
+	/* ODP global init */
+	if (odp_init_global(&instance, NULL, NULL)) {
+		LOG_ERR("ODP global init failed.\n");
+		return -1;
+	}
+
+	/*
+	 * Init this thread. It makes also ODP calls when
+	 * setting up resources for worker threads.
+	 */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		LOG_ERR("ODP global init failed.\n");
+		return -1;
+	}
+
+	printf("\n");
+	printf("ODP system info\n");
+	printf("---------------\n");
+	printf("ODP API version:  %s\n",        odp_version_api_str());
+	printf("ODP impl name:    %s\n",        odp_version_impl_name());
+	printf("ODP impl details: %s\n",        odp_version_impl_str());
+	printf("CPU model:        %s\n",        odp_cpu_model_str());
+	printf("Cache line size:  %i\n",        odp_sys_cache_line_size());
+	printf("Max CPU count:    %i\n",        odp_cpu_count());
+
+	/* Get default worker cpumask */
+	if (args.cpu_count)
+		num_workers = args.cpu_count;
+
+	num_workers = odp_cpumask_default_worker(&cpumask, num_workers);
+	args.cpu_count = num_workers;
+
+	(void)odp_cpumask_to_str(&cpumask, cpumaskstr, sizeof(cpumaskstr));
+
+	printf("Worker threads:   %i\n", num_workers);
+	printf("First CPU:        %i\n", odp_cpumask_first(&cpumask));
+	printf("CPU mask:         %s\n", cpumaskstr);
+	printf("Groups:           %i\n", args.num_groups);
+	printf("Groups per worker: %i\n", args.groups_per_thread);
+	printf("Queues per group: %i\n", args.queues_per_group);
+	printf("Events per queue: %i\n", args.events_per_queue);
+	printf("Burst size:       %i\n\n", args.burst_size);
+
+	thread_tbl = calloc(sizeof(odph_odpthread_t), num_workers);
+	if (!thread_tbl) {
+		LOG_ERR("no memory for thread_tbl\n");
+		return -1;
+	}
+
+	shm = odp_shm_reserve("test_globals",
+			      sizeof(test_globals_t), ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		LOG_ERR("Shared memory reserve failed.\n");
+		return -1;
+	}
+
+	globals = odp_shm_addr(shm);
+	memset(globals, 0, sizeof(test_globals_t));
+	memcpy(&globals->args, &args, sizeof(test_args_t));
+	odp_atomic_init_u32(&globals->worker_idx, 0);
+
+	/*
+	 * Create event pool
+	 */
+	odp_pool_param_init(&params);
+	params.buf.size  = sizeof(uint64_t);
+	params.buf.align = 0;
+	params.buf.num   = EVENT_POOL_SIZE;
+	params.type      = ODP_POOL_BUFFER;
+
+	pool = odp_pool_create("event_pool", &params);
+
+	if (pool == ODP_POOL_INVALID) {
+		LOG_ERR("Pool create failed.\n");
+		return -1;
+	}
+	globals->pool = pool;
+
+	/*
+	 * Create groups and queues. Groups are created empty, workers join
+	 * their groups at start up.
+	 */
+	odp_thrmask_zero(&zero_mask);
+
+	for (i = 0; i < args.num_groups; i++) {
+		char name[ODP_SCHED_GROUP_NAME_LEN];
+		odp_queue_param_t param;
+
+		snprintf(name, sizeof(name), "group_%i", i);
+		globals->group[i] = odp_schedule_group_create(name, &zero_mask);
+
+		if (globals->group[i] == ODP_SCHED_GROUP_INVALID) {
+			LOG_ERR("Schedule group create failed.\n");
+			return -1;
+		}
+
+		odp_queue_param_init(&param);
+		param.type        = ODP_QUEUE_TYPE_SCHED;
+		param.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
+		param.sched.sync  = args.sync_type;
+		param.sched.group = globals->group[i];
+
+		for (j = 0; j < args.queues_per_group; j++) {
+			odp_queue_t queue;
+
+			queue = odp_queue_create(NULL, &param);
+
+			if (queue == ODP_QUEUE_INVALID) {
+				LOG_ERR("Scheduled queue create failed.\n");
+				return -1;
+			}
+
+			globals->queue[i][j] = queue;
+
+			for (k = 0; k < args.events_per_queue; k++) {
+				odp_buffer_t buf = odp_buffer_alloc(pool);
+
+				if (buf == ODP_BUFFER_INVALID) {
+					LOG_ERR("Buffer alloc failed.\n");
+					return -1;
+				}
+
+				if (odp_queue_enq(queue,
+						  odp_buffer_to_event(buf))) {
+					LOG_ERR("Queue enqueue failed.\n");
+					odp_buffer_free(buf);
+					return -1;
+				}
+			}
+		}
+	}
+
+	odp_barrier_init(&globals->barrier, num_workers);
+
+	/* Create and launch worker threads */
+	memset(&thr_params, 0, sizeof(thr_params));
+	thr_params.thr_type = ODP_THREAD_WORKER;
+	thr_params.instance = instance;
+	thr_params.start = run_thread;
+	thr_params.arg   = NULL;
+	odph_odpthreads_create(thread_tbl, &cpumask, &thr_params);
+
+	/* Wait for worker threads to terminate */
+	odph_odpthreads_join(thread_tbl);
+	free(thread_tbl);
+
+	print_results(globals, num_workers);
+
+	printf("ODP schedule group test complete\n\n");
+
+	clear_sched_queues(globals);
+
+	for (i = 0; i < args.num_groups; i++) {
+		for (j = 0; j < args.queues_per_group; j++)
+			ret += odp_queue_destroy(globals->queue[i][j]);
+
+		ret += odp_schedule_group_destroy(globals->group[i]);
+	}
+
+	ret += odp_shm_free(shm);
+	ret += odp_pool_destroy(pool);
+	ret += odp_term_local();
+	ret += odp_term_global(instance);
+
+	return ret;
+}
@@ -0,0 +1,26 @@
+#!/bin/sh
+#
+# Copyright (c) 2017, Linaro Limited
+# All rights reserved.
+#
+# SPDX-License-Identifier:	BSD-3-Clause
+#
+# Script that passes command line arguments to odp_sched_groups test when
+# launched by 'make check'
+
+TEST_DIR="${TEST_DIR:-$(dirname $0)}"
+ALL=0
+
+run()
+{
+	echo odp_sched_groups_run starts requesting $1 worker threads
+	echo ===============================================
+
+	$TEST_DIR/odp_sched_groups${EXEEXT} -c $1 $2 || exit $?
+}
+
+run 1 "-t 1"
+run $ALL "-t 1"
+run $ALL "-t 1 -g 128 -m 2"
+
+exit 0
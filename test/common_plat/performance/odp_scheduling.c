@@ -51,6 +51,7 @@ typedef struct {
 typedef struct {
 	int cpu_count;  /**< CPU count */
 	int fairness;   /**< Check fairness */
+	uint32_t queue_size; /**< Queue size, 0=implementation default */
 } test_args_t;
 
 typedef struct {
@@ -66,6 +67,9 @@ typedef struct {
 	odp_spinlock_t   lock;
 	odp_pool_t       pool;
 	int              first_thr;
+	int              num_workers;
+	odp_atomic_u64_t mp_events;
+	odp_atomic_u64_t mp_nsec;
 	test_args_t      args;
 	odp_queue_t      queue[NUM_PRIOS][QUEUES_PER_PRIO];
 	queue_context_t  queue_ctx[NUM_PRIOS][QUEUES_PER_PRIO];
@@ -328,6 +332,116 @@ static int test_plain_queue(int thr, test_globals_t *globals)
 	return 0;
 }
 
+/**
+ * @internal Test plain queue with multiple producers
+ *
+ * All threads enqueue to and dequeue bursts from a single shared queue. Each
+ * thread is both a producer and a consumer, so the number of producers equals
+ * the number of worker threads.
+ *
+ * @param thr      Thread
+ * @param globals Test shared data
+ *
+ * @return 0 if successful
+ */
+static int test_plain_queue_mp(int thr, test_globals_t *globals)
+{
+	odp_event_t ev[MULTI_BUFS_MAX];
+	odp_buffer_t buf[MULTI_BUFS_MAX];
+	odp_queue_t queue;
+	odp_time_t t1, t2;
+	uint64_t c1, c2, cycles, nsec, events;
+	uint64_t tot = 0;
+	int i, j, num, ret;
+
+	queue = odp_queue_lookup("plain_mp_queue");
+
+	if (queue == ODP_QUEUE_INVALID) {
+		printf("  [%i] Queue lookup failed.\n", thr);
+		return -1;
+	}
+
+	num = odp_buffer_alloc_multi(globals->pool, buf, MULTI_BUFS_MAX);
+
+	if (num != MULTI_BUFS_MAX) {
+		LOG_ERR("  [%i] buffer alloc failed\n", thr);
+		num = num < 0 ? 0 : num;
+		odp_buffer_free_multi(buf, num);
+		return -1;
+	}
+
+	for (i = 0; i < num; i++)
+		ev[i] = odp_buffer_to_event(buf[i]);
+
+	odp_barrier_wait(&globals->barrier);
+
+	t1 = odp_time_local();
+	c1 = odp_cpu_cycles();
+
+	for (i = 0; i < QUEUE_ROUNDS; i++) {
+		ret = odp_queue_enq_multi(queue, ev, num);
+
+		if (ret < 0) {
+			LOG_ERR("  [%i] Queue enqueue failed.\n", thr);
+			for (j = 0; j < num; j++)
+				odp_event_free(ev[j]);
+			return -1;
+		}
+
+		tot += ret;
+
+		/* Keep events that did not fit into the queue */
+		for (j = 0; j < num - ret; j++)
+			ev[j] = ev[ret + j];
+
+		num -= ret;
+
+		ret = odp_queue_deq_multi(queue, &ev[num],
+					  MULTI_BUFS_MAX - num);
+
+		if (ret > 0)
+			num += ret;
+	}
+
+	c2 = odp_cpu_cycles();
+	t2 = odp_time_local();
+
+	for (j = 0; j < num; j++)
+		odp_event_free(ev[j]);
+
+	cycles = odp_cpu_cycles_diff(c2, c1);
+	nsec   = odp_time_to_ns(odp_time_diff(t2, t1));
+
+	if (tot)
+		cycles = cycles / tot;
+
+	printf("  [%i] plain_mp    enq+deq    %6" PRIu64 " CPU cycles\n",
+	       thr, cycles);
+
+	odp_atomic_add_u64(&globals->mp_events, tot);
+	odp_atomic_max_u64(&globals->mp_nsec, nsec);
+
+	odp_barrier_wait(&globals->barrier);
+
+	if (globals->first_thr == thr) {
+		while ((num = odp_queue_deq_multi(queue, ev,
+						  MULTI_BUFS_MAX)) > 0) {
+			for (j = 0; j < num; j++)
+				odp_event_free(ev[j]);
+		}
+
+		events = odp_atomic_load_u64(&globals->mp_events);
+		nsec   = odp_atomic_load_u64(&globals->mp_nsec);
+
+		printf("\n  plain_mp %i producers, queue size %" PRIu32 ": "
+		       "%.2f M enq+deq/sec\n\n", globals->num_workers,
+		       globals->args.queue_size,
+		       nsec ? (double)events * 1000.0 / nsec : 0.0);
+	}
+
+	return 0;
+}
+
 /**
  * @internal Test scheduling of a single queue - with odp_schedule()
  *
@@ -628,6 +742,11 @@ static int run_thread(void *arg ODP_UNUSED)
 	if (test_plain_queue(thr, globals))
 		return -1;
 
+	odp_barrier_wait(barrier);
+
+	if (test_plain_queue_mp(thr, globals))
+		return -1;
+
 	/* Low prio */
 
 	odp_barrier_wait(barrier);
@@ -726,6 +845,8 @@ static void print_usage(void)
 	printf("  -c, --count <number>    CPU count, 0=all available, default=0\n");
 	printf("  -h, --help              this help\n");
 	printf("  -f, --fair              collect fairness statistics\n");
+	printf("  -q, --queue-size <num>  queue size, 0=implementation default,\n"
+	       "                          default=0\n");
 	printf("\n\n");
 }
 
@@ -744,11 +865,12 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 	static const struct option longopts[] = {
 		{"count", required_argument, NULL, 'c'},
 		{"fair", no_argument, NULL, 'f'},
+		{"queue-size", required_argument, NULL, 'q'},
 		{"help", no_argument, NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts = "+c:fh";
+	static const char *shortopts = "+c:fq:h";
 
 	/* let helper collect its own arguments (e.g. --odph_proc) */
 	odph_parse_options(argc, argv, shortopts, longopts);
@@ -769,6 +891,10 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 			args->cpu_count = atoi(optarg);
 			break;
 
+		case 'q':
+			args->queue_size = atoi(optarg);
+			break;
+
 		case 'h':
 			print_usage();
 			exit(EXIT_SUCCESS);
@@ -790,7 +916,8 @@ int main(int argc, char *argv[])
 	int num_workers;
 	odp_cpumask_t cpumask;
 	odp_pool_t pool;
-	odp_queue_t plain_queue;
+	odp_queue_t plain_queue, plain_mp_queue;
+	odp_queue_param_t plain_param;
 	int i, j;
 	odp_shm_t shm;
 	test_globals_t *globals;
@@ -881,15 +1008,25 @@ int main(int argc, char *argv[])
 	globals->pool = pool;
 
 	/*
-	 * Create a queue for plain queue test
+	 * Create queues for plain queue tests
 	 */
-	plain_queue = odp_queue_create("plain_queue", NULL);
+	odp_queue_param_init(&plain_param);
+	plain_param.size = args.queue_size;
+
+	plain_queue = odp_queue_create("plain_queue", &plain_param);
 
 	if (plain_queue == ODP_QUEUE_INVALID) {
 		LOG_ERR("Plain queue create failed.\n");
 		return -1;
 	}
 
+	plain_mp_queue = odp_queue_create("plain_mp_queue", &plain_param);
+
+	if (plain_mp_queue == ODP_QUEUE_INVALID) {
+		LOG_ERR("Plain queue create failed.\n");
+		return -1;
+	}
+
 	/*
 	 * Create queues for schedule test. QUEUES_PER_PRIO per priority.
 	 */
@@ -912,6 +1049,7 @@ int main(int argc, char *argv[])
 		param.sched.prio  = prio;
 		param.sched.sync  = ODP_SCHED_SYNC_ATOMIC;
 		param.sched.group = ODP_SCHED_GROUP_ALL;
+		param.size        = args.queue_size;
 
 		for (j = 0; j < QUEUES_PER_PRIO; j++) {
 			name[9]  = '0' + j / 10;
@@ -945,6 +1083,9 @@ int main(int argc, char *argv[])
 
 	odp_spinlock_init(&globals->lock);
 	globals->first_thr = -1;
+	globals->num_workers = num_workers;
+	odp_atomic_init_u64(&globals->mp_events, 0);
+	odp_atomic_init_u64(&globals->mp_nsec, 0);
 
 	/* Create and launch worker threads */
 	memset(&thr_params, 0, sizeof(thr_params));
@@ -971,6 +1112,7 @@ int main(int argc, char *argv[])
 
 	ret += odp_shm_free(shm);
 	ret += odp_queue_destroy(plain_queue);
+	ret += odp_queue_destroy(plain_mp_queue);
 	ret += odp_pool_destroy(pool);
 	ret += odp_term_local();
 	ret += odp_term_global(instance);
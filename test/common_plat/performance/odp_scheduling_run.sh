@@ -14,10 +14,10 @@ ALL=0
 
 run()
 {
-	echo odp_scheduling_run starts requesting $1 worker threads
+	echo odp_scheduling_run starts requesting $1 worker threads $2
 	echo ===============================================
 
-	$TEST_DIR/odp_scheduling${EXEEXT} -c $1 || ret=1
+	$TEST_DIR/odp_scheduling${EXEEXT} -c $1 $2 || ret=1
 }
 
 run 1
@@ -26,4 +26,8 @@ run 8
 run 11
 run $ALL
 
+# Ring based queues
+run 1 "-q 1024"
+run $ALL "-q 1024"
+
 exit $ret
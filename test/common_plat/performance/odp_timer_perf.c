@@ -0,0 +1,468 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_timer_perf.c  Timer pool expiry benchmark application
+ *
+ * Sets timers with timeouts spread over a range of ticks and re-arms them as
+ * timeouts are received. Repeats for each combination of timer count and
+ * resolution, and reports received timeouts per second, CPU load outside of
+ * the application thread (i.e. timer expiry) and timeout lateness. Timer
+ * pools are driven by signals, by idle schedule calls of the application
+ * thread (inline) or by a busy polling thread. Inline expiry runs in the
+ * application thread and is not included in the expiry CPU load.
+ */
+
+/* For clock_gettime */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+#include <sched.h>
+
+#include <test_debug.h>
+
+/* ODP main header */
+#include <odp_api.h>
+
+/* ODP helper for Linux apps */
+#include <odp/helper/odph_api.h>
+
+/* GNU lib C */
+#include <getopt.h>
+
+#define MAX_VALUES   16  /**< Maximum number of values per sweep option */
+#define BURST_SIZE   64  /**< Timeout dequeue burst size */
+
+/** Default values for command line arguments */
+#define DEF_NUM_TIMERS "1000,10000,100000,1000000"
+#define DEF_RES_NS     "1000000,100000"
+#define DEF_TMO_TICKS  1000
+#define DEF_TIME       3
+
+/** Get rid of path in filename - only for unix-type paths using '/' */
+#define NO_PATH(file_name) (strrchr((file_name), '/') ? \
+			    strrchr((file_name), '/') + 1 : (file_name))
+
+/** Test arguments */
+typedef struct {
+	int num_num;                      /**< Number of timer counts */
+	uint32_t num_timers[MAX_VALUES];  /**< Timer counts */
+	int num_res;                      /**< Number of resolutions */
+	uint64_t res_ns[MAX_VALUES];      /**< Resolutions in nsec */
+	uint64_t tmo_ticks;               /**< Minimum timeout in ticks */
+	int time;                         /**< Test time per round in sec */
+	odp_timer_drive_t drive;          /**< Timer pool drive mode */
+	int drive_cpu;                    /**< CPU of the polling thread */
+	uint32_t max_tmo_per_tick;        /**< Timeouts per tick, 0: no limit */
+	int per_thread;                   /**< Per thread timer pool */
+} test_args_t;
+
+/** Test results of a round */
+typedef struct {
+	uint64_t tmo;        /**< Timeouts received */
+	uint64_t late_sum;   /**< Sum of timeout lateness in ticks */
+	uint64_t late_max;   /**< Maximum timeout lateness in ticks */
+	double   nsec;       /**< Test time */
+	double   exp_load;   /**< CPU load of timer expiry */
+} test_res_t;
+
+static uint64_t cpu_time_ns(clockid_t clk)
+{
+	struct timespec ts;
+
+	clock_gettime(clk, &ts);
+	return (uint64_t)ts.tv_sec * ODP_TIME_SEC_IN_NS + ts.tv_nsec;
+}
+
+/** Timeout in [tmo_ticks, 2 * tmo_ticks) ticks, spread by a counter */
+static inline uint64_t next_tmo(const test_args_t *args, uint64_t *seq)
+{
+	*seq = *seq * 6364136223846793005ULL + 1442695040888963407ULL;
+	return args->tmo_ticks + (*seq >> 33) % args->tmo_ticks;
+}
+
+static int run_round(const test_args_t *args, uint32_t num_timers,
+		     uint64_t res_ns, test_res_t *res)
+{
+	odp_pool_param_t pool_param;
+	odp_timer_pool_param_t tp_param;
+	odp_pool_t pool;
+	odp_timer_pool_t tp;
+	odp_queue_t queue;
+	odp_timer_t *timer;
+	odp_event_t ev[BURST_SIZE];
+	odp_time_t start, end;
+	uint64_t seq = num_timers;
+	uint64_t proc0, thr0, cur_tick, late;
+	uint32_t i;
+	int num, j, ret = -1;
+
+	memset(res, 0, sizeof(test_res_t));
+
+	timer = malloc(num_timers * sizeof(odp_timer_t));
+	if (timer == NULL) {
+		LOG_ERR("Timer table alloc failed\n");
+		return -1;
+	}
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type    = ODP_POOL_TIMEOUT;
+	pool_param.tmo.num = num_timers;
+
+	pool = odp_pool_create("timer_perf_tmo", &pool_param);
+	if (pool == ODP_POOL_INVALID) {
+		LOG_ERR("Timeout pool create failed\n");
+		goto free_table;
+	}
+
+	odp_timer_pool_param_init(&tp_param);
+	tp_param.res_ns     = res_ns;
+	tp_param.min_tmo    = res_ns;
+	tp_param.max_tmo    = 2 * args->tmo_ticks * res_ns;
+	tp_param.num_timers = num_timers;
+	tp_param.priv       = 0;
+	tp_param.clk_src    = ODP_CLOCK_CPU;
+	tp_param.drive      = args->drive;
+	tp_param.drive_cpu  = args->drive_cpu;
+	tp_param.max_tmo_per_tick = args->max_tmo_per_tick;
+	tp_param.per_thread = args->per_thread;
+
+	tp = odp_timer_pool_create("timer_perf", &tp_param);
+	if (tp == ODP_TIMER_POOL_INVALID) {
+		LOG_ERR("Timer pool create failed\n");
+		goto destroy_pool;
+	}
+	odp_timer_pool_start();
+
+	queue = odp_queue_create("timer_perf", NULL);
+	if (queue == ODP_QUEUE_INVALID) {
+		LOG_ERR("Queue create failed\n");
+		goto destroy_tp;
+	}
+
+	/* First timeouts are spread over [1, 2 * tmo_ticks) */
+	for (i = 0; i < num_timers; i++) {
+		odp_timeout_t tmo = odp_timeout_alloc(pool);
+		odp_event_t tmo_ev;
+
+		timer[i] = odp_timer_alloc(tp, queue, NULL);
+
+		if (timer[i] == ODP_TIMER_INVALID ||
+		    tmo == ODP_TIMEOUT_INVALID) {
+			LOG_ERR("Timer alloc failed\n");
+			if (tmo != ODP_TIMEOUT_INVALID)
+				odp_timeout_free(tmo);
+			num_timers = i + 1;
+			goto free_timers;
+		}
+
+		tmo_ev = odp_timeout_to_event(tmo);
+
+		if (odp_timer_set_rel(timer[i], 1 + i % (2 * args->tmo_ticks),
+				      &tmo_ev) != ODP_TIMER_SUCCESS) {
+			LOG_ERR("Timer set failed\n");
+			odp_event_free(tmo_ev);
+			num_timers = i + 1;
+			goto free_timers;
+		}
+	}
+
+	proc0 = cpu_time_ns(CLOCK_PROCESS_CPUTIME_ID);
+	thr0  = cpu_time_ns(CLOCK_THREAD_CPUTIME_ID);
+	start = odp_time_local();
+	end   = odp_time_sum(start, odp_time_local_from_ns(args->time *
+							  ODP_TIME_SEC_IN_NS));
+
+	while (odp_time_cmp(end, odp_time_local()) > 0) {
+		num = odp_queue_deq_multi(queue, ev, BURST_SIZE);
+
+		if (num <= 0) {
+			odp_event_t sched_ev;
+
+			/* Leave CPU time to timer threads when sharing a
+			 * CPU, or expire inline driven timers */
+			if (args->drive != ODP_TIMER_DRIVE_INLINE) {
+				sched_yield();
+				continue;
+			}
+
+			sched_ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+			if (sched_ev != ODP_EVENT_INVALID)
+				odp_event_free(sched_ev);
+			continue;
+		}
+
+		cur_tick = odp_timer_current_tick(tp);
+
+		for (j = 0; j < num; j++) {
+			odp_timeout_t tmo = odp_timeout_from_event(ev[j]);
+
+			late = cur_tick - odp_timeout_tick(tmo);
+			res->late_sum += late;
+			if (late > res->late_max)
+				res->late_max = late;
+
+			if (odp_timer_set_rel(odp_timeout_timer(tmo),
+					      next_tmo(args, &seq), &ev[j]) !=
+			    ODP_TIMER_SUCCESS) {
+				LOG_ERR("Timer re-arm failed\n");
+				odp_event_free(ev[j]);
+			}
+		}
+
+		res->tmo += num;
+	}
+
+	/* CPU time used by other than this thread */
+	thr0  = cpu_time_ns(CLOCK_THREAD_CPUTIME_ID) - thr0;
+	proc0 = cpu_time_ns(CLOCK_PROCESS_CPUTIME_ID) - proc0;
+	res->nsec = odp_time_to_ns(odp_time_diff(odp_time_local(), start));
+	res->exp_load = (double)(proc0 - thr0) / res->nsec;
+	ret = 0;
+
+free_timers:
+	for (i = 0; i < num_timers; i++) {
+		odp_event_t tmo_ev;
+
+		if (timer[i] == ODP_TIMER_INVALID)
+			continue;
+
+		tmo_ev = odp_timer_free(timer[i]);
+		if (tmo_ev != ODP_EVENT_INVALID)
+			odp_event_free(tmo_ev);
+	}
+
+	while ((num = odp_queue_deq_multi(queue, ev, BURST_SIZE)) > 0)
+		for (j = 0; j < num; j++)
+			odp_event_free(ev[j]);
+
+	odp_queue_destroy(queue);
+destroy_tp:
+	odp_timer_pool_destroy(tp);
+destroy_pool:
+	if (odp_pool_destroy(pool)) {
+		LOG_ERR("Timeout pool destroy failed\n");
+		ret = -1;
+	}
+free_table:
+	free(timer);
+	return ret;
+}
+
+/**
+ * Prinf usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "OpenDataPlane timer pool expiry benchmark.\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -n 1000,1000000 -r 1000000,10000\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "  -n, --num <list>     Comma separated timer counts.\n"
+	       "                       Default: %s\n"
+	       "  -r, --res <list>     Comma separated timer resolutions in\n"
+	       "                       nsec. Default: %s\n"
+	       "  -m, --tmo <ticks>    Timeouts are %i to 2x%i ticks by\n"
+	       "                       default.\n"
+	       "  -t, --time <sec>     Test time per round. Default: %i\n"
+	       "  -d, --drive <mode>   Timer pool drive mode: signal, inline\n"
+	       "                       or poll. Default: signal\n"
+	       "  -c, --cpu <id>       CPU of the poll mode timer thread.\n"
+	       "                       Default: any CPU\n"
+	       "  -b, --burst <num>    Maximum timeouts delivered per tick.\n"
+	       "                       Default: 0 (no limit)\n"
+	       "  -l, --local          Per thread timer pool. Sets inline\n"
+	       "                       drive mode.\n"
+	       "  -h, --help           Display help and exit.\n\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname), DEF_NUM_TIMERS,
+	       DEF_RES_NS, DEF_TMO_TICKS, DEF_TMO_TICKS, DEF_TIME);
+}
+
+/** Parse comma separated list of values */
+static int parse_list(const char *str, uint64_t val[])
+{
+	char *end;
+	int num = 0;
+
+	while (*str && num < MAX_VALUES) {
+		val[num++] = strtoull(str, &end, 0);
+
+		if (*end != ',')
+			break;
+
+		str = end + 1;
+	}
+
+	return num;
+}
+
+static void parse_args(int argc, char *argv[], test_args_t *args)
+{
+	int opt, i;
+	int long_index;
+	uint64_t val[MAX_VALUES];
+	const char *num_str = DEF_NUM_TIMERS;
+	const char *res_str = DEF_RES_NS;
+	static const struct option longopts[] = {
+		{"num", required_argument, NULL, 'n'},
+		{"res", required_argument, NULL, 'r'},
+		{"tmo", required_argument, NULL, 'm'},
+		{"time", required_argument, NULL, 't'},
+		{"drive", required_argument, NULL, 'd'},
+		{"cpu", required_argument, NULL, 'c'},
+		{"burst", required_argument, NULL, 'b'},
+		{"local", no_argument, NULL, 'l'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts =  "n:r:m:t:d:c:b:lh";
+
+	/* Let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	opterr = 0; /* Do not issue errors on helper options */
+
+	args->tmo_ticks = DEF_TMO_TICKS;
+	args->time      = DEF_TIME;
+	args->drive     = ODP_TIMER_DRIVE_SIGNAL;
+	args->drive_cpu = -1;
+	args->max_tmo_per_tick = 0;
+	args->per_thread = 0;
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'n':
+			num_str = optarg;
+			break;
+		case 'r':
+			res_str = optarg;
+			break;
+		case 'm':
+			args->tmo_ticks = strtoull(optarg, NULL, 0);
+			break;
+		case 't':
+			args->time = atoi(optarg);
+			break;
+		case 'd':
+			if (strcmp(optarg, "inline") == 0) {
+				args->drive = ODP_TIMER_DRIVE_INLINE;
+			} else if (strcmp(optarg, "poll") == 0) {
+				args->drive = ODP_TIMER_DRIVE_POLL;
+			} else if (strcmp(optarg, "signal") != 0) {
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'c':
+			args->drive_cpu = atoi(optarg);
+			break;
+		case 'b':
+			args->max_tmo_per_tick = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			args->per_thread = 1;
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	args->num_num = parse_list(num_str, val);
+	for (i = 0; i < args->num_num; i++)
+		args->num_timers[i] = val[i];
+
+	args->num_res = parse_list(res_str, args->res_ns);
+
+	if (args->per_thread)
+		args->drive = ODP_TIMER_DRIVE_INLINE;
+
+	if (args->num_num == 0 || args->num_res == 0 ||
+	    args->tmo_ticks == 0 || args->time < 1) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	optind = 1;		/* Reset 'extern optind' from the getopt lib */
+}
+
+int main(int argc, char *argv[])
+{
+	odp_instance_t instance;
+	test_args_t args;
+	test_res_t res;
+	int i, j, ret = 0;
+
+	parse_args(argc, argv, &args);
+
+	if (odp_init_global(&instance, NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("\nTimeouts %" PRIu64 " to %" PRIu64 " ticks, %i sec per "
+	       "round\n\n", args.tmo_ticks, 2 * args.tmo_ticks - 1, args.time);
+	printf("  res (ns)    timers     tmo/sec   expiry cpu   "
+	       "late avg   late max\n");
+	printf("  --------------------------------------------------"
+	       "--------------------\n");
+
+	for (i = 0; i < args.num_res && ret == 0; i++) {
+		for (j = 0; j < args.num_num; j++) {
+			if (run_round(&args, args.num_timers[j], args.res_ns[i],
+				      &res)) {
+				ret = -1;
+				break;
+			}
+
+			printf("%10" PRIu64 " %9" PRIu32 " %11.0f %11.1f%% "
+			       "%10.2f %10" PRIu64 "\n", args.res_ns[i],
+			       args.num_timers[j],
+			       res.tmo * (ODP_TIME_SEC_IN_NS / res.nsec),
+			       100.0 * res.exp_load,
+			       res.tmo ? (double)res.late_sum / res.tmo : 0.0,
+			       res.late_max);
+		}
+	}
+
+	printf("\n");
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: term local failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		LOG_ERR("Error: term global failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret;
+}
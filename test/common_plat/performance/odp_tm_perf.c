@@ -0,0 +1,633 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_tm_perf.c  Traffic manager packet rate benchmark application
+ *
+ * Creates a TM system per egress port, each with a hierarchy like the one of
+ * example/traffic_mgmt: a shaped port node, a node per service class and a
+ * number of shaped tm_queues per class. Producer threads keep the TM systems
+ * loaded with packets and an egress function counts packets leaving each
+ * port. Repeats for each port count and reports the shaped packet rate in
+ * total and per port. TM systems get a service thread (and CPU) of their own
+ * as long as there are enough CPUs, so the port count is also the number of
+ * TM cores.
+ */
+
+/* For usleep */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include <test_debug.h>
+
+/* ODP main header */
+#include <odp_api.h>
+
+/* ODP helper for Linux apps */
+#include <odp/helper/odph_api.h>
+
+/* GNU lib C */
+#include <getopt.h>
+
+#define MAX_VALUES      16    /**< Maximum number of values per sweep option */
+#define MAX_PORTS       32    /**< Maximum number of ports (TM systems) */
+#define NUM_CLASSES     4     /**< Service classes per port */
+#define MAX_QUEUES      64    /**< Maximum tm_queues per service class */
+#define PKT_LEN         64    /**< Packet length */
+#define LEN_ADJUST      20    /**< Ethernet preamble and inter frame gap */
+#define BURST_SIZE      32    /**< Packet alloc and enqueue burst size */
+#define MAX_INFLIGHT    2048  /**< Maximum packets in a TM system */
+#define WARMUP_US       100000
+
+/** Default values for command line arguments */
+#define DEF_PORTS       "1,2,4,8"
+#define DEF_QUEUES      4
+#define DEF_RATE_MBPS   40000
+#define DEF_TIME        3
+
+/** Get rid of path in filename - only for unix-type paths using '/' */
+#define NO_PATH(file_name) (strrchr((file_name), '/') ? \
+			    strrchr((file_name), '/') + 1 : (file_name))
+
+/** Test arguments */
+typedef struct {
+	int num_ports;                /**< Number of port counts */
+	uint32_t ports[MAX_VALUES];   /**< Port counts */
+	uint32_t queues;              /**< tm_queues per service class */
+	uint64_t rate_mbps;           /**< Port shaper rate in Mbps */
+	uint32_t burst;               /**< TM max burst, 0: default */
+	int time;                     /**< Test time per round in sec */
+} test_args_t;
+
+/** Egress port state */
+typedef struct ODP_ALIGNED_CACHE {
+	odp_tm_t tm;                                     /**< TM system */
+	odp_tm_node_t port_node;                         /**< Port node */
+	odp_tm_node_t class_node[NUM_CLASSES];           /**< Class nodes */
+	odp_tm_queue_t queue[NUM_CLASSES * MAX_QUEUES];  /**< tm_queues */
+	uint32_t num_queues;                             /**< Number of queues */
+	uint32_t next_queue;                             /**< Next enq queue */
+	uint64_t enq;                                    /**< Enqueued packets */
+	uint64_t drops;                                  /**< Failed enqueues */
+
+	/** Packets out of the TM system, updated by the TM thread */
+	odp_atomic_u64_t egress ODP_ALIGNED_CACHE;
+} port_t;
+
+/** Test global state */
+typedef struct {
+	test_args_t args;                 /**< Test arguments */
+	odp_pool_t pool;                  /**< Packet pool */
+	odp_tm_shaper_t port_shaper;      /**< Port node shaper profile */
+	odp_tm_shaper_t queue_shaper;     /**< tm_queue shaper profile */
+	odp_atomic_u32_t stop;            /**< Stop producers */
+	odp_atomic_u32_t producer_idx;    /**< Next producer index */
+	uint32_t num_ports;               /**< Ports in this round */
+	uint32_t num_producers;           /**< Producers in this round */
+	port_t port[MAX_PORTS];           /**< Egress ports */
+} test_global_t;
+
+/** Test results of a round */
+typedef struct {
+	uint64_t pkts;       /**< Packets out of all TM systems */
+	uint64_t drops;      /**< Failed enqueues */
+	double   nsec;       /**< Test time */
+} test_res_t;
+
+static test_global_t *gbl;
+
+static void egress_fcn(odp_packet_t pkt)
+{
+	port_t *port = odp_packet_user_ptr(pkt);
+
+	odp_atomic_inc_u64(&port->egress);
+	odp_packet_free(pkt);
+}
+
+static int run_producer(void *arg ODP_UNUSED)
+{
+	odp_packet_t pkt[BURST_SIZE];
+	port_t *port;
+	uint32_t idx, p;
+	int i, num;
+
+	idx = odp_atomic_fetch_inc_u32(&gbl->producer_idx);
+
+	while (!odp_atomic_load_u32(&gbl->stop)) {
+		for (p = idx; p < gbl->num_ports; p += gbl->num_producers) {
+			port = &gbl->port[p];
+
+			if (port->enq - odp_atomic_load_u64(&port->egress) +
+			    BURST_SIZE > MAX_INFLIGHT)
+				continue;
+
+			num = odp_packet_alloc_multi(gbl->pool, PKT_LEN, pkt,
+						     BURST_SIZE);
+
+			for (i = 0; i < num; i++) {
+				odp_tm_queue_t queue;
+
+				queue = port->queue[port->next_queue++];
+				if (port->next_queue == port->num_queues)
+					port->next_queue = 0;
+
+				odp_packet_user_ptr_set(pkt[i], port);
+				if (odp_tm_enq(queue, pkt[i]) < 0) {
+					odp_packet_free(pkt[i]);
+					port->drops++;
+				} else {
+					port->enq++;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int create_port(uint32_t p)
+{
+	odp_tm_requirements_t requirements;
+	odp_tm_level_requirements_t *per_level;
+	odp_tm_node_params_t node_params;
+	odp_tm_queue_params_t queue_params;
+	odp_tm_egress_t egress;
+	port_t *port = &gbl->port[p];
+	uint32_t level, c, q;
+	char name[64];
+
+	memset(port, 0, sizeof(port_t));
+	odp_atomic_init_u64(&port->egress, 0);
+	port->num_queues = NUM_CLASSES * gbl->args.queues;
+
+	odp_tm_requirements_init(&requirements);
+	requirements.max_tm_queues          = port->num_queues + 1;
+	requirements.num_levels             = 2;
+	requirements.tm_queue_shaper_needed = true;
+	requirements.max_burst              = gbl->args.burst;
+
+	for (level = 0; level < 2; level++) {
+		per_level = &requirements.per_level[level];
+		per_level->max_num_tm_nodes      = NUM_CLASSES;
+		per_level->max_fanin_per_node    = MAX_QUEUES;
+		per_level->max_priority          = NUM_CLASSES - 1;
+		per_level->min_weight            = 1;
+		per_level->max_weight            = 255;
+		per_level->tm_node_shaper_needed = level == 0;
+	}
+
+	odp_tm_egress_init(&egress);
+	egress.egress_kind = ODP_TM_EGRESS_FN;
+	egress.egress_fcn  = egress_fcn;
+
+	snprintf(name, sizeof(name), "tm_perf_port_%" PRIu32, p);
+	port->tm = odp_tm_create(name, &requirements, &egress);
+	if (port->tm == ODP_TM_INVALID) {
+		LOG_ERR("TM system create failed\n");
+		return -1;
+	}
+
+	snprintf(name, sizeof(name), "tm_perf_port_%" PRIu32 "_node", p);
+	odp_tm_node_params_init(&node_params);
+	node_params.max_fanin      = NUM_CLASSES;
+	node_params.shaper_profile = gbl->port_shaper;
+	node_params.level          = 0;
+
+	port->port_node = odp_tm_node_create(port->tm, name, &node_params);
+	if (port->port_node == ODP_TM_INVALID ||
+	    odp_tm_node_connect(port->port_node, ODP_TM_ROOT)) {
+		LOG_ERR("Port node create failed\n");
+		return -1;
+	}
+
+	for (c = 0; c < NUM_CLASSES; c++) {
+		odp_tm_node_params_init(&node_params);
+		node_params.max_fanin = gbl->args.queues;
+		node_params.level     = 1;
+
+		snprintf(name, sizeof(name), "tm_perf_port_%" PRIu32
+			 "_class_%" PRIu32, p, c);
+		port->class_node[c] = odp_tm_node_create(port->tm, name,
+							 &node_params);
+		if (port->class_node[c] == ODP_TM_INVALID ||
+		    odp_tm_node_connect(port->class_node[c], port->port_node)) {
+			LOG_ERR("Class node create failed\n");
+			return -1;
+		}
+
+		for (q = 0; q < gbl->args.queues; q++) {
+			odp_tm_queue_t *queue;
+
+			/* Interleave classes in enqueue order */
+			queue = &port->queue[q * NUM_CLASSES + c];
+
+			odp_tm_queue_params_init(&queue_params);
+			queue_params.shaper_profile = gbl->queue_shaper;
+			queue_params.priority       = c;
+
+			*queue = odp_tm_queue_create(port->tm, &queue_params);
+			if (*queue == ODP_TM_INVALID ||
+			    odp_tm_queue_connect(*queue, port->class_node[c])) {
+				LOG_ERR("TM queue create failed\n");
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int destroy_port(uint32_t p)
+{
+	port_t *port = &gbl->port[p];
+	uint32_t c, q;
+	int ret = 0;
+
+	for (q = 0; q < port->num_queues; q++) {
+		ret |= odp_tm_queue_disconnect(port->queue[q]);
+		ret |= odp_tm_queue_shaper_config(port->queue[q],
+						  ODP_TM_INVALID);
+		ret |= odp_tm_queue_destroy(port->queue[q]);
+	}
+
+	for (c = 0; c < NUM_CLASSES; c++) {
+		ret |= odp_tm_node_disconnect(port->class_node[c]);
+		ret |= odp_tm_node_destroy(port->class_node[c]);
+	}
+
+	ret |= odp_tm_node_disconnect(port->port_node);
+	ret |= odp_tm_node_shaper_config(port->port_node, ODP_TM_INVALID);
+	ret |= odp_tm_node_destroy(port->port_node);
+	ret |= odp_tm_destroy(port->tm);
+
+	if (ret)
+		LOG_ERR("TM system destroy failed\n");
+
+	return ret;
+}
+
+static uint64_t egress_pkts(void)
+{
+	uint64_t sum = 0;
+	uint32_t p;
+
+	for (p = 0; p < gbl->num_ports; p++)
+		sum += odp_atomic_load_u64(&gbl->port[p].egress);
+
+	return sum;
+}
+
+/* Producers run on the last worker CPUs, since the implementation places TM
+ * service threads starting from the first worker CPU. */
+static void producer_cpumask(uint32_t num_ports, odp_cpumask_t *mask)
+{
+	odp_cpumask_t workers;
+	int cpu[ODP_CPUMASK_SIZE];
+	int num_cpus = 0, num, i;
+
+	odp_cpumask_default_worker(&workers, 0);
+	for (i = odp_cpumask_first(&workers); i >= 0;
+	     i = odp_cpumask_next(&workers, i))
+		cpu[num_cpus++] = i;
+
+	num = num_cpus - (int)num_ports;
+	if (num > (int)num_ports)
+		num = num_ports;
+	if (num < 1)
+		num = 1;
+
+	odp_cpumask_zero(mask);
+	for (i = num_cpus - num; i < num_cpus; i++)
+		odp_cpumask_set(mask, cpu[i]);
+}
+
+static int run_round(odp_instance_t instance, uint32_t num_ports,
+		     test_res_t *res)
+{
+	odph_odpthread_t thread_tbl[ODP_THREAD_COUNT_MAX];
+	odph_odpthread_params_t thr_params;
+	odp_cpumask_t cpumask;
+	odp_time_t t1, t2, end;
+	uint64_t pkts;
+	uint32_t p;
+	int ret = 0;
+
+	gbl->num_ports = num_ports;
+	for (p = 0; p < num_ports; p++) {
+		if (create_port(p)) {
+			gbl->num_ports = p;
+			ret = -1;
+			goto destroy;
+		}
+	}
+
+	producer_cpumask(num_ports, &cpumask);
+	gbl->num_producers = odp_cpumask_count(&cpumask);
+	odp_atomic_store_u32(&gbl->stop, 0);
+	odp_atomic_store_u32(&gbl->producer_idx, 0);
+
+	memset(thread_tbl, 0, sizeof(thread_tbl));
+	memset(&thr_params, 0, sizeof(thr_params));
+	thr_params.start    = run_producer;
+	thr_params.arg      = NULL;
+	thr_params.thr_type = ODP_THREAD_WORKER;
+	thr_params.instance = instance;
+	odph_odpthreads_create(thread_tbl, &cpumask, &thr_params);
+
+	usleep(WARMUP_US);
+	t1   = odp_time_local();
+	pkts = egress_pkts();
+
+	sleep(gbl->args.time);
+
+	t2        = odp_time_local();
+	res->pkts = egress_pkts() - pkts;
+	res->nsec = odp_time_to_ns(odp_time_diff(t2, t1));
+
+	odp_atomic_store_u32(&gbl->stop, 1);
+	odph_odpthreads_join(thread_tbl);
+
+	/* Let TM systems drain before destroying them */
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(ODP_TIME_SEC_IN_NS));
+	for (p = 0; p < num_ports; p++) {
+		while (odp_atomic_load_u64(&gbl->port[p].egress) <
+		       gbl->port[p].enq &&
+		       odp_time_cmp(end, odp_time_local()) > 0)
+			usleep(1000);
+	}
+
+	res->drops = 0;
+	for (p = 0; p < num_ports; p++)
+		res->drops += gbl->port[p].drops;
+
+destroy:
+	for (p = 0; p < gbl->num_ports; p++)
+		ret |= destroy_port(p);
+
+	return ret;
+}
+
+static int create_profiles(void)
+{
+	odp_tm_shaper_params_t params;
+	uint64_t bps = gbl->args.rate_mbps * 1000000;
+	uint32_t num_queues = NUM_CLASSES * gbl->args.queues;
+
+	/* Port rate is shaped by the port node. Queue shapers allow twice
+	 * the fair share of the port rate. */
+	odp_tm_shaper_params_init(&params);
+	params.commit_bps        = bps;
+	params.commit_burst      = 100 * PKT_LEN * 8;
+	params.shaper_len_adjust = LEN_ADJUST;
+
+	gbl->port_shaper = odp_tm_shaper_create("tm_perf_port", &params);
+
+	params.commit_bps   = 2 * bps / num_queues;
+	gbl->queue_shaper = odp_tm_shaper_create("tm_perf_queue", &params);
+
+	if (gbl->port_shaper == ODP_TM_INVALID ||
+	    gbl->queue_shaper == ODP_TM_INVALID) {
+		LOG_ERR("Shaper profile create failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Prinf usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "OpenDataPlane traffic manager packet rate benchmark.\n"
+	       "\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -p 1,2,4 -r 10000\n"
+	       "\n"
+	       "Optional OPTIONS:\n"
+	       "  -p, --ports <list>   Comma separated port (TM system)\n"
+	       "                       counts. Default: %s\n"
+	       "  -q, --queues <num>   tm_queues per service class (%i per\n"
+	       "                       port). Default: %i\n"
+	       "  -r, --rate <mbps>    Port shaper rate in Mbps. Default: %i\n"
+	       "  -b, --burst <num>    TM system max burst.\n"
+	       "                       Default: 0 (implementation default)\n"
+	       "  -t, --time <sec>     Test time per round. Default: %i\n"
+	       "  -h, --help           Display help and exit.\n\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname), DEF_PORTS,
+	       NUM_CLASSES, DEF_QUEUES, DEF_RATE_MBPS, DEF_TIME);
+}
+
+/** Parse comma separated list of values */
+static int parse_list(const char *str, uint64_t val[])
+{
+	char *end;
+	int num = 0;
+
+	while (*str && num < MAX_VALUES) {
+		val[num++] = strtoull(str, &end, 0);
+
+		if (*end != ',')
+			break;
+
+		str = end + 1;
+	}
+
+	return num;
+}
+
+static void parse_args(int argc, char *argv[], test_args_t *args)
+{
+	int opt, i;
+	int long_index;
+	uint64_t val[MAX_VALUES];
+	const char *ports_str = DEF_PORTS;
+	static const struct option longopts[] = {
+		{"ports", required_argument, NULL, 'p'},
+		{"queues", required_argument, NULL, 'q'},
+		{"rate", required_argument, NULL, 'r'},
+		{"burst", required_argument, NULL, 'b'},
+		{"time", required_argument, NULL, 't'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	static const char *shortopts =  "p:q:r:b:t:h";
+
+	/* Let helper collect its own arguments (e.g. --odph_proc) */
+	odph_parse_options(argc, argv, shortopts, longopts);
+
+	opterr = 0; /* Do not issue errors on helper options */
+
+	args->queues    = DEF_QUEUES;
+	args->rate_mbps = DEF_RATE_MBPS;
+	args->burst     = 0;
+	args->time      = DEF_TIME;
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'p':
+			ports_str = optarg;
+			break;
+		case 'q':
+			args->queues = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			args->rate_mbps = strtoull(optarg, NULL, 0);
+			break;
+		case 'b':
+			args->burst = strtoul(optarg, NULL, 0);
+			break;
+		case 't':
+			args->time = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	args->num_ports = parse_list(ports_str, val);
+	for (i = 0; i < args->num_ports; i++) {
+		args->ports[i] = val[i];
+		if (val[i] == 0 || val[i] > MAX_PORTS) {
+			usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (args->num_ports == 0 || args->queues == 0 ||
+	    args->queues > MAX_QUEUES || args->rate_mbps == 0 ||
+	    args->time < 1) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	optind = 1;		/* Reset 'extern optind' from the getopt lib */
+}
+
+int main(int argc, char *argv[])
+{
+	odp_instance_t instance;
+	odp_pool_param_t params;
+	odp_shm_t shm;
+	test_args_t args;
+	test_res_t res;
+	uint32_t max_ports = 0;
+	double pps;
+	int i, ret = 0;
+
+	parse_args(argc, argv, &args);
+
+	if (odp_init_global(&instance, NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	shm = odp_shm_reserve("tm_perf_global", sizeof(test_global_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		LOG_ERR("Error: shm reserve failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	gbl = odp_shm_addr(shm);
+	memset(gbl, 0, sizeof(test_global_t));
+	gbl->args = args;
+	odp_atomic_init_u32(&gbl->stop, 0);
+	odp_atomic_init_u32(&gbl->producer_idx, 0);
+
+	for (i = 0; i < args.num_ports; i++)
+		if (args.ports[i] > max_ports)
+			max_ports = args.ports[i];
+
+	/* Packets in TM systems, producer bursts and per thread caches */
+	odp_pool_param_init(&params);
+	params.type    = ODP_POOL_PACKET;
+	params.pkt.len = PKT_LEN;
+	params.pkt.num = max_ports * (MAX_INFLIGHT + 2 * BURST_SIZE) +
+			 ODP_THREAD_COUNT_MAX * 256;
+
+	gbl->pool = odp_pool_create("tm_perf_pool", &params);
+	if (gbl->pool == ODP_POOL_INVALID) {
+		LOG_ERR("Error: packet pool create failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (create_profiles())
+		exit(EXIT_FAILURE);
+
+	printf("\n%i service classes, %" PRIu32 " tm_queues per port, "
+	       "%" PRIu64 " Mbps port rate, %i sec per round\n\n",
+	       NUM_CLASSES, NUM_CLASSES * args.queues, args.rate_mbps,
+	       args.time);
+	printf("  ports   producers       pkts/sec   pkts/sec/port"
+	       "      drops\n");
+	printf("  ------------------------------------------------"
+	       "-----------\n");
+
+	for (i = 0; i < args.num_ports; i++) {
+		if (run_round(instance, args.ports[i], &res)) {
+			ret = -1;
+			break;
+		}
+
+		pps = res.pkts * (ODP_TIME_SEC_IN_NS / res.nsec);
+		printf("%7" PRIu32 " %11" PRIu32 " %14.0f %15.0f %10" PRIu64
+		       "\n", args.ports[i], gbl->num_producers, pps,
+		       pps / args.ports[i], res.drops);
+	}
+
+	printf("\n");
+
+	odp_tm_shaper_destroy(gbl->queue_shaper);
+	odp_tm_shaper_destroy(gbl->port_shaper);
+
+	if (odp_pool_destroy(gbl->pool)) {
+		LOG_ERR("Error: pool destroy failed.\n");
+		ret = -1;
+	}
+
+	if (odp_shm_free(shm)) {
+		LOG_ERR("Error: shm free failed.\n");
+		ret = -1;
+	}
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: term local failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		LOG_ERR("Error: term global failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return ret;
+}
@@ -95,6 +95,8 @@ void classification_test_pmr_term_tcp_dport(void);
 void classification_test_pmr_term_tcp_sport(void);
 void classification_test_pmr_term_udp_dport(void);
 void classification_test_pmr_term_udp_sport(void);
+void classification_test_pmr_term_udp_dport_many(void);
+void classification_test_pmr_term_udp_tuples(void);
 void classification_test_pmr_term_ipproto(void);
 void classification_test_pmr_term_dmac(void);
 void classification_test_pmr_term_packet_len(void);
@@ -428,6 +428,288 @@ void classification_test_pmr_term_udp_dport(void)
 	odp_pktio_close(pktio);
 }
 
+void classification_test_pmr_term_udp_dport_many(void)
+{
+	odp_packet_t pkt;
+	odph_udphdr_t *udp;
+	uint32_t seqno;
+	uint16_t val;
+	uint16_t mask;
+	int retval;
+	int i, num;
+	odp_pktio_t pktio;
+	odp_pool_t pool[2];
+	odp_queue_t queue[2];
+	odp_cos_t cos[2];
+	odp_queue_t retqueue;
+	odp_queue_t default_queue;
+	odp_cos_t default_cos;
+	odp_pool_t default_pool;
+	odp_pmr_t pmr[32];
+	char cosname[ODP_COS_NAME_LEN];
+	odp_pmr_param_t pmr_param;
+	odp_cls_cos_param_t cls_param;
+	odp_cls_capability_t capa;
+	odph_ethhdr_t *eth;
+	cls_packet_info_t pkt_info;
+	uint16_t dport[3];
+	odp_queue_t expect[3];
+
+	/* More PMRs than a single CoS used to support. Even ports are
+	 * classified to the first CoS and odd ports to the second one. */
+	retval = odp_cls_capability(&capa);
+	CU_ASSERT_FATAL(retval == 0);
+	num = 32;
+	if (capa.available_pmr_terms < (unsigned)num)
+		num = capa.available_pmr_terms;
+	CU_ASSERT_FATAL(num >= 2);
+
+	pktio = create_pktio(ODP_QUEUE_TYPE_SCHED, pkt_pool);
+	CU_ASSERT_FATAL(pktio != ODP_PKTIO_INVALID);
+	retval = start_pktio(pktio);
+	CU_ASSERT(retval == 0);
+
+	configure_default_cos(pktio, &default_cos,
+			      &default_queue, &default_pool);
+
+	for (i = 0; i < 2; i++) {
+		sprintf(cosname, "udp_dport_many%d", i);
+		queue[i] = queue_create(cosname, true);
+		CU_ASSERT_FATAL(queue[i] != ODP_QUEUE_INVALID);
+
+		pool[i] = pool_create(cosname);
+		CU_ASSERT_FATAL(pool[i] != ODP_POOL_INVALID);
+
+		odp_cls_cos_param_init(&cls_param);
+		cls_param.pool = pool[i];
+		cls_param.queue = queue[i];
+		cls_param.drop_policy = ODP_COS_DROP_POOL;
+
+		cos[i] = odp_cls_cos_create(cosname, &cls_param);
+		CU_ASSERT_FATAL(cos[i] != ODP_COS_INVALID);
+	}
+
+	mask = 0xffff;
+	for (i = 0; i < num; i++) {
+		val = CLS_DEFAULT_DPORT + i;
+		odp_cls_pmr_param_init(&pmr_param);
+		pmr_param.term = ODP_PMR_UDP_DPORT;
+		pmr_param.match.value = &val;
+		pmr_param.match.mask = &mask;
+		pmr_param.val_sz = sizeof(val);
+
+		pmr[i] = odp_cls_pmr_create(&pmr_param, 1, default_cos,
+					    cos[i % 2]);
+		CU_ASSERT_FATAL(pmr[i] != ODP_PMR_INVAL);
+	}
+
+	dport[0] = CLS_DEFAULT_DPORT + num - 1;
+	expect[0] = queue[(num - 1) % 2];
+	dport[1] = CLS_DEFAULT_DPORT + num - 2;
+	expect[1] = queue[num % 2];
+	dport[2] = CLS_DEFAULT_DPORT + num;
+	expect[2] = default_queue;
+
+	pkt_info = default_pkt_info;
+	pkt_info.udp = true;
+
+	for (i = 0; i < 3; i++) {
+		pkt = create_packet(pkt_info);
+		CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+		seqno = cls_pkt_get_seq(pkt);
+		CU_ASSERT(seqno != TEST_SEQ_INVALID);
+		eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+		odp_pktio_mac_addr(pktio, eth->src.addr, ODPH_ETHADDR_LEN);
+		odp_pktio_mac_addr(pktio, eth->dst.addr, ODPH_ETHADDR_LEN);
+
+		udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+		udp->dst_port = odp_cpu_to_be_16(dport[i]);
+
+		enqueue_pktio_interface(pkt, pktio);
+
+		pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS);
+		CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+		CU_ASSERT(seqno == cls_pkt_get_seq(pkt));
+		CU_ASSERT(retqueue == expect[i]);
+		odp_packet_free(pkt);
+	}
+
+	for (i = 0; i < num; i++)
+		odp_cls_pmr_destroy(pmr[i]);
+	for (i = 0; i < 2; i++)
+		odp_cos_destroy(cos[i]);
+	odp_cos_destroy(default_cos);
+	stop_pktio(pktio);
+	for (i = 0; i < 2; i++) {
+		odp_queue_destroy(queue[i]);
+		odp_pool_destroy(pool[i]);
+	}
+	odp_queue_destroy(default_queue);
+	odp_pool_destroy(default_pool);
+	odp_pktio_close(pktio);
+}
+
+/* Send a UDP packet with the given ports and check the queue it is
+ * classified to */
+static void cls_send_udp(odp_pktio_t pktio, uint16_t sport, uint16_t dport,
+			 odp_queue_t expect)
+{
+	odp_packet_t pkt;
+	odph_udphdr_t *udp;
+	odph_ethhdr_t *eth;
+	odp_queue_t retqueue;
+	cls_packet_info_t pkt_info;
+	uint32_t seqno;
+
+	pkt_info = default_pkt_info;
+	pkt_info.udp = true;
+	pkt = create_packet(pkt_info);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	seqno = cls_pkt_get_seq(pkt);
+	CU_ASSERT(seqno != TEST_SEQ_INVALID);
+	eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+	odp_pktio_mac_addr(pktio, eth->src.addr, ODPH_ETHADDR_LEN);
+	odp_pktio_mac_addr(pktio, eth->dst.addr, ODPH_ETHADDR_LEN);
+
+	udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+	udp->src_port = odp_cpu_to_be_16(sport);
+	udp->dst_port = odp_cpu_to_be_16(dport);
+
+	enqueue_pktio_interface(pkt, pktio);
+
+	pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT(seqno == cls_pkt_get_seq(pkt));
+	CU_ASSERT(retqueue == expect);
+	odp_packet_free(pkt);
+}
+
+static odp_pmr_t cls_udp_pmr_create(odp_cls_pmr_term_t term0, uint16_t val0,
+				    odp_cls_pmr_term_t term1, uint16_t val1,
+				    int num_terms, odp_cos_t src,
+				    odp_cos_t dst)
+{
+	odp_pmr_param_t pmr_param[2];
+	uint16_t val[2];
+	uint16_t mask = 0xffff;
+	int i;
+
+	val[0] = val0;
+	val[1] = val1;
+
+	for (i = 0; i < num_terms; i++) {
+		odp_cls_pmr_param_init(&pmr_param[i]);
+		pmr_param[i].term = i ? term1 : term0;
+		pmr_param[i].match.value = &val[i];
+		pmr_param[i].match.mask = &mask;
+		pmr_param[i].val_sz = sizeof(val[i]);
+	}
+
+	return odp_cls_pmr_create(pmr_param, num_terms, src, dst);
+}
+
+void classification_test_pmr_term_udp_tuples(void)
+{
+	odp_pktio_t pktio;
+	odp_pool_t pool[4];
+	odp_queue_t queue[4];
+	odp_cos_t cos[4];
+	odp_queue_t default_queue;
+	odp_cos_t default_cos;
+	odp_pool_t default_pool;
+	odp_pmr_t pmr[5];
+	odp_cls_cos_param_t cls_param;
+	char cosname[ODP_COS_NAME_LEN];
+	uint16_t sport = CLS_DEFAULT_SPORT;
+	uint16_t dport = CLS_DEFAULT_DPORT;
+	uint16_t port = CLS_DEFAULT_DPORT + 100;
+	int retval;
+	int i;
+
+	pktio = create_pktio(ODP_QUEUE_TYPE_SCHED, pkt_pool);
+	CU_ASSERT_FATAL(pktio != ODP_PKTIO_INVALID);
+	retval = start_pktio(pktio);
+	CU_ASSERT(retval == 0);
+
+	configure_default_cos(pktio, &default_cos,
+			      &default_queue, &default_pool);
+
+	for (i = 0; i < 4; i++) {
+		sprintf(cosname, "udp_tuples%d", i);
+		queue[i] = queue_create(cosname, true);
+		CU_ASSERT_FATAL(queue[i] != ODP_QUEUE_INVALID);
+
+		pool[i] = pool_create(cosname);
+		CU_ASSERT_FATAL(pool[i] != ODP_POOL_INVALID);
+
+		odp_cls_cos_param_init(&cls_param);
+		cls_param.pool = pool[i];
+		cls_param.queue = queue[i];
+		cls_param.drop_policy = ODP_COS_DROP_POOL;
+
+		cos[i] = odp_cls_cos_create(cosname, &cls_param);
+		CU_ASSERT_FATAL(cos[i] != ODP_COS_INVALID);
+	}
+
+	/* Rules of three different tuples on the same source CoS. The same
+	 * port value is used in different tuples, and the same key twice in
+	 * one tuple. */
+	pmr[0] = cls_udp_pmr_create(ODP_PMR_UDP_DPORT, port, 0, 0, 1,
+				    default_cos, cos[0]);
+	pmr[1] = cls_udp_pmr_create(ODP_PMR_UDP_SPORT, port, 0, 0, 1,
+				    default_cos, cos[1]);
+	pmr[2] = cls_udp_pmr_create(ODP_PMR_UDP_SPORT, port + 1,
+				    ODP_PMR_UDP_DPORT, port + 2, 2,
+				    default_cos, cos[2]);
+	pmr[3] = cls_udp_pmr_create(ODP_PMR_UDP_DPORT, port, 0, 0, 1,
+				    default_cos, cos[3]);
+	for (i = 0; i < 4; i++)
+		CU_ASSERT_FATAL(pmr[i] != ODP_PMR_INVAL);
+
+	/* The first created of the rules with the same key matches */
+	cls_send_udp(pktio, sport, port, queue[0]);
+	/* Same value in a different tuple */
+	cls_send_udp(pktio, port, dport, queue[1]);
+	/* Both matching rules created before are checked in order */
+	cls_send_udp(pktio, port, port, queue[0]);
+	/* Composite rule needs both terms to match */
+	cls_send_udp(pktio, port + 1, port + 2, queue[2]);
+	cls_send_udp(pktio, port + 1, port + 3, default_queue);
+
+	/* Later rule with the same key matches after the first one is
+	 * destroyed, also when its slot has been reused */
+	CU_ASSERT(odp_cls_pmr_destroy(pmr[0]) == 0);
+	cls_send_udp(pktio, sport, port, queue[3]);
+
+	pmr[4] = cls_udp_pmr_create(ODP_PMR_UDP_DPORT, port, 0, 0, 1,
+				    default_cos, cos[0]);
+	CU_ASSERT_FATAL(pmr[4] != ODP_PMR_INVAL);
+	cls_send_udp(pktio, sport, port, queue[3]);
+
+	/* Removing all rules of a tuple frees it for other rules */
+	CU_ASSERT(odp_cls_pmr_destroy(pmr[2]) == 0);
+	cls_send_udp(pktio, port + 1, port + 2, default_queue);
+	pmr[2] = cls_udp_pmr_create(ODP_PMR_UDP_DPORT, port + 2,
+				    ODP_PMR_UDP_SPORT, port + 1, 2,
+				    default_cos, cos[2]);
+	CU_ASSERT_FATAL(pmr[2] != ODP_PMR_INVAL);
+	cls_send_udp(pktio, port + 1, port + 2, queue[2]);
+
+	for (i = 1; i < 5; i++)
+		odp_cls_pmr_destroy(pmr[i]);
+	for (i = 0; i < 4; i++)
+		odp_cos_destroy(cos[i]);
+	odp_cos_destroy(default_cos);
+	stop_pktio(pktio);
+	for (i = 0; i < 4; i++) {
+		odp_queue_destroy(queue[i]);
+		odp_pool_destroy(pool[i]);
+	}
+	odp_queue_destroy(default_queue);
+	odp_pool_destroy(default_pool);
+	odp_pktio_close(pktio);
+}
+
 void classification_test_pmr_term_udp_sport(void)
 {
 	odp_packet_t pkt;
@@ -1394,11 +1676,284 @@ static void classification_test_pmr_term_ipv6saddr(void)
 	odp_pktio_close(pktio);
 }
 
+/* Turn a UDP test packet into a VXLAN packet with an inner IPv4/UDP packet */
+static void cls_pkt_set_vxlan(odp_packet_t pkt, uint32_t vni)
+{
+	odph_udphdr_t *udp;
+	odph_ethhdr_t *eth;
+	odph_ipv4hdr_t *ip;
+	uint8_t *vxlan;
+
+	/* Tunnels are not parsed from IP fragments */
+	ip = (odph_ipv4hdr_t *)odp_packet_l3_ptr(pkt, NULL);
+	CU_ASSERT_FATAL(ip != NULL);
+	ip->frag_offset = 0;
+
+	udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+	CU_ASSERT_FATAL(udp != NULL);
+	udp->dst_port = odp_cpu_to_be_16(4789);
+
+	/* VXLAN header: I flag and 24 bit VNI */
+	vxlan = (uint8_t *)(udp + 1);
+	memset(vxlan, 0, 8);
+	vxlan[0] = 0x08;
+	vxlan[4] = (vni >> 16) & 0xff;
+	vxlan[5] = (vni >> 8) & 0xff;
+	vxlan[6] = vni & 0xff;
+
+	eth = (odph_ethhdr_t *)(vxlan + 8);
+	memset(eth, 0, ODPH_ETHHDR_LEN);
+	eth->type = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4);
+
+	ip = (odph_ipv4hdr_t *)(eth + 1);
+	memset(ip, 0, ODPH_IPV4HDR_LEN);
+	ip->ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip->tot_len = odp_cpu_to_be_16(ODPH_IPV4HDR_LEN + ODPH_UDPHDR_LEN);
+	ip->ttl = 64;
+	ip->proto = ODPH_IPPROTO_UDP;
+}
+
+static void classification_test_pmr_term_ld_vni(void)
+{
+	odp_packet_t pkt;
+	uint32_t val;
+	uint32_t mask;
+	int retval;
+	odp_pktio_t pktio;
+	odp_pool_t pool;
+	odp_pool_t recvpool;
+	odp_queue_t queue;
+	odp_queue_t retqueue;
+	odp_queue_t default_queue;
+	odp_cos_t default_cos;
+	odp_pool_t default_pool;
+	odp_pmr_t pmr;
+	odp_cos_t cos;
+	char cosname[ODP_COS_NAME_LEN];
+	odp_pmr_param_t pmr_param;
+	odp_cls_cos_param_t cls_param;
+	odph_ethhdr_t *eth;
+	cls_packet_info_t pkt_info;
+
+	val = 0x123456;
+	mask = 0xffffff;
+
+	pktio = create_pktio(ODP_QUEUE_TYPE_SCHED, pkt_pool);
+	CU_ASSERT_FATAL(pktio != ODP_PKTIO_INVALID);
+	retval = start_pktio(pktio);
+	CU_ASSERT(retval == 0);
+
+	configure_default_cos(pktio, &default_cos,
+			      &default_queue, &default_pool);
+
+	queue = queue_create("ld_vni", true);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	pool = pool_create("ld_vni");
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	sprintf(cosname, "ld_vni");
+	odp_cls_cos_param_init(&cls_param);
+	cls_param.pool = pool;
+	cls_param.queue = queue;
+	cls_param.drop_policy = ODP_COS_DROP_POOL;
+
+	cos = odp_cls_cos_create(cosname, &cls_param);
+	CU_ASSERT_FATAL(cos != ODP_COS_INVALID);
+
+	odp_cls_pmr_param_init(&pmr_param);
+	pmr_param.term = ODP_PMR_LD_VNI;
+	pmr_param.match.value = &val;
+	pmr_param.match.mask = &mask;
+	pmr_param.val_sz = sizeof(val);
+
+	pmr = odp_cls_pmr_create(&pmr_param, 1, default_cos, cos);
+	CU_ASSERT(pmr != ODP_PMR_INVAL);
+
+	pkt_info = default_pkt_info;
+	pkt_info.udp = true;
+	pkt_info.len = 64;
+	pkt = create_packet(pkt_info);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+	odp_pktio_mac_addr(pktio, eth->src.addr, ODPH_ETHADDR_LEN);
+	odp_pktio_mac_addr(pktio, eth->dst.addr, ODPH_ETHADDR_LEN);
+	cls_pkt_set_vxlan(pkt, val);
+
+	enqueue_pktio_interface(pkt, pktio);
+
+	pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT(retqueue == queue);
+	recvpool = odp_packet_pool(pkt);
+	CU_ASSERT(recvpool == pool);
+	odp_packet_free(pkt);
+
+	/* Other VNIs received in default queue */
+	pkt = create_packet(pkt_info);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+	odp_pktio_mac_addr(pktio, eth->src.addr, ODPH_ETHADDR_LEN);
+	odp_pktio_mac_addr(pktio, eth->dst.addr, ODPH_ETHADDR_LEN);
+	cls_pkt_set_vxlan(pkt, val + 1);
+
+	enqueue_pktio_interface(pkt, pktio);
+
+	pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT(retqueue == default_queue);
+	recvpool = odp_packet_pool(pkt);
+	CU_ASSERT(recvpool == default_pool);
+
+	odp_packet_free(pkt);
+	odp_cos_destroy(cos);
+	odp_cos_destroy(default_cos);
+	odp_cls_pmr_destroy(pmr);
+	stop_pktio(pktio);
+	odp_queue_destroy(queue);
+	odp_queue_destroy(default_queue);
+	odp_pool_destroy(default_pool);
+	odp_pool_destroy(pool);
+	odp_pktio_close(pktio);
+}
+
+static void classification_test_pmr_stats(void)
+{
+	odp_packet_t pkt;
+	odph_udphdr_t *udp;
+	uint32_t seqno;
+	uint32_t pkt_len;
+	uint16_t val;
+	uint16_t mask;
+	int retval;
+	odp_pktio_t pktio;
+	odp_pool_t pool;
+	odp_queue_t queue;
+	odp_queue_t retqueue;
+	odp_queue_t default_queue;
+	odp_cos_t default_cos;
+	odp_pool_t default_pool;
+	odp_pmr_t pmr;
+	odp_cos_t cos;
+	char cosname[ODP_COS_NAME_LEN];
+	odp_pmr_param_t pmr_param;
+	odp_cls_cos_param_t cls_param;
+	odp_cls_stats_t stats;
+	odph_ethhdr_t *eth;
+	cls_packet_info_t pkt_info;
+
+	val = CLS_DEFAULT_DPORT;
+	mask = 0xffff;
+
+	pktio = create_pktio(ODP_QUEUE_TYPE_SCHED, pkt_pool);
+	CU_ASSERT_FATAL(pktio != ODP_PKTIO_INVALID);
+	retval = start_pktio(pktio);
+	CU_ASSERT(retval == 0);
+
+	configure_default_cos(pktio, &default_cos,
+			      &default_queue, &default_pool);
+
+	queue = queue_create("pmr_stats", true);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	pool = pool_create("pmr_stats");
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	sprintf(cosname, "pmr_stats");
+	odp_cls_cos_param_init(&cls_param);
+	cls_param.pool = pool;
+	cls_param.queue = queue;
+	cls_param.drop_policy = ODP_COS_DROP_POOL;
+
+	cos = odp_cls_cos_create(cosname, &cls_param);
+	CU_ASSERT_FATAL(cos != ODP_COS_INVALID);
+
+	odp_cls_pmr_param_init(&pmr_param);
+	pmr_param.term = ODP_PMR_UDP_DPORT;
+	pmr_param.match.value = &val;
+	pmr_param.match.mask = &mask;
+	pmr_param.val_sz = sizeof(val);
+
+	pmr = odp_cls_pmr_create(&pmr_param, 1, default_cos, cos);
+	CU_ASSERT_FATAL(pmr != ODP_PMR_INVAL);
+
+	/* Counters start from zero */
+	CU_ASSERT(odp_cls_pmr_stats(pmr, &stats) == 0);
+	CU_ASSERT(stats.packets == 0);
+	CU_ASSERT(stats.octets == 0);
+	CU_ASSERT(odp_cls_cos_stats(cos, &stats) == 0);
+	CU_ASSERT(stats.packets == 0);
+	CU_ASSERT(stats.octets == 0);
+
+	pkt_info = default_pkt_info;
+	pkt_info.udp = true;
+	pkt = create_packet(pkt_info);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	seqno = cls_pkt_get_seq(pkt);
+	CU_ASSERT(seqno != TEST_SEQ_INVALID);
+	eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+	odp_pktio_mac_addr(pktio, eth->src.addr, ODPH_ETHADDR_LEN);
+	odp_pktio_mac_addr(pktio, eth->dst.addr, ODPH_ETHADDR_LEN);
+
+	udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+	udp->dst_port = odp_cpu_to_be_16(CLS_DEFAULT_DPORT);
+	pkt_len = odp_packet_len(pkt);
+
+	enqueue_pktio_interface(pkt, pktio);
+
+	pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT(seqno == cls_pkt_get_seq(pkt));
+	CU_ASSERT(retqueue == queue);
+	odp_packet_free(pkt);
+
+	/* Other packets are counted on the default CoS only */
+	pkt = create_packet(pkt_info);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	seqno = cls_pkt_get_seq(pkt);
+	CU_ASSERT(seqno != TEST_SEQ_INVALID);
+	eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+	odp_pktio_mac_addr(pktio, eth->src.addr, ODPH_ETHADDR_LEN);
+	odp_pktio_mac_addr(pktio, eth->dst.addr, ODPH_ETHADDR_LEN);
+
+	udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+	udp->dst_port = odp_cpu_to_be_16(CLS_DEFAULT_DPORT + 1);
+
+	enqueue_pktio_interface(pkt, pktio);
+
+	pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT(seqno == cls_pkt_get_seq(pkt));
+	CU_ASSERT(retqueue == default_queue);
+	odp_packet_free(pkt);
+
+	CU_ASSERT(odp_cls_pmr_stats(pmr, &stats) == 0);
+	CU_ASSERT(stats.packets == 1);
+	CU_ASSERT(stats.octets == pkt_len);
+	CU_ASSERT(odp_cls_cos_stats(cos, &stats) == 0);
+	CU_ASSERT(stats.packets == 1);
+	CU_ASSERT(stats.octets == pkt_len);
+	CU_ASSERT(odp_cls_cos_stats(default_cos, &stats) == 0);
+	CU_ASSERT(stats.packets == 1);
+
+	odp_cos_destroy(cos);
+	odp_cos_destroy(default_cos);
+	odp_cls_pmr_destroy(pmr);
+	stop_pktio(pktio);
+	odp_queue_destroy(queue);
+	odp_queue_destroy(default_queue);
+	odp_pool_destroy(default_pool);
+	odp_pool_destroy(pool);
+	odp_pktio_close(pktio);
+}
+
 odp_testinfo_t classification_suite_pmr[] = {
 	ODP_TEST_INFO(classification_test_pmr_term_tcp_dport),
 	ODP_TEST_INFO(classification_test_pmr_term_tcp_sport),
 	ODP_TEST_INFO(classification_test_pmr_term_udp_dport),
 	ODP_TEST_INFO(classification_test_pmr_term_udp_sport),
+	ODP_TEST_INFO(classification_test_pmr_term_udp_dport_many),
+	ODP_TEST_INFO(classification_test_pmr_term_udp_tuples),
 	ODP_TEST_INFO(classification_test_pmr_term_ipproto),
 	ODP_TEST_INFO(classification_test_pmr_term_dmac),
 	ODP_TEST_INFO(classification_test_pmr_pool_set),
@@ -1407,5 +1962,7 @@ odp_testinfo_t classification_suite_pmr[] = {
 	ODP_TEST_INFO(classification_test_pmr_term_ipv6saddr),
 	ODP_TEST_INFO(classification_test_pmr_term_ipv6daddr),
 	ODP_TEST_INFO(classification_test_pmr_term_packet_len),
+	ODP_TEST_INFO(classification_test_pmr_term_ld_vni),
+	ODP_TEST_INFO(classification_test_pmr_stats),
 	ODP_TEST_INFO_NULL,
 };
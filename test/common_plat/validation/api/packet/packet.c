@@ -13,6 +13,8 @@
 #define PACKET_BUF_LEN	ODP_CONFIG_PACKET_SEG_LEN_MIN
 /* Reserve some tailroom for tests */
 #define PACKET_TAILROOM_RESERVE  4
+/* Number of packets in vector tests */
+#define VECTOR_TEST_SIZE 8
 
 static odp_pool_t packet_pool, packet_pool_no_uarea, packet_pool_double_uarea;
 static uint32_t packet_len;
@@ -1516,6 +1518,192 @@ void packet_test_concat_extend_trunc(void)
 	CU_ASSERT(odp_pool_destroy(pool) == 0);
 }
 
+void packet_test_split_add_data(void)
+{
+	odp_packet_t pkt, tail;
+	uint32_t pkt_len, seg_len, offset, cur_data;
+	uint32_t add_len = 100;
+	int ret;
+
+	pkt = odp_packet_copy(segmented_test_packet,
+			      odp_packet_pool(segmented_test_packet));
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+
+	/* Segmented test packet may have the maximum length. Make room for
+	 * the added data. */
+	CU_ASSERT_FATAL(odp_packet_trunc_tail(&pkt, add_len, NULL, NULL) >= 0);
+	pkt_len = odp_packet_len(pkt);
+	seg_len = odp_packet_seg_len(pkt);
+
+	/* Split at the end of the first segment */
+	if (seg_len < pkt_len) {
+		CU_ASSERT_FATAL(odp_packet_split(&pkt, seg_len, &tail) >= 0);
+		CU_ASSERT(odp_packet_len(pkt) == seg_len);
+		CU_ASSERT(odp_packet_len(tail) == pkt_len - seg_len);
+		packet_compare_offset(pkt, 0, segmented_test_packet, 0,
+				      seg_len);
+		packet_compare_offset(tail, 0, segmented_test_packet, seg_len,
+				      pkt_len - seg_len);
+
+		CU_ASSERT(odp_packet_concat(&pkt, tail) >= 0);
+		CU_ASSERT(odp_packet_len(pkt) == pkt_len);
+		packet_compare_offset(pkt, 0, segmented_test_packet, 0,
+				      pkt_len);
+	}
+
+	/* Add data into the middle of a segment and remove it again */
+	offset = seg_len < pkt_len ? seg_len + 1 : pkt_len / 2;
+	ret = odp_packet_add_data(&pkt, offset, add_len);
+	CU_ASSERT_FATAL(ret >= 0);
+	CU_ASSERT(odp_packet_len(pkt) == pkt_len + add_len);
+
+	cur_data = 0;
+	CU_ASSERT(fill_data_forward(pkt, offset, add_len, &cur_data) == 0);
+	packet_compare_offset(pkt, 0, segmented_test_packet, 0, offset);
+	packet_compare_offset(pkt, offset + add_len, segmented_test_packet,
+			      offset, pkt_len - offset);
+
+	ret = odp_packet_rem_data(&pkt, offset, add_len);
+	CU_ASSERT_FATAL(ret >= 0);
+	CU_ASSERT(odp_packet_len(pkt) == pkt_len);
+	packet_compare_offset(pkt, 0, segmented_test_packet, 0, pkt_len);
+
+	odp_packet_free(pkt);
+
+	/* Add data to both ends */
+	pkt = odp_packet_copy(test_packet, odp_packet_pool(test_packet));
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	pkt_len = odp_packet_len(pkt);
+
+	CU_ASSERT_FATAL(odp_packet_add_data(&pkt, 0, add_len) >= 0);
+	CU_ASSERT_FATAL(odp_packet_add_data(&pkt, pkt_len + add_len,
+					    add_len) >= 0);
+	CU_ASSERT(odp_packet_len(pkt) == pkt_len + 2 * add_len);
+	packet_compare_offset(pkt, add_len, test_packet, 0, pkt_len);
+
+	odp_packet_free(pkt);
+}
+
+void packet_test_concat_ref(void)
+{
+	odp_packet_t pkt, src, ref;
+	odp_pool_t pool;
+	uint32_t pkt_len;
+
+	pool = odp_packet_pool(test_packet);
+	pkt_len = odp_packet_len(test_packet);
+	pkt = odp_packet_copy(test_packet, pool);
+	src = odp_packet_copy(test_packet, pool);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT_FATAL(src != ODP_PACKET_INVALID);
+
+	/* Source data is shared with another reference */
+	ref = odp_packet_ref(src, pkt_len / 2);
+	CU_ASSERT_FATAL(ref != ODP_PACKET_INVALID);
+
+	CU_ASSERT(odp_packet_concat(&pkt, src) >= 0);
+	CU_ASSERT(odp_packet_len(pkt) == 2 * pkt_len);
+	CU_ASSERT(odp_packet_unshared_len(pkt) >= pkt_len);
+	packet_compare_offset(pkt, 0, test_packet, 0, pkt_len);
+	packet_compare_offset(pkt, pkt_len, test_packet, 0, pkt_len);
+
+	/* Remove the concatenated source, which shares data with ref */
+	CU_ASSERT(odp_packet_trunc_tail(&pkt, pkt_len, NULL, NULL) >= 0);
+	CU_ASSERT(odp_packet_len(pkt) == pkt_len);
+	packet_compare_data(pkt, test_packet);
+	odp_packet_free(pkt);
+
+	CU_ASSERT(odp_packet_len(ref) == pkt_len - pkt_len / 2);
+	packet_compare_offset(ref, 0, test_packet, pkt_len / 2,
+			      pkt_len - pkt_len / 2);
+	odp_packet_free(ref);
+}
+
+void packet_test_split_push_head(void)
+{
+	odp_packet_t pkt, tail, copy;
+	uint32_t pkt_len, push_len;
+	uint32_t split_len = 10;
+	uint32_t cur_data = 0;
+
+	pkt = odp_packet_alloc(packet_pool, 100);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+
+	/* Fill the segment and push the head past the segment length, so that
+	 * the first segment is longer than a new pool segment */
+	CU_ASSERT_FATAL(odp_packet_extend_tail(&pkt, odp_packet_tailroom(pkt),
+					       NULL, NULL) >= 0);
+	push_len = odp_packet_headroom(pkt);
+	if (push_len > 66)
+		push_len = 66;
+	CU_ASSERT_PTR_NOT_NULL(odp_packet_push_head(pkt, push_len));
+
+	pkt_len = odp_packet_len(pkt);
+	CU_ASSERT(fill_data_forward(pkt, 0, pkt_len, &cur_data) == 0);
+
+	copy = odp_packet_copy(pkt, odp_packet_pool(pkt));
+	CU_ASSERT_FATAL(copy != ODP_PACKET_INVALID);
+
+	CU_ASSERT_FATAL(odp_packet_split(&pkt, split_len, &tail) >= 0);
+	CU_ASSERT(odp_packet_len(pkt) == split_len);
+	CU_ASSERT(odp_packet_len(tail) == pkt_len - split_len);
+	packet_compare_offset(pkt, 0, copy, 0, split_len);
+	packet_compare_offset(tail, 0, copy, split_len, pkt_len - split_len);
+
+	CU_ASSERT(odp_packet_concat(&pkt, tail) >= 0);
+	CU_ASSERT(odp_packet_len(pkt) == pkt_len);
+	packet_compare_data(pkt, copy);
+
+	odp_packet_free(pkt);
+	odp_packet_free(copy);
+}
+
+void packet_test_unshare_write(void)
+{
+	odp_packet_t base, ref, copy;
+	uint32_t pkt_len, offset, ref_len;
+	uint32_t write_len = 16;
+	uint32_t cur_data = 0;
+
+	base = odp_packet_copy(test_packet, odp_packet_pool(test_packet));
+	CU_ASSERT_FATAL(base != ODP_PACKET_INVALID);
+	pkt_len = odp_packet_len(base);
+	offset  = pkt_len / 4;
+	ref_len = pkt_len - offset;
+
+	ref = odp_packet_ref(base, offset);
+	CU_ASSERT_FATAL(ref != ODP_PACKET_INVALID);
+	CU_ASSERT(odp_packet_len(ref) == ref_len);
+
+	/* The shared part may be written when it has a single reference */
+	odp_packet_free(base);
+
+	copy = odp_packet_copy_part(test_packet, offset, ref_len,
+				    odp_packet_pool(test_packet));
+	CU_ASSERT_FATAL(copy != ODP_PACKET_INVALID);
+	CU_ASSERT(fill_data_forward(copy, ref_len / 2, write_len,
+				    &cur_data) == 0);
+
+	/* Write from memory into the middle of the formerly shared part */
+	cur_data = 0;
+	CU_ASSERT(fill_data_forward(ref, ref_len / 2, write_len,
+				    &cur_data) == 0);
+	CU_ASSERT(odp_packet_len(ref) == ref_len);
+	CU_ASSERT(odp_packet_unshared_len(ref) >= ref_len / 2 + write_len);
+	packet_compare_data(ref, copy);
+
+	/* Write from another packet to the end of the packet */
+	CU_ASSERT(odp_packet_copy_from_pkt(ref, ref_len - write_len,
+					   test_packet, 0, write_len) == 0);
+	CU_ASSERT(odp_packet_copy_from_pkt(copy, ref_len - write_len,
+					   test_packet, 0, write_len) == 0);
+	CU_ASSERT(odp_packet_unshared_len(ref) == ref_len);
+	packet_compare_data(ref, copy);
+
+	odp_packet_free(ref);
+	odp_packet_free(copy);
+}
+
 void packet_test_extend_small(void)
 {
 	odp_pool_capability_t capa;
@@ -2031,6 +2219,87 @@ void packet_test_offset(void)
 	CU_ASSERT_PTR_NOT_NULL(ptr);
 }
 
+/* Ethernet + IPv4 + UDP + VXLAN + Ethernet + IPv4 + TCP */
+static const uint8_t test_packet_vxlan[] = {
+	0x00, 0x00, 0x09, 0x00, 0x05, 0x00, 0x00, 0x00,
+	0x09, 0x00, 0x04, 0x00, 0x08, 0x00, 0x45, 0x00,
+	0x00, 0x5A, 0x00, 0x01, 0x00, 0x00, 0x40, 0x11,
+	0x00, 0x00, 0x0A, 0x00, 0x00, 0x01, 0x0A, 0x00,
+	0x00, 0x02, 0x30, 0x39, 0x12, 0xB5, 0x00, 0x46,
+	0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x12,
+	0x34, 0x00, 0x00, 0x00, 0x09, 0x00, 0x05, 0x01,
+	0x00, 0x00, 0x09, 0x00, 0x04, 0x01, 0x08, 0x00,
+	0x45, 0x00, 0x00, 0x28, 0x00, 0x01, 0x00, 0x00,
+	0x40, 0x06, 0x00, 0x00, 0xC0, 0xA8, 0x00, 0x01,
+	0xC0, 0xA8, 0x00, 0x02, 0x04, 0xD2, 0x16, 0x2E,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x50, 0x02, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/* Ethernet + MPLS + IPv4 + UDP */
+static const uint8_t test_packet_mpls[] = {
+	0x00, 0x00, 0x09, 0x00, 0x05, 0x00, 0x00, 0x00,
+	0x09, 0x00, 0x04, 0x00, 0x88, 0x47, 0x00, 0x01,
+	0x01, 0x40, 0x45, 0x00, 0x00, 0x1C, 0x00, 0x01,
+	0x00, 0x00, 0x40, 0x11, 0x00, 0x00, 0x0A, 0x00,
+	0x00, 0x01, 0x0A, 0x00, 0x00, 0x02, 0x30, 0x39,
+	0x30, 0x3A, 0x00, 0x08, 0x00, 0x00
+};
+
+static odp_packet_t packet_from_data(const uint8_t *data, uint32_t len)
+{
+	odp_packet_t pkt;
+
+	pkt = odp_packet_alloc(packet_pool, len);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT_FATAL(odp_packet_copy_from_mem(pkt, 0, len, data) == 0);
+
+	return pkt;
+}
+
+void packet_test_parse(void)
+{
+	odp_packet_parse_param_t param;
+	odp_packet_t pkt[2];
+	int i;
+
+	pkt[0] = packet_from_data(test_packet_vxlan, sizeof(test_packet_vxlan));
+	pkt[1] = packet_from_data(test_packet_mpls, sizeof(test_packet_mpls));
+
+	odp_packet_flow_hash_set(pkt[0], 0x1234);
+
+	/* Parse only L2, higher layer offsets are found by L2 parsing */
+	param.last_layer = ODP_PROTO_LAYER_L2;
+	CU_ASSERT(odp_packet_parse(pkt[0], &param) == 0);
+	CU_ASSERT(odp_packet_has_eth(pkt[0]));
+	CU_ASSERT(odp_packet_l2_offset(pkt[0]) == 0);
+	CU_ASSERT(odp_packet_l3_offset(pkt[0]) == 14);
+	CU_ASSERT(odp_packet_has_flow_hash(pkt[0]));
+	CU_ASSERT(odp_packet_flow_hash(pkt[0]) == 0x1234);
+
+	param.last_layer = ODP_PROTO_LAYER_ALL;
+	CU_ASSERT(odp_packet_parse_multi(pkt, 2, &param) == 2);
+
+	/* Outer headers of a VXLAN packet */
+	CU_ASSERT(!odp_packet_has_error(pkt[0]));
+	CU_ASSERT(odp_packet_has_ipv4(pkt[0]));
+	CU_ASSERT(odp_packet_has_udp(pkt[0]));
+	CU_ASSERT(!odp_packet_has_tcp(pkt[0]));
+	CU_ASSERT(odp_packet_l3_offset(pkt[0]) == 14);
+	CU_ASSERT(odp_packet_l4_offset(pkt[0]) == 34);
+	CU_ASSERT(odp_packet_has_flow_hash(pkt[0]));
+
+	/* MPLS label stack is skipped */
+	CU_ASSERT(!odp_packet_has_error(pkt[1]));
+	CU_ASSERT(odp_packet_has_ipv4(pkt[1]));
+	CU_ASSERT(odp_packet_has_udp(pkt[1]));
+	CU_ASSERT(odp_packet_l3_offset(pkt[1]) == 18);
+	CU_ASSERT(odp_packet_l4_offset(pkt[1]) == 38);
+
+	for (i = 0; i < 2; i++)
+		odp_packet_free(pkt[i]);
+}
+
 void packet_test_ref(void)
 {
 	odp_packet_t base_pkt, segmented_base_pkt, hdr_pkt[4],
@@ -2297,6 +2566,121 @@ void packet_test_ref(void)
 	odp_packet_free(ref_pkt[1]);
 }
 
+void packet_test_vector(void)
+{
+	odp_pool_t pool, pkt_pool;
+	odp_pool_param_t params;
+	odp_pool_capability_t capa;
+	odp_packet_vector_t pktv, pktv2;
+	odp_packet_t pkt[VECTOR_TEST_SIZE];
+	odp_packet_t extra;
+	int num;
+	odp_packet_t *pkt_tbl;
+	odp_event_t ev;
+	uint32_t i, size;
+
+	CU_ASSERT_FATAL(odp_pool_capability(&capa) == 0);
+
+	if (capa.vector.max_pools == 0 ||
+	    capa.vector.max_size < VECTOR_TEST_SIZE)
+		return;
+
+	odp_pool_param_init(&params);
+
+	params.type            = ODP_POOL_VECTOR;
+	params.vector.num      = 1;
+	params.vector.max_size = VECTOR_TEST_SIZE;
+
+	pool = odp_pool_create("packet_vector_pool", &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	/* Packet pool with exactly one vector worth of packets */
+	odp_pool_param_init(&params);
+
+	params.type           = ODP_POOL_PACKET;
+	params.pkt.len        = packet_len;
+	params.pkt.num        = VECTOR_TEST_SIZE;
+
+	pkt_pool = odp_pool_create("packet_vector_pkt_pool", &params);
+	CU_ASSERT_FATAL(pkt_pool != ODP_POOL_INVALID);
+
+	pktv = odp_packet_vector_alloc(pool);
+	CU_ASSERT_FATAL(pktv != ODP_PACKET_VECTOR_INVALID);
+	CU_ASSERT(odp_packet_vector_valid(pktv) == 1);
+	CU_ASSERT(odp_packet_vector_pool(pktv) == pool);
+	CU_ASSERT(odp_packet_vector_size(pktv) == 0);
+	CU_ASSERT(odp_packet_vector_to_u64(pktv) !=
+		  odp_packet_vector_to_u64(ODP_PACKET_VECTOR_INVALID));
+
+	/* Pool has only one vector */
+	pktv2 = odp_packet_vector_alloc(pool);
+	CU_ASSERT(pktv2 == ODP_PACKET_VECTOR_INVALID);
+
+	ev = odp_packet_vector_to_event(pktv);
+	CU_ASSERT(odp_event_type(ev) == ODP_EVENT_PACKET_VECTOR);
+	CU_ASSERT(odp_packet_vector_from_event(ev) == pktv);
+
+	/* Fill the vector */
+	CU_ASSERT_FATAL(odp_packet_alloc_multi(pkt_pool, packet_len, pkt,
+					       VECTOR_TEST_SIZE) ==
+			VECTOR_TEST_SIZE);
+
+	size = odp_packet_vector_tbl(pktv, &pkt_tbl);
+	CU_ASSERT(size == 0);
+	CU_ASSERT_FATAL(pkt_tbl != NULL);
+
+	for (i = 0; i < VECTOR_TEST_SIZE; i++)
+		pkt_tbl[i] = pkt[i];
+
+	odp_packet_vector_size_set(pktv, VECTOR_TEST_SIZE);
+	CU_ASSERT(odp_packet_vector_size(pktv) == VECTOR_TEST_SIZE);
+
+	size = odp_packet_vector_tbl(pktv, &pkt_tbl);
+	CU_ASSERT(size == VECTOR_TEST_SIZE);
+
+	for (i = 0; i < size; i++)
+		CU_ASSERT(pkt_tbl[i] == pkt[i]);
+
+	/* Vector free releases only the vector */
+	odp_packet_vector_free(pktv);
+
+	for (i = 0; i < VECTOR_TEST_SIZE; i++)
+		CU_ASSERT(odp_packet_is_valid(pkt[i]) == 1);
+
+	/* Event free releases both the vector and the packets */
+	pktv = odp_packet_vector_alloc(pool);
+	CU_ASSERT_FATAL(pktv != ODP_PACKET_VECTOR_INVALID);
+
+	odp_packet_vector_tbl(pktv, &pkt_tbl);
+	for (i = 0; i < VECTOR_TEST_SIZE; i++)
+		pkt_tbl[i] = pkt[i];
+
+	odp_packet_vector_size_set(pktv, VECTOR_TEST_SIZE);
+
+	/* All packets are in the vector */
+	extra = odp_packet_alloc(pkt_pool, packet_len);
+	CU_ASSERT(extra == ODP_PACKET_INVALID);
+	if (extra != ODP_PACKET_INVALID)
+		odp_packet_free(extra);
+
+	odp_event_free(odp_packet_vector_to_event(pktv));
+
+	/* Both the vector and all the packets are back in their pools */
+	pktv = odp_packet_vector_alloc(pool);
+	CU_ASSERT(pktv != ODP_PACKET_VECTOR_INVALID);
+	num = odp_packet_alloc_multi(pkt_pool, packet_len, pkt,
+				     VECTOR_TEST_SIZE);
+	CU_ASSERT(num == VECTOR_TEST_SIZE);
+
+	if (num > 0)
+		odp_packet_free_multi(pkt, num);
+	if (pktv != ODP_PACKET_VECTOR_INVALID)
+		odp_packet_vector_free(pktv);
+
+	CU_ASSERT(odp_pool_destroy(pkt_pool) == 0);
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
 odp_testinfo_t packet_suite[] = {
 	ODP_TEST_INFO(packet_test_alloc_free),
 	ODP_TEST_INFO(packet_test_alloc_free_multi),
@@ -2320,6 +2704,10 @@ odp_testinfo_t packet_suite[] = {
 	ODP_TEST_INFO(packet_test_concatsplit),
 	ODP_TEST_INFO(packet_test_concat_small),
 	ODP_TEST_INFO(packet_test_concat_extend_trunc),
+	ODP_TEST_INFO(packet_test_split_add_data),
+	ODP_TEST_INFO(packet_test_concat_ref),
+	ODP_TEST_INFO(packet_test_split_push_head),
+	ODP_TEST_INFO(packet_test_unshare_write),
 	ODP_TEST_INFO(packet_test_extend_small),
 	ODP_TEST_INFO(packet_test_extend_large),
 	ODP_TEST_INFO(packet_test_extend_mix),
@@ -2327,6 +2715,8 @@ odp_testinfo_t packet_suite[] = {
 	ODP_TEST_INFO(packet_test_align),
 	ODP_TEST_INFO(packet_test_offset),
 	ODP_TEST_INFO(packet_test_ref),
+	ODP_TEST_INFO(packet_test_parse),
+	ODP_TEST_INFO(packet_test_vector),
 	ODP_TEST_INFO_NULL,
 };
 
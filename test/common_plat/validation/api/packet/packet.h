@@ -32,6 +32,10 @@ void packet_test_copydata(void);
 void packet_test_concatsplit(void);
 void packet_test_concat_small(void);
 void packet_test_concat_extend_trunc(void);
+void packet_test_split_add_data(void);
+void packet_test_concat_ref(void);
+void packet_test_split_push_head(void);
+void packet_test_unshare_write(void);
 void packet_test_extend_small(void);
 void packet_test_extend_large(void);
 void packet_test_extend_mix(void);
@@ -39,6 +43,8 @@ void packet_test_extend_ref(void);
 void packet_test_align(void);
 void packet_test_offset(void);
 void packet_test_ref(void);
+void packet_test_parse(void);
+void packet_test_vector(void);
 
 /* test arrays: */
 extern odp_testinfo_t packet_suite[];
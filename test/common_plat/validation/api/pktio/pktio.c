@@ -23,6 +23,8 @@
 #define TEST_SEQ_MAGIC         0x92749451
 #define TX_BATCH_LEN           4
 #define MAX_QUEUES             128
+#define FLOW_HASH_FLOWS        8
+#define FLOW_HASH_PKTS         (2 * FLOW_HASH_FLOWS)
 
 #define PKTIN_TS_INTERVAL      (50 * ODP_TIME_MSEC_IN_NS)
 #define PKTIN_TS_MIN_RES       1000
@@ -891,6 +893,277 @@ void pktio_test_recv_queue(void)
 	}
 }
 
+void pktio_test_recv_flow_hash(void)
+{
+	odp_pktio_t pktio_tx, pktio_rx;
+	odp_pktio_t pktio[MAX_NUM_IFACES];
+	odp_pktio_capability_t capa;
+	odp_pktin_queue_param_t in_queue_param;
+	odp_pktout_queue_t pktout_queue;
+	odp_pktin_queue_t pktin_queue[MAX_QUEUES];
+	odp_packet_t pkt_tbl[FLOW_HASH_PKTS];
+	odp_packet_t tmp_pkt[FLOW_HASH_PKTS];
+	uint32_t pkt_seq[FLOW_HASH_PKTS];
+	uint32_t flow_hash[FLOW_HASH_FLOWS];
+	int flow_queue[FLOW_HASH_FLOWS];
+	int queue_used[MAX_QUEUES];
+	odp_time_t wait_time, end;
+	odph_udphdr_t *udp;
+	uint32_t hash;
+	int num_used = 0;
+	int num_rx = 0;
+	int num_queues;
+	int flow;
+	int ret;
+	int i, j, k;
+
+	CU_ASSERT_FATAL(num_ifaces >= 1);
+
+	/* Open and configure interfaces */
+	for (i = 0; i < num_ifaces; ++i) {
+		pktio[i] = create_pktio(i, ODP_PKTIN_MODE_DIRECT,
+					ODP_PKTOUT_MODE_DIRECT);
+		CU_ASSERT_FATAL(pktio[i] != ODP_PKTIO_INVALID);
+
+		CU_ASSERT_FATAL(odp_pktio_capability(pktio[i], &capa) == 0);
+
+		odp_pktin_queue_param_init(&in_queue_param);
+		num_queues = (capa.max_input_queues < MAX_QUEUES) ?
+				capa.max_input_queues : MAX_QUEUES;
+		in_queue_param.num_queues  = num_queues;
+		in_queue_param.hash_enable = 1;
+		in_queue_param.hash_proto.proto.ipv4_udp = 1;
+
+		ret = odp_pktin_queue_config(pktio[i], &in_queue_param);
+		CU_ASSERT_FATAL(ret == 0);
+
+		CU_ASSERT_FATAL(odp_pktio_start(pktio[i]) == 0);
+	}
+
+	for (i = 0; i < num_ifaces; ++i)
+		_pktio_wait_linkup(pktio[i]);
+
+	pktio_tx = pktio[0];
+	pktio_rx = (num_ifaces > 1) ? pktio[1] : pktio_tx;
+
+	/* Each flow has its own UDP source port and several packets */
+	ret = create_packets(pkt_tbl, pkt_seq, FLOW_HASH_PKTS, pktio_tx,
+			     pktio_rx);
+	if (ret != FLOW_HASH_PKTS) {
+		for (i = 0; i < ret; i++)
+			odp_packet_free(pkt_tbl[i]);
+		CU_FAIL("Failed to generate test packets");
+		return;
+	}
+
+	for (i = 0; i < FLOW_HASH_PKTS; i++) {
+		udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt_tbl[i], NULL);
+		udp->src_port = odp_cpu_to_be_16(10000 +
+						 i % FLOW_HASH_FLOWS);
+		CU_ASSERT_FATAL(pktio_fixup_checksums(pkt_tbl[i]) == 0);
+	}
+
+	for (i = 0; i < FLOW_HASH_FLOWS; i++)
+		flow_queue[i] = -1;
+
+	for (i = 0; i < MAX_QUEUES; i++)
+		queue_used[i] = 0;
+
+	CU_ASSERT_FATAL(odp_pktout_queue(pktio_tx, &pktout_queue, 1) > 0);
+
+	for (i = 0; i < FLOW_HASH_PKTS; i += ret) {
+		ret = odp_pktout_send(pktout_queue, &pkt_tbl[i],
+				      FLOW_HASH_PKTS - i);
+		CU_ASSERT_FATAL(ret > 0);
+	}
+
+	num_queues = odp_pktin_queue(pktio_rx, pktin_queue, MAX_QUEUES);
+	CU_ASSERT_FATAL(num_queues > 0);
+	if (num_queues > MAX_QUEUES)
+		num_queues = MAX_QUEUES;
+
+	wait_time = odp_time_local_from_ns(ODP_TIME_SEC_IN_NS);
+	end = odp_time_sum(odp_time_local(), wait_time);
+	do {
+		for (i = 0; i < num_queues; i++) {
+			ret = odp_pktin_recv(pktin_queue[i], tmp_pkt,
+					     FLOW_HASH_PKTS);
+			CU_ASSERT_FATAL(ret >= 0);
+
+			for (j = 0; j < ret; j++) {
+				for (k = 0; k < FLOW_HASH_PKTS; k++) {
+					if (pktio_pkt_seq(tmp_pkt[j]) ==
+					    pkt_seq[k])
+						break;
+				}
+
+				if (k == FLOW_HASH_PKTS) {
+					odp_packet_free(tmp_pkt[j]);
+					continue;
+				}
+
+				CU_ASSERT(odp_packet_has_flow_hash(tmp_pkt[j]));
+
+				/* All packets of a flow have the same hash
+				 * and are received from the same queue */
+				flow = k % FLOW_HASH_FLOWS;
+				hash = odp_packet_flow_hash(tmp_pkt[j]);
+				if (flow_queue[flow] < 0) {
+					flow_hash[flow]  = hash;
+					flow_queue[flow] = i;
+				}
+
+				CU_ASSERT(hash == flow_hash[flow]);
+				CU_ASSERT(i == flow_queue[flow]);
+
+				if (!queue_used[i]) {
+					queue_used[i] = 1;
+					num_used++;
+				}
+
+				pkt_tbl[num_rx++] = tmp_pkt[j];
+			}
+		}
+	} while (num_rx < FLOW_HASH_PKTS &&
+		 odp_time_cmp(end, odp_time_local()) > 0);
+
+	CU_ASSERT(num_rx == FLOW_HASH_PKTS);
+
+	/* Flows are spread when there are multiple queues */
+	if (num_queues > 1)
+		CU_ASSERT(num_used > 1);
+
+	for (i = 0; i < num_rx; i++)
+		odp_packet_free(pkt_tbl[i]);
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT_FATAL(odp_pktio_stop(pktio[i]) == 0);
+		CU_ASSERT_FATAL(odp_pktio_close(pktio[i]) == 0);
+	}
+}
+
+void pktio_test_recv_vector(void)
+{
+	odp_pktio_t pktio_tx, pktio_rx;
+	odp_pktio_t pktio[MAX_NUM_IFACES];
+	odp_pktio_capability_t capa;
+	odp_pktin_queue_param_t in_queue_param;
+	odp_pool_param_t params;
+	odp_pool_t vector_pool;
+	odp_packet_vector_t pktv;
+	odp_queue_t outq;
+	odp_packet_t pkt_tbl[TX_BATCH_LEN];
+	odp_packet_t *vec_tbl;
+	uint32_t pkt_seq[TX_BATCH_LEN];
+	odp_time_t wait_time, end;
+	odp_event_t ev;
+	uint32_t size, j;
+	int num_rx = 0;
+	int num_vec = 0;
+	int ret;
+	int i;
+
+	CU_ASSERT_FATAL(num_ifaces >= 1);
+
+	odp_pool_param_init(&params);
+	params.type            = ODP_POOL_VECTOR;
+	params.vector.num      = 2 * TX_BATCH_LEN;
+	params.vector.max_size = TX_BATCH_LEN;
+
+	vector_pool = odp_pool_create("pktio_vector_pool", &params);
+	CU_ASSERT_FATAL(vector_pool != ODP_POOL_INVALID);
+
+	/* Open and configure interfaces */
+	for (i = 0; i < num_ifaces; ++i) {
+		pktio[i] = create_pktio(i, ODP_PKTIN_MODE_SCHED,
+					ODP_PKTOUT_MODE_QUEUE);
+		CU_ASSERT_FATAL(pktio[i] != ODP_PKTIO_INVALID);
+
+		CU_ASSERT_FATAL(odp_pktio_capability(pktio[i], &capa) == 0);
+		CU_ASSERT_FATAL(capa.vector.supported);
+		CU_ASSERT(capa.vector.min_size <= TX_BATCH_LEN);
+		CU_ASSERT(capa.vector.max_size >= TX_BATCH_LEN);
+
+		odp_pktin_queue_param_init(&in_queue_param);
+		in_queue_param.queue_param.sched.sync = ODP_SCHED_SYNC_ATOMIC;
+		in_queue_param.vector.enable   = 1;
+		in_queue_param.vector.pool     = vector_pool;
+		in_queue_param.vector.max_size = TX_BATCH_LEN;
+
+		ret = odp_pktin_queue_config(pktio[i], &in_queue_param);
+		CU_ASSERT_FATAL(ret == 0);
+
+		CU_ASSERT_FATAL(odp_pktio_start(pktio[i]) == 0);
+	}
+
+	for (i = 0; i < num_ifaces; ++i)
+		_pktio_wait_linkup(pktio[i]);
+
+	pktio_tx = pktio[0];
+	pktio_rx = (num_ifaces > 1) ? pktio[1] : pktio_tx;
+
+	ret = create_packets(pkt_tbl, pkt_seq, TX_BATCH_LEN, pktio_tx,
+			     pktio_rx);
+	if (ret != TX_BATCH_LEN) {
+		CU_FAIL("Failed to generate test packets");
+		return;
+	}
+
+	/* Send all packets as a single vector event */
+	pktv = odp_packet_vector_alloc(vector_pool);
+	CU_ASSERT_FATAL(pktv != ODP_PACKET_VECTOR_INVALID);
+
+	odp_packet_vector_tbl(pktv, &vec_tbl);
+	for (i = 0; i < TX_BATCH_LEN; i++)
+		vec_tbl[i] = pkt_tbl[i];
+	odp_packet_vector_size_set(pktv, TX_BATCH_LEN);
+
+	CU_ASSERT_FATAL(odp_pktout_event_queue(pktio_tx, &outq, 1) == 1);
+	CU_ASSERT_FATAL(odp_queue_enq(outq,
+				      odp_packet_vector_to_event(pktv)) == 0);
+
+	/* Packets are received in order, in vectors or as packets */
+	wait_time = odp_time_local_from_ns(ODP_TIME_SEC_IN_NS);
+	end = odp_time_sum(odp_time_local(), wait_time);
+	do {
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		if (odp_event_type(ev) == ODP_EVENT_PACKET_VECTOR) {
+			pktv = odp_packet_vector_from_event(ev);
+			CU_ASSERT(odp_packet_vector_valid(pktv) == 1);
+			size = odp_packet_vector_tbl(pktv, &vec_tbl);
+			CU_ASSERT(size > 0 && size <= TX_BATCH_LEN);
+			num_vec++;
+		} else {
+			CU_ASSERT(odp_event_type(ev) == ODP_EVENT_PACKET);
+			pkt_tbl[0] = odp_packet_from_event(ev);
+			vec_tbl = pkt_tbl;
+			size = 1;
+		}
+
+		for (j = 0; j < size && num_rx < TX_BATCH_LEN; j++) {
+			if (pktio_pkt_seq(vec_tbl[j]) == pkt_seq[num_rx])
+				num_rx++;
+		}
+
+		odp_event_free(ev);
+	} while (num_rx < TX_BATCH_LEN &&
+		 odp_time_cmp(end, odp_time_local()) > 0);
+
+	CU_ASSERT(num_rx == TX_BATCH_LEN);
+	CU_ASSERT(num_vec > 0);
+
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT_FATAL(odp_pktio_stop(pktio[i]) == 0);
+		flush_input_queue(pktio[i], ODP_PKTIN_MODE_SCHED);
+		CU_ASSERT_FATAL(odp_pktio_close(pktio[i]) == 0);
+	}
+
+	CU_ASSERT(odp_pool_destroy(vector_pool) == 0);
+}
+
 static void test_recv_tmo(recv_tmo_mode_e mode)
 {
 	odp_pktio_t pktio_tx, pktio_rx;
@@ -2019,6 +2292,93 @@ void pktio_test_pktin_ts(void)
 	}
 }
 
+int pktio_check_pktin_zero_copy(void)
+{
+	odp_pktio_t pktio;
+	odp_pktio_capability_t capa;
+	odp_pktio_param_t pktio_param;
+	int ret;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	pktio = odp_pktio_open(iface_name[0], pool[0], &pktio_param);
+	if (pktio == ODP_PKTIO_INVALID)
+		return ODP_TEST_INACTIVE;
+
+	ret = odp_pktio_capability(pktio, &capa);
+	(void)odp_pktio_close(pktio);
+
+	if (ret < 0 || !capa.config.pktin.bit.zero_copy)
+		return ODP_TEST_INACTIVE;
+
+	return ODP_TEST_ACTIVE;
+}
+
+void pktio_test_pktin_zero_copy(void)
+{
+	odp_pktio_t pktio_tx, pktio_rx;
+	odp_pktio_t pktio[MAX_NUM_IFACES];
+	pktio_info_t pktio_rx_info;
+	odp_pktio_config_t config;
+	odp_pktout_queue_t pktout_queue;
+	odp_packet_t pkt_tbl[TX_BATCH_LEN];
+	uint32_t pkt_seq[TX_BATCH_LEN];
+	int num_rx;
+	int ret;
+	int i;
+
+	CU_ASSERT_FATAL(num_ifaces >= 1);
+
+	/* Open and configure interfaces */
+	for (i = 0; i < num_ifaces; ++i) {
+		pktio[i] = create_pktio(i, ODP_PKTIN_MODE_DIRECT,
+					ODP_PKTOUT_MODE_DIRECT);
+		CU_ASSERT_FATAL(pktio[i] != ODP_PKTIO_INVALID);
+
+		odp_pktio_config_init(&config);
+		config.pktin.bit.zero_copy = 1;
+		CU_ASSERT_FATAL(odp_pktio_config(pktio[i], &config) == 0);
+
+		CU_ASSERT_FATAL(odp_pktio_start(pktio[i]) == 0);
+	}
+
+	for (i = 0; i < num_ifaces; i++)
+		_pktio_wait_linkup(pktio[i]);
+
+	pktio_tx = pktio[0];
+	pktio_rx = (num_ifaces > 1) ? pktio[1] : pktio_tx;
+	pktio_rx_info.id   = pktio_rx;
+	pktio_rx_info.inq  = ODP_QUEUE_INVALID;
+	pktio_rx_info.in_mode = ODP_PKTIN_MODE_DIRECT;
+
+	ret = create_packets(pkt_tbl, pkt_seq, TX_BATCH_LEN, pktio_tx,
+			     pktio_rx);
+	CU_ASSERT_FATAL(ret == TX_BATCH_LEN);
+
+	ret = odp_pktout_queue(pktio_tx, &pktout_queue, 1);
+	CU_ASSERT_FATAL(ret > 0);
+
+	CU_ASSERT_FATAL(odp_pktout_send(pktout_queue, pkt_tbl,
+					TX_BATCH_LEN) == TX_BATCH_LEN);
+
+	num_rx = wait_for_packets(&pktio_rx_info, pkt_tbl, pkt_seq,
+				  TX_BATCH_LEN, TXRX_MODE_MULTI,
+				  ODP_TIME_SEC_IN_NS);
+	CU_ASSERT(num_rx == TX_BATCH_LEN);
+
+	/* Received packets stay valid after the interfaces are closed */
+	for (i = 0; i < num_ifaces; i++) {
+		CU_ASSERT_FATAL(odp_pktio_stop(pktio[i]) == 0);
+		CU_ASSERT_FATAL(odp_pktio_close(pktio[i]) == 0);
+	}
+
+	for (i = 0; i < num_rx; i++) {
+		CU_ASSERT(pktio_pkt_seq(pkt_tbl[i]) == pkt_seq[i]);
+		odp_packet_free(pkt_tbl[i]);
+	}
+}
+
 static int create_pool(const char *iface, int num)
 {
 	char pool_name[ODP_POOL_NAME_LEN];
@@ -2143,6 +2503,8 @@ odp_testinfo_t pktio_suite_unsegmented[] = {
 	ODP_TEST_INFO(pktio_test_recv),
 	ODP_TEST_INFO(pktio_test_recv_multi),
 	ODP_TEST_INFO(pktio_test_recv_queue),
+	ODP_TEST_INFO(pktio_test_recv_flow_hash),
+	ODP_TEST_INFO(pktio_test_recv_vector),
 	ODP_TEST_INFO(pktio_test_recv_tmo),
 	ODP_TEST_INFO(pktio_test_recv_mq_tmo),
 	ODP_TEST_INFO(pktio_test_recv_mtu),
@@ -2161,6 +2523,8 @@ odp_testinfo_t pktio_suite_unsegmented[] = {
 				  pktio_check_statistics_counters),
 	ODP_TEST_INFO_CONDITIONAL(pktio_test_pktin_ts,
 				  pktio_check_pktin_ts),
+	ODP_TEST_INFO_CONDITIONAL(pktio_test_pktin_zero_copy,
+				  pktio_check_pktin_zero_copy),
 	ODP_TEST_INFO_NULL
 };
 
@@ -17,6 +17,8 @@ void pktio_test_sched_multi(void);
 void pktio_test_recv(void);
 void pktio_test_recv_multi(void);
 void pktio_test_recv_queue(void);
+void pktio_test_recv_flow_hash(void);
+void pktio_test_recv_vector(void);
 void pktio_test_recv_tmo(void);
 void pktio_test_recv_mq_tmo(void);
 void pktio_test_recv_mtu(void);
@@ -46,6 +48,8 @@ int pktio_check_statistics_counters(void);
 void pktio_test_statistics_counters(void);
 int pktio_check_pktin_ts(void);
 void pktio_test_pktin_ts(void);
+int pktio_check_pktin_zero_copy(void);
+void pktio_test_pktin_zero_copy(void);
 
 /* test arrays: */
 extern odp_testinfo_t pktio_suite[];
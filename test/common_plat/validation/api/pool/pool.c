@@ -94,11 +94,236 @@ void pool_test_lookup_info_print(void)
 	CU_ASSERT(odp_pool_destroy(pool) == 0);
 }
 
+void pool_test_numa(void)
+{
+	odp_pool_t pool;
+	odp_pool_info_t info;
+	odp_pool_capability_t capa;
+	odp_buffer_t buf[default_buffer_num];
+	uint32_t i, num_nodes, sum;
+	int num;
+	odp_pool_param_t params = {
+			.buf = {
+				.size  = default_buffer_size,
+				.num   = default_buffer_num,
+			},
+			.type  = ODP_POOL_BUFFER,
+			.numa  = 1,
+	};
+
+	CU_ASSERT_FATAL(odp_pool_capability(&capa) == 0);
+	CU_ASSERT(capa.numa_nodes >= 1);
+	CU_ASSERT(capa.numa_nodes <= ODP_POOL_MAX_NODES);
+
+	pool = odp_pool_create(NULL, &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	num_nodes = info.num_nodes;
+	CU_ASSERT(num_nodes >= 1);
+	CU_ASSERT(num_nodes <= capa.numa_nodes);
+
+	sum = 0;
+	for (i = 0; i < num_nodes; i++) {
+		CU_ASSERT(info.node[i].num_free == info.node[i].num);
+		sum += info.node[i].num;
+	}
+
+	CU_ASSERT(sum == params.buf.num);
+
+	/* All buffers can be allocated, also from remote nodes */
+	num = 0;
+	while (num < default_buffer_num) {
+		buf[num] = odp_buffer_alloc(pool);
+
+		if (buf[num] == ODP_BUFFER_INVALID)
+			break;
+
+		num++;
+	}
+
+	CU_ASSERT(num == default_buffer_num);
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	for (i = 0; i < num_nodes; i++)
+		CU_ASSERT(info.node[i].num_free == 0);
+
+	odp_buffer_free_multi(buf, num);
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	for (i = 0; i < num_nodes; i++)
+		CU_ASSERT(info.node[i].num_free <= info.node[i].num);
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
+void pool_test_cache_param(void)
+{
+	odp_pool_t pool;
+	odp_pool_info_t info;
+	odp_pool_capability_t capa;
+	odp_buffer_t buf[32];
+	int i, j, num;
+	odp_pool_param_t params = {
+			.buf = {
+				.size  = default_buffer_size,
+				.num   = default_buffer_num,
+			},
+			.type  = ODP_POOL_BUFFER,
+	};
+
+	CU_ASSERT_FATAL(odp_pool_capability(&capa) == 0);
+
+	/* Too large cache falls back to the default size */
+	params.cache.size = capa.max_cache_size + 1;
+	pool = odp_pool_create(NULL, &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.params.cache.size > 0);
+	CU_ASSERT(info.params.cache.size <= capa.max_cache_size);
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+
+	/* Too large refill falls back to the default refill */
+	params.cache.size   = 16;
+	params.cache.refill = params.cache.size + 1;
+	pool = odp_pool_create(NULL, &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.params.cache.size == 16);
+	CU_ASSERT(info.params.cache.refill <= 16);
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+
+	params.cache.refill = 8;
+	params.cache.flush  = 4;
+
+	pool = odp_pool_create(NULL, &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.params.cache.size == params.cache.size);
+	CU_ASSERT(info.cache.alloc_hit + info.cache.alloc_miss == 0);
+
+	/* Alloc and free bursts larger and smaller than the cache */
+	for (i = 0; i < 100; i++) {
+		int max = (i % 2) ? 32 : 2;
+
+		num = odp_buffer_alloc_multi(pool, buf, max);
+		CU_ASSERT(num == max);
+
+		for (j = 0; j < num; j++)
+			odp_buffer_free(buf[j]);
+	}
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.cache.alloc_hit + info.cache.alloc_miss == 100);
+	CU_ASSERT(info.cache.free_hit + info.cache.free_miss ==
+		  50 * 32 + 50 * 2);
+	CU_ASSERT(info.cache.alloc_miss > 0);
+	CU_ASSERT(info.cache.free_miss > 0);
+
+	odp_pool_print(pool);
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
+void pool_test_pkt_room(void)
+{
+	odp_pool_t pool;
+	odp_pool_capability_t capa;
+	odp_packet_t pkt;
+	void *data;
+	uint32_t headroom, tailroom;
+	odp_pool_param_t params;
+
+	CU_ASSERT_FATAL(odp_pool_capability(&capa) == 0);
+
+	headroom = capa.pkt.max_headroom;
+	tailroom = capa.pkt.max_tailroom;
+
+	if (headroom > 256)
+		headroom = 256;
+
+	if (tailroom > 64)
+		tailroom = 64;
+
+	odp_pool_param_init(&params);
+	params.type         = ODP_POOL_PACKET;
+	params.pkt.len      = 512;
+	params.pkt.num      = default_buffer_num;
+	params.pkt.headroom = headroom;
+	params.pkt.tailroom = tailroom;
+
+	/* Too large headroom */
+	if (capa.pkt.max_headroom) {
+		params.pkt.headroom = capa.pkt.max_headroom + 1;
+		CU_ASSERT(odp_pool_create(NULL, &params) == ODP_POOL_INVALID);
+		params.pkt.headroom = headroom;
+	}
+
+	pool = odp_pool_create(NULL, &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	pkt = odp_packet_alloc(pool, params.pkt.len);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+
+	CU_ASSERT(odp_packet_headroom(pkt) >= headroom);
+	CU_ASSERT(odp_packet_tailroom(pkt) >= tailroom);
+
+	/* Whole headroom is usable without moving data */
+	data = odp_packet_data(pkt);
+	CU_ASSERT(odp_packet_push_head(pkt, headroom) ==
+		  (uint8_t *)data - headroom);
+	CU_ASSERT(odp_packet_push_tail(pkt, tailroom) != NULL);
+	CU_ASSERT(odp_packet_len(pkt) == params.pkt.len + headroom + tailroom);
+
+	odp_packet_free(pkt);
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
+void pool_test_shm_flags(void)
+{
+	odp_pool_t pool;
+	odp_pool_info_t info;
+	odp_buffer_t buf;
+	odp_pool_param_t params;
+
+	odp_pool_param_init(&params);
+	params.type     = ODP_POOL_BUFFER;
+	params.buf.size = default_buffer_size;
+	params.buf.num  = default_buffer_num;
+
+	/* Only page size and pre-fault flags are allowed */
+	params.shm_flags = ODP_SHM_PROC;
+	CU_ASSERT(odp_pool_create(NULL, &params) == ODP_POOL_INVALID);
+
+	/* Pre-faulting may fail due to locked memory limits */
+	params.shm_flags = ODP_SHM_PREFAULT;
+	pool = odp_pool_create(NULL, &params);
+	if (pool == ODP_POOL_INVALID) {
+		printf("\n    Pre-faulted pool not created, skipped.\n");
+		return;
+	}
+
+	CU_ASSERT_FATAL(odp_pool_info(pool, &info) == 0);
+	CU_ASSERT(info.params.shm_flags == ODP_SHM_PREFAULT);
+
+	buf = odp_buffer_alloc(pool);
+	CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+	odp_buffer_free(buf);
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
 odp_testinfo_t pool_suite[] = {
 	ODP_TEST_INFO(pool_test_create_destroy_buffer),
 	ODP_TEST_INFO(pool_test_create_destroy_packet),
 	ODP_TEST_INFO(pool_test_create_destroy_timeout),
 	ODP_TEST_INFO(pool_test_lookup_info_print),
+	ODP_TEST_INFO(pool_test_numa),
+	ODP_TEST_INFO(pool_test_cache_param),
+	ODP_TEST_INFO(pool_test_pkt_room),
+	ODP_TEST_INFO(pool_test_shm_flags),
 	ODP_TEST_INFO_NULL,
 };
 
@@ -15,6 +15,10 @@ void pool_test_create_destroy_packet(void);
 void pool_test_create_destroy_timeout(void);
 void pool_test_create_destroy_buffer_shm(void);
 void pool_test_lookup_info_print(void);
+void pool_test_numa(void);
+void pool_test_cache_param(void);
+void pool_test_pkt_room(void);
+void pool_test_shm_flags(void);
 
 /* test arrays: */
 extern odp_testinfo_t pool_suite[];
@@ -31,6 +31,7 @@ int queue_suite_init(void)
 {
 	odp_pool_param_t params;
 
+	odp_pool_param_init(&params);
 	params.buf.size  = 0;
 	params.buf.align = ODP_CACHE_LINE_SIZE;
 	params.buf.num   = 1024 * 10;
@@ -240,6 +241,67 @@ void queue_test_param(void)
 	CU_ASSERT(odp_queue_destroy(queue) == 0);
 }
 
+void queue_test_size(void)
+{
+	odp_queue_capability_t capa;
+	odp_queue_param_t param;
+	odp_queue_t queue;
+	odp_buffer_t buf;
+	odp_event_t ev[MAX_BUFFER_QUEUE];
+	odp_event_t deev[MAX_BUFFER_QUEUE];
+	int i, ret, num;
+
+	CU_ASSERT_FATAL(odp_queue_capability(&capa) == 0);
+
+	if (capa.max_size == 0)
+		return;
+
+	CU_ASSERT(capa.max_size >= MAX_BUFFER_QUEUE);
+
+	odp_queue_param_init(&param);
+	CU_ASSERT(param.size == 0);
+
+	param.size = capa.max_size + 1;
+	CU_ASSERT(odp_queue_create("test_queue_size", &param) ==
+		  ODP_QUEUE_INVALID);
+
+	param.size = MAX_BUFFER_QUEUE;
+	queue = odp_queue_create("test_queue_size", &param);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	for (i = 0; i < MAX_BUFFER_QUEUE; i++) {
+		buf = odp_buffer_alloc(pool);
+		CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+		ev[i] = odp_buffer_to_event(buf);
+	}
+
+	/* Queue must store at least 'size' events */
+	ret = odp_queue_enq_multi(queue, ev, MAX_BUFFER_QUEUE);
+	CU_ASSERT(ret == MAX_BUFFER_QUEUE);
+	i = ret < 0 ? 0 : ret;
+	for ( ; i < MAX_BUFFER_QUEUE; i++)
+		odp_event_free(ev[i]);
+
+	num = 0;
+	for (i = 0; i < CONFIG_MAX_ITERATION && num < MAX_BUFFER_QUEUE; i++) {
+		ret = odp_queue_deq_multi(queue, &deev[num],
+					  MAX_BUFFER_QUEUE - num);
+		CU_ASSERT(ret >= 0);
+		if (ret > 0)
+			num += ret;
+	}
+
+	CU_ASSERT(num == MAX_BUFFER_QUEUE);
+
+	for (i = 0; i < num; i++) {
+		CU_ASSERT(deev[i] == ev[i]);
+		odp_event_free(deev[i]);
+	}
+
+	CU_ASSERT(odp_queue_deq(queue) == ODP_EVENT_INVALID);
+	CU_ASSERT(odp_queue_destroy(queue) == 0);
+}
+
 void queue_test_info(void)
 {
 	odp_queue_t q_plain, q_order;
@@ -303,6 +365,7 @@ odp_testinfo_t queue_suite[] = {
 	ODP_TEST_INFO(queue_test_capa),
 	ODP_TEST_INFO(queue_test_mode),
 	ODP_TEST_INFO(queue_test_param),
+	ODP_TEST_INFO(queue_test_size),
 	ODP_TEST_INFO(queue_test_info),
 	ODP_TEST_INFO_NULL,
 };
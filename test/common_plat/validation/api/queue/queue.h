@@ -13,6 +13,7 @@
 void queue_test_capa(void);
 void queue_test_mode(void);
 void queue_test_param(void);
+void queue_test_size(void);
 void queue_test_info(void);
 
 /* test arrays: */
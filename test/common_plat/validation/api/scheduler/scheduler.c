@@ -19,6 +19,7 @@
 #define NUM_BUFS_PAUSE		1000
 #define NUM_BUFS_BEFORE_PAUSE	10
 #define NUM_GROUPS              2
+#define NUM_PREFETCH_QUEUES     4
 
 #define GLOBALS_SHM_NAME	"test_globals"
 #define MSG_POOL_NAME		"msg_pool"
@@ -62,6 +63,11 @@ typedef struct {
 		odp_queue_t handle;
 		char name[ODP_QUEUE_NAME_LEN];
 	} chaos_q[CHAOS_NUM_QUEUES];
+	struct {
+		odp_queue_t oq;
+		odp_queue_t pq;
+		odp_atomic_u32_t step;
+	} stash;
 } test_globals_t;
 
 typedef struct {
@@ -1332,6 +1338,177 @@ void scheduler_test_pause_resume(void)
 	CU_ASSERT(ret == 0);
 }
 
+static void stash_wait_step(test_globals_t *globals, uint32_t step)
+{
+	while (odp_atomic_load_u32(&globals->stash.step) < step)
+		odp_cpu_pause();
+}
+
+static int stash_thread(void *arg)
+{
+	thread_args_t *args = arg;
+	test_globals_t *globals = args->globals;
+	odp_queue_t from;
+	odp_event_t ev;
+
+	/* Second ordered context, which enqueues out of order */
+	ev = odp_schedule(&from, ODP_SCHED_WAIT);
+	CU_ASSERT_FATAL(ev != ODP_EVENT_INVALID);
+	CU_ASSERT(from == globals->stash.oq);
+	CU_ASSERT(odp_queue_enq(globals->stash.pq, ev) == 0);
+	odp_atomic_store_u32(&globals->stash.step, 1);
+
+	/* Release the stash after the first context has been released */
+	stash_wait_step(globals, 2);
+	odp_schedule_release_ordered();
+
+	exit_schedule_loop();
+	return 0;
+}
+
+void scheduler_test_ordered_stash_release(void)
+{
+	test_globals_t *globals;
+	thread_args_t *args;
+	odp_queue_param_t qp;
+	odp_buffer_t buf;
+	odp_event_t ev;
+	odp_queue_t from;
+	odp_shm_t shm;
+	int num = 0;
+
+	shm = odp_shm_lookup(GLOBALS_SHM_NAME);
+	CU_ASSERT_FATAL(shm != ODP_SHM_INVALID);
+	globals = odp_shm_addr(shm);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(globals);
+
+	shm = odp_shm_lookup(SHM_THR_ARGS_NAME);
+	CU_ASSERT_FATAL(shm != ODP_SHM_INVALID);
+	args = odp_shm_addr(shm);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(args);
+
+	pool = odp_pool_lookup(MSG_POOL_NAME);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	odp_queue_param_init(&qp);
+	qp.type        = ODP_QUEUE_TYPE_SCHED;
+	qp.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
+	qp.sched.sync  = ODP_SCHED_SYNC_ORDERED;
+	qp.sched.group = ODP_SCHED_GROUP_ALL;
+	globals->stash.oq = odp_queue_create("stash_ordered", &qp);
+	CU_ASSERT_FATAL(globals->stash.oq != ODP_QUEUE_INVALID);
+
+	globals->stash.pq = odp_queue_create("stash_plain", NULL);
+	CU_ASSERT_FATAL(globals->stash.pq != ODP_QUEUE_INVALID);
+	odp_atomic_init_u32(&globals->stash.step, 0);
+
+	/* First ordered context */
+	buf = odp_buffer_alloc(pool);
+	CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+	CU_ASSERT_FATAL(odp_queue_enq(globals->stash.oq,
+				      odp_buffer_to_event(buf)) == 0);
+	ev = odp_schedule(&from, ODP_SCHED_WAIT);
+	CU_ASSERT_FATAL(ev != ODP_EVENT_INVALID);
+	CU_ASSERT(from == globals->stash.oq);
+
+	/* Event for the second context is enqueued in order */
+	buf = odp_buffer_alloc(pool);
+	CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+	CU_ASSERT_FATAL(odp_queue_enq(globals->stash.oq,
+				      odp_buffer_to_event(buf)) == 0);
+
+	args->globals = globals;
+	args->cu_thr.numthrds = 1;
+	odp_cunit_thread_create(stash_thread, &args->cu_thr);
+
+	stash_wait_step(globals, 1);
+	odp_event_free(ev);
+	odp_schedule_release_ordered();
+	odp_atomic_store_u32(&globals->stash.step, 2);
+
+	odp_cunit_thread_exit(&args->cu_thr);
+
+	/* Stashed event must be enqueued exactly once */
+	while ((ev = odp_queue_deq(globals->stash.pq)) != ODP_EVENT_INVALID) {
+		odp_event_free(ev);
+		num++;
+	}
+
+	CU_ASSERT(num == 1);
+
+	exit_schedule_loop();
+	CU_ASSERT(odp_queue_destroy(globals->stash.pq) == 0);
+	CU_ASSERT(odp_queue_destroy(globals->stash.oq) == 0);
+}
+
+void scheduler_test_prefetch(void)
+{
+	odp_queue_t queue[NUM_PREFETCH_QUEUES];
+	int count[NUM_PREFETCH_QUEUES];
+	odp_buffer_t buf;
+	odp_event_t ev;
+	odp_queue_t from;
+	char name[32];
+	int i, j, ret;
+	int num = 0;
+
+	pool = odp_pool_lookup(MSG_POOL_NAME);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	for (i = 0; i < NUM_PREFETCH_QUEUES; i++) {
+		snprintf(name, sizeof(name), "sched_0_%d_n", i);
+		queue[i] = odp_queue_lookup(name);
+		CU_ASSERT_FATAL(queue[i] != ODP_QUEUE_INVALID);
+		count[i] = 0;
+
+		for (j = 0; j < BUFS_PER_QUEUE; j++) {
+			buf = odp_buffer_alloc(pool);
+			CU_ASSERT_FATAL(buf != ODP_BUFFER_INVALID);
+			ev = odp_buffer_to_event(buf);
+			ret = odp_queue_enq(queue[i], ev);
+			CU_ASSERT(ret == 0);
+
+			if (ret)
+				odp_buffer_free(buf);
+			else
+				num++;
+		}
+	}
+
+	/* Pause with prefetched events. Those must still be output. */
+	odp_schedule_prefetch(NUM_PREFETCH_QUEUES * BUFS_PER_QUEUE);
+	odp_schedule_pause();
+
+	while (num) {
+		ev = odp_schedule(&from, ODP_SCHED_NO_WAIT);
+
+		if (ev == ODP_EVENT_INVALID) {
+			odp_schedule_resume();
+			continue;
+		}
+
+		for (i = 0; i < NUM_PREFETCH_QUEUES; i++) {
+			if (from == queue[i])
+				break;
+		}
+
+		CU_ASSERT_FATAL(i < NUM_PREFETCH_QUEUES);
+		count[i]++;
+		num--;
+
+		odp_event_free(ev);
+		odp_schedule_prefetch(BURST_BUF_SIZE);
+	}
+
+	for (i = 0; i < NUM_PREFETCH_QUEUES; i++)
+		CU_ASSERT(count[i] == BUFS_PER_QUEUE);
+
+	odp_schedule_resume();
+	ret = exit_schedule_loop();
+
+	CU_ASSERT(ret == 0);
+}
+
 static int create_queues(void)
 {
 	int i, j, prios, rc;
@@ -1612,6 +1789,8 @@ odp_testinfo_t scheduler_suite[] = {
 	ODP_TEST_INFO(scheduler_test_queue_destroy),
 	ODP_TEST_INFO(scheduler_test_groups),
 	ODP_TEST_INFO(scheduler_test_pause_resume),
+	ODP_TEST_INFO(scheduler_test_prefetch),
+	ODP_TEST_INFO(scheduler_test_ordered_stash_release),
 	ODP_TEST_INFO(scheduler_test_parallel),
 	ODP_TEST_INFO(scheduler_test_atomic),
 	ODP_TEST_INFO(scheduler_test_ordered),
@@ -45,6 +45,8 @@ void scheduler_test_multi_mq_mt_prio_a(void);
 void scheduler_test_multi_mq_mt_prio_o(void);
 void scheduler_test_multi_1q_mt_a_excl(void);
 void scheduler_test_pause_resume(void);
+void scheduler_test_prefetch(void);
+void scheduler_test_ordered_stash_release(void);
 
 /* test arrays: */
 extern odp_testinfo_t scheduler_suite[];
@@ -708,11 +708,68 @@ void shmem_test_stress(void)
 	/* check that no memory is left over: */
 }
 
+/*
+ * test huge page size selection and pre-faulting
+ */
+void shmem_test_page_size(void)
+{
+	odp_shm_capability_t capa;
+	odp_shm_info_t info;
+	odp_shm_t shm;
+	shared_test_data_small_t *data;
+	int i;
+	const uint32_t hp_flag[2] = {ODP_SHM_HP_2M, ODP_SHM_HP_1G};
+	const uint64_t hp_size[2] = {2 * 1024 * 1024ULL, 1024 * 1024 * 1024ULL};
+
+	CU_ASSERT_FATAL(odp_shm_capability(&capa) == 0);
+
+	shm = odp_shm_reserve(MEM_NAME, sizeof(shared_test_data_small_t),
+			      0, ODP_SHM_PREFAULT);
+	CU_ASSERT_FATAL(ODP_SHM_INVALID != shm);
+	data = odp_shm_addr(shm);
+	CU_ASSERT_FATAL(NULL != data);
+	data->data[0] = TEST_SHARE_FOO;
+	CU_ASSERT(0 == odp_shm_info(shm, &info));
+	CU_ASSERT(ODP_SHM_PREFAULT == info.flags);
+	CU_ASSERT((info.page_size == odp_sys_huge_page_size()) ||
+		  (info.page_size == odp_sys_page_size()));
+	CU_ASSERT(0 == odp_shm_free(shm));
+
+	/* only one page size can be required */
+	shm = odp_shm_reserve(MEM_NAME, sizeof(shared_test_data_small_t), 0,
+			      ODP_SHM_HP_2M | ODP_SHM_HP_1G);
+	CU_ASSERT(ODP_SHM_INVALID == shm);
+
+	for (i = 0; i < 2; i++) {
+		shm = odp_shm_reserve(MEM_NAME,
+				      sizeof(shared_test_data_small_t), 0,
+				      hp_flag[i]);
+
+		if (!(capa.hp_flags & hp_flag[i])) {
+			CU_ASSERT(ODP_SHM_INVALID == shm);
+			continue;
+		}
+
+		/* page size is supported, but pages may have run out */
+		if (ODP_SHM_INVALID == shm) {
+			printf("  no free %" PRIu64 " kB huge pages\n",
+			       hp_size[i] / 1024);
+			continue;
+		}
+
+		CU_ASSERT(0 == odp_shm_info(shm, &info));
+		CU_ASSERT(hp_size[i] == info.page_size);
+		odp_shm_print_all();
+		CU_ASSERT(0 == odp_shm_free(shm));
+	}
+}
+
 odp_testinfo_t shmem_suite[] = {
 	ODP_TEST_INFO(shmem_test_basic),
 	ODP_TEST_INFO(shmem_test_reserve_after_fork),
 	ODP_TEST_INFO(shmem_test_singleva_after_fork),
 	ODP_TEST_INFO(shmem_test_stress),
+	ODP_TEST_INFO(shmem_test_page_size),
 	ODP_TEST_INFO_NULL,
 };
 
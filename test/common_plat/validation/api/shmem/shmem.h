@@ -14,6 +14,7 @@ void shmem_test_basic(void);
 void shmem_test_reserve_after_fork(void);
 void shmem_test_singleva_after_fork(void);
 void shmem_test_stress(void);
+void shmem_test_page_size(void);
 
 /* test arrays: */
 extern odp_testinfo_t shmem_suite[];
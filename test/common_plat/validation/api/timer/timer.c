@@ -150,6 +150,7 @@ void timer_test_odp_timer_cancel(void)
 	if (pool == ODP_POOL_INVALID)
 		CU_FAIL_FATAL("Timeout pool create failed");
 
+	odp_timer_pool_param_init(&tparam);
 	tparam.res_ns     = 100 * ODP_TIME_MSEC_IN_NS;
 	tparam.min_tmo    = 1   * ODP_TIME_SEC_IN_NS;
 	tparam.max_tmo    = 10  * ODP_TIME_SEC_IN_NS;
@@ -216,6 +217,365 @@ void timer_test_odp_timer_cancel(void)
 		CU_FAIL_FATAL("Failed to destroy pool");
 }
 
+#define DRIVE_TIMERS 8
+
+/* @private Expire timers of a pool with the drive mode */
+static void test_drive(odp_timer_drive_t drive)
+{
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	odp_timer_pool_param_t tparam;
+	odp_timer_pool_t tp;
+	odp_queue_t queue;
+	odp_timer_t tim[DRIVE_TIMERS];
+	odp_event_t ev;
+	odp_timeout_t tmo;
+	odp_time_t end;
+	uint64_t tick;
+	int i, num = 0;
+
+	odp_pool_param_init(&params);
+	params.type    = ODP_POOL_TIMEOUT;
+	params.tmo.num = DRIVE_TIMERS;
+
+	pool = odp_pool_create("tmo_pool_for_drive", &params);
+	if (pool == ODP_POOL_INVALID)
+		CU_FAIL_FATAL("Timeout pool create failed");
+
+	odp_timer_pool_param_init(&tparam);
+	CU_ASSERT(tparam.drive == ODP_TIMER_DRIVE_SIGNAL);
+	CU_ASSERT(tparam.drive_cpu < 0);
+	tparam.res_ns     = ODP_TIME_MSEC_IN_NS;
+	tparam.min_tmo    = ODP_TIME_MSEC_IN_NS;
+	tparam.max_tmo    = ODP_TIME_SEC_IN_NS;
+	tparam.num_timers = DRIVE_TIMERS;
+	tparam.drive      = drive;
+	tp = odp_timer_pool_create(NULL, &tparam);
+	if (tp == ODP_TIMER_POOL_INVALID)
+		CU_FAIL_FATAL("Timer pool create failed");
+
+	odp_timer_pool_start();
+
+	queue = odp_queue_create("timer_drive_queue", NULL);
+	if (queue == ODP_QUEUE_INVALID)
+		CU_FAIL_FATAL("Queue create failed");
+
+	for (i = 0; i < DRIVE_TIMERS; i++) {
+		tim[i] = odp_timer_alloc(tp, queue, NULL);
+		CU_ASSERT_FATAL(tim[i] != ODP_TIMER_INVALID);
+
+		ev = odp_timeout_to_event(odp_timeout_alloc(pool));
+		CU_ASSERT_FATAL(ev != ODP_EVENT_INVALID);
+
+		tick = odp_timer_ns_to_tick(tp, (i + 1) * 10 *
+					    ODP_TIME_MSEC_IN_NS);
+		CU_ASSERT(odp_timer_set_rel(tim[i], tick, &ev) ==
+			  ODP_TIMER_SUCCESS);
+	}
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(ODP_TIME_SEC_IN_NS));
+
+	while (num < DRIVE_TIMERS && odp_time_cmp(end, odp_time_local()) > 0) {
+		/* Inline driven timers expire in idle schedule calls */
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+		if (ev != ODP_EVENT_INVALID)
+			odp_event_free(ev);
+
+		ev = odp_queue_deq(queue);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		tmo = odp_timeout_from_event(ev);
+		CU_ASSERT(odp_timeout_tick(tmo) <= odp_timer_current_tick(tp));
+		odp_timeout_free(tmo);
+		num++;
+	}
+
+	CU_ASSERT(num == DRIVE_TIMERS);
+
+	for (i = 0; i < DRIVE_TIMERS; i++)
+		CU_ASSERT(odp_timer_free(tim[i]) == ODP_EVENT_INVALID);
+
+	odp_timer_pool_destroy(tp);
+
+	if (odp_queue_destroy(queue) != 0)
+		CU_FAIL_FATAL("Failed to destroy queue");
+
+	if (odp_pool_destroy(pool) != 0)
+		CU_FAIL_FATAL("Failed to destroy pool");
+}
+
+void timer_test_odp_timer_drive(void)
+{
+	test_drive(ODP_TIMER_DRIVE_INLINE);
+	test_drive(ODP_TIMER_DRIVE_POLL);
+}
+
+#define BURST_TIMERS 32
+#define BURST_MAX    4
+
+/* @private Timers expiring on the same tick are delivered at most
+ * BURST_MAX per tick, and per expiry round when the expiry is late */
+void timer_test_odp_timer_burst(void)
+{
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	odp_timer_pool_param_t tparam;
+	odp_timer_pool_t tp;
+	odp_queue_t queue;
+	odp_timer_t tim[BURST_TIMERS];
+	odp_event_t ev;
+	odp_timeout_t tmo;
+	odp_time_t end;
+	uint64_t tick, cur_tick;
+	int i, burst, num = 0;
+
+	odp_pool_param_init(&params);
+	params.type    = ODP_POOL_TIMEOUT;
+	params.tmo.num = BURST_TIMERS;
+
+	pool = odp_pool_create("tmo_pool_for_burst", &params);
+	if (pool == ODP_POOL_INVALID)
+		CU_FAIL_FATAL("Timeout pool create failed");
+
+	/* Inline drive: expiry runs only in the schedule calls below */
+	odp_timer_pool_param_init(&tparam);
+	CU_ASSERT(tparam.max_tmo_per_tick == 0);
+	tparam.res_ns           = ODP_TIME_MSEC_IN_NS;
+	tparam.min_tmo          = ODP_TIME_MSEC_IN_NS;
+	tparam.max_tmo          = ODP_TIME_SEC_IN_NS;
+	tparam.num_timers       = BURST_TIMERS;
+	tparam.drive            = ODP_TIMER_DRIVE_INLINE;
+	tparam.max_tmo_per_tick = BURST_MAX;
+	tp = odp_timer_pool_create(NULL, &tparam);
+	if (tp == ODP_TIMER_POOL_INVALID)
+		CU_FAIL_FATAL("Timer pool create failed");
+
+	odp_timer_pool_start();
+
+	queue = odp_queue_create("timer_burst_queue", NULL);
+	if (queue == ODP_QUEUE_INVALID)
+		CU_FAIL_FATAL("Queue create failed");
+
+	tick = odp_timer_current_tick(tp) +
+	       odp_timer_ns_to_tick(tp, 20 * ODP_TIME_MSEC_IN_NS);
+
+	for (i = 0; i < BURST_TIMERS; i++) {
+		tim[i] = odp_timer_alloc(tp, queue, NULL);
+		CU_ASSERT_FATAL(tim[i] != ODP_TIMER_INVALID);
+
+		ev = odp_timeout_to_event(odp_timeout_alloc(pool));
+		CU_ASSERT_FATAL(ev != ODP_EVENT_INVALID);
+
+		CU_ASSERT(odp_timer_set_abs(tim[i], tick, &ev) ==
+			  ODP_TIMER_SUCCESS);
+	}
+
+	/* Expire late, many ticks after the expiration tick */
+	odp_time_wait_ns(40 * ODP_TIME_MSEC_IN_NS);
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(ODP_TIME_SEC_IN_NS));
+
+	while (num < BURST_TIMERS && odp_time_cmp(end, odp_time_local()) > 0) {
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+		if (ev != ODP_EVENT_INVALID)
+			odp_event_free(ev);
+
+		burst = 0;
+
+		while ((ev = odp_queue_deq(queue)) != ODP_EVENT_INVALID) {
+			tmo = odp_timeout_from_event(ev);
+			cur_tick = odp_timer_current_tick(tp);
+			CU_ASSERT(odp_timeout_tick(tmo) == tick);
+			CU_ASSERT(cur_tick >= tick);
+			odp_timeout_free(tmo);
+			num++;
+			burst++;
+
+			/* Delivered timeouts by the current tick */
+			CU_ASSERT((uint64_t)num <=
+				  (cur_tick - tick + 1) * BURST_MAX);
+		}
+
+		/* Limit applies also when several ticks are caught up */
+		CU_ASSERT(burst <= BURST_MAX);
+	}
+
+	CU_ASSERT(num == BURST_TIMERS);
+
+	for (i = 0; i < BURST_TIMERS; i++)
+		CU_ASSERT(odp_timer_free(tim[i]) == ODP_EVENT_INVALID);
+
+	odp_timer_pool_destroy(tp);
+
+	if (odp_queue_destroy(queue) != 0)
+		CU_FAIL_FATAL("Failed to destroy queue");
+
+	if (odp_pool_destroy(pool) != 0)
+		CU_FAIL_FATAL("Failed to destroy pool");
+}
+
+#define LOCAL_TIMERS 16
+
+/** @private Per thread timer pool test state */
+static struct {
+	odp_pool_t pool;
+	odp_timer_pool_t tp;
+	odp_timer_t tim[LOCAL_TIMERS];
+	odp_event_t ev[LOCAL_TIMERS];
+	int free;
+} local;
+
+/* @private Set or free the second half of the timers from a thread which
+ * does not own them */
+static int local_worker(void *arg TEST_UNUSED)
+{
+	uint64_t tick = odp_timer_ns_to_tick(local.tp,
+					     10 * ODP_TIME_MSEC_IN_NS);
+	int i;
+
+	for (i = LOCAL_TIMERS / 2; i < LOCAL_TIMERS; i++) {
+		if (local.free) {
+			CU_ASSERT(odp_timer_free(local.tim[i]) ==
+				  ODP_EVENT_INVALID);
+			continue;
+		}
+
+		CU_ASSERT(odp_timer_set_rel(local.tim[i], tick,
+					    &local.ev[i]) == ODP_TIMER_SUCCESS);
+	}
+
+	return CU_get_number_of_failures();
+}
+
+/* @private Timers of a per thread pool expire in the owner thread, also
+ * when set and freed by other threads */
+void timer_test_odp_timer_per_thread(void)
+{
+	odp_pool_param_t params;
+	odp_timer_pool_param_t tparam;
+	odp_timer_pool_info_t tpinfo;
+	odp_queue_t queue;
+	odp_event_t ev;
+	odp_timeout_t tmo;
+	odp_time_t end;
+	pthrd_arg thrdarg;
+	uint64_t tick;
+	int i, num = 0;
+
+	odp_pool_param_init(&params);
+	params.type    = ODP_POOL_TIMEOUT;
+	params.tmo.num = LOCAL_TIMERS;
+
+	local.pool = odp_pool_create("tmo_pool_for_local", &params);
+	if (local.pool == ODP_POOL_INVALID)
+		CU_FAIL_FATAL("Timeout pool create failed");
+
+	odp_timer_pool_param_init(&tparam);
+	CU_ASSERT(!tparam.per_thread);
+	tparam.res_ns     = ODP_TIME_MSEC_IN_NS;
+	tparam.min_tmo    = ODP_TIME_MSEC_IN_NS;
+	tparam.max_tmo    = ODP_TIME_SEC_IN_NS;
+	tparam.num_timers = LOCAL_TIMERS;
+	tparam.drive      = ODP_TIMER_DRIVE_SIGNAL;
+	tparam.per_thread = true;
+
+	/* Requires inline drive */
+	CU_ASSERT(odp_timer_pool_create(NULL, &tparam) ==
+		  ODP_TIMER_POOL_INVALID);
+
+	tparam.drive = ODP_TIMER_DRIVE_INLINE;
+	local.tp = odp_timer_pool_create(NULL, &tparam);
+	if (local.tp == ODP_TIMER_POOL_INVALID)
+		CU_FAIL_FATAL("Timer pool create failed");
+
+	odp_timer_pool_start();
+
+	queue = odp_queue_create("timer_local_queue", NULL);
+	if (queue == ODP_QUEUE_INVALID)
+		CU_FAIL_FATAL("Queue create failed");
+
+	for (i = 0; i < LOCAL_TIMERS; i++) {
+		local.tim[i] = odp_timer_alloc(local.tp, queue, NULL);
+		CU_ASSERT_FATAL(local.tim[i] != ODP_TIMER_INVALID);
+
+		tmo = odp_timeout_alloc(local.pool);
+		CU_ASSERT_FATAL(tmo != ODP_TIMEOUT_INVALID);
+		local.ev[i] = odp_timeout_to_event(tmo);
+	}
+
+	/* Owner sets the first half */
+	for (i = 0; i < LOCAL_TIMERS / 2; i++) {
+		tick = odp_timer_ns_to_tick(local.tp,
+					    (i + 1) * ODP_TIME_MSEC_IN_NS);
+		CU_ASSERT(odp_timer_set_rel(local.tim[i], tick,
+					    &local.ev[i]) == ODP_TIMER_SUCCESS);
+	}
+
+	thrdarg.testcase = 0;
+	thrdarg.numthrds = 1;
+	local.free = 0;
+	odp_cunit_thread_create(local_worker, &thrdarg);
+	odp_cunit_thread_exit(&thrdarg);
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(ODP_TIME_SEC_IN_NS));
+
+	while (num < LOCAL_TIMERS && odp_time_cmp(end, odp_time_local()) > 0) {
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+		if (ev != ODP_EVENT_INVALID)
+			odp_event_free(ev);
+
+		ev = odp_queue_deq(queue);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		tmo = odp_timeout_from_event(ev);
+		CU_ASSERT(odp_timeout_tick(tmo) <=
+			  odp_timer_current_tick(local.tp));
+		odp_timeout_free(tmo);
+		num++;
+	}
+
+	CU_ASSERT(num == LOCAL_TIMERS);
+
+	/* Other thread frees the second half */
+	local.free = 1;
+	odp_cunit_thread_create(local_worker, &thrdarg);
+	odp_cunit_thread_exit(&thrdarg);
+
+	for (i = 0; i < LOCAL_TIMERS / 2; i++)
+		CU_ASSERT(odp_timer_free(local.tim[i]) == ODP_EVENT_INVALID);
+
+	CU_ASSERT(odp_timer_pool_info(local.tp, &tpinfo) == 0);
+	CU_ASSERT(tpinfo.cur_timers == 0);
+
+	/* Owner takes back timers freed by the other thread on the next
+	 * tick */
+	ev = odp_schedule(NULL, odp_schedule_wait_time(10 *
+						      ODP_TIME_MSEC_IN_NS));
+	if (ev != ODP_EVENT_INVALID)
+		odp_event_free(ev);
+
+	for (i = 0; i < LOCAL_TIMERS; i++) {
+		local.tim[i] = odp_timer_alloc(local.tp, queue, NULL);
+		CU_ASSERT_FATAL(local.tim[i] != ODP_TIMER_INVALID);
+	}
+
+	for (i = 0; i < LOCAL_TIMERS; i++)
+		CU_ASSERT(odp_timer_free(local.tim[i]) == ODP_EVENT_INVALID);
+
+	odp_timer_pool_destroy(local.tp);
+
+	if (odp_queue_destroy(queue) != 0)
+		CU_FAIL_FATAL("Failed to destroy queue");
+
+	if (odp_pool_destroy(local.pool) != 0)
+		CU_FAIL_FATAL("Failed to destroy pool");
+}
+
 /* @private Handle a received (timeout) event */
 static void handle_tmo(odp_event_t ev, bool stale, uint64_t prev_tick)
 {
@@ -508,6 +868,7 @@ void timer_test_odp_timer_all(void)
 #define MIN (10 * ODP_TIME_MSEC_IN_NS / 3)
 #define MAX (1000000 * ODP_TIME_MSEC_IN_NS)
 	/* Create a timer pool */
+	odp_timer_pool_param_init(&tparam);
 	tparam.res_ns = RES;
 	tparam.min_tmo = MIN;
 	tparam.max_tmo = MAX;
@@ -581,6 +942,9 @@ odp_testinfo_t timer_suite[] = {
 	ODP_TEST_INFO(timer_test_timeout_pool_alloc),
 	ODP_TEST_INFO(timer_test_timeout_pool_free),
 	ODP_TEST_INFO(timer_test_odp_timer_cancel),
+	ODP_TEST_INFO(timer_test_odp_timer_drive),
+	ODP_TEST_INFO(timer_test_odp_timer_burst),
+	ODP_TEST_INFO(timer_test_odp_timer_per_thread),
 	ODP_TEST_INFO(timer_test_odp_timer_all),
 	ODP_TEST_INFO_NULL,
 };
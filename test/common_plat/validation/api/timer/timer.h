@@ -13,6 +13,9 @@
 void timer_test_timeout_pool_alloc(void);
 void timer_test_timeout_pool_free(void);
 void timer_test_odp_timer_cancel(void);
+void timer_test_odp_timer_drive(void);
+void timer_test_odp_timer_burst(void);
+void timer_test_odp_timer_per_thread(void);
 void timer_test_odp_timer_all(void);
 
 /* test arrays: */
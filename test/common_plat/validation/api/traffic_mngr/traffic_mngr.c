@@ -64,6 +64,10 @@
 #define MAX_DROP_PROB            8
 
 #define MAX_PKTS                 1000
+#define NUM_MULTI_TM_SYSTEMS     4
+#define NUM_MULTI_TM_QUEUES      8
+#define NUM_MULTI_TM_PKTS        256
+#define MULTI_TM_PKT_LEN         64
 #define PKT_BUF_SIZE             1460
 #define MAX_PAYLOAD              1400
 #define USE_IPV4                 false
@@ -280,6 +284,11 @@ static uint32_t        num_odp_tm_systems;
 
 static odp_tm_capabilities_t tm_capabilities;
 
+static odp_tm_t         multi_tm_systems[NUM_MULTI_TM_SYSTEMS];
+static odp_tm_queue_t   multi_tm_queues[NUM_MULTI_TM_SYSTEMS]
+				       [NUM_MULTI_TM_QUEUES];
+static odp_atomic_u32_t multi_tm_egress_cnt[NUM_MULTI_TM_SYSTEMS];
+
 static odp_tm_shaper_t    shaper_profiles[NUM_SHAPER_PROFILES];
 static odp_tm_sched_t     sched_profiles[NUM_SCHED_PROFILES];
 static odp_tm_threshold_t threshold_profiles[NUM_THRESHOLD_PROFILES];
@@ -3804,6 +3813,204 @@ static int test_fanin_info(const char *node_name)
 	return walk_tree_backwards(node_desc->node);
 }
 
+static void multi_tm_egress_fcn(odp_packet_t odp_pkt)
+{
+	odp_atomic_u32_t *egress_cnt = odp_packet_user_ptr(odp_pkt);
+
+	odp_atomic_inc_u32(egress_cnt);
+	odp_packet_free(odp_pkt);
+}
+
+static int multi_tm_xmt(uint32_t tm_idx)
+{
+	odp_tm_queue_t tm_queue;
+	odp_packet_t   pkt;
+	uint32_t       cnt;
+
+	for (cnt = 0; cnt < NUM_MULTI_TM_PKTS; cnt++) {
+		pkt = odp_packet_alloc(pools[0], MULTI_TM_PKT_LEN);
+		if (pkt == ODP_PACKET_INVALID) {
+			LOG_ERR("odp_packet_alloc() failed\n");
+			return -1;
+		}
+
+		tm_queue = multi_tm_queues[tm_idx][cnt % NUM_MULTI_TM_QUEUES];
+		odp_packet_user_ptr_set(pkt, &multi_tm_egress_cnt[tm_idx]);
+		if (odp_tm_enq(tm_queue, pkt) < 0) {
+			LOG_ERR("odp_tm_enq() failed\n");
+			odp_packet_free(pkt);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int multi_tm_wait_rcv(uint32_t tm_idx, uint32_t expected)
+{
+	odp_time_t end;
+	uint32_t   rcvd;
+
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(2 * BILLION));
+	rcvd = odp_atomic_load_u32(&multi_tm_egress_cnt[tm_idx]);
+	while (rcvd < expected) {
+		if (odp_time_cmp(end, odp_time_local()) < 0) {
+			LOG_ERR("TM system %u egressed %u of %u pkts\n", tm_idx,
+				rcvd, expected);
+			return -1;
+		}
+
+		rcvd = odp_atomic_load_u32(&multi_tm_egress_cnt[tm_idx]);
+	}
+
+	return 0;
+}
+
+static int multi_tm_destroy(uint32_t tm_idx)
+{
+	uint32_t idx;
+
+	for (idx = 0; idx < NUM_MULTI_TM_QUEUES; idx++) {
+		if (odp_tm_queue_disconnect(multi_tm_queues[tm_idx][idx]) ||
+		    odp_tm_queue_destroy(multi_tm_queues[tm_idx][idx])) {
+			LOG_ERR("tm_queue destroy failed\n");
+			return -1;
+		}
+
+		multi_tm_queues[tm_idx][idx] = ODP_TM_INVALID;
+	}
+
+	if (odp_tm_destroy(multi_tm_systems[tm_idx]))
+		return -1;
+
+	multi_tm_systems[tm_idx] = ODP_TM_INVALID;
+	return 0;
+}
+
+/* Destroy TM systems and queues which are left after a failure */
+static void multi_tm_cleanup(void)
+{
+	odp_tm_queue_t tm_queue;
+	uint32_t tm_idx, idx;
+
+	for (tm_idx = 0; tm_idx < NUM_MULTI_TM_SYSTEMS; tm_idx++) {
+		if (multi_tm_systems[tm_idx] == ODP_TM_INVALID)
+			continue;
+
+		for (idx = 0; idx < NUM_MULTI_TM_QUEUES; idx++) {
+			tm_queue = multi_tm_queues[tm_idx][idx];
+			if (tm_queue == ODP_TM_INVALID)
+				continue;
+
+			/* Queue may not be connected */
+			(void)odp_tm_queue_disconnect(tm_queue);
+			(void)odp_tm_queue_destroy(tm_queue);
+			multi_tm_queues[tm_idx][idx] = ODP_TM_INVALID;
+		}
+
+		(void)odp_tm_destroy(multi_tm_systems[tm_idx]);
+		multi_tm_systems[tm_idx] = ODP_TM_INVALID;
+	}
+}
+
+static int test_multi_tm_systems(void)
+{
+	odp_tm_requirements_t requirements;
+	odp_tm_capabilities_t capabilities;
+	odp_tm_queue_params_t queue_params;
+	odp_tm_egress_t       egress;
+	odp_tm_queue_t        tm_queue;
+	char                  tm_name[TM_NAME_LEN];
+	uint32_t              max_bursts[] = {0, 1, 8, 1000};
+	uint32_t              tm_idx, idx;
+
+	for (tm_idx = 0; tm_idx < NUM_MULTI_TM_SYSTEMS; tm_idx++) {
+		multi_tm_systems[tm_idx] = ODP_TM_INVALID;
+		for (idx = 0; idx < NUM_MULTI_TM_QUEUES; idx++)
+			multi_tm_queues[tm_idx][idx] = ODP_TM_INVALID;
+	}
+
+	/* Create several TM systems with different burst sizes, so that
+	 * these are spread over TM service threads (or share one). */
+	for (tm_idx = 0; tm_idx < NUM_MULTI_TM_SYSTEMS; tm_idx++) {
+		odp_tm_requirements_init(&requirements);
+		odp_tm_egress_init(&egress);
+		requirements.max_tm_queues = NUM_MULTI_TM_QUEUES + 1;
+		requirements.num_levels    = 1;
+		requirements.max_burst     = max_bursts[tm_idx];
+		egress.egress_kind         = ODP_TM_EGRESS_FN;
+		egress.egress_fcn          = multi_tm_egress_fcn;
+
+		snprintf(tm_name, sizeof(tm_name), "TM_multi_%" PRIu32,
+			 tm_idx);
+		multi_tm_systems[tm_idx] = odp_tm_create(tm_name, &requirements,
+							 &egress);
+		if (multi_tm_systems[tm_idx] == ODP_TM_INVALID) {
+			LOG_ERR("odp_tm_create() failed\n");
+			goto error;
+		}
+
+		if (odp_tm_capability(multi_tm_systems[tm_idx],
+				      &capabilities) != 0 ||
+		    capabilities.max_burst == 0 ||
+		    (max_bursts[tm_idx] != 0 &&
+		     capabilities.max_burst > max_bursts[tm_idx])) {
+			LOG_ERR("bad max_burst capability\n");
+			goto error;
+		}
+
+		odp_atomic_init_u32(&multi_tm_egress_cnt[tm_idx], 0);
+		for (idx = 0; idx < NUM_MULTI_TM_QUEUES; idx++) {
+			odp_tm_queue_params_init(&queue_params);
+			queue_params.priority = idx % NUM_PRIORITIES;
+			tm_queue = odp_tm_queue_create(multi_tm_systems[tm_idx],
+						       &queue_params);
+			if (tm_queue == ODP_TM_INVALID) {
+				LOG_ERR("tm_queue create failed\n");
+				goto error;
+			}
+
+			multi_tm_queues[tm_idx][idx] = tm_queue;
+
+			if (odp_tm_queue_connect(tm_queue, ODP_TM_ROOT) != 0) {
+				LOG_ERR("tm_queue connect failed\n");
+				goto error;
+			}
+		}
+	}
+
+	for (tm_idx = 0; tm_idx < NUM_MULTI_TM_SYSTEMS; tm_idx++)
+		if (multi_tm_xmt(tm_idx) != 0)
+			goto error;
+
+	for (tm_idx = 0; tm_idx < NUM_MULTI_TM_SYSTEMS; tm_idx++)
+		if (multi_tm_wait_rcv(tm_idx, NUM_MULTI_TM_PKTS) != 0)
+			goto error;
+
+	/* Destroying some TM systems must not disturb the others, whether
+	 * or not they share a TM service thread. */
+	for (tm_idx = 1; tm_idx < NUM_MULTI_TM_SYSTEMS; tm_idx += 2)
+		if (multi_tm_destroy(tm_idx) != 0)
+			goto error;
+
+	for (tm_idx = 0; tm_idx < NUM_MULTI_TM_SYSTEMS; tm_idx += 2) {
+		if (multi_tm_xmt(tm_idx) != 0 ||
+		    multi_tm_wait_rcv(tm_idx, 2 * NUM_MULTI_TM_PKTS) != 0)
+			goto error;
+	}
+
+	for (tm_idx = 0; tm_idx < NUM_MULTI_TM_SYSTEMS; tm_idx += 2)
+		if (multi_tm_destroy(tm_idx) != 0)
+			goto error;
+
+	return 0;
+
+error:
+	multi_tm_cleanup();
+	return -1;
+}
+
 void traffic_mngr_test_capabilities(void)
 {
 	CU_ASSERT(test_overall_capabilities() == 0);
@@ -3970,6 +4177,11 @@ void traffic_mngr_test_fanin_info(void)
 	CU_ASSERT(test_fanin_info("node_1_3_7") == 0);
 }
 
+void traffic_mngr_test_multi_tm_systems(void)
+{
+	CU_ASSERT(test_multi_tm_systems() == 0);
+}
+
 void traffic_mngr_test_destroy(void)
 {
 	CU_ASSERT(destroy_tm_systems() == 0);
@@ -3992,6 +4204,7 @@ odp_testinfo_t traffic_mngr_suite[] = {
 	ODP_TEST_INFO(traffic_mngr_test_query),
 	ODP_TEST_INFO(traffic_mngr_test_marking),
 	ODP_TEST_INFO(traffic_mngr_test_fanin_info),
+	ODP_TEST_INFO(traffic_mngr_test_multi_tm_systems),
 	ODP_TEST_INFO(traffic_mngr_test_destroy),
 	ODP_TEST_INFO_NULL,
 };
@@ -27,6 +27,7 @@ void traffic_mngr_test_pkt_wred(void);
 void traffic_mngr_test_query(void);
 void traffic_mngr_test_marking(void);
 void traffic_mngr_test_fanin_info(void);
+void traffic_mngr_test_multi_tm_systems(void);
 void traffic_mngr_test_destroy(void);
 
 /* test arrays: */
@@ -6,4 +6,5 @@ AC_CONFIG_FILES([test/linux-generic/Makefile
 		 test/linux-generic/mmap_vlan_ins/Makefile
 		 test/linux-generic/pktio_ipc/Makefile
 		 test/linux-generic/ring/Makefile
+		 test/linux-generic/parser/Makefile
 		 test/linux-generic/performance/Makefile])
@@ -0,0 +1,365 @@
+/* Copyright (c) 2017, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP packet parser test
+ *
+ * Checks tunnel metadata that the parser stores in the packet header but
+ * that is not visible through the API (inner header offsets, tunnel id).
+ */
+
+#include <string.h>
+
+#include <odp_api.h>
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/udp.h>
+#include <test_debug.h>
+#include <odp_cunit_common.h>
+#include <odp_packet_internal.h>
+#include <protocols/ip.h>
+#include <protocols/tunnel.h>
+
+#define PARSER_PKT_LEN  256
+#define PARSER_PKT_NUM  8
+#define PARSER_TEID     0x12345678
+#define PARSER_GRE_KEY  0xabcdef01
+
+/* Offsets of the outer headers of all test packets */
+#define OUTER_L3_OFF    ODPH_ETHHDR_LEN
+#define OUTER_L4_OFF    (OUTER_L3_OFF + ODPH_IPV4HDR_LEN)
+#define OUTER_UDP_END   (OUTER_L4_OFF + ODPH_UDPHDR_LEN)
+
+static odp_pool_t parser_pool;
+
+static uint32_t put_eth(uint8_t *buf, uint16_t type)
+{
+	odph_ethhdr_t *eth = (odph_ethhdr_t *)buf;
+
+	memset(eth, 0, ODPH_ETHHDR_LEN);
+	eth->dst.addr[0] = 0x02;
+	eth->src.addr[0] = 0x02;
+	eth->src.addr[5] = 0x01;
+	eth->type = odp_cpu_to_be_16(type);
+
+	return ODPH_ETHHDR_LEN;
+}
+
+static uint32_t put_ipv4(uint8_t *buf, uint8_t proto, uint32_t payload_len)
+{
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)buf;
+
+	memset(ip, 0, ODPH_IPV4HDR_LEN);
+	ip->ver_ihl = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip->tot_len = odp_cpu_to_be_16(ODPH_IPV4HDR_LEN + payload_len);
+	ip->ttl = 64;
+	ip->proto = proto;
+	ip->src_addr = odp_cpu_to_be_32(0x0a000001);
+	ip->dst_addr = odp_cpu_to_be_32(0x0a000002);
+
+	return ODPH_IPV4HDR_LEN;
+}
+
+static uint32_t put_udp(uint8_t *buf, uint16_t dport, uint32_t payload_len)
+{
+	odph_udphdr_t *udp = (odph_udphdr_t *)buf;
+
+	memset(udp, 0, ODPH_UDPHDR_LEN);
+	udp->src_port = odp_cpu_to_be_16(1024);
+	udp->dst_port = odp_cpu_to_be_16(dport);
+	udp->length = odp_cpu_to_be_16(ODPH_UDPHDR_LEN + payload_len);
+
+	return ODPH_UDPHDR_LEN;
+}
+
+/* Inner IPv4/UDP packet with a few bytes of payload */
+static uint32_t put_inner_ipv4_udp(uint8_t *buf)
+{
+	uint32_t len;
+
+	len = put_ipv4(buf, ODPH_IPPROTO_UDP, ODPH_UDPHDR_LEN + 4);
+	len += put_udp(buf + len, 2048, 4);
+	memset(buf + len, 0, 4);
+
+	return len + 4;
+}
+
+/* Outer Ethernet/IPv4/UDP headers for a UDP payload of 'len' bytes */
+static uint32_t put_outer_udp(uint8_t *buf, uint16_t dport, uint32_t len)
+{
+	uint32_t off;
+
+	off = put_eth(buf, ODPH_ETHTYPE_IPV4);
+	off += put_ipv4(buf + off, ODPH_IPPROTO_UDP, ODPH_UDPHDR_LEN + len);
+	off += put_udp(buf + off, dport, len);
+
+	return off;
+}
+
+/* GTP-U header with the given flags, padded with optional fields when any
+ * of E, S or PN flags is set */
+static uint32_t put_gtpu(uint8_t *buf, uint8_t flags, uint32_t payload_len)
+{
+	uint32_t len = _ODP_GTPUHDR_LEN;
+
+	if (flags & _ODP_GTPU_FLAG_OPT)
+		len = _ODP_GTPUHDR_OPT_LEN;
+
+	memset(buf, 0, len);
+	buf[0] = _ODP_GTPU_VER_PT | flags;
+	buf[1] = _ODP_GTPU_MSG_GPDU;
+	buf[2] = ((len - _ODP_GTPUHDR_LEN + payload_len) >> 8) & 0xff;
+	buf[3] = (len - _ODP_GTPUHDR_LEN + payload_len) & 0xff;
+	buf[4] = (PARSER_TEID >> 24) & 0xff;
+	buf[5] = (PARSER_TEID >> 16) & 0xff;
+	buf[6] = (PARSER_TEID >> 8) & 0xff;
+	buf[7] = PARSER_TEID & 0xff;
+
+	return len;
+}
+
+static odp_packet_t parser_packet(const uint8_t *data, uint32_t len)
+{
+	odp_packet_parse_param_t param;
+	odp_packet_t pkt;
+
+	pkt = odp_packet_alloc(parser_pool, len);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT_FATAL(odp_packet_copy_from_mem(pkt, 0, len, data) == 0);
+
+	param.last_layer = ODP_PROTO_LAYER_ALL;
+	CU_ASSERT(odp_packet_parse(pkt, &param) == 0);
+	CU_ASSERT(!odp_packet_has_error(pkt));
+	CU_ASSERT(odp_packet_l3_offset(pkt) == OUTER_L3_OFF);
+
+	return pkt;
+}
+
+static void parser_test_gtpu(void)
+{
+	static const uint8_t flags[] = { 0, 0x02, 0x01 };
+	uint8_t buf[PARSER_PKT_LEN];
+	odp_packet_hdr_t *pkt_hdr;
+	odp_packet_t pkt;
+	uint32_t inner_len = ODPH_IPV4HDR_LEN + ODPH_UDPHDR_LEN + 4;
+	uint32_t gtpu_len, off;
+	unsigned i;
+
+	/* No optional fields, sequence number, N-PDU number */
+	for (i = 0; i < sizeof(flags); i++) {
+		gtpu_len = (flags[i] & _ODP_GTPU_FLAG_OPT) ?
+			   _ODP_GTPUHDR_OPT_LEN : _ODP_GTPUHDR_LEN;
+		off = put_outer_udp(buf, _ODP_UDP_PORT_GTPU,
+				    gtpu_len + inner_len);
+		off += put_gtpu(buf + off, flags[i], inner_len);
+		off += put_inner_ipv4_udp(buf + off);
+
+		pkt = parser_packet(buf, off);
+		pkt_hdr = odp_packet_hdr(pkt);
+
+		CU_ASSERT(odp_packet_has_udp(pkt));
+		CU_ASSERT(pkt_hdr->p.input_flags.gtpu);
+		CU_ASSERT(pkt_hdr->p.input_flags.tunnel);
+		CU_ASSERT(pkt_hdr->p.tunnel_id == PARSER_TEID);
+		CU_ASSERT(pkt_hdr->p.inner_l2_offset ==
+			  ODP_PACKET_OFFSET_INVALID);
+		CU_ASSERT(pkt_hdr->p.inner_l3_offset ==
+			  OUTER_UDP_END + gtpu_len);
+		CU_ASSERT(pkt_hdr->p.inner_l4_offset ==
+			  OUTER_UDP_END + gtpu_len + ODPH_IPV4HDR_LEN);
+		CU_ASSERT(pkt_hdr->p.inner_ip_proto == ODPH_IPPROTO_UDP);
+
+		odp_packet_free(pkt);
+	}
+}
+
+static void parser_test_gtpu_ext(void)
+{
+	uint8_t buf[PARSER_PKT_LEN];
+	odp_packet_hdr_t *pkt_hdr;
+	odp_packet_t pkt;
+	uint32_t inner_len = ODPH_IPV4HDR_LEN + ODPH_UDPHDR_LEN + 4;
+	uint32_t gtpu_len = _ODP_GTPUHDR_OPT_LEN + 4;
+	uint32_t off, gtpu_off;
+
+	/* One 4 byte extension header (PDU session container) */
+	off = put_outer_udp(buf, _ODP_UDP_PORT_GTPU, gtpu_len + inner_len);
+	gtpu_off = off;
+	off += put_gtpu(buf + off, _ODP_GTPU_FLAG_E, 4 + inner_len);
+	buf[off - 1] = 0x85;
+	buf[off] = 1;
+	buf[off + 1] = 0;
+	buf[off + 2] = 0;
+	buf[off + 3] = 0;
+	off += 4;
+	off += put_inner_ipv4_udp(buf + off);
+
+	pkt = parser_packet(buf, off);
+	pkt_hdr = odp_packet_hdr(pkt);
+
+	CU_ASSERT(pkt_hdr->p.input_flags.gtpu);
+	CU_ASSERT(pkt_hdr->p.input_flags.tunnel);
+	CU_ASSERT(pkt_hdr->p.inner_l3_offset == gtpu_off + gtpu_len);
+
+	odp_packet_free(pkt);
+}
+
+static void parser_test_gtpu_short(void)
+{
+	uint8_t buf[PARSER_PKT_LEN];
+	odp_packet_hdr_t *pkt_hdr;
+	odp_packet_t pkt;
+	uint32_t off;
+
+	/* Mandatory header only, followed by less data than the optional
+	 * fields would take. Header is recognized, no inner packet. */
+	off = put_outer_udp(buf, _ODP_UDP_PORT_GTPU, _ODP_GTPUHDR_LEN + 2);
+	off += put_gtpu(buf + off, 0, 2);
+	buf[off++] = 0x45;
+	buf[off++] = 0;
+
+	pkt = parser_packet(buf, off);
+	pkt_hdr = odp_packet_hdr(pkt);
+
+	CU_ASSERT(pkt_hdr->p.input_flags.gtpu);
+	CU_ASSERT(pkt_hdr->p.tunnel_id == PARSER_TEID);
+	CU_ASSERT(!pkt_hdr->p.input_flags.tunnel);
+
+	odp_packet_free(pkt);
+
+	/* Optional fields flagged but missing */
+	off = put_outer_udp(buf, _ODP_UDP_PORT_GTPU, _ODP_GTPUHDR_LEN + 2);
+	off += put_gtpu(buf + off, 0x02, 0);
+	off -= _ODP_GTPUHDR_OPT_LEN - _ODP_GTPUHDR_LEN - 2;
+
+	pkt = parser_packet(buf, off);
+	pkt_hdr = odp_packet_hdr(pkt);
+
+	CU_ASSERT(pkt_hdr->p.input_flags.gtpu);
+	CU_ASSERT(!pkt_hdr->p.input_flags.tunnel);
+
+	odp_packet_free(pkt);
+}
+
+static void parser_test_gre(void)
+{
+	uint8_t buf[PARSER_PKT_LEN];
+	odp_packet_hdr_t *pkt_hdr;
+	odp_packet_t pkt;
+	uint32_t inner_len = ODPH_IPV4HDR_LEN + ODPH_UDPHDR_LEN + 4;
+	uint32_t gre_len = _ODP_GREHDR_LEN + 4;
+	uint32_t off;
+
+	/* NVGRE: key present, inner Ethernet frame */
+	off = put_eth(buf, ODPH_ETHTYPE_IPV4);
+	off += put_ipv4(buf + off, _ODP_IPPROTO_GRE,
+			gre_len + ODPH_ETHHDR_LEN + inner_len);
+	buf[off++] = (_ODP_GRE_FLAG_K >> 8) & 0xff;
+	buf[off++] = 0;
+	buf[off++] = (_ODP_GRE_PROTO_TEB >> 8) & 0xff;
+	buf[off++] = _ODP_GRE_PROTO_TEB & 0xff;
+	buf[off++] = (PARSER_GRE_KEY >> 24) & 0xff;
+	buf[off++] = (PARSER_GRE_KEY >> 16) & 0xff;
+	buf[off++] = (PARSER_GRE_KEY >> 8) & 0xff;
+	buf[off++] = PARSER_GRE_KEY & 0xff;
+	off += put_eth(buf + off, ODPH_ETHTYPE_IPV4);
+	off += put_inner_ipv4_udp(buf + off);
+
+	pkt = parser_packet(buf, off);
+	pkt_hdr = odp_packet_hdr(pkt);
+
+	CU_ASSERT(pkt_hdr->p.input_flags.gre);
+	CU_ASSERT(pkt_hdr->p.input_flags.tunnel);
+	CU_ASSERT(pkt_hdr->p.tunnel_id == PARSER_GRE_KEY);
+	CU_ASSERT(pkt_hdr->p.inner_l2_offset == OUTER_L4_OFF + gre_len);
+	CU_ASSERT(pkt_hdr->p.inner_l3_offset ==
+		  OUTER_L4_OFF + gre_len + ODPH_ETHHDR_LEN);
+	CU_ASSERT(pkt_hdr->p.inner_l4_offset ==
+		  OUTER_L4_OFF + gre_len + ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN);
+	CU_ASSERT(pkt_hdr->p.inner_ip_proto == ODPH_IPPROTO_UDP);
+
+	odp_packet_free(pkt);
+
+	/* No key, inner IPv4 packet */
+	off = put_eth(buf, ODPH_ETHTYPE_IPV4);
+	off += put_ipv4(buf + off, _ODP_IPPROTO_GRE,
+			_ODP_GREHDR_LEN + inner_len);
+	buf[off++] = 0;
+	buf[off++] = 0;
+	buf[off++] = (ODPH_ETHTYPE_IPV4 >> 8) & 0xff;
+	buf[off++] = ODPH_ETHTYPE_IPV4 & 0xff;
+	off += put_inner_ipv4_udp(buf + off);
+
+	pkt = parser_packet(buf, off);
+	pkt_hdr = odp_packet_hdr(pkt);
+
+	CU_ASSERT(pkt_hdr->p.input_flags.gre);
+	CU_ASSERT(pkt_hdr->p.input_flags.tunnel);
+	CU_ASSERT(pkt_hdr->p.tunnel_id == 0);
+	CU_ASSERT(pkt_hdr->p.inner_l2_offset == ODP_PACKET_OFFSET_INVALID);
+	CU_ASSERT(pkt_hdr->p.inner_l3_offset ==
+		  OUTER_L4_OFF + _ODP_GREHDR_LEN);
+	CU_ASSERT(pkt_hdr->p.inner_l4_offset ==
+		  OUTER_L4_OFF + _ODP_GREHDR_LEN + ODPH_IPV4HDR_LEN);
+
+	odp_packet_free(pkt);
+}
+
+static int parser_suite_init(void)
+{
+	odp_pool_param_t params;
+
+	odp_pool_param_init(&params);
+	params.type = ODP_POOL_PACKET;
+	params.pkt.len = PARSER_PKT_LEN;
+	params.pkt.seg_len = PARSER_PKT_LEN;
+	params.pkt.num = PARSER_PKT_NUM;
+
+	parser_pool = odp_pool_create("parser_pool", &params);
+	if (parser_pool == ODP_POOL_INVALID)
+		return -1;
+
+	return 0;
+}
+
+static int parser_suite_term(void)
+{
+	if (odp_pool_destroy(parser_pool))
+		return -1;
+
+	return 0;
+}
+
+static odp_testinfo_t parser_suite[] = {
+	ODP_TEST_INFO(parser_test_gtpu),
+	ODP_TEST_INFO(parser_test_gtpu_ext),
+	ODP_TEST_INFO(parser_test_gtpu_short),
+	ODP_TEST_INFO(parser_test_gre),
+	ODP_TEST_INFO_NULL,
+};
+
+static odp_suiteinfo_t parser_suites[] = {
+	{"parser tunnel", parser_suite_init, parser_suite_term, parser_suite},
+	ODP_SUITE_INFO_NULL
+};
+
+int main(int argc, char *argv[])
+{
+	int ret;
+
+	/* let helper collect its own arguments (e.g. --odph_proc) */
+	if (odp_cunit_parse_options(argc, argv))
+		return -1;
+
+	ret = odp_cunit_register(parser_suites);
+
+	if (ret == 0)
+		ret = odp_cunit_run();
+
+	return ret;
+}